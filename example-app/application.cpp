@@ -7,11 +7,11 @@
 #include "inexor/vulkan-renderer/octree/collision.hpp"
 #include "inexor/vulkan-renderer/octree/collision_query.hpp"
 #include "inexor/vulkan-renderer/octree/cube.hpp"
+#include "inexor/vulkan-renderer/render-modules/octree/octree_mesh_cache.hpp"
 #include "inexor/vulkan-renderer/tools/camera.hpp"
 #include "inexor/vulkan-renderer/tools/device_info.hpp"
 #include "inexor/vulkan-renderer/tools/enumerate.hpp"
 #include "inexor/vulkan-renderer/tools/exception.hpp"
-#include "inexor/vulkan-renderer/tools/random.hpp"
 #include "inexor/vulkan-renderer/tools/representation.hpp"
 #include "inexor/vulkan-renderer/wrapper/core/instance.hpp"
 #include "inexor/vulkan-renderer/wrapper/windows/surface.hpp"
@@ -29,7 +29,6 @@
 #include <stdexcept>
 #include <string_view>
 #include <toml++/toml.hpp>
-#include <unordered_map>
 
 namespace inexor::example_app {
 
@@ -84,7 +83,7 @@ VkBool32 ExampleApp::validation_layer_debug_messenger_callback(const VkDebugUtil
 }
 
 void ExampleApp::load_octree_geometry(bool initialize) {
-    const auto old_vertex_count = m_octree_vertices.size();
+    const auto old_vertex_count = m_octree_mesh.vertices.size();
 
     // 4: 23 012 | 5: 184352 | 6: 1474162 | 7: 11792978 cubes, DO NOT USE 7!
     m_worlds.clear();
@@ -92,42 +91,20 @@ void ExampleApp::load_octree_geometry(bool initialize) {
     m_worlds.push_back(create_random_world(2, {0.0f, 0.0f, 0.0f}, initialize ? std::optional(42) : std::nullopt));
     m_worlds.push_back(create_random_world(2, {10.0f, 0.0f, 0.0f}, initialize ? std::optional(60) : std::nullopt));
 
-    using tools::generate_random_number;
-    m_octree_vertices.clear();
-    for (const auto &world : m_worlds) {
-        for (const auto &polygons : world->polygons(true)) {
-            for (const auto &triangle : *polygons) {
-                for (const auto &vertex : triangle) {
-                    glm::vec3 color = {
-                        generate_random_number(0.0f, 1.0f),
-                        generate_random_number(0.0f, 1.0f),
-                        generate_random_number(0.0f, 1.0f),
-                    };
-                    m_octree_vertices.emplace_back(vertex, color);
-                }
-            }
-        }
+    if (!m_octree_mesh_cache) {
+        m_octree_mesh_cache = std::make_shared<OctreeMeshCache>("octree_mesh.cache");
     }
-    spdlog::trace("Octree vertices generated [new: {}, old: {}]", m_octree_vertices.size(), old_vertex_count);
-}
-
-void ExampleApp::generate_octree_indices() {
-    auto old_vertices = std::move(m_octree_vertices);
-    m_octree_indices.clear();
-    m_octree_vertices.clear();
-    std::unordered_map<OctreeVertex, std::uint32_t> vertex_map;
-    for (auto &vertex : old_vertices) {
-        // TODO: Use std::unordered_map::contains() when we switch to C++ 20.
-        if (vertex_map.count(vertex) == 0) {
-            if (vertex_map.size() >= std::numeric_limits<std::uint32_t>::max()) {
-                throw std::overflow_error("Octree too big!");
-            }
-            vertex_map.emplace(vertex, static_cast<std::uint32_t>(vertex_map.size()));
-            m_octree_vertices.push_back(vertex);
-        }
-        m_octree_indices.push_back(vertex_map.at(vertex));
-    }
-    // @TODO Fix index generation and bring back debug output
+    const auto cache_hits = m_octree_mesh_cache->hits();
+    // The shading comes from the ambient occlusion which is baked into the vertices, so a constant color is enough
+    render_modules::octree::OctreeMesher mesher(OCTREE_CHUNK_DEPTH, OCTREE_LOD_COUNT,
+                                                [](const glm::vec3 &) { return glm::vec3{0.85f, 0.8f, 0.7f}; });
+    mesher.set_cache(m_octree_mesh_cache);
+    m_octree_mesh = mesher.mesh(m_worlds);
+    spdlog::trace("Octree chunks loaded from mesh cache: {}", m_octree_mesh_cache->hits() - cache_hits);
+    spdlog::trace("Octree vertices generated [new: {}, old: {}, chunks: {}]", m_octree_mesh.vertices.size(),
+                  old_vertex_count, m_octree_mesh.chunks.size());
+    spdlog::trace("Octree vertex cache ACMR [before: {:.3f}, after: {:.3f}]", m_octree_mesh.acmr_before_optimization,
+                  m_octree_mesh.acmr_after_optimization);
 }
 
 void ExampleApp::setup_window_and_input_callbacks() {
@@ -385,16 +362,20 @@ ExampleApp::ExampleApp(int argc, char **argv) {
     m_render_graph = std::make_unique<RenderGraph>(*m_device, !m_no_cmd_buf_cache);
 
     load_octree_geometry(true);
-    generate_octree_indices();
 
     m_window->show();
     recreate_swapchain();
     setup_render_graph();
 
-    m_octree_renderer->set_vertices_and_indices(m_octree_vertices, m_octree_indices);
+    m_octree_renderer->set_lod_distances({OCTREE_LOD_DISTANCES.begin(), OCTREE_LOD_DISTANCES.end()});
+    m_octree_renderer->set_mesh(m_octree_mesh);
 }
 
-ExampleApp::~ExampleApp() {}
+ExampleApp::~ExampleApp() {
+    if (m_octree_mesh_cache) {
+        m_octree_mesh_cache->save();
+    }
+}
 
 void ExampleApp::render_frame() {
     if (m_window_resized) {
@@ -571,8 +552,7 @@ void ExampleApp::run() {
             render_frame();
             if (m_input->kbm_data().was_key_pressed_once(GLFW_KEY_N)) {
                 load_octree_geometry(false);
-                generate_octree_indices();
-                m_octree_renderer->set_vertices_and_indices(m_octree_vertices, m_octree_indices);
+                m_octree_renderer->set_mesh(m_octree_mesh);
             }
             if (m_input->kbm_data().was_key_pressed_once(GLFW_KEY_V)) {
                 m_device->log_vma_statistics("Manual VMA statistics");
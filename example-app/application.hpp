@@ -9,7 +9,7 @@ class Cube;
 
 namespace inexor::vulkan_renderer::render_modules::octree {
 // Forward declaration
-class OctreeVertex;
+class OctreeMeshCache;
 } // namespace inexor::vulkan_renderer::render_modules::octree
 
 namespace inexor::vulkan_renderer::input {
@@ -28,7 +28,9 @@ namespace inexor::example_app {
 using vulkan_renderer::input::Input;
 using vulkan_renderer::octree::Cube;
 using vulkan_renderer::render_graph::TextureUsage;
-using vulkan_renderer::render_modules::octree::OctreeVertex;
+using vulkan_renderer::render_modules::octree::build_octree_mesh;
+using vulkan_renderer::render_modules::octree::OctreeMesh;
+using vulkan_renderer::render_modules::octree::OctreeMeshCache;
 using vulkan_renderer::tools::CameraMovement;
 using vulkan_renderer::tools::CameraType;
 using vulkan_renderer::tools::FPSLimiter;
@@ -50,8 +52,16 @@ private:
     std::string m_window_title;
     bool m_no_cmd_buf_cache{false};
 
-    std::vector<OctreeVertex> m_octree_vertices;
-    std::vector<std::uint32_t> m_octree_indices;
+    /// The depth of the octree chunks, which are the units of level of detail selection
+    static constexpr std::uint32_t OCTREE_CHUNK_DEPTH{1};
+    /// The maximum number of levels of detail per chunk
+    static constexpr std::uint32_t OCTREE_LOD_COUNT{3};
+    /// The camera distances from which level of detail 1, 2, ... of a chunk is drawn
+    static constexpr std::array<float, OCTREE_LOD_COUNT - 1> OCTREE_LOD_DISTANCES{20.0f, 40.0f};
+
+    OctreeMesh m_octree_mesh;
+    /// The chunk meshes of previous starts, so unchanged chunks are not meshed again
+    std::shared_ptr<OctreeMeshCache> m_octree_mesh_cache;
 
     static VkBool32 validation_layer_debug_messenger_callback(VkDebugUtilsMessageSeverityFlagBitsEXT severity,
                                                               VkDebugUtilsMessageTypeFlagsEXT type,
@@ -72,7 +82,6 @@ private:
     /// Use the camera's position and view direction vector to check for ray-octree collisions with all octrees.
     void check_octree_collisions();
     void process_input();
-    void generate_octree_indices();
     void initialize_spdlog();
     void recreate_swapchain();
     void render_frame();
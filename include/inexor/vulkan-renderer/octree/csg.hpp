@@ -0,0 +1,31 @@
+#pragma once
+
+// Forward declaration
+namespace inexor::vulkan_renderer::octree {
+class Cube;
+} // namespace inexor::vulkan_renderer::octree
+
+namespace inexor::vulkan_renderer::octree {
+
+/// Boolean operations between two octrees.
+enum class CsgOperation {
+    /// Add the geometry of the brush to the target.
+    UNION,
+    /// Remove the geometry of the brush from the target.
+    SUBTRACT,
+    /// Keep only the geometry which is both in the target and in the brush.
+    INTERSECT,
+};
+
+/// @brief Merge a brush octree into a target octree node by node.
+/// Homogeneous (Type::EMPTY or Type::SOLID) cubes on either side are resolved without descending into the other tree,
+/// and the target is simplified only once after the whole merge instead of after every changed cube.
+/// Two Type::NORMAL cubes are combined edge by edge. The complement of a Type::NORMAL cube, or its combination with an
+/// octant, can't be represented exactly, so in these cases the Type::NORMAL cube is rounded to Type::SOLID or
+/// Type::EMPTY depending on its fill ratio.
+/// @param target The cube which is modified. This can be any cube of an octree, e.g. the cube selected in the editor
+/// @param brush The cube which is merged into the target. It must have the same size and position as the target
+/// @param operation The boolean operation
+void apply_csg(Cube &target, const Cube &brush, CsgOperation operation);
+
+} // namespace inexor::vulkan_renderer::octree
@@ -82,6 +82,9 @@ private:
 
     /// Get the root to this cube.
     [[nodiscard]] std::shared_ptr<Cube> root();
+    /// Simplify all octants of this subtree bottom-up without notifying the parent.
+    void simplify_subtree();
+
     /// Get the vertices of this cube. Use only on geometry cubes.
     [[nodiscard]] std::array<glm::vec3, 8> vertices() const;
 
@@ -128,6 +131,11 @@ public:
     /// Count the number of Type::SOLID and Type::NORMAL cubes.
     [[nodiscard]] std::size_t count_geometry_cubes() const noexcept;
 
+    /// Approximate fraction of the cube's volume which is filled with geometry.
+    /// This is 0 for Type::EMPTY and 1 for Type::SOLID cubes. For Type::NORMAL cubes it is estimated from the
+    /// indentations of the edges along each axis, and for Type::OCTANT cubes it is the mean of the children.
+    [[nodiscard]] float fill_ratio() const noexcept;
+
     /// At which child level this cube is.
     /// root cube = 0
     [[nodiscard]] std::size_t grid_level() const noexcept;
@@ -172,9 +180,18 @@ public:
     /// Set an indent by the edge id.
     void set_indent(std::uint8_t edge_id, Indentation indentation);
 
+    /// Set all indentations at once. Use only on Type::NORMAL cubes.
+    void set_indentations(const std::array<Indentation, Cube::EDGES> &indentations);
+
     /// Set a new type.
     void set_type(Type new_type);
 
+    /// Set a new type without asking the parent to simplify itself afterwards.
+    /// Bulk operations (builders, CSG, ...) use this to avoid the simplify cascade on every single cube and call
+    /// simplify_recursive() once after the whole tree has been written.
+    /// @note Different subtrees can be written in parallel this way, because the parent is never touched.
+    void set_type_without_simplify(Type new_type);
+
     [[nodiscard]] float size() const noexcept {
         return m_size;
     }
@@ -182,6 +199,10 @@ public:
     /// Simplify this octant if all children are of the same homogeneous type (EMPTY or SOLID).
     void simplify();
 
+    /// Simplify all octants of this subtree bottom-up, including this cube itself.
+    /// If this cube is collapsed, the parent is notified like in set_type.
+    void simplify_recursive();
+
     /// Get type.
     [[nodiscard]] Type type() const noexcept;
 
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+// Forward declaration
+namespace inexor::vulkan_renderer::octree {
+class Cube;
+} // namespace inexor::vulkan_renderer::octree
+
+namespace inexor::vulkan_renderer::octree {
+
+/// How a subtree is replaced by a single representative cube when a level of detail is generated.
+enum class LodHeuristic {
+    /// The type which covers most of the subtree's volume wins. Type::NORMAL cubes vote for Type::SOLID or Type::EMPTY
+    /// depending on their fill ratio.
+    MAJORITY_TYPE,
+    /// The subtree becomes Type::SOLID if its fill ratio reaches the coverage threshold, otherwise Type::EMPTY.
+    COVERAGE,
+};
+
+/// The number of nested octants below a cube. A cube which is not an octant has a depth of 0.
+[[nodiscard]] std::uint32_t octree_depth(const Cube &cube) noexcept;
+
+/// @brief Create a simplified copy of an octree for rendering it at a lower level of detail.
+/// The copy is identical to the original down to the given depth. Octants at this depth are collapsed into a single
+/// Type::SOLID or Type::EMPTY cube according to the heuristic, and the copy is simplified once at the end.
+/// @param cube The cube to copy. This does not need to be a root cube, e.g. it can be one chunk of a larger octree
+/// @param depth The depth relative to the given cube at which subtrees are collapsed (0 collapses the whole cube)
+/// @param heuristic The heuristic which selects the type of a collapsed subtree
+/// @param coverage_threshold The fill ratio at which a subtree becomes Type::SOLID with LodHeuristic::COVERAGE
+/// @return A new root cube with the same size and position as the given cube
+[[nodiscard]] std::shared_ptr<Cube> create_lod(const Cube &cube, std::uint32_t depth,
+                                               LodHeuristic heuristic = LodHeuristic::COVERAGE,
+                                               float coverage_threshold = 0.5f);
+
+} // namespace inexor::vulkan_renderer::octree
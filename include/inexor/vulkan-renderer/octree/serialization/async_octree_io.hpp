@@ -0,0 +1,116 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/octree/serialization/byte_stream.hpp"
+#include "inexor/vulkan-renderer/octree/serialization/nxoc_parser.hpp"
+
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Forward declaration
+namespace inexor::vulkan_renderer::octree {
+class Cube;
+} // namespace inexor::vulkan_renderer::octree
+
+// Forward declaration
+namespace inexor::vulkan_renderer::tools {
+class ThreadPool;
+} // namespace inexor::vulkan_renderer::tools
+
+namespace inexor::vulkan_renderer::serialization {
+
+/// @brief Loads and saves octree files on the worker threads of a thread pool, so the render loop does not wait for
+/// file I/O and parsing.
+/// Results are either returned as futures, or passed to completion callbacks which run on the thread that calls
+/// poll(), so a loaded octree can be swapped in by the main thread between two frames.
+class AsyncOctreeIO {
+public:
+    /// Called with the loaded octree, or with the exception if loading failed.
+    using LoadCallback = std::function<void(std::shared_ptr<octree::Cube>, std::exception_ptr)>;
+    /// Called with the size of the file, or with the exception if saving failed.
+    using SaveCallback = std::function<void(std::size_t, std::exception_ptr)>;
+
+private:
+    tools::ThreadPool &m_thread_pool;
+    NXOCParser m_parser;
+    FileWriteOptions m_write_options;
+
+    std::mutex m_mutex;
+    std::condition_variable m_finished;
+    /// The completion callbacks of finished tasks, which are run by poll()
+    std::vector<std::function<void()>> m_completions;
+    /// The number of submitted tasks which have not finished yet
+    std::size_t m_pending_tasks{0};
+
+    /// Run a task on the thread pool, and count it as pending until it has finished.
+    template <typename Task>
+    [[nodiscard]] auto run(Task task);
+
+    /// Run a task on the thread pool, and queue its completion callback for poll().
+    template <typename Task, typename Callback>
+    void run_with_callback(Task task, Callback callback);
+
+public:
+    /// @param thread_pool The thread pool which runs the tasks, which must outlive this object
+    /// @param parser The parser which decodes and encodes the octrees
+    /// @param write_options The options of the files which are saved
+    explicit AsyncOctreeIO(tools::ThreadPool &thread_pool, NXOCParser parser = NXOCParser(),
+                           FileWriteOptions write_options = {});
+    AsyncOctreeIO(const AsyncOctreeIO &) = delete;
+    AsyncOctreeIO(AsyncOctreeIO &&) = delete;
+
+    /// Wait for all tasks which have been submitted. Completion callbacks which have not been polled are dropped.
+    ~AsyncOctreeIO();
+
+    AsyncOctreeIO &operator=(const AsyncOctreeIO &) = delete;
+    AsyncOctreeIO &operator=(AsyncOctreeIO &&) = delete;
+
+    /// @brief Load an octree file on the thread pool.
+    /// @param path The path of the file
+    /// @param filter Selects the subtrees to decode (see NXOCParser::deserialize)
+    /// @return The future of the octree, which holds the exception if the file can't be read or parsed
+    [[nodiscard]] std::future<std::shared_ptr<octree::Cube>> load(std::filesystem::path path,
+                                                                  NXOCParser::SubtreeFilter filter = {});
+
+    /// @brief Load an octree file on the thread pool, and pass it to a callback which runs in poll().
+    /// @param path The path of the file
+    /// @param callback The completion callback
+    /// @param filter Selects the subtrees to decode (see NXOCParser::deserialize)
+    void load(std::filesystem::path path, LoadCallback callback, NXOCParser::SubtreeFilter filter = {});
+
+    /// @brief Save an octree file on the thread pool.
+    /// The octree is read by the worker thread, so it must not be modified until the file is saved. Save a clone() of
+    /// an octree which is edited in the meantime.
+    /// @param cube The octree
+    /// @param version The version of the format
+    /// @param path The path of the file
+    /// @return The future of the size of the file, which holds the exception if the file can't be written
+    [[nodiscard]] std::future<std::size_t> save(std::shared_ptr<const octree::Cube> cube, std::uint32_t version,
+                                                std::filesystem::path path);
+
+    /// @brief Save an octree file on the thread pool, and pass the size of the file to a callback which runs in poll().
+    /// The octree must not be modified until the file is saved.
+    /// @param cube The octree
+    /// @param version The version of the format
+    /// @param path The path of the file
+    /// @param callback The completion callback
+    void save(std::shared_ptr<const octree::Cube> cube, std::uint32_t version, std::filesystem::path path,
+              SaveCallback callback);
+
+    /// Run the completion callbacks of the finished tasks on the calling thread.
+    /// @return The number of callbacks which have been run
+    std::size_t poll();
+
+    /// The number of tasks which have not finished yet.
+    [[nodiscard]] std::size_t pending_tasks();
+
+    /// Wait until all submitted tasks have finished. Their completion callbacks still need to be polled.
+    void wait();
+};
+
+} // namespace inexor::vulkan_renderer::serialization
@@ -1,58 +1,145 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <span>
 #include <vector>
 
+// Forward declaration
+namespace inexor::vulkan_renderer::tools {
+class MemoryMappedFile;
+} // namespace inexor::vulkan_renderer::tools
+
 namespace inexor::vulkan_renderer::serialization {
 
+/// The bytes of a serialized octree, which are either held in memory or mapped from a file.
 class ByteStream {
 protected:
     std::vector<std::uint8_t> m_buffer;
-
-    /// Read from file.
-    [[nodiscard]] static std::vector<std::uint8_t> read_file(const std::filesystem::path &path);
+    /// The file of a stream which is read from a file. Copies of the stream share the file.
+    std::shared_ptr<const tools::MemoryMappedFile> m_file;
 
 public:
     ByteStream() = default;
     explicit ByteStream(std::vector<std::uint8_t> buffer);
 
-    /// Read from file.
+    /// Read from file. The file is mapped into memory without copying it if possible (see tools::MemoryMappedFile).
+    /// @exception std::runtime_error The file can't be opened or read
     explicit ByteStream(const std::filesystem::path &path);
 
-    [[nodiscard]] const std::vector<std::uint8_t> &buffer() const;
+    /// The bytes of the stream, which stay valid as long as the stream or a copy of it exists.
+    [[nodiscard]] std::span<const std::uint8_t> data() const;
 
     [[nodiscard]] std::size_t size() const;
+
+    /// Whether the stream is a file which is mapped into memory.
+    [[nodiscard]] bool is_memory_mapped() const;
+
+    /// Compare the bytes of two streams.
+    [[nodiscard]] bool operator==(const ByteStream &rhs) const;
 };
 
 class ByteStreamReader {
 private:
-    const ByteStream &m_stream;
+    /// The bytes of the stream.
+    std::span<const std::uint8_t> m_data;
 
-    /// Stream iterator.
-    std::vector<std::uint8_t>::const_iterator m_iter;
+    /// The read position.
+    std::size_t m_position{0};
 
     void check_end(std::size_t size) const;
 
 public:
     explicit ByteStreamReader(const ByteStream &stream);
+    /// Read from bytes which are not a stream, like a decompressed block. The bytes must outlive the reader.
+    explicit ByteStreamReader(std::span<const std::uint8_t> data);
 
-    /// Generic read method.
+    /// Generic read method. Reading std::span<const std::uint8_t> with a size returns a view into the stream without
+    /// copying.
     template <typename T, typename... Args>
     [[nodiscard]] T read(const Args &...);
 
     [[nodiscard]] std::size_t remaining() const;
 
+    /// The number of bytes which have been read or skipped.
+    [[nodiscard]] std::size_t position() const;
+
     /// Skip 'size' bytes (std::uint8_t).
     void skip(std::size_t size);
 };
 
+/// Options of a ByteStreamWriter which streams into a file.
+struct FileWriteOptions {
+    /// The size of the write buffer, which bounds the memory of the writer regardless of the size of the file
+    std::size_t buffer_size{1024 * 1024};
+    /// Bypass the page cache with O_DIRECT, so writing big files does not evict other data from it. This is only
+    /// supported on Linux, and the file is written normally if the file system does not support it.
+    bool direct_io{false};
+    /// Flush the file to the disk (fsync) before finish() returns.
+    bool sync{false};
+};
+
 class ByteStreamWriter : public ByteStream {
 public:
-    using ByteStream::ByteStream;
+    /// Receives the buffer of a streaming writer whenever it is full, and the remaining bytes in finish().
+    using FlushCallback = std::function<void(std::span<const std::uint8_t>)>;
+
+private:
+    /// The file which the buffer is flushed into when streaming into a file
+    class FileSink;
+    std::unique_ptr<FileSink> m_sink;
+    /// The function which the buffer is flushed into when streaming into a function
+    FlushCallback m_on_flush;
+    /// The size at which the buffer is flushed, or 0 if the writer writes into memory
+    std::size_t m_buffer_size{0};
+    /// The number of bytes which have been flushed
+    std::size_t m_flushed_size{0};
+
+    void append(std::uint8_t value);
+    void append(std::span<const std::uint8_t> values);
+    void flush();
+
+public:
+    ByteStreamWriter();
+    explicit ByteStreamWriter(std::vector<std::uint8_t> buffer);
+
+    /// @brief Stream into a file instead of memory.
+    /// The writer keeps at most FileWriteOptions::buffer_size bytes in memory, and data() only contains the bytes
+    /// which have not been flushed yet. finish() must be called after the last write. The bytes are written into a
+    /// temporary file next to the file, which only replaces the file in finish(), so the old file is kept if writing
+    /// fails, and streams which map the old file stay valid.
+    /// @param path The path of the file, which is created or replaced
+    /// @param options The file write options
+    /// @exception std::runtime_error The file can't be opened
+    ByteStreamWriter(const std::filesystem::path &path, const FileWriteOptions &options);
+
+    /// @brief Stream into a function instead of memory.
+    /// The function is called with exactly buffer_size bytes whenever the buffer is full, and with the remaining
+    /// bytes in finish(), which must be called after the last write.
+    /// @param buffer_size The number of bytes which are kept in memory
+    /// @param on_flush The function which receives the bytes
+    ByteStreamWriter(std::size_t buffer_size, FlushCallback on_flush);
+
+    ByteStreamWriter(const ByteStreamWriter &) = delete;
+    ByteStreamWriter(ByteStreamWriter &&) noexcept;
+    ~ByteStreamWriter();
+
+    ByteStreamWriter &operator=(const ByteStreamWriter &) = delete;
+    ByteStreamWriter &operator=(ByteStreamWriter &&) noexcept;
 
     /// Generic write method.
     template <typename T>
     void write(const T &value);
+
+    /// The number of bytes which have been written, including the bytes which have been flushed.
+    [[nodiscard]] std::size_t bytes_written() const;
+
+    /// Flush the remaining bytes into the file or function, close the file, and replace the file with it. This does
+    /// nothing if the writer writes into memory.
+    /// @exception std::runtime_error The file can't be written or replaced
+    void finish();
 };
 
 } // namespace inexor::vulkan_renderer::serialization
@@ -2,7 +2,11 @@
 
 #include "inexor/vulkan-renderer/octree/serialization/octree_parser.hpp"
 
+#include <filesystem>
+#include <functional>
 #include <memory>
+#include <span>
+#include <vector>
 
 // Forward declaration
 namespace inexor::vulkan_renderer::octree {
@@ -12,27 +16,165 @@ class Cube;
 // Forward declaration
 namespace inexor::vulkan_renderer::serialization {
 class ByteStream;
+class ByteStreamReader;
+class ByteStreamWriter;
+struct FileWriteOptions;
 } // namespace inexor::vulkan_renderer::serialization
 
 namespace inexor::vulkan_renderer::serialization {
 
+/// @brief Parser of the Inexor octree format (NXOC).
+/// Every version starts with the identifier "Inexor Octree" and the version as little endian std::uint32_t.
+/// Version 0 stores the cubes as a single pre-order stream: the type of every cube, followed by the packed
+/// indentations of normal cubes.
+/// Version 1 splits the octree into subtrees at a fixed depth, so they can be decoded in parallel or only when needed:
+///   - std::uint8_t: the subtree depth
+///   - std::uint32_t: the number of subtrees
+///   - for every subtree: std::uint32_t byte offset from the start of the stream and std::uint32_t size in bytes
+///   - the cubes above the subtree depth in pre-order like version 0
+///   - the subtrees, which are the children of octants directly above the subtree depth, in pre-order like version 0
+/// Version 2 stores the cubes above the subtree depth and every subtree as a block, which can be compressed. The table
+/// follows the blocks, so the file can be written in a single pass:
+///   - std::uint8_t: the subtree depth
+///   - std::uint8_t: the compression of the blocks (see Compression)
+///   - the block of the cubes above the subtree depth, and the blocks of the subtrees in pre-order
+///   - std::uint32_t: the number of subtrees
+///   - for the cubes above the subtree depth and every subtree: std::uint32_t byte offset from the start of the stream,
+///     std::uint32_t size in bytes, and std::uint32_t size after decompression
+///   - std::uint32_t: the byte offset of the number of subtrees from the start of the stream
+/// A compressed block is split into chunks of LZ_CHUNK_SIZE bytes before compression, and the last chunk may be
+/// smaller. Every chunk is compressed on its own and stored as its std::uint32_t size in bytes, followed by the bytes.
 class NXOCParser : public OctreeParser {
+public:
+    static constexpr std::uint32_t LATEST_VERSION{2};
+    /// The default depth of the subtrees in version 1, which gives up to 64 subtrees.
+    static constexpr std::uint32_t DEFAULT_SUBTREE_DEPTH{2};
+    /// The size of the chunks of compressed blocks in version 2 before compression.
+    static constexpr std::size_t LZ_CHUNK_SIZE{64 * 1024};
+
+    /// Selects the subtrees which are decoded. The subtree root has its size and position in the octree, but its type
+    /// is not decoded yet.
+    using SubtreeFilter = std::function<bool(const octree::Cube &)>;
+
+    /// The compression of the blocks of version 2.
+    enum class Compression : std::uint8_t {
+        NONE = 0,
+        /// The fast block codec tools::lz_compress, which shrinks runs of equal cubes a lot
+        LZ = 1,
+    };
+
 private:
-    static constexpr std::uint32_t LATEST_VERSION{0};
+    /// An entry of the subtree table of version 1 and 2.
+    struct SubtreeEntry {
+        std::uint32_t offset{0};
+        std::uint32_t size{0};
+        /// The size after decompression, which is the size if the block is not compressed
+        std::uint32_t decoded_size{0};
+    };
+
+    /// The subtree table of version 1 and 2.
+    struct SubtreeTable {
+        std::uint32_t subtree_depth{0};
+        Compression compression{Compression::NONE};
+        /// The cubes above the subtree depth
+        SubtreeEntry top;
+        std::vector<SubtreeEntry> subtrees;
+    };
+
+    std::uint32_t m_subtree_depth;
+    Compression m_compression;
+
+    /// Read the subtree table of a version 1 or 2 stream.
+    [[nodiscard]] static SubtreeTable read_subtree_table(const ByteStream &stream, std::uint32_t version);
+
+    /// The bytes of a block, which are decompressed into the buffer if needed.
+    [[nodiscard]] static std::span<const std::uint8_t> read_block(const ByteStream &stream, Compression compression,
+                                                                  const SubtreeEntry &entry,
+                                                                  std::vector<std::uint8_t> &buffer);
+
+    /// Decode a cube and its children in pre-order.
+    static void decode_cube(ByteStreamReader &reader, const std::shared_ptr<octree::Cube> &cube);
+
+    /// Decode the cubes above the subtree depth in pre-order, and collect the roots of the subtrees.
+    static void decode_top_cubes(ByteStreamReader &reader, const std::shared_ptr<octree::Cube> &cube,
+                                 std::uint32_t depth, std::uint32_t subtree_depth,
+                                 std::vector<std::shared_ptr<octree::Cube>> &subtrees);
+
+    /// The number of bytes which encode_cube writes.
+    [[nodiscard]] static std::size_t encoded_size(const std::shared_ptr<const octree::Cube> &cube);
+
+    /// Encode a cube and its children in pre-order.
+    static void encode_cube(ByteStreamWriter &writer, const std::shared_ptr<const octree::Cube> &cube);
+
+    /// Encode the cubes above the subtree depth in pre-order, and collect the roots of the subtrees.
+    static void encode_top_cubes(ByteStreamWriter &writer, const std::shared_ptr<const octree::Cube> &cube,
+                                 std::uint32_t depth, std::uint32_t subtree_depth,
+                                 std::vector<std::shared_ptr<const octree::Cube>> &subtrees);
+
+    /// Decode a version 1 or 2 stream, where only the selected subtrees are decoded.
+    [[nodiscard]] static std::shared_ptr<octree::Cube>
+    decode_blocks(const ByteStream &stream, const SubtreeTable &table, const SubtreeFilter &filter);
+
+    /// Decode the selected subtrees of a version 1 or 2 stream in parallel. Compressed subtrees are decompressed by
+    /// the task which decodes them.
+    static void decode_subtrees(const ByteStream &stream, const SubtreeTable &table,
+                                std::span<const std::shared_ptr<octree::Cube>> subtrees, const SubtreeFilter &filter);
 
     /// Specific version deserialization.
     template <std::size_t version>
-    [[nodiscard]] std::shared_ptr<octree::Cube> deserialize_impl(const ByteStream &stream);
+    [[nodiscard]] std::shared_ptr<octree::Cube> deserialize_impl(const ByteStream &stream,
+                                                                 const SubtreeFilter &filter);
 
     /// Specific version serialization.
     template <std::size_t version>
-    [[nodiscard]] ByteStream serialize_impl(std::shared_ptr<const octree::Cube> cube);
+    void serialize_impl(ByteStreamWriter &writer, std::shared_ptr<const octree::Cube> cube);
+
+    /// Serialization of an octree into a writer.
+    void serialize(ByteStreamWriter &writer, const std::shared_ptr<const octree::Cube> &cube, std::uint32_t version);
 
 public:
+    /// @param subtree_depth The depth of the subtrees when serializing version 1 and 2 (at most 255)
+    /// @param compression The compression of the blocks when serializing version 2. Streams are decoded with the
+    /// compression which they were serialized with.
+    /// @exception std::invalid_argument The subtree depth is too big
+    explicit NXOCParser(std::uint32_t subtree_depth = DEFAULT_SUBTREE_DEPTH,
+                        Compression compression = Compression::LZ);
+
     /// Deserialization of an octree.
     [[nodiscard]] std::shared_ptr<octree::Cube> deserialize(const ByteStream &stream) final;
 
+    /// @brief Deserialization of an octree, where only the selected subtrees are decoded.
+    /// The other subtrees are left empty and can be decoded later with load_subtrees. Version 0 has no subtrees and
+    /// is always decoded completely.
+    /// @param stream The serialized octree
+    /// @param filter Selects the subtrees to decode
+    [[nodiscard]] std::shared_ptr<octree::Cube> deserialize(const ByteStream &stream, const SubtreeFilter &filter);
+
+    /// @brief Decode the selected subtrees of an octree which was deserialized from the same stream.
+    /// Subtrees which were decoded before are replaced. Nothing is decoded for version 0.
+    /// @param stream The serialized octree
+    /// @param root The octree which was deserialized from the stream
+    /// @param filter Selects the subtrees to decode
+    /// @exception std::invalid_argument The cubes above the subtree depth do not match the stream
+    void load_subtrees(const ByteStream &stream, const std::shared_ptr<octree::Cube> &root,
+                       const SubtreeFilter &filter);
+
     /// Serialization of an octree.
     [[nodiscard]] ByteStream serialize(std::shared_ptr<const octree::Cube> cube, std::uint32_t version) final;
+
+    /// @brief Serialization of an octree directly into a file.
+    /// The octree is streamed through a buffer of fixed size, and compressed blocks are compressed chunk by chunk, so
+    /// the memory does not grow with the size of the octree.
+    /// @param cube The octree
+    /// @param version The version of the format
+    /// @param path The path of the file, which is created or replaced once the octree has been written
+    /// @param options The file write options
+    /// @exception std::runtime_error The file can't be written
+    /// @return The size of the file in bytes
+    std::size_t serialize(const std::shared_ptr<const octree::Cube> &cube, std::uint32_t version,
+                          const std::filesystem::path &path, const FileWriteOptions &options);
+
+    /// Convert a serialized octree into another version.
+    [[nodiscard]] ByteStream convert(const ByteStream &stream, std::uint32_t version);
 };
 } // namespace inexor::vulkan_renderer::serialization
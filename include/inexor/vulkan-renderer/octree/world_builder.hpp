@@ -0,0 +1,84 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Forward declaration
+namespace inexor::vulkan_renderer::octree {
+class Cube;
+} // namespace inexor::vulkan_renderer::octree
+
+namespace inexor::vulkan_renderer::octree {
+
+/// A signed distance function which is negative inside of the geometry and positive outside of it.
+/// @note The builder relies on the distance bound |f(a) - f(b)| <= |a - b| to skip cells which are not crossed by the
+/// surface, so the function must never overestimate the distance to the surface. It is called from several threads.
+using SignedDistanceFunction = std::function<float(const glm::vec3 &)>;
+
+/// A 2D heightmap which is stretched over the x/y extent of an octree. The z axis points upwards.
+class Heightmap {
+private:
+    std::uint32_t m_width;
+    std::uint32_t m_height;
+    /// The heights in row-major order (x changes fastest).
+    std::vector<float> m_heights;
+
+    [[nodiscard]] float at(std::uint32_t x, std::uint32_t y) const {
+        return m_heights[static_cast<std::size_t>(y) * m_width + x];
+    }
+
+public:
+    /// Default constructor
+    /// @param width The number of samples in x direction (at least 2)
+    /// @param height The number of samples in y direction (at least 2)
+    /// @param heights The heights in row-major order, measured from the minimum z of the octree
+    Heightmap(std::uint32_t width, std::uint32_t height, std::vector<float> heights);
+
+    [[nodiscard]] std::uint32_t height() const noexcept {
+        return m_height;
+    }
+
+    /// Conservative minimum and maximum height inside of a rectangle in normalized coordinates.
+    /// @param u0 The lower x coordinate in [0, 1]
+    /// @param v0 The lower y coordinate in [0, 1]
+    /// @param u1 The upper x coordinate in [0, 1]
+    /// @param v1 The upper y coordinate in [0, 1]
+    [[nodiscard]] std::pair<float, float> range(float u0, float v0, float u1, float v1) const;
+
+    /// Bilinear filtered height at normalized coordinates in [0, 1].
+    [[nodiscard]] float sample(float u, float v) const;
+
+    [[nodiscard]] std::uint32_t width() const noexcept {
+        return m_width;
+    }
+};
+
+/// @brief Build an octree from a heightmap.
+/// Only cells which are crossed by the terrain surface are subdivided. Cells at the maximum depth which are crossed by
+/// the surface become Type::NORMAL cubes, whose vertical edges are indented to approximate the surface. The eight
+/// top-level octants are built in parallel and the octree is simplified once at the end.
+/// @param heightmap The heightmap, which covers the x/y extent of the root cube
+/// @param max_depth The maximum of nested octants
+/// @param size The size of the root cube
+/// @param position The position where the root cube is placed
+std::shared_ptr<Cube> create_world_from_heightmap(const Heightmap &heightmap, std::uint32_t max_depth, float size,
+                                                  const glm::vec3 &position);
+
+/// @brief Build an octree from a signed distance function.
+/// Only cells which are crossed by the surface are subdivided. Cells at the maximum depth which are crossed by the
+/// surface become Type::NORMAL cubes, whose edges along the dominant axis of the surface normal are indented to the
+/// zero crossing of the signed distance. The eight top-level octants are built in parallel and the octree is simplified
+/// once at the end.
+/// @param sdf The signed distance function
+/// @param max_depth The maximum of nested octants
+/// @param size The size of the root cube
+/// @param position The position where the root cube is placed
+std::shared_ptr<Cube> create_world_from_sdf(const SignedDistanceFunction &sdf, std::uint32_t max_depth, float size,
+                                            const glm::vec3 &position);
+
+} // namespace inexor::vulkan_renderer::octree
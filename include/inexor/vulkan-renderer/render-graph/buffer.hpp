@@ -29,7 +29,8 @@ class VulkanException;
 
 namespace inexor::vulkan_renderer::render_graph {
 
-// Forward declaration
+// Forward declarations
+class DeferredReleases;
 class RenderGraph;
 class StagingBuffer;
 
@@ -45,7 +46,10 @@ enum class BufferType {
     VERTEX_BUFFER,
     INDEX_BUFFER,
     UNIFORM_BUFFER,
-    // @TODO: Support more buffer types (storage buffer, indirect buffer...)
+    STORAGE_BUFFER,
+    /// Draw commands for indirect draw calls (e.g. VkDrawIndexedIndirectCommand). Indirect buffers can also be bound as
+    /// storage buffers, so a compute shader can write the draw commands.
+    INDIRECT_BUFFER,
 };
 
 enum class BufferUpdateMode {
@@ -80,14 +84,15 @@ private:
     std::string m_name;
 
     /// The buffer type will be set depending on which constructor of the Buffer wrapper is called by rendergraph. The
-    /// engine currently supports three different types of buffers in the Buffer wrapper class: vertex buffers, index
-    /// buffers, and uniform buffers. The instances of the Buffer wrapper class are managed by rendergraph only. One
-    /// solution to deal with the different buffer types would be to use a BufferBase class and to make three distinct
-    /// classes VertexBuffer, IndexBuffer, and UniformBuffer. However, we aimed for simplicity and wanted to avoid
-    /// polymorphism in the rendergraph for performance reasons. We also refrained from using templates for this use
-    /// case. Therefore, we have chosen to use only one Buffer wrapper class which contains members for all three
-    /// different buffer types. The type of the buffer will be set depending on which Buffer constructor is called by
-    /// rendergraph. The actual memory management for the buffers is done by Vulkan Memory Allocator (VMA) internally.
+    /// engine currently supports five different types of buffers in the Buffer wrapper class: vertex buffers, index
+    /// buffers, uniform buffers, storage buffers, and indirect buffers. The instances of the Buffer wrapper class are
+    /// managed by rendergraph only. One solution to deal with the different buffer types would be to use a BufferBase
+    /// class and to make a distinct class for every buffer type, such as VertexBuffer, IndexBuffer, or UniformBuffer.
+    /// However, we aimed for simplicity and wanted to avoid polymorphism in the rendergraph for performance reasons. We
+    /// also refrained from using templates for this use case. Therefore, we have chosen to use only one Buffer wrapper
+    /// class which contains members for all the different buffer types. The type of the buffer will be set depending on
+    /// which Buffer constructor is called by rendergraph. The actual memory management for the buffers is done by
+    /// Vulkan Memory Allocator (VMA) internally.
     BufferType m_buffer_type;
 
     BufferUpdateMode m_update_mode{BufferUpdateMode::DEVICE_LOCAL};
@@ -121,7 +126,7 @@ private:
     /// @param upload_offset Current write offset inside the shared upload arena buffer
     /// @param pending_releases Deferred resource releases that must happen after GPU completion
     void create(std::vector<PendingBufferCopy> &pending_buffer_copies, StagingBuffer &staging_buffer,
-                std::size_t &upload_offset, std::vector<std::function<void()>> &pending_releases);
+                std::size_t &upload_offset, DeferredReleases &pending_releases);
 
     [[nodiscard]] bool can_update_without_command_buffer() const;
 
@@ -130,8 +135,7 @@ private:
     void create_per_frame_buffer_resources(PerFrameBufferResources &resources,
                                            std::vector<PendingBufferCopy> &pending_buffer_copies,
                                            StagingBuffer &staging_buffer, std::size_t &upload_offset,
-                                           std::vector<std::function<void()>> &pending_releases,
-                                           std::size_t slot_index);
+                                           DeferredReleases &pending_releases, std::size_t slot_index);
 
     void destroy_per_frame_buffer_resources(PerFrameBufferResources &resources);
 
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <volk.h>
+
+#include "inexor/vulkan-renderer/wrapper/core/device.hpp"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace inexor::vulkan_renderer::wrapper::commands {
+// Forward declaration
+class CommandBufferBuilder;
+} // namespace inexor::vulkan_renderer::wrapper::commands
+
+namespace inexor::vulkan_renderer::render_graph {
+// Forward declarations
+class Buffer;
+class Texture;
+} // namespace inexor::vulkan_renderer::render_graph
+
+namespace inexor::vulkan_renderer::render_graph {
+
+// Forward declaration
+class RenderGraph;
+
+// Using declarations
+using wrapper::commands::CommandBufferBuilder;
+using wrapper::core::DebugLabelColor;
+
+/// A wrapper for compute passes inside of rendergraph
+/// @note Compute passes are recorded into the primary command buffer between the graphics passes, outside of dynamic
+/// rendering. Rendergraph orders them by their resources just like graphics passes, and records the barriers between
+/// them and the graphics passes which produce or consume their resources. If the device has a compute queue which is
+/// separate from the graphics queue, compute passes which don't depend on any graphics pass are recorded on it instead.
+class ComputePass {
+private:
+    friend class RenderGraph;
+
+    /// The name of the compute pass
+    std::string m_name;
+    /// The command buffer recording function of the compute pass
+    std::function<void(CommandBufferBuilder &)> m_on_record_cmd_buffer{[](auto &) {}};
+    /// The color of the debug label region (visible in graphics debuggers like RenderDoc)
+    std::array<float, 4> m_debug_label_color;
+
+    /// The buffers which are read by this compute pass
+    std::vector<std::weak_ptr<Buffer>> m_buffer_reads;
+    /// The buffers which are written to by this compute pass
+    std::vector<std::weak_ptr<Buffer>> m_buffer_writes;
+    /// The textures which are read by this compute pass (sampled, or loaded if they are storage images)
+    std::vector<std::weak_ptr<Texture>> m_texture_reads;
+    /// The storage images which are written to by this compute pass
+    std::vector<std::weak_ptr<Texture>> m_texture_writes;
+
+public:
+    /// Default constructor
+    /// @param name The name of the compute pass
+    /// @param on_record_cmd_buffer The command buffer recording function of the compute pass
+    /// @param buffer_reads The buffers which are read by this compute pass
+    /// @param buffer_writes The buffers which are written to by this compute pass
+    /// @param texture_reads The textures which are read by this compute pass
+    /// @param texture_writes The storage images which are written to by this compute pass
+    /// @param pass_debug_label_color The debug label of the pass (visible in graphics debuggers like RenderDoc)
+    ComputePass(std::string name, std::function<void(CommandBufferBuilder &)> on_record_cmd_buffer,
+                std::vector<std::weak_ptr<Buffer>> buffer_reads, std::vector<std::weak_ptr<Buffer>> buffer_writes,
+                std::vector<std::weak_ptr<Texture>> texture_reads, std::vector<std::weak_ptr<Texture>> texture_writes,
+                DebugLabelColor pass_debug_label_color);
+
+    ComputePass(const ComputePass &) = delete;
+    ComputePass(ComputePass &&other) noexcept;
+    ~ComputePass() = default;
+
+    ComputePass &operator=(const ComputePass &) = delete;
+    ComputePass &operator=(ComputePass &&) = delete;
+};
+
+} // namespace inexor::vulkan_renderer::render_graph
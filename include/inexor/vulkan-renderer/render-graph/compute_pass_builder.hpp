@@ -0,0 +1,87 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/wrapper/core/device.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace inexor::vulkan_renderer::wrapper::commands {
+// Forward declaration
+class CommandBufferBuilder;
+} // namespace inexor::vulkan_renderer::wrapper::commands
+
+namespace inexor::vulkan_renderer::render_graph {
+// Forward declarations
+class Buffer;
+class ComputePass;
+class Texture;
+} // namespace inexor::vulkan_renderer::render_graph
+
+namespace inexor::vulkan_renderer::render_graph {
+
+// Using declarations
+using wrapper::commands::CommandBufferBuilder;
+using wrapper::core::DebugLabelColor;
+
+/// A builder class for compute passes in the rendergraph
+class ComputePassBuilder {
+private:
+    /// The command buffer recording function
+    std::function<void(CommandBufferBuilder &)> m_on_record_cmd_buffer;
+    /// The buffers which are read by this compute pass
+    std::vector<std::weak_ptr<Buffer>> m_buffer_reads;
+    /// The buffers which are written to by this compute pass
+    std::vector<std::weak_ptr<Buffer>> m_buffer_writes;
+    /// The textures which are read by this compute pass
+    std::vector<std::weak_ptr<Texture>> m_texture_reads;
+    /// The storage images which are written to by this compute pass
+    std::vector<std::weak_ptr<Texture>> m_texture_writes;
+
+    /// Reset the data of the compute pass builder
+    void reset();
+
+public:
+    ComputePassBuilder();
+
+    ComputePassBuilder(const ComputePassBuilder &) = delete;
+    ComputePassBuilder(ComputePassBuilder &&) noexcept;
+
+    /// Build the compute pass
+    /// @param name The name of the compute pass
+    /// @param color The debug label color (debug labels are specified per pass and are visible in RenderDoc debugger)
+    /// @return The compute pass that was just created
+    [[nodiscard]] std::shared_ptr<ComputePass> build(std::string name, DebugLabelColor color);
+
+    /// Specify that this compute pass reads from a buffer
+    /// @param buffer The buffer which is read by this compute pass (indirect buffers may also hold the arguments of
+    /// indirect dispatches)
+    /// @return A const reference to the this pointer (allowing method calls to be chained)
+    [[nodiscard]] ComputePassBuilder &reads_from(std::weak_ptr<Buffer> buffer);
+
+    /// Specify that this compute pass reads from a texture
+    /// @param texture The texture which is sampled, or loaded from if it is a storage image
+    /// @note Passes which write to the texture will be ordered before this compute pass
+    /// @return A const reference to the this pointer (allowing method calls to be chained)
+    [[nodiscard]] ComputePassBuilder &reads_from(std::weak_ptr<Texture> texture);
+
+    /// Set the function which will be called when the command buffer of the pass is being recorded
+    /// @param on_record_cmd_buffer The command buffer recording function
+    /// @return A const reference to the this pointer (allowing method calls to be chained)
+    [[nodiscard]] ComputePassBuilder &set_on_record(std::function<void(CommandBufferBuilder &)> on_record_cmd_buffer);
+
+    /// Specify that this compute pass writes to a buffer
+    /// @param buffer The buffer that is written to
+    /// @note Passes which read from the buffer will be ordered after this compute pass
+    /// @return A const reference to the this pointer (allowing method calls to be chained)
+    [[nodiscard]] ComputePassBuilder &writes_to(std::weak_ptr<Buffer> buffer);
+
+    /// Specify that this compute pass writes to a storage image
+    /// @param texture The texture that is written to, which must have been added with TextureUsage::STORAGE_IMAGE
+    /// @note Passes which read from the texture will be ordered after this compute pass
+    /// @return A const reference to the this pointer (allowing method calls to be chained)
+    [[nodiscard]] ComputePassBuilder &writes_to(std::weak_ptr<Texture> texture);
+};
+
+} // namespace inexor::vulkan_renderer::render_graph
@@ -1,10 +1,10 @@
 #pragma once
 
-#include <volk.h>
+#include <vk_mem_alloc.h>
 
 #include <cstddef>
-#include <functional>
-#include <span>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace inexor::vulkan_renderer::wrapper::core {
@@ -12,44 +12,118 @@ namespace inexor::vulkan_renderer::wrapper::core {
 class Device;
 } // namespace inexor::vulkan_renderer::wrapper::core
 
+namespace inexor::vulkan_renderer::wrapper::images {
+// Forward declaration
+class Image;
+} // namespace inexor::vulkan_renderer::wrapper::images
+
+namespace inexor::vulkan_renderer::wrapper::synchronization {
+// Forward declaration
+class TimelineSemaphore;
+} // namespace inexor::vulkan_renderer::wrapper::synchronization
+
 namespace inexor::vulkan_renderer::render_graph {
 
-// Using declaration
+// Using declarations
 using wrapper::core::Device;
+using wrapper::images::Image;
+
+/// The resources which are released once a frame is finished. The records are plain handles in vectors which keep their
+/// capacity, so deferring a release doesn't allocate memory once the vectors have grown to the usual size.
+class DeferredReleases {
+private:
+    friend class FrameSyncManager;
+
+    struct BufferRelease {
+        VkBuffer buffer{VK_NULL_HANDLE};
+        VmaAllocation allocation{VK_NULL_HANDLE};
+    };
+
+    /// The value of the frame after which the resources are released
+    std::uint64_t m_frame_value{0};
+    std::vector<BufferRelease> m_buffers;
+    std::vector<VmaAllocation> m_allocations;
+    std::vector<std::shared_ptr<Image>> m_images;
+
+    [[nodiscard]] bool empty() const {
+        return m_buffers.empty() && m_allocations.empty() && m_images.empty();
+    }
+
+    /// Release all resources, keeping the capacity of the vectors
+    /// @param allocator The allocator of the buffers and memory blocks
+    void release(VmaAllocator allocator);
 
+public:
+    /// Call vmaDestroyBuffer once the frame is finished
+    /// @param buffer The buffer
+    /// @param allocation The allocation of the buffer
+    void destroy_buffer(VkBuffer buffer, VmaAllocation allocation);
+
+    /// Call vmaFreeMemory once the frame is finished
+    /// @param allocation The memory block
+    void free_memory(VmaAllocation allocation);
+
+    /// Keep an image alive until the frame is finished
+    /// @param image The image
+    void destroy_image(std::shared_ptr<Image> image);
+};
+
+/// Tracks the completion of frames with a timeline semaphore, which the last submission of every frame signals to the
+/// next value. Resources which the GPU may still use are released once the frame which used them last is finished.
 class FrameSyncManager {
 private:
     const Device &m_device;
-    std::vector<VkFence> m_frame_slot_submission_fences{VK_NULL_HANDLE};
+    /// Signaled by the last submission of every frame on the graphics queue, which waits for all other submissions of
+    /// the frame (on the transfer queue and on the async compute queue as well)
+    std::unique_ptr<wrapper::synchronization::TimelineSemaphore> m_frame_timeline;
+    /// The value which the last submitted frame signals
+    std::uint64_t m_submitted_frame_value{0};
     std::size_t m_frame_slot_count{1};
     std::size_t m_current_frame_slot{0};
 
-    struct DeferredRelease {
-        std::vector<VkFence> fences;
-        std::function<void()> release;
-    };
+    /// The releases of the frames which are not finished, as a ring ordered by the frame values. The entries of
+    /// finished frames stay in the ring, so their vectors are reused by the next frames.
+    std::vector<DeferredReleases> m_frame_releases;
+    std::size_t m_oldest_frame_releases{0};
+    std::size_t m_frame_releases_count{0};
 
-    std::vector<DeferredRelease> m_deferred_releases;
+    /// Release the resources of the oldest frame in the ring and remove it from the ring
+    void release_oldest_frame();
 
 public:
     explicit FrameSyncManager(const Device &device);
 
+    FrameSyncManager(const FrameSyncManager &) = delete;
+    FrameSyncManager(FrameSyncManager &&) = delete;
+
+    ~FrameSyncManager();
+
+    FrameSyncManager &operator=(const FrameSyncManager &) = delete;
+    FrameSyncManager &operator=(FrameSyncManager &&) = delete;
+
     void set_frame_context(std::size_t frame_slot_count, std::size_t current_frame_slot);
 
-    void mark_frame_slot_submission_fence(VkFence fence);
+    /// The timeline semaphore which the last submission of every frame must signal to current_frame_value
+    [[nodiscard]] VkSemaphore frame_timeline_semaphore() const;
+
+    /// The value which the last submission of the current frame signals
+    [[nodiscard]] std::uint64_t current_frame_value() const {
+        return m_submitted_frame_value + 1;
+    }
 
-    void defer_release(std::span<const VkFence> fences, std::function<void()> release);
+    /// Mark the current frame as submitted, so the next frame signals the next value.
+    void mark_frame_submitted();
 
-    void defer_release(VkFence fence, std::function<void()> release);
+    /// Get the resources which are released once the current frame is finished, which implies that all frames before
+    /// it are finished
+    [[nodiscard]] DeferredReleases &current_frame_releases();
 
+    /// Release the resources of the finished frames, which takes a single query of the timeline semaphore.
+    /// @param wait_all Whether to wait for all submitted frames first, so all resources are released
     void process_deferred_releases(bool wait_all);
 
     void clear();
 
-    [[nodiscard]] const std::vector<VkFence> &frame_slot_submission_fences() const {
-        return m_frame_slot_submission_fences;
-    }
-
     [[nodiscard]] std::size_t frame_slot_count() const {
         return m_frame_slot_count;
     }
@@ -59,4 +133,4 @@ public:
     }
 };
 
-} // namespace inexor::vulkan_renderer::render_graph
\ No newline at end of file
+} // namespace inexor::vulkan_renderer::render_graph
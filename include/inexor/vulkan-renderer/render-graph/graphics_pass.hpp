@@ -64,10 +64,16 @@ private:
 
     /// The buffers which are read by this graphics pass
     std::vector<std::weak_ptr<Buffer>> m_buffer_reads;
+    /// The buffers which are written to by this graphics pass
+    std::vector<std::weak_ptr<Buffer>> m_buffer_writes;
+    /// The textures which are sampled by this graphics pass, and the shader stages which sample them
+    std::vector<std::pair<std::weak_ptr<Texture>, VkShaderStageFlags>> m_texture_reads;
     /// The texture attachments of this pass (unified means color, depth, stencil attachment or a swapchain)
     std::vector<std::pair<std::weak_ptr<Texture>, std::optional<VkClearValue>>> m_texture_writes;
     /// The swapchains this graphics pass writes to
     std::vector<std::pair<std::weak_ptr<Swapchain>, std::optional<VkClearValue>>> m_swapchain_writes;
+    /// Whether the recorded secondary command buffers of this pass must be recorded again by rendergraph
+    bool m_secondary_cmd_buffers_dirty{false};
 
     // All the data below will be filled and used by rendergraph only
 
@@ -90,6 +96,7 @@ private:
         std::optional<VkClearValue> clear_value{std::nullopt};
         TextureUsage usage{TextureUsage::DEFAULT};
         VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT}; // Track sample count
+        VkAttachmentStoreOp store_op{VK_ATTACHMENT_STORE_OP_STORE}; // Transient attachments are not stored
     };
 
     bool m_rendering_info_dirty{true};
@@ -120,11 +127,14 @@ public:
     /// @param name The name of the graphics pass
     /// @param on_record_cmd_buffer The command buffer recording function of the graphics pass
     /// @param buffer_reads The buffers which are read by this graphics pass
+    /// @param buffer_writes The buffers which are written to by this graphics pass
+    /// @param texture_reads The textures which are sampled by this graphics pass
     /// @param texture_writes The textures which are written to by this graphics pass
     /// @param swapchain_writes The swapchains which are written to by this graphics pass
     /// @param pass_debug_label_color The debug label of the pass (visible in graphics debuggers like RenderDoc)
     GraphicsPass(std::string name, std::function<void(CommandBufferBuilder &)> on_record_cmd_buffer,
-                 std::vector<std::weak_ptr<Buffer>> buffer_reads,
+                 std::vector<std::weak_ptr<Buffer>> buffer_reads, std::vector<std::weak_ptr<Buffer>> buffer_writes,
+                 std::vector<std::pair<std::weak_ptr<Texture>, VkShaderStageFlags>> texture_reads,
                  std::vector<std::pair<std::weak_ptr<Texture>, std::optional<VkClearValue>>> texture_writes,
                  std::vector<std::pair<std::weak_ptr<Swapchain>, std::optional<VkClearValue>>> swapchain_writes,
                  DebugLabelColor pass_debug_label_color);
@@ -135,6 +145,13 @@ public:
 
     GraphicsPass &operator=(const GraphicsPass &) = delete;
     GraphicsPass &operator=(GraphicsPass &&) = delete;
+
+    /// Make rendergraph record the command buffers of this pass again before they are executed the next time. This
+    /// must be called when the command buffer recording function would record different commands than before.
+    /// @note This must be called on the render thread, for example in the update function of a buffer.
+    void mark_secondary_cmd_buffers_dirty() {
+        m_secondary_cmd_buffers_dirty = true;
+    }
 };
 
 } // namespace inexor::vulkan_renderer::render_graph
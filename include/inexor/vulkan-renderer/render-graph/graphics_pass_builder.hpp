@@ -45,6 +45,8 @@ private:
     std::vector<std::weak_ptr<Buffer>> m_buffer_reads;
     /// The buffers which are written to by this graphics pass
     std::vector<std::weak_ptr<Buffer>> m_buffer_writes;
+    /// The textures which are sampled by this graphics pass
+    std::vector<std::pair<std::weak_ptr<Texture>, VkShaderStageFlags>> m_texture_reads;
 
     /// Reset the data of the graphics pass builder
     void reset();
@@ -66,6 +68,15 @@ public:
     /// @return A const reference to the this pointer (allowing method calls to be chained)
     [[nodiscard]] GraphicsPassBuilder &reads_from(std::weak_ptr<Buffer> buffer);
 
+    /// Specify that this graphics pass samples a texture
+    /// @param texture The texture which is sampled by this graphics pass
+    /// @param stage The shader stages which sample the texture
+    /// @note The texture is transitioned into VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL before this graphics pass, and
+    /// graphics passes which write to the texture will be ordered before this graphics pass
+    /// @return A const reference to the this pointer (allowing method calls to be chained)
+    [[nodiscard]] GraphicsPassBuilder &reads_from(std::weak_ptr<Texture> texture,
+                                                  VkShaderStageFlags stage = VK_SHADER_STAGE_FRAGMENT_BIT);
+
     /// Set the function which will be called when the command buffer for rendering of the pass is being recorded
     /// @param on_record_cmd_buffer The command buffer recording function
     /// @return A const reference to the this pointer (allowing method calls to be chained)
@@ -73,7 +84,7 @@ public:
 
     /// Specify that this graphics pass writes to a buffer
     /// @brief buffer The buffer that is written to
-    /// @note This feature might be used in the future if a pass writes to a buffer
+    /// @note Graphics passes which read from the buffer will be ordered after this graphics pass
     /// @return A const reference to the this pointer (allowing method calls to be chained)
     [[nodiscard]] GraphicsPassBuilder &writes_to(std::weak_ptr<Buffer> buffer);
 
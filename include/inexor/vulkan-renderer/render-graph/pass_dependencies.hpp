@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace inexor::vulkan_renderer::render_graph {
+
+/// The indices of the passes which write to and read from a resource, in the order in which the passes were added
+struct ResourceAccesses {
+    std::vector<std::size_t> writers;
+    std::vector<std::size_t> readers;
+};
+
+/// Get the dependencies between passes from the resources they access, so the passes see the resources as if they were
+/// executed in the order in which they were added. Passes which write to the same resource depend on each other in
+/// this order, a pass which reads from a resource depends on the last pass added before it which writes to it, and a
+/// pass which writes to a resource depends on the passes which read from it since the previous write. A pass which
+/// reads from and writes to a resource reads before it writes.
+/// @param pass_count The number of passes
+/// @param resources The passes which access each resource
+/// @return The sorted indices of the passes which each pass depends on
+[[nodiscard]] std::vector<std::vector<std::size_t>> get_pass_dependencies(std::size_t pass_count,
+                                                                          std::span<const ResourceAccesses> resources);
+
+/// Sort passes topologically, so every pass comes after the passes it depends on.
+/// A barrier is needed in front of a pass which depends on a pass sorted after the last barrier. The passes which don't
+/// need a new barrier are picked first, so passes which depend on the same producers share one barrier. Among these,
+/// the pass whose producers were sorted most recently is picked, so results are consumed soon after they are produced.
+/// The remaining ties are broken by the index of the pass, so independent passes keep their order.
+/// @param dependencies The indices of the passes which each pass depends on
+/// @return The indices of the passes in sorted order, which are fewer than the passes if some of them depend on each
+/// other in a cycle
+[[nodiscard]] std::vector<std::size_t> sort_topologically(const std::vector<std::vector<std::size_t>> &dependencies);
+
+/// Find a cycle among the passes which could not be sorted topologically.
+/// @param dependencies The indices of the passes which each pass depends on
+/// @param sorted Whether each pass has been sorted
+/// @return The indices of the passes which form the cycle, with every pass depending on the one before it
+[[nodiscard]] std::vector<std::size_t> find_cycle(const std::vector<std::vector<std::size_t>> &dependencies,
+                                                  const std::vector<bool> &sorted);
+
+/// Check that the passes can be sorted topologically.
+/// @param dependencies The indices of the passes which each pass depends on
+/// @param pass_names The name of every pass, which are used to describe a cycle
+/// @exception InexorException The passes depend on each other in a cycle
+void check_for_cycles(const std::vector<std::vector<std::size_t>> &dependencies,
+                      std::span<const std::string> pass_names);
+
+/// Find the passes whose results are used: the root passes, which write to a swapchain or an exported resource, and
+/// all passes they depend on directly or indirectly. The other passes can be culled.
+/// @param dependencies The indices of the passes which each pass depends on
+/// @param roots Whether each pass is a root pass
+/// @return Whether each pass is used
+[[nodiscard]] std::vector<bool> find_used_passes(const std::vector<std::vector<std::size_t>> &dependencies,
+                                                 const std::vector<bool> &roots);
+
+} // namespace inexor::vulkan_renderer::render_graph
@@ -1,19 +1,25 @@
 #pragma once
 
 #include "inexor/vulkan-renderer/render-graph/buffer_copy_batch_builder.hpp"
+#include "inexor/vulkan-renderer/render-graph/compute_pass_builder.hpp"
 #include "inexor/vulkan-renderer/render-graph/frame_sync_manager.hpp"
 #include "inexor/vulkan-renderer/render-graph/graphics_pass_builder.hpp"
 #include "inexor/vulkan-renderer/render-graph/resource_descriptor_manager.hpp"
+#include "inexor/vulkan-renderer/render-graph/resource_state_tracker.hpp"
 #include "inexor/vulkan-renderer/render-graph/staging_buffer.hpp"
 #include "inexor/vulkan-renderer/render-graph/swapchain_manager.hpp"
 #include "inexor/vulkan-renderer/render-graph/texture_copy_batch_builder.hpp"
+#include "inexor/vulkan-renderer/render-graph/transient_attachment_allocator.hpp"
 #include "inexor/vulkan-renderer/wrapper/commands/command_buffer_builder.hpp"
 #include "inexor/vulkan-renderer/wrapper/commands/command_buffer_cache.hpp"
+#include "inexor/vulkan-renderer/wrapper/pipelines/compute_pipeline_builder.hpp"
 #include "inexor/vulkan-renderer/wrapper/pipelines/graphics_pipeline_builder.hpp"
 #include "inexor/vulkan-renderer/wrapper/pipelines/pipeline_cache.hpp"
 #include "inexor/vulkan-renderer/wrapper/synchronization/pipeline_barrier_batch_builder.hpp"
 
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <limits>
 #include <memory>
 #include <optional>
@@ -21,21 +27,30 @@
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
+#include <variant>
 #include <vector>
 
+namespace inexor::vulkan_renderer::tools {
+// Forward declaration
+class ThreadPool;
+} // namespace inexor::vulkan_renderer::tools
+
 namespace inexor::vulkan_renderer::wrapper::core {
 // Forward declaration
 class Device;
 } // namespace inexor::vulkan_renderer::wrapper::core
 
 namespace inexor::vulkan_renderer::wrapper::synchronization {
-// Forward declaration
+// Forward declarations
 class Semaphore;
+class TimelineSemaphore;
 } // namespace inexor::vulkan_renderer::wrapper::synchronization
 
 namespace inexor::vulkan_renderer::render_graph {
 // Forward declarations
 class Buffer;
+class ComputePass;
 class GraphicsPass;
 class Texture;
 } // namespace inexor::vulkan_renderer::render_graph
@@ -47,6 +62,7 @@ using wrapper::commands::CommandBufferCache;
 using wrapper::core::DebugLabelColor;
 using wrapper::core::Device;
 using wrapper::descriptors::PerFrameDescriptorSets;
+using wrapper::pipelines::ComputePipelineBuilder;
 using wrapper::pipelines::GraphicsPipelineBuilder;
 using wrapper::pipelines::PipelineCache;
 using wrapper::synchronization::PipelineBarrierBuilder;
@@ -75,6 +91,35 @@ private:
     /// The resource descriptor manager of the rendergraph
     ResourceDescriptorManager m_resource_descriptors;
 
+    /// The buffers and textures which were exported, so the passes which write to them are never culled
+    std::unordered_set<const void *> m_exported_resources;
+    /// The buffers and textures which are bound by automatic resource descriptors, so they are never culled
+    std::unordered_set<const void *> m_descriptor_resources;
+    /// The buffers and textures which are only used by culled passes, so they are neither updated nor
+    /// allocated (filled by cull_unused_passes)
+    std::unordered_set<const void *> m_culled_resources;
+
+    /// A texture whose contents are only used by a range of the sorted passes of a frame
+    struct TransientAttachment {
+        Texture *texture{nullptr};
+        std::size_t first_pass{0};
+        std::size_t last_pass{0};
+    };
+    /// The transient attachments, whose images share memory with the images of other transient attachments which are
+    /// not used at the same time (filled by find_transient_attachments)
+    std::vector<TransientAttachment> m_transient_attachments;
+    /// The memory blocks which the images of the transient attachments alias
+    TransientAttachmentAllocator m_transient_attachment_allocator;
+    /// An image which takes over the memory block of another image in front of a pass
+    struct MemoryHandover {
+        std::size_t pass_index{0};
+        VkImage image{VK_NULL_HANDLE};
+        VkImageSubresourceRange range{};
+        VkImage previous_image{VK_NULL_HANDLE};
+    };
+    /// The memory handovers of a frame, sorted by pass (filled by create_transient_attachments)
+    std::vector<MemoryHandover> m_memory_handovers;
+
     /// --------------------------------------------------------------------------------------------------
     /// GRAPHICS PIPELINES
     /// --------------------------------------------------------------------------------------------------
@@ -87,25 +132,86 @@ private:
     std::vector<OnBuildGraphicsPipeline> m_graphics_pipeline_create_functions;
 
     /// --------------------------------------------------------------------------------------------------
-    /// GRAPHICS PASSES
+    /// COMPUTE PIPELINES
+    /// --------------------------------------------------------------------------------------------------
+
+    /// The compute pipeline builder
+    ComputePipelineBuilder m_compute_pipeline_builder;
+    /// A using declaration for compute pipeline create functions
+    using OnBuildComputePipeline = std::function<void(ComputePipelineBuilder &)>;
+    /// The compute pipeline create functions registered to the rendergraph
+    std::vector<OnBuildComputePipeline> m_compute_pipeline_create_functions;
+
+    /// --------------------------------------------------------------------------------------------------
+    /// GRAPHICS PASSES AND COMPUTE PASSES
     /// --------------------------------------------------------------------------------------------------
 
     /// The graphics pass builder
     GraphicsPassBuilder m_graphics_pass_builder;
     // A using declaration for graphics pass create functions
     using OnBuildGraphicsPass = std::function<std::shared_ptr<GraphicsPass>(GraphicsPassBuilder &)>;
-    /// The graphics passes registered to the rendergraph
+    /// The compute pass builder
+    ComputePassBuilder m_compute_pass_builder;
+    // A using declaration for compute pass create functions
+    using OnBuildComputePass = std::function<std::shared_ptr<ComputePass>(ComputePassBuilder &)>;
+    /// A graphics pass or a compute pass
+    using Pass = std::variant<std::shared_ptr<GraphicsPass>, std::shared_ptr<ComputePass>>;
+    /// The graphics passes and compute passes registered to the rendergraph (sorted by their dependencies after
+    /// compilation)
+    std::vector<Pass> m_passes;
+    /// The graphics passes among the passes, in the order in which they are recorded
     std::vector<std::shared_ptr<GraphicsPass>> m_graphics_passes;
+    /// The indices of the passes which each pass depends on (filled by check_for_cycles)
+    std::vector<std::vector<std::size_t>> m_pass_dependencies;
+    /// The passes which are not recorded because their results are never used (filled by cull_unused_passes)
+    std::vector<Pass> m_culled_passes;
+
+    /// --------------------------------------------------------------------------------------------------
+    /// ASYNC COMPUTE
+    /// --------------------------------------------------------------------------------------------------
+
+    /// Whether each sorted pass is a compute pass which is recorded on the async compute queue, or empty if there are
+    /// no such passes (filled by schedule_async_compute_passes)
+    std::vector<bool> m_async_compute_passes;
+    /// The index of the first sorted pass on the graphics queue which accesses a resource of the async compute passes.
+    /// The passes in front of it are submitted separately, so they overlap with the async compute passes.
+    std::size_t m_async_compute_split_index{0};
+    /// The buffers and textures which are accessed by the async compute passes
+    std::vector<Buffer *> m_async_compute_buffers;
+    std::vector<Texture *> m_async_compute_textures;
+    /// Signaled by the graphics queue once the uploads of a frame are finished and the resources of the async compute
+    /// passes have been released to the async compute queue
+    std::unique_ptr<wrapper::synchronization::Semaphore> m_async_compute_resources_released;
+    /// Signaled by the async compute queue once the async compute passes are finished and their resources have been
+    /// released to the graphics queue
+    std::unique_ptr<wrapper::synchronization::Semaphore> m_async_compute_finished;
+    /// The acquire barriers which match the release barriers of the queue family ownership transfers to the async
+    /// compute queue (recorded on the async compute queue)
+    PipelineBarrierBatchBuilder m_pending_async_compute_acquire_barriers;
+    /// The acquire barriers which match the release barriers of the queue family ownership transfers back to the
+    /// graphics queue (recorded on the graphics queue after the async compute passes are finished)
+    PipelineBarrierBatchBuilder m_pending_graphics_acquire_barriers;
+    /// Reused storage for the release barriers of queue family ownership transfers
+    PipelineBarrierBatchBuilder m_scratch_release_barriers;
 
     /// --------------------------------------------------------------------------------------------------
 
     SwapchainManager m_swapchain_manager;
+    /// The layouts and synchronization states of all images and buffers, which the barriers between passes are derived
+    /// from
+    ResourceStateTracker m_resource_state_tracker;
     CommandBufferCache m_command_buffer_cache;
-    std::unique_ptr<wrapper::synchronization::Semaphore> m_upload_finished;
+    /// Records the secondary command buffers of the dirty graphics passes in parallel. It is only created if secondary
+    /// command buffers are used and the CPU has more than one hardware thread.
+    std::unique_ptr<tools::ThreadPool> m_recording_thread_pool;
+    std::vector<const GraphicsPass *> m_scratch_dirty_graphics_passes;
+    std::vector<std::future<void>> m_scratch_recording_futures;
+    /// Signaled by the uploads on the transfer queue, each to the next value of m_upload_timeline_value
+    std::unique_ptr<wrapper::synchronization::TimelineSemaphore> m_upload_finished;
+    std::uint64_t m_upload_timeline_value{0};
     bool m_upload_submission_pending{false};
     VkPipelineStageFlags2 m_upload_wait_stage_mask{VK_PIPELINE_STAGE_2_NONE};
     std::function<void(wrapper::commands::CommandBufferBuilder &)> m_inline_update_commands;
-    std::vector<std::function<void()>> m_inline_update_pending_releases;
 
     /// Queue family ownership transfer barriers to be replayed as "acquire" operations on the graphics queue,
     /// matching the "release" barriers already recorded on the transfer queue submission. Only populated when
@@ -122,12 +228,10 @@ private:
 
     std::vector<PendingBufferCopy> m_scratch_pending_buffer_copies;
     std::vector<PendingTextureCopy> m_scratch_pending_texture_copies;
-    std::vector<std::function<void()>> m_scratch_pending_releases;
     std::vector<VkFormat> m_scratch_color_attachment_formats;
     /// Reused scratch storage for render() to avoid a heap allocation every frame
     std::vector<wrapper::core::QueueSemaphoreWait> m_scratch_render_wait_semaphores;
-
-    void defer_release(std::span<const VkFence> fences, std::function<void()> release);
+    std::vector<VkSemaphoreSubmitInfo> m_scratch_render_signal_semaphores;
 
     void synchronize_frame_context();
 
@@ -136,16 +240,38 @@ private:
 
     /// --------------------------------------------------------------------------------------------------
 
-    /// @TODO Implement!
-    void sort_graphics_passes_by_order();
+    /// Sort the passes topologically, so every pass is recorded after the passes it depends on.
+    /// Passes which can share one barrier are grouped together, and passes which consume the results of the most
+    /// recently recorded passes are preferred, so results are consumed soon after they are produced.
+    /// @note Independent passes keep the order in which they were added.
+    void sort_passes_by_order();
+
+    /// Remove the passes whose results never reach a swapchain or an exported resource from the sorted passes, and
+    /// collect the buffers and textures which are only used by these passes. The culled passes are kept, and they are
+    /// considered again when rendergraph is compiled the next time.
+    void cull_unused_passes();
+
+    /// Find the textures whose contents are only needed during one frame, so their images can share memory with the
+    /// images of other textures which are not used at the same time. These are attachments which are cleared by the
+    /// first graphics pass which uses them, and which are neither exported nor bound by resource descriptors. If the
+    /// device supports lazily allocated memory, multisampled and depth attachments which are only used by one pass
+    /// are not stored at all.
+    void find_transient_attachments();
+
+    /// Create the images of all transient attachments, so that images whose lifetimes don't overlap alias memory
+    /// @param pending_releases The deferred releases, which receive the old images and memory blocks
+    void create_transient_attachments(DeferredReleases &pending_releases);
 
     /// Update textures and buffers
     void update_resources();
 
-    /// Create the graphics pipelines
-    void create_graphics_pipelines();
+    /// Create the graphics pipelines and the compute pipelines
+    void create_pipelines();
 
-    /// Ensure that rendergraph is a directed acyclic graph (DAG)
+    /// Build the dependencies between the passes and ensure that rendergraph is a directed acyclic graph.
+    /// Passes which access the same texture, swapchain, or buffer depend on each other in the order in which they
+    /// were added, unless they only read from it (see get_pass_dependencies).
+    /// @exception InexorException The passes depend on each other in a cycle
     void check_for_cycles();
 
     /// Rebuild the static texture attachment part of VkRenderingInfo for a graphics pass.
@@ -156,6 +282,16 @@ private:
     /// @param pass The graphics pass
     void refresh_graphics_pass_swapchain_rendering_info(GraphicsPass &pass);
 
+    /// Declare the accesses of a graphics pass to its attachments, textures, and buffers to the resource state tracker,
+    /// so the barriers the pass needs can be recorded in front of it.
+    /// @param pass The graphics pass
+    void require_graphics_pass_resources(const GraphicsPass &pass);
+
+    /// Declare the accesses of a compute pass to its textures and buffers to the resource state tracker, so the
+    /// barriers between the compute pass and the passes which produce or consume its resources are recorded.
+    /// @param pass The compute pass
+    void require_compute_pass_resources(const ComputePass &pass);
+
     /// Record the command buffer of a pass. After a lot of discussions about the API design of rendergraph, we came to
     /// the conclusion that it's the full responsibility of the programmer to manually bind pipelines, descriptors sets,
     /// and buffers inside of the on_record function instead of attempting to abstract all of this in rendergraph. This
@@ -169,7 +305,61 @@ private:
     /// inside of the on_record function.
     /// @param cmd_buf The command buffer to record the pass into
     /// @param pass The graphics pass to record the command buffer for
-    void record_command_buffer_for_pass(const wrapper::commands::CommandBuffer &cmd_buf, GraphicsPass &pass);
+    void record_command_buffer_for_pass(const wrapper::commands::CommandBuffer &cmd_buf, const GraphicsPass &pass);
+
+    /// The attachment formats which the secondary command buffer of a graphics pass inherits
+    /// @param pass The graphics pass
+    [[nodiscard]] static VkCommandBufferInheritanceRenderingInfo
+    make_inheritance_rendering_info(const GraphicsPass &pass);
+
+    /// Record the secondary command buffer of a graphics pass. This is called on the threads of the recording thread
+    /// pool, so it must not modify the render graph.
+    /// @param pass The graphics pass
+    void record_secondary_command_buffer_for_pass(const GraphicsPass &pass);
+
+    /// Refresh the rendering infos of the graphics passes for the current frame, and record the secondary command
+    /// buffers of the passes which are dirty. The passes are spread over the recording thread pool and the render
+    /// thread, and the primary command buffer executes the recorded command buffers in the order of the passes.
+    void record_dirty_secondary_command_buffers();
+
+    /// Record a range of the sorted passes, each preceded by the barriers it needs.
+    /// @param cmd_buf The command buffer builder of the primary command buffer
+    /// @param first_pass The index of the first pass
+    /// @param end_pass The index after the last pass
+    /// @param skip_async_compute_passes Whether the async compute passes are skipped, because they are recorded on the
+    /// async compute queue
+    void record_passes(CommandBufferBuilder &cmd_buf, std::size_t first_pass, std::size_t end_pass,
+                       bool skip_async_compute_passes);
+
+    /// Submit the passes of a frame to the graphics queue and to the async compute queue. The uploads of the frame are
+    /// submitted first, followed by the async compute passes and, at the same time, by the graphics passes which don't
+    /// access their resources. The remaining graphics passes wait for the async compute passes.
+    /// @param render_wait_semaphores The semaphores which the passes writing to swapchains must wait for
+    /// @param render_signal_semaphores The semaphores which the last submission of the frame signals
+    /// @return The fence of the last submission, which waits for all other submissions of the frame
+    [[nodiscard]] VkFence
+    render_with_async_compute(std::span<const wrapper::core::QueueSemaphoreWait> render_wait_semaphores,
+                              std::span<const VkSemaphoreSubmitInfo> render_signal_semaphores);
+
+    /// Pick the compute passes which are recorded on the async compute queue. These are the compute passes which don't
+    /// depend on any graphics pass, directly or through other compute passes, so they can run at the beginning of a
+    /// frame. This requires a compute queue which is separate from the graphics queue.
+    void schedule_async_compute_passes();
+
+    /// Hand the buffers and textures of the async compute passes over between the graphics queue and the async compute
+    /// queue (see ResourceStateTracker::transfer_buffer_ownership).
+    /// @param src_queue_family_index The queue family which accessed the resources so far
+    /// @param dst_queue_family_index The queue family which accesses the resources next
+    /// @param acquire_barriers The barrier batch the acquire barriers are added to
+    /// @note The release barriers are added to m_scratch_release_barriers.
+    void transfer_async_compute_resources(std::uint32_t src_queue_family_index, std::uint32_t dst_queue_family_index,
+                                          PipelineBarrierBatchBuilder &acquire_barriers);
+
+    /// Record a compute pass into the primary command buffer, outside of dynamic rendering. Just like for graphics
+    /// passes, binding the compute pipeline and descriptor sets is the responsibility of the on_record function.
+    /// @param cmd_buf The command buffer builder of the primary command buffer
+    /// @param pass The compute pass
+    void record_compute_pass(CommandBufferBuilder &cmd_buf, const ComputePass &pass);
 
 public:
     /// Default constructor
@@ -188,6 +378,19 @@ public:
     [[nodiscard]] std::weak_ptr<Buffer> add_buffer(std::string name, BufferType type, std::function<void()> on_update,
                                                    BufferUpdateMode update_mode = BufferUpdateMode::DEVICE_LOCAL);
 
+    /// Add a compute pass to the rendergraph
+    /// @param on_build_compute_pass Builds the compute pass with the rendergraph's compute pass builder
+    /// @note Compute passes are ordered among the graphics passes by the resources they read and write, and the
+    /// barriers between them are recorded automatically.
+    /// @return A weak pointer to the compute pass which was created
+    [[nodiscard]] std::weak_ptr<ComputePass> add_compute_pass(OnBuildComputePass on_build_compute_pass);
+
+    /// Add a compute pipeline to rendergraph
+    /// @param on_build_compute_pipeline Builds the compute pipeline with the rendergraph's compute pipeline builder
+    /// @note Just like graphics pipelines, compute pipelines are created during compilation once the descriptor set
+    /// layouts are known (see add_graphics_pipeline).
+    void add_compute_pipeline(OnBuildComputePipeline on_build_compute_pipeline);
+
     /// Add a graphics pass to the rendergraph
     /// @param graphics_pass The graphics pass which was created
     /// @note There is no name parameter here because the OnBuildGraphicsPass callback will use GraphicsPassBuilder to
@@ -244,6 +447,10 @@ public:
 
     /// Compile the rendergraph
     /// Ideally, this should only be done once at startup and all changes in the system will be reported to rendergraph.
+    /// @note Passes whose results never reach a swapchain or an exported resource are culled, which means they are
+    /// not recorded, and buffers and textures which are only used by culled passes are not allocated.
+    /// @note Attachments whose contents are only used during a frame share memory with other such attachments which
+    /// are used by other passes, so textures which are accessed outside of rendergraph must be exported.
     void compile();
 
     /// Since we need to pass the rendergraph to every render module anyways,
@@ -252,6 +459,14 @@ public:
         return m_device;
     }
 
+    /// Export a buffer, so the passes which write to it are never culled (for example because it is read back)
+    /// @param buffer The buffer
+    void export_resource(std::weak_ptr<Buffer> buffer);
+
+    /// Export a texture, so the passes which write to it are never culled
+    /// @param texture The texture
+    void export_resource(std::weak_ptr<Texture> texture);
+
     /// Render a frame while dealing automatically with all frames in flight internally
     void render();
 
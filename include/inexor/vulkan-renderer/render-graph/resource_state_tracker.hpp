@@ -0,0 +1,175 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/wrapper/synchronization/pipeline_barrier_batch_builder.hpp"
+
+#include <volk.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace inexor::vulkan_renderer::wrapper::commands {
+// Forward declaration
+class CommandBufferBuilder;
+} // namespace inexor::vulkan_renderer::wrapper::commands
+
+namespace inexor::vulkan_renderer::render_graph {
+
+// Using declarations
+using wrapper::commands::CommandBufferBuilder;
+using wrapper::synchronization::PipelineBarrierBatchBuilder;
+
+/// The way a pass accesses a buffer or an image
+struct ResourceAccess {
+    /// The pipeline stages which access the resource
+    VkPipelineStageFlags2 stage_mask{VK_PIPELINE_STAGE_2_NONE};
+    /// The kind of memory access
+    VkAccessFlags2 access_mask{VK_ACCESS_2_NONE};
+    /// The layout the image must be in (this is ignored for buffers)
+    VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+};
+
+/// @brief Tracks the layout and the synchronization state of every image subresource and buffer used by rendergraph,
+/// and derives the pipeline barriers which are required between the passes from it.
+/// Before a pass is recorded, its accesses are declared with require_image() and require_buffer(), and flush() records
+/// all barriers these accesses need in one vkCmdPipelineBarrier2 call. Hazards which don't change the layout of an
+/// image are merged into a single global memory barrier, so only layout transitions need image memory barriers.
+/// Accesses which are synchronized already, like reading a resource at a stage the last write has been made visible
+/// to, do not produce any barrier.
+class ResourceStateTracker {
+private:
+    struct State {
+        VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+        /// The stages of the last write or layout transition, which later accesses must wait for
+        VkPipelineStageFlags2 write_stages{VK_PIPELINE_STAGE_2_NONE};
+        /// The memory accesses of the last write, which must be made available before later accesses
+        VkAccessFlags2 write_access{VK_ACCESS_2_NONE};
+        /// The stages which read since the last write, which the next write must wait for
+        VkPipelineStageFlags2 read_stages{VK_PIPELINE_STAGE_2_NONE};
+        /// The stages and memory accesses the last write has been made visible to
+        VkPipelineStageFlags2 visible_stages{VK_PIPELINE_STAGE_2_NONE};
+        VkAccessFlags2 visible_access{VK_ACCESS_2_NONE};
+    };
+
+    struct ImageState {
+        std::uint32_t level_count{0};
+        std::uint32_t layer_count{0};
+        /// The state of every subresource, indexed by mip level * layer count + array layer
+        std::vector<State> subresources;
+    };
+
+    struct PendingImageAccess {
+        VkImage image{VK_NULL_HANDLE};
+        VkImageAspectFlags aspect_mask{0};
+        std::uint32_t mip_level{0};
+        std::uint32_t array_layer{0};
+        ResourceAccess access;
+    };
+
+    struct PendingBufferAccess {
+        VkBuffer buffer{VK_NULL_HANDLE};
+        ResourceAccess access;
+    };
+
+    std::unordered_map<VkImage, ImageState> m_images;
+    std::unordered_map<VkBuffer, State> m_buffers;
+    std::vector<PendingImageAccess> m_pending_image_accesses;
+    std::vector<PendingBufferAccess> m_pending_buffer_accesses;
+    /// Reused storage for the barriers recorded by flush()
+    PipelineBarrierBatchBuilder m_barriers;
+
+    /// Get the state of an image subresource, which is undefined if the subresource has not been used yet.
+    [[nodiscard]] State &image_state(VkImage image, std::uint32_t mip_level, std::uint32_t array_layer);
+
+    /// Set the state of all subresources of an image in a range.
+    void set_image_state(VkImage image, const VkImageSubresourceRange &range, const State &state);
+
+public:
+    /// Declare that the next pass accesses a range of an image.
+    /// All accesses which are declared until the next resolve() or flush() belong to the same pass, so they may not
+    /// require the same subresource in different layouts.
+    /// @param image The image
+    /// @param range The subresources of the image (VK_REMAINING_MIP_LEVELS and VK_REMAINING_ARRAY_LAYERS are not
+    /// supported)
+    /// @param access The way the pass accesses the image
+    void require_image(VkImage image, const VkImageSubresourceRange &range, const ResourceAccess &access);
+
+    /// Declare that the next pass accesses a buffer.
+    /// @param buffer The buffer
+    /// @param access The way the pass accesses the buffer (the layout is ignored)
+    void require_buffer(VkBuffer buffer, const ResourceAccess &access);
+
+    /// Declare that the contents of an image are undefined from now on, for example because the image has just been
+    /// created or acquired from a swapchain. The next access transitions the image from VK_IMAGE_LAYOUT_UNDEFINED.
+    /// @param image The image
+    /// @param range The subresources of the image
+    /// @param stage_mask The stages the next access must wait for, for example the stages which wait for the
+    /// semaphore which signals that a swapchain image has been acquired
+    void discard_image(VkImage image, const VkImageSubresourceRange &range,
+                       VkPipelineStageFlags2 stage_mask = VK_PIPELINE_STAGE_2_NONE);
+
+    /// Declare that an image takes over memory which was used by another image it aliases, which discards its contents.
+    /// The next access transitions the image from VK_IMAGE_LAYOUT_UNDEFINED, after all accesses to the other image.
+    /// @param image The image
+    /// @param range The subresources of the image
+    /// @param previous_image The image which used the memory before
+    void alias_image(VkImage image, const VkImageSubresourceRange &range, VkImage previous_image);
+
+    /// Declare that an image has been transitioned by a barrier which was recorded outside of this tracker, and that
+    /// all writes to it have been made visible to an access (for example the post copy barriers of uploads).
+    /// @param image The image
+    /// @param range The subresources of the image
+    /// @param access The destination scope and the new layout of the barrier
+    void assume_image_state(VkImage image, const VkImageSubresourceRange &range, const ResourceAccess &access);
+
+    /// Declare that all writes to a buffer have been made visible to an access by a barrier which was recorded outside
+    /// of this tracker.
+    /// @param buffer The buffer
+    /// @param access The destination scope of the barrier
+    void assume_buffer_state(VkBuffer buffer, const ResourceAccess &access);
+
+    /// Hand a buffer over to another queue, which waits for a semaphore the current queue signals after all accesses
+    /// which were declared so far. If the queues belong to different queue families, the ownership of the buffer is
+    /// transferred by a release barrier, which must be recorded on the current queue, and an acquire barrier, which
+    /// must be recorded on the other queue before the buffer is accessed there.
+    /// @param buffer The buffer
+    /// @param src_queue_family_index The queue family which accessed the buffer so far
+    /// @param dst_queue_family_index The queue family which accesses the buffer from now on
+    /// @param release_barriers The barrier batch the release barrier is added to
+    /// @param acquire_barriers The barrier batch the acquire barrier is added to
+    void transfer_buffer_ownership(VkBuffer buffer, std::uint32_t src_queue_family_index,
+                                   std::uint32_t dst_queue_family_index, PipelineBarrierBatchBuilder &release_barriers,
+                                   PipelineBarrierBatchBuilder &acquire_barriers);
+
+    /// Hand a range of an image over to another queue (see transfer_buffer_ownership). The layout of the image is kept,
+    /// and the contents of subresources which have not been used yet are not transferred.
+    /// @param image The image
+    /// @param range The subresources of the image
+    /// @param src_queue_family_index The queue family which accessed the image so far
+    /// @param dst_queue_family_index The queue family which accesses the image from now on
+    /// @param release_barriers The barrier batch the release barriers are added to
+    /// @param acquire_barriers The barrier batch the acquire barriers are added to
+    void transfer_image_ownership(VkImage image, const VkImageSubresourceRange &range,
+                                  std::uint32_t src_queue_family_index, std::uint32_t dst_queue_family_index,
+                                  PipelineBarrierBatchBuilder &release_barriers,
+                                  PipelineBarrierBatchBuilder &acquire_barriers);
+
+    /// Stop tracking an image which is destroyed, so its handle can be reused.
+    void forget_image(VkImage image);
+
+    /// Stop tracking a buffer which is destroyed, so its handle can be reused.
+    void forget_buffer(VkBuffer buffer);
+
+    /// Turn the accesses declared since the last call into barriers, and update the tracked states.
+    /// @param barriers The barrier batch the barriers are added to
+    void resolve(PipelineBarrierBatchBuilder &barriers);
+
+    /// Resolve the declared accesses and record the barriers they need, if any.
+    /// @param cmd_buf The command buffer builder
+    void flush(CommandBufferBuilder &cmd_buf);
+
+    /// Forget all resources and declared accesses.
+    void reset();
+};
+
+} // namespace inexor::vulkan_renderer::render_graph
@@ -3,7 +3,6 @@
 #include <vk_mem_alloc.h>
 
 #include <cstddef>
-#include <functional>
 #include <string>
 #include <vector>
 
@@ -20,6 +19,9 @@ class VulkanException;
 
 namespace inexor::vulkan_renderer::render_graph {
 
+// Forward declaration
+class DeferredReleases;
+
 using tools::InexorException;
 using tools::VulkanException;
 using wrapper::core::Device;
@@ -55,7 +57,7 @@ public:
 
     void set_frame_context(std::size_t frame_slot_count, std::size_t current_frame_slot);
 
-    void ensure_capacity(std::size_t required_bytes, std::vector<std::function<void()>> &pending_releases);
+    void ensure_capacity(std::size_t required_bytes, DeferredReleases &pending_releases);
 
     void reset();
 
@@ -12,6 +12,7 @@
 namespace inexor::vulkan_renderer::render_graph {
 
 class GraphicsPass;
+class ResourceStateTracker;
 
 using wrapper::commands::CommandBufferBuilder;
 using wrapper::core::Device;
@@ -36,6 +37,10 @@ private:
     void rebuild_swapchain_cache(const std::vector<std::shared_ptr<GraphicsPass>> &graphics_passes);
 
 public:
+    /// The pipeline stage which waits for the image available semaphores. The layout transitions of the acquired
+    /// images wait for this stage, so the transitions happen after the images have been acquired.
+    static constexpr VkPipelineStageFlags2 IMAGE_AVAILABLE_WAIT_STAGE{VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT};
+
     explicit SwapchainManager(Device &device);
 
     void mark_swapchain_cache_dirty();
@@ -60,9 +65,15 @@ public:
         return m_frame_swapchains;
     }
 
-    void prepare_swapchains_for_rendering(CommandBufferBuilder &cmd_buf) const;
+    /// Declare that the contents of the acquired swapchain images are undefined, so the passes which write to them
+    /// transition them from VK_IMAGE_LAYOUT_UNDEFINED after the image available semaphores have been signaled.
+    /// @param state_tracker The resource state tracker of rendergraph
+    void prepare_swapchains_for_rendering(ResourceStateTracker &state_tracker) const;
 
-    void prepare_swapchains_for_presenting(CommandBufferBuilder &cmd_buf) const;
+    /// Transition the acquired swapchain images into VK_IMAGE_LAYOUT_PRESENT_SRC_KHR after all passes.
+    /// @param state_tracker The resource state tracker of rendergraph
+    /// @param cmd_buf The command buffer builder
+    void prepare_swapchains_for_presenting(ResourceStateTracker &state_tracker, CommandBufferBuilder &cmd_buf) const;
 
     void mark_frame_swapchains_in_flight(VkFence fence) const;
 
@@ -24,11 +24,6 @@ namespace inexor::vulkan_renderer::wrapper::commands {
 class CommandBuffer;
 } // namespace inexor::vulkan_renderer::wrapper::commands
 
-namespace inexor::vulkan_renderer::wrapper::synchronization {
-/// Forward declaration
-class PipelineBarrierBatchBuilder;
-} // namespace inexor::vulkan_renderer::wrapper::synchronization
-
 namespace inexor::vulkan_renderer::tools {
 /// Forward declarations
 class InexorException;
@@ -37,7 +32,8 @@ class VulkanException;
 
 namespace inexor::vulkan_renderer::render_graph {
 
-// Forward declaration
+// Forward declarations
+class DeferredReleases;
 class RenderGraph;
 class StagingBuffer;
 
@@ -47,7 +43,6 @@ using tools::VulkanException;
 using wrapper::core::Device;
 using wrapper::images::Image;
 using wrapper::images::Sampler;
-using wrapper::synchronization::PipelineBarrierBatchBuilder;
 
 /// Specifies the use of the texture
 enum class TextureUsage {
@@ -55,6 +50,8 @@ enum class TextureUsage {
     COLOR_ATTACHMENT,
     DEPTH_ATTACHMENT,
     STENCIL_ATTACHMENT,
+    /// An image which is written to by compute passes, and which can be read by any pass
+    STORAGE_IMAGE,
 };
 
 ///
@@ -92,6 +89,14 @@ private:
 
     std::unique_ptr<Sampler> m_default_sampler;
 
+    /// The memory blocks which the image and the MSAA image alias, if rendergraph found other transient attachments
+    /// which are not used at the same time (VK_NULL_HANDLE means the image gets a dedicated allocation)
+    VmaAllocation m_image_alias_memory{VK_NULL_HANDLE};
+    VmaAllocation m_msaa_image_alias_memory{VK_NULL_HANDLE};
+    /// The contents are not needed after the only pass which renders into the texture, so the image it renders into
+    /// (the MSAA image if there is one) is a transient attachment in lazily allocated memory (set by rendergraph)
+    bool m_lazily_allocated{false};
+
     struct PerFrameTextureResources {
         std::shared_ptr<Image> m_image;
         std::shared_ptr<Image> m_msaa_image;
@@ -120,21 +125,29 @@ private:
 
     void set_frame_context(std::size_t frame_slot_count, std::size_t current_frame_slot);
 
+    /// The create info of the image or of the MSAA image
+    /// @param msaa_image Whether the create info of the MSAA image is returned
+    [[nodiscard]] VkImageCreateInfo image_create_info(bool msaa_image) const;
+
+    /// The aspects of the image which are accessed, depending on the texture usage and format
+    [[nodiscard]] VkImageAspectFlags aspect_mask() const;
+
+    /// The layout in which shaders access the image. Storage images stay in VK_IMAGE_LAYOUT_GENERAL, so passes which
+    /// read them don't need a layout transition after a compute pass wrote to them.
+    [[nodiscard]] VkImageLayout shader_access_layout() const;
+
+    /// The subresource range which covers the entire image
+    [[nodiscard]] VkImageSubresourceRange subresource_range() const;
+
     /// Collect pending upload copy regions and post-copy barriers for this texture.
     /// @param upload_buffer The shared upload arena buffer
     /// @param upload_alloc The shared upload arena allocation
     /// @param upload_offset Current write offset inside the shared upload arena buffer
     /// @param pending_texture_copies Collected copy jobs and image barriers
     void collect_update_copies(StagingBuffer &staging_buffer, std::size_t &upload_offset,
-                               std::vector<std::function<void()>> &pending_releases,
+                               DeferredReleases &pending_releases,
                                std::vector<PendingTextureCopy> &pending_texture_copies);
 
-    /// Record the barriers that prepare the texture image for upload.
-    void prepare_update_barriers(PipelineBarrierBatchBuilder &barrier_builder);
-
-    /// Record initial image-layout barriers for newly created attachment textures.
-    void prepare_initial_layout_barriers(PipelineBarrierBatchBuilder &barrier_builder);
-
 public:
     /// Default constructor
     /// @param device The device wrapper
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vk_mem_alloc.h>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace inexor::vulkan_renderer::wrapper::core {
+// Forward declaration
+class Device;
+} // namespace inexor::vulkan_renderer::wrapper::core
+
+namespace inexor::vulkan_renderer::render_graph {
+
+// Forward declaration
+class DeferredReleases;
+
+// Using declaration
+using wrapper::core::Device;
+
+/// An image of a transient attachment, which is only used by a range of the sorted graphics passes of a frame
+struct TransientImageRequest {
+    /// The index of the first graphics pass which accesses the image
+    std::size_t first_pass{0};
+    /// The index of the last graphics pass which accesses the image
+    std::size_t last_pass{0};
+    /// The memory requirements of the image
+    VkMemoryRequirements requirements{};
+};
+
+/// Assign the images of transient attachments to memory blocks, so images whose lifetimes do not overlap share one
+/// block. The images are placed from the largest to the smallest, each into the first block which is not in use during
+/// its lifetime and which has a compatible memory type, so the size of a block is the size of its first image.
+/// @param requests The images
+/// @return The index of the memory block of every image
+[[nodiscard]] std::vector<std::size_t> assign_memory_blocks(std::span<const TransientImageRequest> requests);
+
+/// Allocates the memory blocks which are aliased by the images of transient attachments
+class TransientAttachmentAllocator {
+private:
+    const Device &m_device;
+    /// The memory blocks (blocks which are used by one image only are not allocated)
+    std::vector<VmaAllocation> m_blocks;
+    /// The index of the memory block of every image
+    std::vector<std::size_t> m_block_indices;
+
+public:
+    /// Default constructor
+    /// @param device The device wrapper
+    explicit TransientAttachmentAllocator(const Device &device);
+
+    TransientAttachmentAllocator(const TransientAttachmentAllocator &) = delete;
+    TransientAttachmentAllocator(TransientAttachmentAllocator &&) noexcept = delete;
+    ~TransientAttachmentAllocator();
+
+    TransientAttachmentAllocator &operator=(const TransientAttachmentAllocator &) = delete;
+    TransientAttachmentAllocator &operator=(TransientAttachmentAllocator &&) = delete;
+
+    /// Allocate the memory blocks for the images of transient attachments. The memory blocks which were allocated
+    /// before are freed once the commands which may still use them have finished.
+    /// @param requests The images
+    /// @param pending_releases The resources which are released once the current frame is finished
+    /// @exception VulkanException vmaAllocateMemory call failed
+    void allocate(std::span<const TransientImageRequest> requests, DeferredReleases &pending_releases);
+
+    /// Get the index of the memory block an image is assigned to
+    /// @param request_index The index of the image in the requests which were passed to allocate()
+    [[nodiscard]] std::size_t block_index(std::size_t request_index) const {
+        return m_block_indices.at(request_index);
+    }
+
+    /// Get the memory block an image aliases
+    /// @param request_index The index of the image in the requests which were passed to allocate()
+    /// @return The memory block, or VK_NULL_HANDLE if the image does not share its block with any other image (in this
+    /// case, the image should get a dedicated allocation)
+    [[nodiscard]] VmaAllocation memory(std::size_t request_index) const {
+        return m_blocks.at(block_index(request_index));
+    }
+
+    /// Free all memory blocks immediately
+    void reset();
+};
+
+} // namespace inexor::vulkan_renderer::render_graph
@@ -0,0 +1,271 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/octree/lod.hpp"
+#include "inexor/vulkan-renderer/render-modules/octree/octree_vertex.hpp"
+#include "inexor/vulkan-renderer/tools/frustum.hpp"
+#include "inexor/vulkan-renderer/tools/meshlet.hpp"
+#include "inexor/vulkan-renderer/tools/occlusion_buffer.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+// Forward declaration
+namespace inexor::vulkan_renderer::octree {
+class Cube;
+} // namespace inexor::vulkan_renderer::octree
+
+namespace inexor::vulkan_renderer::render_modules::octree {
+
+// Forward declaration
+class OctreeMeshCache;
+
+/// A range of the shared index buffer
+struct OctreeMeshRange {
+    std::uint32_t first_index{0};
+    std::uint32_t index_count{0};
+
+    bool operator==(const OctreeMeshRange &) const = default;
+};
+
+/// A range of OctreeMesh::meshlets
+struct OctreeMeshletRange {
+    std::uint32_t first_meshlet{0};
+    std::uint32_t meshlet_count{0};
+
+    bool operator==(const OctreeMeshletRange &) const = default;
+};
+
+/// A chunk is a subtree of an octree which is meshed, selected, and drawn as a unit.
+struct OctreeChunk {
+    /// The bounding box of the chunk's root cube (see octree::Cube::bounding_box)
+    std::array<glm::vec3, 2> bounding_box;
+    /// The index ranges of all levels of detail, starting with the full resolution mesh
+    std::vector<OctreeMeshRange> lods;
+    /// The meshlet ranges of all levels of detail
+    std::vector<OctreeMeshletRange> lod_meshlets;
+
+    bool operator==(const OctreeChunk &) const = default;
+};
+
+/// A node of the culling hierarchy, which mirrors the octants of the octrees down to the chunks.
+struct OctreeCullNode {
+    /// The bounding box of the octant
+    std::array<glm::vec3, 2> bounding_box;
+    /// The chunks below this node are chunks[first_chunk, first_chunk + chunk_count)
+    std::uint32_t first_chunk{0};
+    std::uint32_t chunk_count{0};
+    /// The index of the next node which is not below this node
+    std::uint32_t skip{0};
+
+    bool operator==(const OctreeCullNode &) const = default;
+};
+
+/// The vertices and indices of all chunks of one or several octrees.
+/// All chunks share one vertex buffer and one index buffer, and the indices are absolute into the vertex buffer.
+/// The index ranges are sorted by level of detail first and by chunk second, so the ranges of consecutive chunks at
+/// the same level of detail are adjacent and can be drawn with a single draw call.
+struct OctreeMesh {
+    std::vector<OctreeVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    std::vector<OctreeChunk> chunks;
+    /// The culling hierarchy in pre-order, with one root node per octree and one leaf node per chunk
+    std::vector<OctreeCullNode> cull_nodes;
+    /// The bounding boxes of solid cubes for occlusion culling, where neighbouring boxes with a common face are merged
+    std::vector<std::array<glm::vec3, 2>> occluders;
+    /// The meshlets of all chunks in the same order as the indices, so the triangles of a meshlet are the indices
+    /// [3 * triangle_offset, 3 * (triangle_offset + triangle_count)) (see tools::build_meshlets). The meshlet vertices
+    /// are absolute into the vertex buffer, so the three arrays can be uploaded to storage buffers as they are.
+    std::vector<tools::Meshlet> meshlets;
+    std::vector<std::uint32_t> meshlet_vertices;
+    std::vector<std::uint32_t> meshlet_triangles;
+    /// The average cache miss ratio of the post-transform vertex cache over all levels of detail, weighted by triangle
+    /// count, before and after optimizing the index buffers (see tools::average_cache_miss_ratio)
+    float acmr_before_optimization{0.0f};
+    float acmr_after_optimization{0.0f};
+};
+
+/// Assigns a color to a vertex at the given position.
+/// @note The function is called from several threads at once, because chunks are meshed in parallel.
+using OctreeVertexColorFunction = std::function<glm::vec3(const glm::vec3 &)>;
+
+/// The mesh of one level of detail of a chunk, whose indices are relative to its own vertices.
+struct OctreeChunkMesh {
+    std::vector<OctreeVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    tools::MeshletData meshlets;
+    float acmr_before_optimization{0.0f};
+    float acmr_after_optimization{0.0f};
+};
+
+/// The optimizations which are applied to the mesh of every level of detail of a chunk (see tools/mesh_optimizer.hpp).
+struct OctreeMeshOptimizations {
+    /// Reorder the triangles for the post-transform vertex cache
+    bool vertex_cache{true};
+    /// Reorder the triangle clusters of the vertex cache optimization to reduce overdraw
+    bool overdraw{true};
+    /// Reorder the vertices in the order in which they are used by the indices
+    bool vertex_fetch{true};
+};
+
+/// @brief Splits octrees into chunks and meshes every chunk at several levels of detail.
+/// A chunk is a subtree whose root cube is at the chunk depth, or a leaf cube above it. Level of detail 0 is the full
+/// resolution mesh of the chunk. Every further level collapses the chunk one octant level earlier using
+/// octree::create_lod, until the whole chunk is a single cube. Chunks without geometry are skipped.
+/// Every vertex gets voxel style ambient occlusion, which is baked from the occupancy of the three cells around the
+/// vertex in front of its face (two sides and the diagonal), sampled in the full resolution octree.
+/// The mesher keeps the meshes of all chunks, so that edited chunks can be re-meshed without touching the others.
+/// The index and vertex order of every mesh is optimized for the vertex cache, overdraw, and vertex fetch, and every
+/// mesh is split into meshlets for fine grained culling.
+/// Chunks are meshed in parallel, and chunks which are found in the mesh cache (see set_cache) are not meshed at all.
+class OctreeMesher {
+private:
+    std::uint32_t m_chunk_depth;
+    std::uint32_t m_max_lod_count;
+    OctreeVertexColorFunction m_vertex_color;
+    vulkan_renderer::octree::LodHeuristic m_heuristic;
+    OctreeMeshOptimizations m_optimizations;
+    std::shared_ptr<OctreeMeshCache> m_cache;
+    std::uint64_t m_vertex_color_key{0};
+
+    std::vector<std::shared_ptr<vulkan_renderer::octree::Cube>> m_worlds;
+    std::vector<std::shared_ptr<vulkan_renderer::octree::Cube>> m_chunk_cubes;
+    /// The index of the world in m_worlds which contains the chunk
+    std::vector<std::size_t> m_chunk_worlds;
+    /// The meshes of all levels of detail of every chunk
+    std::vector<std::vector<OctreeChunkMesh>> m_chunk_meshes;
+    std::vector<OctreeCullNode> m_cull_nodes;
+
+    /// Mesh the given chunks in parallel.
+    void mesh_chunks(std::span<const std::uint32_t> chunks);
+
+    /// Combine the chunk meshes into one mesh.
+    [[nodiscard]] OctreeMesh assemble() const;
+
+public:
+    /// @param chunk_depth The depth of the chunks' root cubes in the octrees
+    /// @param max_lod_count The maximum number of levels of detail per chunk (at least 1)
+    /// @param vertex_color The color of the vertices, which is multiplied with the ambient occlusion when drawing
+    /// @param heuristic The heuristic for collapsing subtrees in lower levels of detail
+    /// @exception std::invalid_argument The maximum number of levels of detail is 0 or the color function is empty
+    OctreeMesher(std::uint32_t chunk_depth, std::uint32_t max_lod_count, OctreeVertexColorFunction vertex_color,
+                 vulkan_renderer::octree::LodHeuristic heuristic = vulkan_renderer::octree::LodHeuristic::COVERAGE);
+
+    /// Split the octrees into chunks and mesh all of them.
+    /// @param worlds The octrees to mesh, which are kept alive by the mesher for re-meshing
+    [[nodiscard]] OctreeMesh mesh(std::span<const std::shared_ptr<vulkan_renderer::octree::Cube>> worlds);
+
+    /// @brief Re-mesh chunks after their cubes have been edited, and reuse the meshes of all other chunks.
+    /// The chunk layout must not change, i.e. edits must not add geometry outside of the existing chunks. Because the
+    /// ambient occlusion of a chunk depends on the cubes around it, the chunks next to an edit should be re-meshed as
+    /// well (see find_chunks).
+    /// @param chunks The indices of the chunks to re-mesh
+    /// @exception std::out_of_range A chunk index is invalid
+    [[nodiscard]] OctreeMesh remesh(std::span<const std::uint32_t> chunks);
+
+    /// Set the optimizations for the following calls of mesh and remesh.
+    void set_optimizations(const OctreeMeshOptimizations &optimizations) {
+        m_optimizations = optimizations;
+    }
+
+    /// @brief Look up chunk meshes in a cache before meshing them, and insert the chunks which are meshed.
+    /// A chunk's key is a content hash of the cubes of its octree within one chunk size around it, which covers the
+    /// ambient occlusion, and of the mesher's settings. The vertex color function can't be hashed, so the caller
+    /// must pass a different key whenever it changes.
+    /// @param cache The mesh cache, or nullptr to mesh every chunk
+    /// @param vertex_color_key Identifies the vertex color function
+    void set_cache(std::shared_ptr<OctreeMeshCache> cache, std::uint64_t vertex_color_key = 0) {
+        m_cache = std::move(cache);
+        m_vertex_color_key = vertex_color_key;
+    }
+
+    /// Find the chunks whose bounding box intersects or touches a region, e.g. the bounding box of an edited cube.
+    [[nodiscard]] std::vector<std::uint32_t> find_chunks(const std::array<glm::vec3, 2> &region) const;
+};
+
+/// @brief Split octrees into chunks and mesh every chunk at several levels of detail (see OctreeMesher).
+/// @param worlds The octrees to mesh
+/// @param chunk_depth The depth of the chunks' root cubes in the octrees
+/// @param max_lod_count The maximum number of levels of detail per chunk (at least 1)
+/// @param vertex_color The color of the vertices
+/// @param heuristic The heuristic for collapsing subtrees in lower levels of detail
+[[nodiscard]] OctreeMesh build_octree_mesh(std::span<const std::shared_ptr<vulkan_renderer::octree::Cube>> worlds,
+                                           std::uint32_t chunk_depth, std::uint32_t max_lod_count,
+                                           const OctreeVertexColorFunction &vertex_color,
+                                           vulkan_renderer::octree::LodHeuristic heuristic =
+                                               vulkan_renderer::octree::LodHeuristic::COVERAGE);
+
+/// @brief Collect the chunks which are inside of or intersect the frustum.
+/// The culling hierarchy is walked from the roots: subtrees outside of the frustum are skipped, and the chunks of
+/// subtrees which are completely inside are accepted without testing them one by one.
+/// @param mesh The octree mesh
+/// @param frustum The view frustum
+/// @param visible_chunks The indices of the visible chunks in ascending order (cleared before use, so the caller can
+/// reuse the allocation from frame to frame)
+void cull_chunks(const OctreeMesh &mesh, const tools::Frustum &frustum, std::vector<std::uint32_t> &visible_chunks);
+
+/// @brief Select the occluders which cover the largest part of the view.
+/// Occluders are ranked by their size divided by their distance to the camera. Occluders which contain the camera are
+/// skipped, because they cross the near plane.
+/// @param mesh The octree mesh
+/// @param camera_position The position of the camera
+/// @param max_occluder_count The maximum number of occluders
+/// @param occluders The indices into OctreeMesh::occluders (cleared before use, so the caller can reuse the allocation)
+void select_occluders(const OctreeMesh &mesh, const glm::vec3 &camera_position, std::size_t max_occluder_count,
+                      std::vector<std::uint32_t> &occluders);
+
+/// @brief Remove the chunks which are hidden behind occluders.
+/// The occluders are rasterized into the occlusion buffer, and the chunks are tested against its hierarchical-Z
+/// pyramid. This should run after frustum culling, because chunks outside of the screen are always kept.
+/// @param mesh The octree mesh
+/// @param occluders The indices into OctreeMesh::occluders to rasterize (see select_occluders)
+/// @param view_projection The product of projection and view matrix
+/// @param occlusion_buffer The occlusion buffer
+/// @param visible_chunks The visible chunks, from which occluded chunks are removed
+void cull_occluded_chunks(const OctreeMesh &mesh, std::span<const std::uint32_t> occluders,
+                          const glm::mat4 &view_projection, tools::OcclusionBuffer &occlusion_buffer,
+                          std::vector<std::uint32_t> &visible_chunks);
+
+/// @brief Select the level of detail of a chunk by its distance to the camera.
+/// The distance is measured from the camera position to the closest point of the chunk's bounding box, so the camera
+/// always sees the full resolution of the chunk it is in.
+/// @param chunk The chunk
+/// @param camera_position The position of the camera
+/// @param lod_distances The ascending distances from which level of detail 1, 2, ... is used
+/// @return The index into OctreeChunk::lods, which is clamped to the levels of detail the chunk has
+[[nodiscard]] std::size_t select_lod(const OctreeChunk &chunk, const glm::vec3 &camera_position,
+                                     std::span<const float> lod_distances);
+
+/// @brief Collect the index ranges of the visible chunks at their level of detail, which can be turned into one
+/// indirect draw command each.
+/// Ranges which are adjacent in the index buffer are merged, so the number of draw commands stays low.
+/// @param mesh The octree mesh
+/// @param visible_chunks The visible chunks in ascending order (see cull_chunks)
+/// @param camera_position The position of the camera
+/// @param lod_distances The ascending distances from which level of detail 1, 2, ... is used (see select_lod)
+/// @param draw_ranges The merged index ranges (cleared before use, so the caller can reuse the allocation)
+void collect_draw_ranges(const OctreeMesh &mesh, std::span<const std::uint32_t> visible_chunks,
+                         const glm::vec3 &camera_position, std::span<const float> lod_distances,
+                         std::vector<OctreeMeshRange> &draw_ranges);
+
+/// @brief Collect the index ranges of the visible meshlets of the visible chunks at their level of detail.
+/// Like collect_draw_ranges, but every meshlet is tested against the frustum with its bounding sphere and skipped if
+/// it faces away from the camera (normal cone culling). This removes the back side of large walls, which chunk
+/// culling cannot do. Chunks without meshlets are drawn as a whole. Ranges which are adjacent in the index buffer are
+/// merged.
+/// @param mesh The octree mesh
+/// @param visible_chunks The visible chunks in ascending order (see cull_chunks)
+/// @param frustum The view frustum
+/// @param camera_position The position of the camera
+/// @param lod_distances The ascending distances from which level of detail 1, 2, ... is used (see select_lod)
+/// @param draw_ranges The merged index ranges (cleared before use, so the caller can reuse the allocation)
+void collect_meshlet_draw_ranges(const OctreeMesh &mesh, std::span<const std::uint32_t> visible_chunks,
+                                 const tools::Frustum &frustum, const glm::vec3 &camera_position,
+                                 std::span<const float> lod_distances, std::vector<OctreeMeshRange> &draw_ranges);
+
+} // namespace inexor::vulkan_renderer::render_modules::octree
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/render-modules/octree/octree_mesh.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Forward declaration
+namespace inexor::vulkan_renderer::tools {
+class MemoryMappedFile;
+} // namespace inexor::vulkan_renderer::tools
+
+namespace inexor::vulkan_renderer::render_modules::octree {
+
+/// @brief An on-disk cache of chunk meshes, so chunks which did not change since the last start are not meshed again.
+/// The meshes are keyed by a content hash of the chunk, which covers everything the mesh depends on (see
+/// OctreeMesher::set_cache). Like PipelineCache, the cache is loaded when it is created, and it can be written back
+/// at shutdown. A missing, outdated, or corrupt cache file is not an error: the cache simply starts empty.
+/// The file is memory mapped, and a mesh is only decoded when it is looked up. The layout is:
+///   - 16 bytes: the identifier "Inexor MeshCache"
+///   - std::uint32_t: the version of the layout (VERSION)
+///   - std::uint32_t: 0x01020304 in native byte order, because the arrays are stored in native byte order
+///   - std::uint32_t: the number of entries
+///   - for every entry in ascending key order: std::uint64_t key, std::uint64_t offset, std::uint64_t size
+///   - the entries, each aligned to 4 bytes:
+///     - std::uint32_t: the number of levels of detail
+///     - for every level of detail: the vertex, index, meshlet, meshlet vertex, and meshlet triangle counts as
+///       std::uint32_t, and the ACMR before and after optimization as float
+///     - for every level of detail: the vertices as 7 floats each, the indices, the meshlets as they are laid out in
+///       memory (tools::Meshlet), the meshlet vertices, and the meshlet triangles
+/// @note The cache can be used by several threads at once.
+class OctreeMeshCache {
+public:
+    /// The version of the file layout. Bump it whenever the layout or the meshing algorithms change, so old caches are
+    /// discarded instead of returning outdated meshes.
+    static constexpr std::uint32_t VERSION{1};
+
+private:
+    struct Entry {
+        std::uint64_t key{0};
+        std::uint64_t offset{0};
+        std::uint64_t size{0};
+    };
+
+    std::filesystem::path m_path;
+    std::shared_ptr<const tools::MemoryMappedFile> m_file;
+    /// The entries of the file sorted by key
+    std::vector<Entry> m_entries;
+
+    std::mutex m_mutex;
+    /// The keys of the file's entries which have been looked up, which are kept when saving
+    std::unordered_set<std::uint64_t> m_used_keys;
+    /// The encoded meshes which have been inserted since loading
+    std::unordered_map<std::uint64_t, std::vector<std::uint8_t>> m_new_entries;
+
+    std::atomic<std::size_t> m_hits{0};
+    std::atomic<std::size_t> m_misses{0};
+
+    /// Read the table of the cache file, and discard the file if it is invalid.
+    void load();
+
+public:
+    /// @param path The path of the cache file, which is loaded if it exists
+    explicit OctreeMeshCache(std::filesystem::path path);
+    OctreeMeshCache(const OctreeMeshCache &) = delete;
+    OctreeMeshCache(OctreeMeshCache &&) = delete;
+    ~OctreeMeshCache();
+
+    OctreeMeshCache &operator=(const OctreeMeshCache &) = delete;
+    OctreeMeshCache &operator=(OctreeMeshCache &&) = delete;
+
+    /// @brief Look up the meshes of all levels of detail of a chunk.
+    /// @param key The content hash of the chunk
+    /// @return The meshes, or std::nullopt if the chunk is not cached or its entry is corrupt
+    [[nodiscard]] std::optional<std::vector<OctreeChunkMesh>> find(std::uint64_t key);
+
+    /// @brief Insert the meshes of all levels of detail of a chunk.
+    /// @param key The content hash of the chunk
+    /// @param lods The meshes
+    void insert(std::uint64_t key, std::span<const OctreeChunkMesh> lods);
+
+    /// @brief Write the cache file.
+    /// Only the entries which have been looked up or inserted since loading are written, so meshes of chunks which
+    /// do not exist anymore are dropped. The file is written next to the old one and renamed, so the cache file is
+    /// never left half written. The new file is mapped afterwards, so the saved meshes can still be looked up.
+    /// @return Whether the cache file has been written
+    bool save();
+
+    /// The number of lookups which found a mesh.
+    [[nodiscard]] std::size_t hits() const noexcept {
+        return m_hits;
+    }
+
+    /// The number of lookups which did not find a mesh.
+    [[nodiscard]] std::size_t misses() const noexcept {
+        return m_misses;
+    }
+};
+
+} // namespace inexor::vulkan_renderer::render_modules::octree
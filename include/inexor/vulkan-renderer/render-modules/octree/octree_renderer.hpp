@@ -1,10 +1,14 @@
 #pragma once
 
+#include "inexor/vulkan-renderer/render-modules/octree/octree_mesh.hpp"
 #include "inexor/vulkan-renderer/render-modules/octree/octree_vertex.hpp"
+#include "inexor/vulkan-renderer/tools/occlusion_buffer.hpp"
 
 #include <glm/vec3.hpp>
+#include <volk.h>
 
 #include <memory>
+#include <vector>
 
 namespace inexor::vulkan_renderer::render_graph {
 // Forward declarations
@@ -63,6 +67,13 @@ struct UniformBufferObject {
 
 /// A simple renderer for octree geometry
 class OctreeRenderer {
+public:
+    /// The resolution of the software depth buffer for occlusion culling
+    static constexpr std::uint32_t OCCLUSION_BUFFER_WIDTH{256};
+    static constexpr std::uint32_t OCCLUSION_BUFFER_HEIGHT{128};
+    /// The number of occluders which are rasterized every frame
+    static constexpr std::size_t MAX_OCCLUDER_COUNT{64};
+
 private:
     // The vertex shader and fragment shader for octree rendering
     std::shared_ptr<Shader> m_vertex_shader;
@@ -72,6 +83,9 @@ private:
     std::weak_ptr<Buffer> m_vertex_buffer;
     std::weak_ptr<Buffer> m_index_buffer;
 
+    // The draw commands of the visible chunks, which are drawn with a single indirect draw call
+    std::weak_ptr<Buffer> m_indirect_buffer;
+
     // The matrix for model, view, and projection
     std::weak_ptr<Buffer> m_mvp_matrix;
 
@@ -88,8 +102,26 @@ private:
     std::weak_ptr<Texture> m_depth_buffer;
     std::weak_ptr<Texture> m_color_buffer; // Optional MSAA color buffer
 
-    std::vector<OctreeVertex> m_octree_vertices;
-    std::vector<std::uint32_t> m_octree_indices;
+    OctreeMesh m_octree_mesh;
+    /// The ascending camera distances from which level of detail 1, 2, ... of a chunk is drawn
+    std::vector<float> m_lod_distances;
+    /// Reused scratch storage for the chunks which pass frustum culling, to avoid a heap allocation every frame
+    std::vector<std::uint32_t> m_visible_chunks;
+    /// Reused scratch storage for the merged index ranges of the visible chunks
+    std::vector<OctreeMeshRange> m_draw_ranges;
+    /// The draw commands which are uploaded into the indirect buffer every frame
+    std::vector<VkDrawIndexedIndirectCommand> m_draw_commands;
+    /// The number of draw commands which the secondary command buffers of the octree pass are recorded with
+    std::size_t m_recorded_draw_count{0};
+    /// The chunks which pass frustum culling are tested against the largest nearby occluders on the CPU
+    tools::OcclusionBuffer m_occlusion_buffer{OCCLUSION_BUFFER_WIDTH, OCCLUSION_BUFFER_HEIGHT};
+    /// Reused scratch storage for the occluders which are rasterized in the current frame
+    std::vector<std::uint32_t> m_occluders;
+    bool m_occlusion_culling{true};
+    /// The meshlets of the visible chunks are culled by their bounding sphere and normal cone on the CPU
+    bool m_meshlet_culling{true};
+    /// Without the multiDrawIndirect feature, every draw command needs its own indirect draw call
+    bool m_multi_draw_indirect{false};
 
     UniformBufferObject m_ubo;
 
@@ -107,6 +139,25 @@ public:
                    std::weak_ptr<Texture> depth_buffer, std::shared_ptr<Camera> camera,
                    std::weak_ptr<Texture> color_buffer = {});
 
+    /// Set the chunked octree mesh. The level of detail of every chunk is selected by camera distance each frame.
+    /// @param mesh The octree mesh (see build_octree_mesh)
+    void set_mesh(OctreeMesh mesh);
+
+    /// Set the camera distances at which chunks switch to a lower level of detail.
+    /// @param lod_distances The ascending distances from which level of detail 1, 2, ... is used
+    void set_lod_distances(std::vector<float> lod_distances);
+
+    /// Enable or disable occlusion culling of chunks, which is enabled by default.
+    void set_occlusion_culling(bool enabled) {
+        m_occlusion_culling = enabled;
+    }
+
+    /// Enable or disable frustum and normal cone culling of meshlets, which is enabled by default.
+    void set_meshlet_culling(bool enabled) {
+        m_meshlet_culling = enabled;
+    }
+
+    /// Set unchunked geometry, which is drawn as a single chunk with one level of detail.
     void set_vertices_and_indices(std::vector<OctreeVertex> vertices, std::vector<std::uint32_t> indices);
 };
 
@@ -8,13 +8,16 @@ namespace inexor::vulkan_renderer::render_modules::octree {
 struct OctreeVertex {
     glm::vec3 position;
     glm::vec3 color;
+    /// Baked ambient occlusion, from 0 (fully occluded) to 1 (not occluded), which is multiplied with the color
+    float occlusion{1.0f};
 
-    OctreeVertex(glm::vec3 position, glm::vec3 color) : position(position), color(color) {}
+    OctreeVertex(glm::vec3 position, glm::vec3 color, float occlusion = 1.0f)
+        : position(position), color(color), occlusion(occlusion) {}
 };
 
 // inline to suppress clang-tidy warning.
 inline bool operator==(const OctreeVertex &lhs, const OctreeVertex &rhs) {
-    return lhs.position == rhs.position && lhs.color == rhs.color;
+    return lhs.position == rhs.position && lhs.color == rhs.color && lhs.occlusion == rhs.occlusion;
 }
 
 } // namespace inexor::vulkan_renderer::render_modules::octree
@@ -26,7 +29,8 @@ struct hash<inexor::vulkan_renderer::render_modules::octree::OctreeVertex> {
     std::size_t operator()(const inexor::vulkan_renderer::render_modules::octree::OctreeVertex &vertex) const {
         const auto h1 = std::hash<glm::vec3>{}(vertex.position);
         const auto h2 = std::hash<glm::vec3>{}(vertex.color);
-        return h1 ^ h2;
+        const auto h3 = std::hash<float>{}(vertex.occlusion);
+        return h1 ^ (h2 << 1) ^ (h3 << 2);
     }
 };
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "inexor/vulkan-renderer/tools/frustum.hpp"
+
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 
@@ -38,6 +40,8 @@ private:
     glm::vec3 m_world_up{directions::DEFAULT_UP};
     glm::mat4 m_view_matrix{};
     glm::mat4 m_perspective_matrix{};
+    /// The view frustum, which is extracted from the view and perspective matrix whenever one of them changes.
+    Frustum m_frustum{};
 
     /// The camera's yaw angle.
     float m_yaw{0.0f};
@@ -114,6 +118,12 @@ public:
         return m_fov;
     }
 
+    /// The view frustum for culling, which does not include the y flip of the Vulkan projection.
+    [[nodiscard]] const Frustum &frustum() {
+        update_matrices();
+        return m_frustum;
+    }
+
     [[nodiscard]] const glm::vec3 &front() const {
         return m_front;
     }
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
+
+namespace inexor::vulkan_renderer::tools {
+
+/// The result of testing a bounding volume against a frustum.
+enum class FrustumIntersection { OUTSIDE, INTERSECTING, INSIDE };
+
+/// A view frustum as six planes whose normals point inwards.
+class Frustum {
+public:
+    /// The planes in the order left, right, bottom, top, near, far.
+    static constexpr std::size_t PLANES{6};
+
+private:
+    /// Every plane is stored as (normal, distance), so a point p is inside of the plane if dot(normal, p) + distance
+    /// is not negative.
+    std::array<glm::vec4, PLANES> m_planes{};
+
+public:
+    /// Create a frustum which contains everything.
+    Frustum() = default;
+
+    /// @brief Extract the frustum planes from a view projection matrix (Gribb and Hartmann).
+    /// The matrix must use a depth range of [0, 1], which is what GLM_FORCE_DEPTH_ZERO_TO_ONE gives us.
+    /// @param view_projection The product of projection and view matrix
+    explicit Frustum(const glm::mat4 &view_projection);
+
+    /// Test an axis aligned bounding box against the frustum.
+    /// The test is conservative: a box near a corner of the frustum may be reported as intersecting even though it is
+    /// outside, but a box which is reported as outside is never visible.
+    /// @param bounding_box The minimum and maximum corner of the box
+    [[nodiscard]] FrustumIntersection intersect(const std::array<glm::vec3, 2> &bounding_box) const noexcept;
+
+    /// Test a bounding sphere against the frustum. The test is conservative like the test of bounding boxes.
+    /// @param center The center of the sphere
+    /// @param radius The radius of the sphere
+    [[nodiscard]] FrustumIntersection intersect(const glm::vec3 &center, float radius) const noexcept;
+
+    [[nodiscard]] const std::array<glm::vec4, PLANES> &planes() const noexcept {
+        return m_planes;
+    }
+};
+
+} // namespace inexor::vulkan_renderer::tools
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace inexor::vulkan_renderer::tools {
+
+/// @brief Compress a block with a byte oriented LZ77 codec in the style of LZ4.
+/// The block is a sequence of tokens: the upper 4 bits are the number of literals and the lower 4 bits are the match
+/// length minus 4, both extended with bytes of 255 if they do not fit. The literals follow the token, and then the
+/// little endian 16 bit offset of the match. The last token has only literals. Matches may overlap the output, so
+/// runs of the same byte are encoded as a match with offset 1.
+/// Decoding is a single pass without any tables, so it is fast enough to run on every block while loading.
+/// @param data The data to compress
+/// @return The compressed block, which needs the size of the data to be decompressed
+[[nodiscard]] std::vector<std::uint8_t> lz_compress(std::span<const std::uint8_t> data);
+
+/// @brief Decompress a block which was compressed with lz_compress.
+/// @param block The compressed block
+/// @param decoded_size The size of the decompressed data
+/// @exception std::runtime_error The block is corrupt or does not decompress to exactly decoded_size bytes
+/// @return The decompressed data
+[[nodiscard]] std::vector<std::uint8_t> lz_decompress(std::span<const std::uint8_t> block, std::size_t decoded_size);
+
+} // namespace inexor::vulkan_renderer::tools
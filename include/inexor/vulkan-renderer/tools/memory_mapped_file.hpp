@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace inexor::vulkan_renderer::tools {
+
+/// @brief A read-only view of a whole file, which is mapped into memory if the platform supports it.
+/// Mapping avoids copying the file: pages are loaded by the operating system when they are accessed first, and they
+/// are shared with the page cache. If the file can't be mapped (unsupported platform, empty file, or special files
+/// like pipes), it is read into memory with a single read instead.
+class MemoryMappedFile {
+private:
+    const std::uint8_t *m_data{nullptr};
+    std::size_t m_size{0};
+    bool m_mapped{false};
+    /// The contents of the file if it is not mapped
+    std::vector<std::uint8_t> m_buffer;
+#ifdef _WIN32
+    void *m_file_handle{nullptr};
+    void *m_mapping_handle{nullptr};
+#endif
+
+    /// Read the file into m_buffer.
+    void read(const std::filesystem::path &path);
+
+    /// Unmap the file and close its handles.
+    void unmap() noexcept;
+
+public:
+    /// @param path The path of the file
+    /// @exception std::runtime_error The file can't be opened or read
+    explicit MemoryMappedFile(const std::filesystem::path &path);
+    MemoryMappedFile(const MemoryMappedFile &) = delete;
+    MemoryMappedFile(MemoryMappedFile &&) noexcept;
+    ~MemoryMappedFile();
+
+    MemoryMappedFile &operator=(const MemoryMappedFile &) = delete;
+    MemoryMappedFile &operator=(MemoryMappedFile &&) noexcept;
+
+    [[nodiscard]] std::span<const std::uint8_t> data() const noexcept {
+        return {m_data, m_size};
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    /// Whether the file is mapped into memory, or has been read as fallback.
+    [[nodiscard]] bool is_mapped() const noexcept {
+        return m_mapped;
+    }
+};
+
+} // namespace inexor::vulkan_renderer::tools
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::tools {
+
+/// The size of the simulated post-transform vertex cache. Modern GPUs do not have a FIFO cache of fixed size anymore,
+/// but optimizing for a small FIFO cache still gives good results on them.
+constexpr std::size_t DEFAULT_VERTEX_CACHE_SIZE{16};
+
+/// Marks vertices which are not referenced by any index in the remap table of optimize_vertex_fetch.
+constexpr std::uint32_t UNUSED_VERTEX{std::numeric_limits<std::uint32_t>::max()};
+
+/// @brief Calculate the average cache miss ratio (ACMR) of a triangle list with a simulated FIFO vertex cache.
+/// The ACMR is the number of transformed vertices per triangle: 3 is the worst case, and 0.5 is the best case for
+/// large regular grids.
+/// @param indices The indices of the triangle list
+/// @param vertex_count The number of vertices
+/// @param cache_size The number of entries of the vertex cache
+/// @return The average cache miss ratio, or 0 if there are no triangles
+[[nodiscard]] float average_cache_miss_ratio(std::span<const std::uint32_t> indices, std::size_t vertex_count,
+                                             std::size_t cache_size = DEFAULT_VERTEX_CACHE_SIZE);
+
+/// @brief Reorder triangles for the post-transform vertex cache with the Tipsify algorithm.
+/// The triangles are emitted as fans around vertices, and the next fanning vertex is chosen among the vertices which
+/// are still in the cache.
+/// @see Sander, P. V., Nehab, D., and Barczak, J. (2007) Fast Triangle Reordering for Vertex Locality and Reduced
+/// Overdraw. ACM Transactions on Graphics 26 (3).
+/// @param indices The indices of the triangle list, which are reordered in place
+/// @param vertex_count The number of vertices
+/// @param cache_size The number of entries of the vertex cache
+/// @exception std::invalid_argument The number of indices is not a multiple of 3 or an index is out of range
+/// @return The offsets into the indices at which the algorithm had to start at a new place (dead ends), which split
+/// the triangles into clusters for optimize_overdraw
+std::vector<std::size_t> optimize_vertex_cache(std::span<std::uint32_t> indices, std::size_t vertex_count,
+                                               std::size_t cache_size = DEFAULT_VERTEX_CACHE_SIZE);
+
+/// @brief Reduce overdraw by sorting the clusters of optimize_vertex_cache by their occlusion potential.
+/// Clusters on the outside of the mesh which face away from its center are drawn first, because they are likely to
+/// occlude the other clusters. The order inside of the clusters is kept, so the vertex cache efficiency barely changes.
+/// @param indices The indices of the triangle list, which are reordered in place
+/// @param positions The vertex positions
+/// @param clusters The offsets at which the clusters start (see optimize_vertex_cache)
+void optimize_overdraw(std::span<std::uint32_t> indices, std::span<const glm::vec3> positions,
+                       std::span<const std::size_t> clusters);
+
+/// @brief Renumber the vertices in the order in which the index buffer references them first, so vertex fetches
+/// access memory sequentially.
+/// @param indices The indices, which are rewritten to the new vertex numbers
+/// @param vertex_count The number of vertices
+/// @return The new index of every vertex, or UNUSED_VERTEX for vertices which are not referenced (see remap_vertices)
+[[nodiscard]] std::vector<std::uint32_t> optimize_vertex_fetch(std::span<std::uint32_t> indices,
+                                                               std::size_t vertex_count);
+
+/// Reorder vertices with the remap table of optimize_vertex_fetch. Unused vertices are removed.
+template <typename Vertex>
+void remap_vertices(std::vector<Vertex> &vertices, const std::span<const std::uint32_t> remap) {
+    if (remap.size() != vertices.size()) {
+        throw std::invalid_argument("Error: The remap table does not match the number of vertices!");
+    }
+    // The new vertex numbers are dense, so the inverse table tells which vertex goes to which place
+    std::vector<std::size_t> order;
+    order.reserve(vertices.size());
+    for (std::size_t idx = 0; idx < remap.size(); idx++) {
+        if (remap[idx] == UNUSED_VERTEX) {
+            continue;
+        }
+        if (remap[idx] >= order.size()) {
+            order.resize(remap[idx] + 1);
+        }
+        order[remap[idx]] = idx;
+    }
+    std::vector<Vertex> remapped;
+    remapped.reserve(order.size());
+    for (const auto idx : order) {
+        remapped.push_back(std::move(vertices[idx]));
+    }
+    vertices = std::move(remapped);
+}
+
+} // namespace inexor::vulkan_renderer::tools
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace inexor::vulkan_renderer::tools {
+
+/// The maximum number of vertices per meshlet, which is the limit most mesh shader implementations recommend.
+constexpr std::size_t MAX_MESHLET_VERTICES{64};
+/// The maximum number of triangles per meshlet, which is a multiple of 4 so the triangles of a meshlet can be processed
+/// in groups of 4 by mesh shaders.
+constexpr std::size_t MAX_MESHLET_TRIANGLES{124};
+
+/// @brief A cluster of triangles with its culling bounds, laid out for use in a storage buffer (std430).
+/// The local vertex i of the meshlet is the vertex MeshletData::vertices[vertex_offset + i], and the triangles are
+/// MeshletData::triangles[triangle_offset, triangle_offset + triangle_count).
+struct Meshlet {
+    /// The bounding sphere of the meshlet
+    glm::vec3 center{0.0f};
+    float radius{0.0f};
+    /// The normal cone: the meshlet faces away from every camera for which
+    /// dot(normalize(cone_apex - camera_position), cone_axis) >= cone_cutoff (see is_meshlet_backfacing).
+    /// Meshlets without a valid cone have a zero axis and a cutoff of 1, so they are never back facing.
+    glm::vec3 cone_apex{0.0f};
+    float cone_cutoff{1.0f};
+    glm::vec3 cone_axis{0.0f};
+    std::uint32_t vertex_offset{0};
+    std::uint32_t triangle_offset{0};
+    std::uint32_t vertex_count{0};
+    std::uint32_t triangle_count{0};
+    std::uint32_t padding{0};
+};
+
+static_assert(sizeof(Meshlet) == 64, "Meshlet must match its layout in shaders!");
+
+/// The meshlets of a triangle list.
+struct MeshletData {
+    std::vector<Meshlet> meshlets;
+    /// The vertex indices of all meshlets
+    std::vector<std::uint32_t> vertices;
+    /// The triangles of all meshlets, with the three local vertex indices packed into 8 bits each (see
+    /// pack_meshlet_triangle)
+    std::vector<std::uint32_t> triangles;
+};
+
+/// Pack the local vertex indices of a meshlet triangle into one value.
+[[nodiscard]] constexpr std::uint32_t pack_meshlet_triangle(const std::array<std::uint32_t, 3> &triangle) noexcept {
+    return triangle[0] | (triangle[1] << 8) | (triangle[2] << 16);
+}
+
+/// Unpack the local vertex indices of a meshlet triangle (see pack_meshlet_triangle).
+[[nodiscard]] constexpr std::array<std::uint32_t, 3> unpack_meshlet_triangle(const std::uint32_t triangle) noexcept {
+    return {triangle & 0xFF, (triangle >> 8) & 0xFF, (triangle >> 16) & 0xFF};
+}
+
+/// @brief Split a triangle list into meshlets.
+/// The triangles are added to the current meshlet in the order of the indices until it runs out of vertices or
+/// triangles, so the index buffer should be optimized for the vertex cache first (see optimize_vertex_cache), which
+/// keeps neighbouring triangles together. Because the order is kept, meshlet n covers the triangles
+/// [triangle_offset, triangle_offset + triangle_count) of the index buffer, and the meshlets can be drawn as ranges of
+/// the index buffer without mesh shaders.
+/// Front faces are wound clockwise like in the graphics pipelines, which the normal cones depend on.
+/// @param indices The indices of the triangle list
+/// @param positions The vertex positions
+/// @param max_vertices The maximum number of vertices per meshlet (3 to 256)
+/// @param max_triangles The maximum number of triangles per meshlet (at least 1)
+/// @param splits The ascending offsets into the indices at which a new meshlet is started, e.g. between groups of
+/// triangles which face the same direction, which keeps the normal cones narrow
+/// @exception std::invalid_argument The limits are invalid, the number of indices is not a multiple of 3, or an index
+/// is out of range
+[[nodiscard]] MeshletData build_meshlets(std::span<const std::uint32_t> indices, std::span<const glm::vec3> positions,
+                                         std::size_t max_vertices = MAX_MESHLET_VERTICES,
+                                         std::size_t max_triangles = MAX_MESHLET_TRIANGLES,
+                                         std::span<const std::size_t> splits = {});
+
+/// Test if all triangles of a meshlet face away from the camera (normal cone culling).
+[[nodiscard]] bool is_meshlet_backfacing(const Meshlet &meshlet, const glm::vec3 &camera_position) noexcept;
+
+} // namespace inexor::vulkan_renderer::tools
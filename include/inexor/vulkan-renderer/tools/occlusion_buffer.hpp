@@ -0,0 +1,86 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace inexor::vulkan_renderer::tools {
+
+/// @brief A low resolution software depth buffer with a hierarchical-Z (HiZ) pyramid for occlusion culling on the CPU.
+/// Occluders are rasterized into the depth buffer, then the pyramid is built, and finally bounding boxes are tested
+/// against it. Every texel of level n + 1 stores the farthest depth of the 2x2 texels below it, so a bounding box can
+/// be tested with at most 2x2 texel reads.
+/// The occlusion test is conservative: occluders only cover pixels which they cover completely, and they are written
+/// with the farthest depth of the triangle inside of the pixel. Depth is in the range [0, 1] with 0 being the nearest.
+class OcclusionBuffer {
+public:
+    /// Vertices with a smaller clip space w are treated as behind the camera.
+    static constexpr float MIN_CLIP_W{1e-4f};
+
+private:
+    struct Level {
+        std::size_t offset{0};
+        std::uint32_t width{0};
+        std::uint32_t height{0};
+    };
+
+    std::uint32_t m_width{0};
+    std::uint32_t m_height{0};
+    glm::mat4 m_view_projection{1.0f};
+    /// The depth of all levels, starting with the full resolution depth buffer
+    std::vector<float> m_depth;
+    std::vector<Level> m_levels;
+
+    /// Project a point into screen space (x and y in pixels, z is the depth, and w the clip space w).
+    [[nodiscard]] glm::vec4 project(const glm::vec3 &point) const;
+
+    /// Rasterize a convex, planar polygon with four projected vertices (see project).
+    void rasterize_projected_polygon(const std::array<glm::vec4, 4> &polygon);
+
+public:
+    /// @param width The width in pixels, which is rounded up to a multiple of 4 for SIMD rasterization
+    /// @param height The height in pixels
+    /// @exception std::invalid_argument The width or height is 0
+    OcclusionBuffer(std::uint32_t width, std::uint32_t height);
+
+    /// Reset the depth buffer to the far plane and set the view projection matrix for the following calls.
+    /// @param view_projection The product of projection and view matrix, which must use a depth range of [0, 1]
+    void clear(const glm::mat4 &view_projection);
+
+    /// Rasterize a triangle as occluder. Triangles which cross the near plane are skipped.
+    void rasterize_triangle(const std::array<glm::vec3, 3> &triangle);
+
+    /// Rasterize an axis aligned solid box as occluder. Boxes which cross the near plane are skipped.
+    /// @param bounding_box The minimum and maximum corner of the box
+    void rasterize_box(const std::array<glm::vec3, 2> &bounding_box);
+
+    /// Build the hierarchical-Z pyramid from the depth buffer. This must be called after rasterizing the occluders and
+    /// before testing boxes with is_visible.
+    void build_hierarchy();
+
+    /// Test if an axis aligned bounding box could be visible. Boxes which cross the near plane or are outside of the
+    /// screen are always reported as visible.
+    /// @param bounding_box The minimum and maximum corner of the box
+    [[nodiscard]] bool is_visible(const std::array<glm::vec3, 2> &bounding_box) const;
+
+    /// The depth of a texel in a level of the pyramid (level 0 is the depth buffer).
+    [[nodiscard]] float depth(std::uint32_t x, std::uint32_t y, std::size_t level = 0) const;
+
+    [[nodiscard]] std::uint32_t width() const noexcept {
+        return m_width;
+    }
+
+    [[nodiscard]] std::uint32_t height() const noexcept {
+        return m_height;
+    }
+
+    [[nodiscard]] std::size_t level_count() const noexcept {
+        return m_levels.size();
+    }
+};
+
+} // namespace inexor::vulkan_renderer::tools
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace inexor::vulkan_renderer::tools {
+
+/// @brief A fixed number of worker threads which run submitted tasks in submission order.
+/// Unlike std::async, the threads are created once, so submitting a task does not create a thread.
+class ThreadPool {
+private:
+    std::vector<std::thread> m_threads;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_task_available;
+    std::condition_variable m_idle;
+    /// The number of tasks which are running
+    std::size_t m_running_tasks{0};
+    bool m_stop{false};
+
+    void run_worker();
+    void push(std::function<void()> task);
+
+public:
+    /// The number of hardware threads, or 1 if it is unknown.
+    [[nodiscard]] static std::size_t default_thread_count();
+
+    /// @param thread_count The number of worker threads (at least 1)
+    /// @exception std::invalid_argument The thread count is 0
+    explicit ThreadPool(std::size_t thread_count = default_thread_count());
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+
+    /// Run the remaining tasks and join the worker threads.
+    ~ThreadPool();
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ThreadPool &operator=(ThreadPool &&) = delete;
+
+    /// @brief Run a task on a worker thread.
+    /// @param task The task, which must be callable without arguments
+    /// @return The future of the result of the task, which holds the exception if the task throws
+    template <typename Task>
+    [[nodiscard]] std::future<std::invoke_result_t<std::decay_t<Task>>> submit(Task &&task) {
+        // std::function needs a copyable task, so the packaged task is shared
+        auto packaged_task =
+            std::make_shared<std::packaged_task<std::invoke_result_t<std::decay_t<Task>>()>>(std::forward<Task>(task));
+        auto future = packaged_task->get_future();
+        push([packaged_task = std::move(packaged_task)]() { (*packaged_task)(); });
+        return future;
+    }
+
+    /// Wait until all submitted tasks have finished.
+    void wait_idle();
+
+    [[nodiscard]] std::size_t thread_count() const noexcept {
+        return m_threads.size();
+    }
+};
+
+} // namespace inexor::vulkan_renderer::tools
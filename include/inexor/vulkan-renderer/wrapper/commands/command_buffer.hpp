@@ -3,6 +3,7 @@
 #include "inexor/vulkan-renderer/render-graph/buffer.hpp"
 #include "inexor/vulkan-renderer/tools/exception.hpp"
 #include "inexor/vulkan-renderer/wrapper/images/image.hpp"
+#include "inexor/vulkan-renderer/wrapper/pipelines/compute_pipeline.hpp"
 #include "inexor/vulkan-renderer/wrapper/pipelines/graphics_pipeline.hpp"
 #include "inexor/vulkan-renderer/wrapper/synchronization/fence.hpp"
 
@@ -28,7 +29,8 @@ class Image;
 } // namespace inexor::vulkan_renderer::wrapper::images
 
 namespace inexor::vulkan_renderer::wrapper::pipelines {
-// Forward declaration
+// Forward declarations
+class ComputePipeline;
 class GraphicsPipeline;
 } // namespace inexor::vulkan_renderer::wrapper::pipelines
 
@@ -51,6 +53,7 @@ using tools::InexorException;
 using wrapper::core::QueueSemaphoreWait;
 using wrapper::descriptors::PerFrameDescriptorSets;
 using wrapper::images::Image;
+using wrapper::pipelines::ComputePipeline;
 using wrapper::pipelines::GraphicsPipeline;
 using wrapper::synchronization::Fence;
 
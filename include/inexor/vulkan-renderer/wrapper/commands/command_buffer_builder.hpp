@@ -74,6 +74,20 @@ public:
         return *this;
     }
 
+    [[nodiscard]] CommandBufferBuilder &bind_descriptor_set(VkDescriptorSet descriptor_set,
+                                                            std::weak_ptr<ComputePipeline> pipeline) {
+        if (!descriptor_set) {
+            throw InexorException("Error: Parameter 'descriptor_set' is invalid!");
+        }
+        const auto pipeline_ref = pipeline.lock();
+        if (!pipeline_ref) {
+            throw InexorException("Error: Parameter 'pipeline' is an invalid pointer!");
+        }
+        vkCmdBindDescriptorSets(command_buffer_handle(), VK_PIPELINE_BIND_POINT_COMPUTE,
+                                pipeline_ref->pipeline_layout(), 0, 1, &descriptor_set, 0, nullptr);
+        return *this;
+    }
+
     [[nodiscard]] CommandBufferBuilder &
     bind_descriptor_set(std::weak_ptr<descriptors::PerFrameDescriptorSets> descriptor_sets) {
         const auto desc_sets = descriptor_sets.lock();
@@ -105,6 +119,16 @@ public:
         return bind_descriptor_set(descriptor_sets_ref->current_descriptor_set(), pipeline);
     }
 
+    [[nodiscard]] CommandBufferBuilder &
+    bind_descriptor_set(std::weak_ptr<descriptors::PerFrameDescriptorSets> descriptor_sets,
+                        std::weak_ptr<ComputePipeline> pipeline) {
+        const auto descriptor_sets_ref = descriptor_sets.lock();
+        if (!descriptor_sets_ref) {
+            throw InexorException("Error: Parameter 'descriptor_set' is an invalid pointer!");
+        }
+        return bind_descriptor_set(descriptor_sets_ref->current_descriptor_set(), pipeline);
+    }
+
     [[nodiscard]] CommandBufferBuilder &
     bind_descriptor_sets(std::span<const VkDescriptorSet> desc_sets, VkPipelineLayout layout,
                          VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS, std::uint32_t first_set = 0,
@@ -153,6 +177,14 @@ public:
         return bind_pipeline(pipeline_ref->pipeline());
     }
 
+    [[nodiscard]] CommandBufferBuilder &bind_pipeline(std::weak_ptr<ComputePipeline> compute_pipeline) {
+        const auto pipeline_ref = compute_pipeline.lock();
+        if (!pipeline_ref) {
+            throw InexorException("Error: Parameter 'pipeline' is an invalid pointer!");
+        }
+        return bind_pipeline(pipeline_ref->pipeline(), VK_PIPELINE_BIND_POINT_COMPUTE);
+    }
+
     [[nodiscard]] CommandBufferBuilder &
     bind_pipeline(VkPipeline pipeline, VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS) {
         if (!pipeline) {
@@ -390,6 +422,35 @@ public:
                                     });
     }
 
+    /// Call vkCmdDispatch
+    /// @note Compute passes are recorded outside of dynamic rendering, so this must not be called in graphics passes.
+    [[nodiscard]] CommandBufferBuilder &dispatch(std::uint32_t group_count_x, std::uint32_t group_count_y = 1,
+                                                 std::uint32_t group_count_z = 1) {
+        vkCmdDispatch(command_buffer_handle(), group_count_x, group_count_y, group_count_z);
+        return *this;
+    }
+
+    /// Call vkCmdDispatchIndirect with the VkDispatchIndirectCommand in an indirect buffer.
+    [[nodiscard]] CommandBufferBuilder &dispatch_indirect(VkBuffer buf, VkDeviceSize offset = 0) {
+        if (!buf) {
+            throw std::invalid_argument("Error: Parameter 'buf' is invalid!");
+        }
+        vkCmdDispatchIndirect(command_buffer_handle(), buf, offset);
+        return *this;
+    }
+
+    [[nodiscard]] CommandBufferBuilder &dispatch_indirect(const std::weak_ptr<Buffer> buffer, VkDeviceSize offset = 0) {
+        const auto buffer_ref = buffer.lock();
+        if (!buffer_ref) {
+            throw InexorException("Error: Parameter 'buffer' is an invalid pointer!");
+        }
+        if (buffer_ref->type() != BufferType::INDIRECT_BUFFER) {
+            throw InexorException("Error: Rendergraph buffer resource " + buffer_ref->name() +
+                                  " is not an indirect buffer!");
+        }
+        return dispatch_indirect(buffer_ref->buffer(), offset);
+    }
+
     [[nodiscard]] CommandBufferBuilder &draw(std::uint32_t vert_count, std::uint32_t inst_count = 1,
                                              std::uint32_t first_vert = 0, std::uint32_t first_inst = 0) {
         vkCmdDraw(command_buffer_handle(), vert_count, inst_count, first_vert, first_inst);
@@ -403,6 +464,32 @@ public:
         return *this;
     }
 
+    /// Call vkCmdDrawIndexedIndirect with the VkDrawIndexedIndirectCommand array in an indirect buffer.
+    /// @note A draw count above 1 requires the multiDrawIndirect device feature.
+    [[nodiscard]] CommandBufferBuilder &
+    draw_indexed_indirect(VkBuffer buf, std::uint32_t draw_count, VkDeviceSize offset = 0,
+                          std::uint32_t stride = sizeof(VkDrawIndexedIndirectCommand)) {
+        if (!buf) {
+            throw std::invalid_argument("Error: Parameter 'buf' is invalid!");
+        }
+        vkCmdDrawIndexedIndirect(command_buffer_handle(), buf, offset, draw_count, stride);
+        return *this;
+    }
+
+    [[nodiscard]] CommandBufferBuilder &
+    draw_indexed_indirect(const std::weak_ptr<Buffer> buffer, std::uint32_t draw_count, VkDeviceSize offset = 0,
+                          std::uint32_t stride = sizeof(VkDrawIndexedIndirectCommand)) {
+        const auto buffer_ref = buffer.lock();
+        if (!buffer_ref) {
+            throw InexorException("Error: Parameter 'buffer' is an invalid pointer!");
+        }
+        if (buffer_ref->type() != BufferType::INDIRECT_BUFFER) {
+            throw InexorException("Error: Rendergraph buffer resource " + buffer_ref->name() +
+                                  " is not an indirect buffer!");
+        }
+        return draw_indexed_indirect(buffer_ref->buffer(), draw_count, offset, stride);
+    }
+
     [[nodiscard]] CommandBufferBuilder &begin_rendering(const VkRenderingInfo &rendering_info) {
         vkCmdBeginRendering(command_buffer_handle(), &rendering_info);
         return *this;
@@ -524,6 +611,17 @@ public:
         return push_constants(pipeline_ref->pipeline_layout(), stage, sizeof(data), &data, offset);
     }
 
+    template <typename T>
+    [[nodiscard]] CommandBufferBuilder &push_constant(const std::weak_ptr<ComputePipeline> pipeline, const T &data,
+                                                      const VkDeviceSize offset = 0) {
+        const auto pipeline_ref = pipeline.lock();
+        if (!pipeline_ref) {
+            throw InexorException("Error: Parameter 'pipeline' is an invalid pointer!");
+        }
+        return push_constants(pipeline_ref->pipeline_layout(), VK_SHADER_STAGE_COMPUTE_BIT, sizeof(data), &data,
+                              offset);
+    }
+
     [[nodiscard]] CommandBufferBuilder &set_scissor(VkRect2D scissor) {
         vkCmdSetScissor(command_buffer_handle(), 0, 1, &scissor);
         return *this;
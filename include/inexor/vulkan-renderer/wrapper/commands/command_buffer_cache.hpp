@@ -24,18 +24,22 @@ class CommandBufferBuilder;
 namespace inexor::vulkan_renderer::wrapper::commands {
 
 /// Caches RenderGraph-owned secondary command buffer recording state.
+/// @note The secondary command buffers of different passes can be recorded on different threads at the same time. Each
+/// thread records into command buffers of its own command pool, because command pools must be externally synchronized.
 class CommandBufferCache {
 private:
     bool m_use_secondary_command_buffers{true};
     struct SecondaryCommandBufferState {
         VkExtent2D cached_render_extent{0, 0};
         std::vector<bool> dirty_by_frame_slot{true};
+        /// The recorded command buffer of every frame slot, which belongs to the command pool of the thread which
+        /// recorded it
+        std::vector<VkCommandBuffer> command_buffer_by_frame_slot{VK_NULL_HANDLE};
     };
 
     core::Device &m_device;
     std::size_t m_frame_slot_count{1};
     std::size_t m_current_frame_slot{0};
-    std::vector<VkFence> m_frame_slot_submission_fences{VK_NULL_HANDLE};
     std::unordered_map<std::string, SecondaryCommandBufferState> m_secondary_command_buffers;
 
     SecondaryCommandBufferState &state_for_pass(const std::string &pass_name);
@@ -43,16 +47,42 @@ private:
 public:
     explicit CommandBufferCache(core::Device &device, bool use_secondary_command_buffers = true);
 
-    void set_frame_context(std::size_t frame_slot_count, std::size_t current_frame_slot,
-                           std::span<const VkFence> frame_slot_submission_fences);
+    void set_frame_context(std::size_t frame_slot_count, std::size_t current_frame_slot);
 
     void invalidate_all_secondary_command_buffers();
 
-    void record_secondary_command_buffer(const CommandBuffer &primary_cmd_buf, const std::string &pass_name,
-                                         std::array<float, 4> debug_label_color, VkExtent2D render_extent,
+    /// Make the secondary command buffers of all frame slots of a pass dirty.
+    /// @param pass_name The name of the pass
+    void invalidate_secondary_command_buffers(const std::string &pass_name);
+
+    [[nodiscard]] bool uses_secondary_command_buffers() const {
+        return m_use_secondary_command_buffers;
+    }
+
+    /// Check if the secondary command buffer of a pass must be recorded for the current frame slot. A change of the
+    /// render extent makes the command buffers of all frame slots dirty.
+    /// @note This must be called on the render thread before the command buffer is recorded.
+    /// @param pass_name The name of the pass
+    /// @param render_extent The render extent of the pass
+    /// @return ``true`` if the secondary command buffer must be recorded
+    [[nodiscard]] bool prepare_secondary_command_buffer(const std::string &pass_name, VkExtent2D render_extent);
+
+    /// Record the secondary command buffer of a pass for the current frame slot. This can be called on any thread,
+    /// for a pass which prepare_secondary_command_buffer has been called for.
+    /// @param pass_name The name of the pass
+    /// @param inheritance_info The inheritance info of the secondary command buffer
+    /// @param on_record The function which records the commands of the pass
+    void record_secondary_command_buffer(const std::string &pass_name,
                                          const VkCommandBufferInheritanceInfo &inheritance_info,
-                                         const VkRenderingInfo &rendering_info,
-                                         std::function<void(CommandBufferBuilder &)> on_record);
+                                         const std::function<void(CommandBufferBuilder &)> &on_record);
+
+    /// Execute the secondary command buffer of a pass in the primary command buffer, and record it first if it is
+    /// still dirty. If secondary command buffers are not used, the pass is recorded into the primary command buffer.
+    void execute_secondary_command_buffer(const CommandBuffer &primary_cmd_buf, const std::string &pass_name,
+                                          std::array<float, 4> debug_label_color, VkExtent2D render_extent,
+                                          const VkCommandBufferInheritanceInfo &inheritance_info,
+                                          const VkRenderingInfo &rendering_info,
+                                          const std::function<void(CommandBufferBuilder &)> &on_record);
 };
 
 } // namespace inexor::vulkan_renderer::wrapper::commands
\ No newline at end of file
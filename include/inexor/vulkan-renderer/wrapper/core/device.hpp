@@ -8,6 +8,7 @@
 #include "inexor/vulkan-renderer/wrapper/commands/command_pool.hpp"
 
 #include <array>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -59,6 +60,8 @@ enum class DebugLabelColor {
 struct QueueSemaphoreWait {
     VkSemaphore semaphore{VK_NULL_HANDLE};
     VkPipelineStageFlags2 stage_mask{VK_PIPELINE_STAGE_2_NONE};
+    /// The value a timeline semaphore must reach (ignored for binary semaphores)
+    std::uint64_t value{0};
 };
 
 /// Convert a DebugLabelColor to a rgba value
@@ -79,6 +82,7 @@ private:
     VmaAllocator m_allocator{VK_NULL_HANDLE};
     std::string m_gpu_name;
     VkPhysicalDeviceFeatures m_enabled_features{};
+    bool m_lazily_allocated_memory_supported{false};
     std::array<std::uint8_t, VK_UUID_SIZE> m_pipeline_cache_uuid{};
 
     VkQueue m_graphics_queue{VK_NULL_HANDLE};
@@ -225,6 +229,17 @@ public:
         return m_enabled_features;
     }
 
+    /// Check if there is a memory type for lazily allocated memory, which is usually only committed by tile-based GPUs
+    /// when a transient attachment actually needs to be stored.
+    [[nodiscard]] bool is_lazily_allocated_memory_supported() const {
+        return m_lazily_allocated_memory_supported;
+    }
+
+    /// Check if indirect draw calls can execute more than one draw command (multiDrawIndirect).
+    [[nodiscard]] bool is_multi_draw_indirect_supported() const {
+        return m_enabled_features.multiDrawIndirect == VK_TRUE;
+    }
+
     [[nodiscard]] const std::string &gpu_name() const {
         return m_gpu_name;
     }
@@ -241,10 +256,22 @@ public:
         return m_compute_queue != VK_NULL_HANDLE;
     }
 
+    /// Check if there is a compute queue which is separate from the graphics queue, so compute work which is submitted
+    /// to it can overlap with the graphics work.
+    [[nodiscard]] bool has_async_compute_queue() const {
+        return m_compute_queue != VK_NULL_HANDLE && m_compute_queue != m_graphics_queue;
+    }
+
     [[nodiscard]] bool has_any_transfer_queue() const {
         return m_transfer_queue != VK_NULL_HANDLE;
     }
 
+    /// Check if there is a transfer queue which is separate from the graphics queue, so uploads which are submitted to
+    /// it can overlap with the graphics work.
+    [[nodiscard]] bool has_dedicated_transfer_queue() const {
+        return m_transfer_queue != VK_NULL_HANDLE && m_transfer_queue != m_graphics_queue;
+    }
+
     [[nodiscard]] bool transfer_queue_shares_graphics_family() const {
         return m_transfer_queue_family_index.has_value() && m_graphics_queue_family_index.has_value() &&
                m_transfer_queue_family_index.value() == m_graphics_queue_family_index.value();
@@ -269,6 +296,13 @@ public:
         return m_transfer_queue;
     }
 
+    [[nodiscard]] std::uint32_t compute_queue_family_index() const {
+        if (!m_compute_queue_family_index.has_value()) {
+            throw std::runtime_error("Error: Compute queue family index is not available!");
+        }
+        return m_compute_queue_family_index.value();
+    }
+
     [[nodiscard]] std::uint32_t graphics_queue_family_index() const {
         if (!m_graphics_queue_family_index.has_value()) {
             throw std::runtime_error("Error: Graphics queue family index is not available!");
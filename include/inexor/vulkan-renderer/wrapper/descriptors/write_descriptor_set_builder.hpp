@@ -29,6 +29,7 @@ namespace inexor::vulkan_renderer::wrapper::descriptors {
 using render_graph::Buffer;
 using render_graph::BufferType;
 using render_graph::Texture;
+using render_graph::TextureUsage;
 using tools::InexorException;
 using tools::make_info;
 
@@ -69,15 +70,19 @@ public:
                 using T = std::decay_t<decltype(descriptor)>;
                 if constexpr (std::is_same_v<T, std::weak_ptr<Texture>>) {
                     if (auto texture = descriptor.lock(); texture) {
-                        write_descriptor_set.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                        write_descriptor_set.descriptorType = (texture->usage() == TextureUsage::STORAGE_IMAGE)
+                                                                  ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+                                                                  : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
                         write_descriptor_set.pImageInfo = texture->descriptor_image_info();
                     } else {
                         throw InexorException("Error: Texture is invalid!");
                     }
                 } else if constexpr (std::is_same_v<T, std::weak_ptr<Buffer>>) {
                     if (auto buffer = descriptor.lock(); buffer) {
-                        // @TODO: Distinguish type by buffer->type()! (uniform ? storage? ..)
-                        write_descriptor_set.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                        // Indirect buffers are bound as storage buffers so that shaders can write draw commands
+                        write_descriptor_set.descriptorType = (buffer->type() == BufferType::UNIFORM_BUFFER)
+                                                                  ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+                                                                  : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
                         write_descriptor_set.pBufferInfo = buffer->descriptor_buffer_info();
                     } else {
                         throw InexorException("Error: Buffer is invalid!");
@@ -52,6 +52,15 @@ private:
     /// @param img_view_ci The image view create info
     void create(VkImageCreateInfo img_ci, VkImageViewCreateInfo img_view_ci);
 
+    /// Create the image and the image view, and bind the image to memory which it shares with other images
+    /// @param img_ci The image create info
+    /// @param img_view_ci The image view create info
+    /// @param alias_alloc The allocation the image is bound to, which is not freed when the image is destroyed
+    void create(VkImageCreateInfo img_ci, VkImageViewCreateInfo img_view_ci, VmaAllocation alias_alloc);
+
+    /// Create the image view of the image which has just been created
+    void create_image_view();
+
     /// Destroy the image view, the image, and the sampler
     void destroy();
 
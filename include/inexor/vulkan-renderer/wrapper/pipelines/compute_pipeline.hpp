@@ -0,0 +1,72 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/tools/make_info.hpp"
+
+#include <volk.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace inexor::vulkan_renderer::wrapper::core {
+// Forward declaration
+class Device;
+} // namespace inexor::vulkan_renderer::wrapper::core
+
+namespace inexor::vulkan_renderer::wrapper::descriptors {
+// Forward declaration
+class PerFrameDescriptorSets;
+} // namespace inexor::vulkan_renderer::wrapper::descriptors
+
+namespace inexor::vulkan_renderer::wrapper::pipelines {
+
+// Forward declaration
+class PipelineLayout;
+
+// Using declaration
+using tools::make_info;
+
+/// The data which is used to create a compute pipeline
+/// @note Unlike GraphicsPipelineSetupData, there are no nested create info structures which point to this data, so it
+/// only needs to be kept alive until vkCreateComputePipelines has been called.
+struct ComputePipelineSetupData {
+    VkPipelineShaderStageCreateInfo shader_stage{make_info<VkPipelineShaderStageCreateInfo>()};
+    std::vector<VkPushConstantRange> push_constant_ranges{};
+    std::vector<VkDescriptorSetLayout> descriptor_set_layouts{};
+    std::vector<std::weak_ptr<wrapper::descriptors::PerFrameDescriptorSets>> associated_descriptor_sets{};
+};
+
+/// RAII wrapper for compute pipelines
+class ComputePipeline {
+private:
+    const core::Device &m_device;
+    std::string m_name;
+    VkPipeline m_pipeline{VK_NULL_HANDLE};
+    std::unique_ptr<PipelineLayout> m_pipeline_layout;
+
+public:
+    /// Default constructor
+    /// @param device The device wrapper
+    /// @param setup_data The compute pipeline setup data
+    /// @param name The internal debug name of the compute pipeline
+    /// @exception InexorException An associated descriptor set is invalid
+    /// @exception VulkanException vkCreateComputePipelines call failed
+    ComputePipeline(const core::Device &device, ComputePipelineSetupData setup_data, std::string name);
+
+    ComputePipeline(const ComputePipeline &) = delete;
+    ComputePipeline(ComputePipeline &&) = delete;
+
+    /// Call vkDestroyPipeline
+    ~ComputePipeline();
+
+    ComputePipeline &operator=(const ComputePipeline &) = delete;
+    ComputePipeline &operator=(ComputePipeline &&) = delete;
+
+    [[nodiscard]] VkPipeline pipeline() const {
+        return m_pipeline;
+    }
+
+    [[nodiscard]] VkPipelineLayout pipeline_layout() const;
+};
+
+} // namespace inexor::vulkan_renderer::wrapper::pipelines
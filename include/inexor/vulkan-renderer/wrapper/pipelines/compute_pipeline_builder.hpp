@@ -0,0 +1,114 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/tools/exception.hpp"
+#include "inexor/vulkan-renderer/tools/make_info.hpp"
+#include "inexor/vulkan-renderer/wrapper/pipelines/compute_pipeline.hpp"
+#include "inexor/vulkan-renderer/wrapper/shaders/shader.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::wrapper::core {
+// Forward declarations
+class Device;
+} // namespace inexor::vulkan_renderer::wrapper::core
+
+namespace inexor::vulkan_renderer::wrapper::descriptors {
+// Forward declaration
+class PerFrameDescriptorSets;
+} // namespace inexor::vulkan_renderer::wrapper::descriptors
+
+namespace inexor::vulkan_renderer::wrapper::pipelines {
+
+// Using declaration
+using shaders::Shader;
+using tools::InexorException;
+
+/// Builder class for VkComputePipelineCreateInfo
+/// @note Just like GraphicsPipelineBuilder, this builder does not perform any checks which are already covered by
+/// validation layers.
+class ComputePipelineBuilder {
+private:
+    const core::Device &m_device;
+    ComputePipelineSetupData m_data;
+    void reset();
+
+public:
+    /// Default constructor
+    /// @param device The device wrapper
+    ComputePipelineBuilder(const core::Device &device);
+
+    /// Associate a descriptor set resource with the compute pipeline.
+    /// The pipeline layout will be linked to this descriptor set automatically after build.
+    [[nodiscard]] auto &add_descriptor_set(std::weak_ptr<wrapper::descriptors::PerFrameDescriptorSets> descriptor_set) {
+        if (descriptor_set.expired()) {
+            throw InexorException("Error: Parameter 'descriptor_set' is invalid!");
+        }
+        m_data.associated_descriptor_sets.emplace_back(std::move(descriptor_set));
+        return *this;
+    }
+
+    /// Add a push constant range to the compute pipeline
+    /// @param size The size of the push constant
+    /// @param offset The offset in the push constant range (``0`` by default)
+    /// @return A const reference to the ``this`` pointer, which allows method calls to be chained
+    [[nodiscard]] auto &add_push_constant_range(const std::uint32_t size, const std::uint32_t offset = 0) {
+        m_data.push_constant_ranges.emplace_back(VkPushConstantRange{
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset = offset,
+            .size = size,
+        });
+        return *this;
+    }
+
+    /// Build the compute pipeline
+    /// @param name The debug name of the compute pipeline
+    /// @exception InexorException The name is empty, or no compute shader was set
+    /// @return The compute pipeline which was created
+    [[nodiscard]] std::shared_ptr<ComputePipeline> build(std::string name);
+
+    /// Set the descriptor set layout
+    /// @param descriptor_set_layout The descriptor set layout
+    /// @return A const reference to the ``this`` pointer, which allows method calls to be chained
+    [[nodiscard]] auto &set_descriptor_set_layout(const VkDescriptorSetLayout descriptor_set_layout) {
+        if (!descriptor_set_layout) {
+            throw InexorException("Error: Parameter 'descriptor_set_layout' is invalid!");
+        }
+        m_data.descriptor_set_layouts = {descriptor_set_layout};
+        return *this;
+    }
+
+    /// Set the descriptor set layouts
+    /// @param descriptor_set_layouts The descriptor set layouts
+    /// @return A const reference to the ``this`` pointer, which allows method calls to be chained
+    [[nodiscard]] auto &set_descriptor_set_layouts(std::vector<VkDescriptorSetLayout> descriptor_set_layouts) {
+        if (descriptor_set_layouts.empty()) {
+            throw InexorException("Error: Parameter 'descriptor_set_layouts' is empty!");
+        }
+        m_data.descriptor_set_layouts = std::move(descriptor_set_layouts);
+        return *this;
+    }
+
+    /// Set the compute shader of the compute pipeline
+    /// @param shader The compute shader
+    /// @return A const reference to the ``this`` pointer, which allows method calls to be chained
+    [[nodiscard]] auto &set_shader(std::weak_ptr<Shader> shader) {
+        const auto shader_ref = shader.lock();
+        if (!shader_ref) {
+            throw InexorException("Error: Parameter 'shader' is invalid!");
+        }
+        if (shader_ref->shader_stage() != VK_SHADER_STAGE_COMPUTE_BIT) {
+            throw InexorException("Error: Parameter 'shader' is not a compute shader!");
+        }
+        m_data.shader_stage = tools::make_info<VkPipelineShaderStageCreateInfo>({
+            .stage = shader_ref->shader_stage(),
+            .module = shader_ref->shader_module(),
+            .pName = shader_ref->entry_point().c_str(),
+        });
+        return *this;
+    }
+};
+
+} // namespace inexor::vulkan_renderer::wrapper::pipelines
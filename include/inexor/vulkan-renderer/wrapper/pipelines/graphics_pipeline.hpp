@@ -36,8 +36,6 @@ class PerFrameDescriptorSets;
 
 namespace inexor::vulkan_renderer::wrapper::pipelines {
 
-// TODO: Implement RAII wrapper for ComputePipeline
-
 // Using declaration
 using tools::make_info;
 
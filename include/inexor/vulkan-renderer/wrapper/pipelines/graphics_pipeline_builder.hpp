@@ -41,8 +41,6 @@ namespace inexor::vulkan_renderer::wrapper::pipelines {
 using shaders::Shader;
 using tools::InexorException;
 
-// TODO: ComputePipelineBuilder
-
 /// Builder class for VkPipelineCreateInfo for graphics pipelines which use dynamic rendering
 /// @note This builder pattern does not perform any checks which are already covered by validation layers.
 /// This means if you forget to specify viewport for example, creation of the graphics pipeline will fail.
@@ -22,7 +22,8 @@ class Device;
 
 namespace inexor::vulkan_renderer::wrapper::pipelines {
 
-// Forward declaration
+// Forward declarations
+class ComputePipeline;
 class GraphicsPipeline;
 
 // Using declarations
@@ -35,6 +36,7 @@ class PipelineLayout {
 public:
     // Friend declarations
     friend class RenderGraph;
+    friend class ComputePipeline;
     friend class GraphicsPipeline;
     friend class CommandBuffer;
 
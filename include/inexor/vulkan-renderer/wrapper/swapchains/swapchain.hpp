@@ -16,17 +16,10 @@ namespace inexor::vulkan_renderer::wrapper::core {
 class Device;
 } // namespace inexor::vulkan_renderer::wrapper::core
 
-namespace inexor::vulkan_renderer::wrapper::commands {
-// Forward declaration
-class CommandBuffer;
-class CommandBufferBuilder;
-} // namespace inexor::vulkan_renderer::wrapper::commands
-
 namespace inexor::vulkan_renderer::wrapper::swapchains {
 
 // Using declaration
 using synchronization::Semaphore;
-using wrapper::commands::CommandBufferBuilder;
 using wrapper::core::Device;
 
 /// RAII wrapper class for swapchains
@@ -71,13 +64,11 @@ public:
     /// @exception VulkanException vkAcquireNextImageKHR failed
     [[nodiscard]] VkResult acquire_next_image();
 
-    /// Change the image layout with a pipeline barrier to prepare for rendering
-    /// @param cmd_buf The command buffer used for recording
-    void change_image_layout_to_prepare_for_rendering(CommandBufferBuilder &cmd_buf);
-
-    /// Change the image layout with a pipeline barrier to prepare to call vkQueuePresentKHR
-    /// @param cmd_buf The command buffer used for recording
-    void change_image_layout_to_prepare_for_presenting(CommandBufferBuilder &cmd_buf);
+    /// The image which was acquired by the last call of acquire_next_image()
+    /// @note The layout of the image is managed by rendergraph
+    [[nodiscard]] auto current_swapchain_image() const {
+        return m_current_swapchain_img;
+    }
 
     [[nodiscard]] auto current_swapchain_image_view() const {
         return m_current_swapchain_img_view;
@@ -59,6 +59,18 @@ public:
 
     [[nodiscard]] bool empty() const;
 
+    [[nodiscard]] const std::vector<VkMemoryBarrier2> &memory_barriers() const {
+        return m_memory_barriers;
+    }
+
+    [[nodiscard]] const std::vector<VkBufferMemoryBarrier2> &buffer_barriers() const {
+        return m_buffer_barriers;
+    }
+
+    [[nodiscard]] const std::vector<VkImageMemoryBarrier2> &image_barriers() const {
+        return m_image_barriers;
+    }
+
     /// Flushes only when at least one barrier has been queued.
     void flush_if_not_empty(wrapper::commands::CommandBufferBuilder &cmd_buf);
 
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <volk.h>
+
+#include <cstdint>
+#include <string>
+
+namespace inexor::vulkan_renderer::wrapper::core {
+// Forward declaration
+class Device;
+} // namespace inexor::vulkan_renderer::wrapper::core
+
+namespace inexor::vulkan_renderer::wrapper::synchronization {
+
+/// RAII wrapper class for VkSemaphore of type VK_SEMAPHORE_TYPE_TIMELINE
+/// @note Unlike binary semaphores, a timeline semaphore holds a counter which only ever increases. Submissions signal
+/// it to a value and wait for it to reach a value, so one signal can be waited for any number of times, and the host
+/// can query or wait for the counter without a fence.
+class TimelineSemaphore {
+    const core::Device &m_device;
+    std::string m_name;
+    VkSemaphore m_semaphore{VK_NULL_HANDLE};
+
+public:
+    /// Default constructor
+    /// @param device The const reference to a device RAII wrapper instance.
+    /// @param name The internal debug marker name of the VkSemaphore.
+    /// @param initial_value The initial value of the counter
+    TimelineSemaphore(const core::Device &device, const std::string &name, std::uint64_t initial_value = 0);
+
+    TimelineSemaphore(const TimelineSemaphore &) = delete;
+    TimelineSemaphore(TimelineSemaphore &&) noexcept;
+
+    ~TimelineSemaphore();
+
+    TimelineSemaphore &operator=(const TimelineSemaphore &) = delete;
+    TimelineSemaphore &operator=(TimelineSemaphore &&) = delete;
+
+    [[nodiscard]] auto semaphore() const {
+        return m_semaphore;
+    }
+
+    /// Call vkGetSemaphoreCounterValue
+    [[nodiscard]] std::uint64_t value() const;
+
+    /// Call vkWaitSemaphores
+    /// @param value The value the counter must reach
+    void wait(std::uint64_t value) const;
+};
+
+} // namespace inexor::vulkan_renderer::wrapper::synchronization
@@ -2,6 +2,7 @@
 
 layout (location = 0) in vec3 in_position;
 layout (location = 1) in vec3 in_color;
+layout (location = 2) in float in_occlusion;
 
 layout (binding = 0) uniform UniformBufferObject {
     mat4 model;
@@ -13,5 +14,5 @@ layout (location = 0) out vec3 frag_color;
 
 void main() {
     gl_Position = ubo.proj * ubo.view * ubo.model * vec4(in_position, 1.0);
-    frag_color = in_color;
+    frag_color = in_color * in_occlusion;
 }
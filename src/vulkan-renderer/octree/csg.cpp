@@ -0,0 +1,144 @@
+#include "inexor/vulkan-renderer/octree/csg.hpp"
+
+#include "inexor/vulkan-renderer/octree/cube.hpp"
+#include "inexor/vulkan-renderer/octree/indentation.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+using inexor::vulkan_renderer::octree::CsgOperation;
+using inexor::vulkan_renderer::octree::Cube;
+using inexor::vulkan_renderer::octree::Indentation;
+
+/// The homogeneous type which is closest to a Type::NORMAL cube.
+Cube::Type round_to_homogeneous(const Cube &cube) {
+    return cube.fill_ratio() >= 0.5f ? Cube::Type::SOLID : Cube::Type::EMPTY;
+}
+
+/// Replace the target with a copy of the brush.
+void copy_cube(Cube &target, const Cube &brush) {
+    target.set_type_without_simplify(brush.type());
+    if (brush.type() == Cube::Type::NORMAL) {
+        target.set_indentations(brush.indentations());
+        return;
+    }
+    if (brush.type() == Cube::Type::OCTANT) {
+        for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+            copy_cube(*target.children()[idx], *brush.children()[idx]);
+        }
+    }
+}
+
+/// Combine two Type::NORMAL cubes edge by edge.
+void merge_indentations(Cube &target, const Cube &brush, const CsgOperation operation) {
+    auto indentations = target.indentations();
+    const auto brush_indentations = brush.indentations();
+    for (std::size_t idx = 0; idx < Cube::EDGES; idx++) {
+        const auto &lhs = indentations[idx];
+        const auto &rhs = brush_indentations[idx];
+        if (operation == CsgOperation::UNION) {
+            indentations[idx] = Indentation(std::min(lhs.start(), rhs.start()), std::max(lhs.end_abs(), rhs.end_abs()));
+        } else {
+            const auto start = std::max(lhs.start(), rhs.start());
+            const auto end = std::min(lhs.end_abs(), rhs.end_abs());
+            indentations[idx] = Indentation(start, std::max(start, end));
+        }
+    }
+    target.set_indentations(indentations);
+    if (target.fill_ratio() == 0.0f) {
+        target.set_type_without_simplify(Cube::Type::EMPTY);
+    }
+}
+
+void merge(Cube &target, const Cube &brush, const CsgOperation operation) {
+    // A Type::NORMAL cube can't be combined with an octant exactly, so it is rounded first.
+    if (target.type() == Cube::Type::NORMAL && brush.type() == Cube::Type::OCTANT) {
+        target.set_type_without_simplify(round_to_homogeneous(target));
+    }
+    Cube::Type brush_type = brush.type();
+    if (brush_type == Cube::Type::NORMAL && target.type() == Cube::Type::OCTANT) {
+        brush_type = round_to_homogeneous(brush);
+    }
+    const Cube::Type target_type = target.type();
+
+    switch (operation) {
+    case CsgOperation::UNION:
+        if (brush_type == Cube::Type::EMPTY || target_type == Cube::Type::SOLID) {
+            return;
+        }
+        if (brush_type == Cube::Type::SOLID) {
+            target.set_type_without_simplify(Cube::Type::SOLID);
+            return;
+        }
+        if (target_type == Cube::Type::EMPTY) {
+            copy_cube(target, brush);
+            return;
+        }
+        if (target_type == Cube::Type::NORMAL) {
+            merge_indentations(target, brush, operation);
+            return;
+        }
+        break;
+    case CsgOperation::SUBTRACT:
+        if (brush_type == Cube::Type::EMPTY || target_type == Cube::Type::EMPTY) {
+            return;
+        }
+        if (brush_type == Cube::Type::SOLID) {
+            target.set_type_without_simplify(Cube::Type::EMPTY);
+            return;
+        }
+        if (brush_type == Cube::Type::NORMAL) {
+            // The complement of a Type::NORMAL cube can't be represented.
+            if (round_to_homogeneous(brush) == Cube::Type::SOLID) {
+                target.set_type_without_simplify(Cube::Type::EMPTY);
+            }
+            return;
+        }
+        if (target_type == Cube::Type::SOLID) {
+            // Carve the brush out of a solid cube
+            target.set_type_without_simplify(Cube::Type::OCTANT);
+            for (const auto &child : target.children()) {
+                child->set_type_without_simplify(Cube::Type::SOLID);
+            }
+        }
+        break;
+    case CsgOperation::INTERSECT:
+        if (brush_type == Cube::Type::SOLID || target_type == Cube::Type::EMPTY) {
+            return;
+        }
+        if (brush_type == Cube::Type::EMPTY) {
+            target.set_type_without_simplify(Cube::Type::EMPTY);
+            return;
+        }
+        if (target_type == Cube::Type::SOLID) {
+            copy_cube(target, brush);
+            return;
+        }
+        if (target_type == Cube::Type::NORMAL) {
+            merge_indentations(target, brush, operation);
+            return;
+        }
+        break;
+    }
+
+    // Both cubes are octants
+    for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+        merge(*target.children()[idx], *brush.children()[idx], operation);
+    }
+}
+
+} // namespace
+
+namespace inexor::vulkan_renderer::octree {
+
+void apply_csg(Cube &target, const Cube &brush, const CsgOperation operation) {
+    if (target.size() != brush.size() || target.position() != brush.position()) {
+        throw std::invalid_argument("Error: Brush and target must have the same size and position!");
+    }
+    merge(target, brush, operation);
+    target.simplify_recursive();
+}
+
+} // namespace inexor::vulkan_renderer::octree
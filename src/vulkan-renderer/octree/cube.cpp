@@ -129,6 +129,35 @@ std::shared_ptr<Cube> create_random_world(std::uint32_t max_depth, const glm::ve
     return cube;
 }
 
+float Cube::fill_ratio() const noexcept {
+    switch (m_type) {
+    case Type::SOLID:
+        return 1.0f;
+    case Type::NORMAL: {
+        // Average the covered fraction of the four edges along each axis and multiply the three axes.
+        float ratio = 1.0f;
+        for (const auto &axis : {RotationAxis::X, RotationAxis::Y, RotationAxis::Z}) {
+            // The last array of the edge rotation contains the edges which are parallel to the rotation axis.
+            std::size_t covered_steps = 0;
+            for (const auto edge_id : std::get<1>(axis)[2]) {
+                covered_steps += m_indentations[edge_id].offset();
+            }
+            ratio *= static_cast<float>(covered_steps) / static_cast<float>(4 * Indentation::MAX);
+        }
+        return ratio;
+    }
+    case Type::OCTANT: {
+        float ratio = 0.0f;
+        for (const auto &child : m_children) {
+            ratio += child->fill_ratio();
+        }
+        return ratio / static_cast<float>(SUB_CUBES);
+    }
+    default:
+        return 0.0f;
+    }
+}
+
 std::size_t Cube::grid_level() const noexcept {
     std::size_t level = 0;
     std::shared_ptr<Cube> parent = m_parent.lock();
@@ -257,8 +286,11 @@ std::shared_ptr<Cube> Cube::neighbor(const Axis axis, const NeighborDirection di
 
 void Cube::remove_children() {
     for (auto &child : m_children) {
-        child->remove_children();
-        child.reset();
+        // Only octants have children
+        if (child) {
+            child->remove_children();
+            child.reset();
+        }
     }
 }
 
@@ -400,7 +432,28 @@ void Cube::set_indent(const std::uint8_t edge_id, Indentation indentation) {
     m_indentations[edge_id] = indentation;
 }
 
+void Cube::set_indentations(const std::array<Indentation, Cube::EDGES> &indentations) {
+    if (m_type != Type::NORMAL) {
+        return;
+    }
+    m_indentations = indentations;
+    m_polygon_cache_valid = false;
+}
+
 void Cube::set_type(const Type new_type) {
+    if (m_type == new_type) {
+        return;
+    }
+    set_type_without_simplify(new_type);
+    // If the cube is now EMPTY or SOLID, notify the parent to evaluate if it can be simplified.
+    if ((m_type == Type::EMPTY || m_type == Type::SOLID) && !is_root()) {
+        if (auto parent = m_parent.lock()) {
+            parent->simplify();
+        }
+    }
+}
+
+void Cube::set_type_without_simplify(const Type new_type) {
     if (m_type == new_type) {
         return;
     }
@@ -435,7 +488,28 @@ void Cube::set_type(const Type new_type) {
     }
     m_polygon_cache_valid = false;
     m_type = new_type;
-    // If the cube is now EMPTY or SOLID, notify the parent to evaluate if it can be simplified.
+}
+
+void Cube::simplify() {
+    if (m_type != Type::OCTANT) {
+        return;
+    }
+    const Type first_child_type = m_children[0]->type();
+    if (first_child_type != Type::EMPTY && first_child_type != Type::SOLID) {
+        return;
+    }
+    for (const auto &child : m_children) {
+        if (!child || child->type() != first_child_type) {
+            return;
+        }
+    }
+    // All children are identical and collapsable (EMPTY or SOLID).
+    set_type(first_child_type);
+}
+
+void Cube::simplify_recursive() {
+    simplify_subtree();
+    // Like set_type, notify the parent if this cube has been collapsed.
     if ((m_type == Type::EMPTY || m_type == Type::SOLID) && !is_root()) {
         if (auto parent = m_parent.lock()) {
             parent->simplify();
@@ -443,21 +517,24 @@ void Cube::set_type(const Type new_type) {
     }
 }
 
-void Cube::simplify() {
+void Cube::simplify_subtree() {
     if (m_type != Type::OCTANT) {
         return;
     }
+    // post-order traversal, so every octant only has to look at its direct children
+    for (const auto &child : m_children) {
+        child->simplify_subtree();
+    }
     const Type first_child_type = m_children[0]->type();
     if (first_child_type != Type::EMPTY && first_child_type != Type::SOLID) {
         return;
     }
     for (const auto &child : m_children) {
-        if (!child || child->type() != first_child_type) {
+        if (child->type() != first_child_type) {
             return;
         }
     }
-    // All children are identical and collapsable (EMPTY or SOLID).
-    set_type(first_child_type);
+    set_type_without_simplify(first_child_type);
 }
 
 Cube::Type Cube::type() const noexcept {
@@ -0,0 +1,93 @@
+#include "inexor/vulkan-renderer/octree/lod.hpp"
+
+#include "inexor/vulkan-renderer/octree/cube.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+using inexor::vulkan_renderer::octree::Cube;
+using inexor::vulkan_renderer::octree::LodHeuristic;
+
+/// The fraction of the cube's volume which votes for Type::SOLID.
+float solid_vote(const Cube &cube) {
+    switch (cube.type()) {
+    case Cube::Type::SOLID:
+        return 1.0f;
+    case Cube::Type::NORMAL:
+        return cube.fill_ratio() >= 0.5f ? 1.0f : 0.0f;
+    case Cube::Type::OCTANT: {
+        float vote = 0.0f;
+        for (const auto &child : cube.children()) {
+            vote += solid_vote(*child);
+        }
+        return vote / static_cast<float>(Cube::SUB_CUBES);
+    }
+    default:
+        return 0.0f;
+    }
+}
+
+Cube::Type representative_type(const Cube &cube, const LodHeuristic heuristic, const float coverage_threshold) {
+    switch (heuristic) {
+    case LodHeuristic::MAJORITY_TYPE:
+        return solid_vote(cube) >= 0.5f ? Cube::Type::SOLID : Cube::Type::EMPTY;
+    case LodHeuristic::COVERAGE:
+        return cube.fill_ratio() >= coverage_threshold ? Cube::Type::SOLID : Cube::Type::EMPTY;
+    }
+    return Cube::Type::EMPTY;
+}
+
+void copy_with_lod(Cube &target, const Cube &source, const std::uint32_t depth, const LodHeuristic heuristic,
+                   const float coverage_threshold) {
+    switch (source.type()) {
+    case Cube::Type::EMPTY:
+        return;
+    case Cube::Type::SOLID:
+        target.set_type_without_simplify(Cube::Type::SOLID);
+        return;
+    case Cube::Type::NORMAL:
+        target.set_type_without_simplify(Cube::Type::NORMAL);
+        target.set_indentations(source.indentations());
+        return;
+    case Cube::Type::OCTANT:
+        break;
+    }
+    if (depth == 0) {
+        target.set_type_without_simplify(representative_type(source, heuristic, coverage_threshold));
+        return;
+    }
+    target.set_type_without_simplify(Cube::Type::OCTANT);
+    for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+        copy_with_lod(*target.children()[idx], *source.children()[idx], depth - 1, heuristic, coverage_threshold);
+    }
+}
+
+} // namespace
+
+namespace inexor::vulkan_renderer::octree {
+
+std::uint32_t octree_depth(const Cube &cube) noexcept {
+    if (cube.type() != Cube::Type::OCTANT) {
+        return 0;
+    }
+    std::uint32_t depth = 0;
+    for (const auto &child : cube.children()) {
+        depth = std::max(depth, octree_depth(*child));
+    }
+    return depth + 1;
+}
+
+std::shared_ptr<Cube> create_lod(const Cube &cube, const std::uint32_t depth, const LodHeuristic heuristic,
+                                 const float coverage_threshold) {
+    if (coverage_threshold <= 0.0f || coverage_threshold > 1.0f) {
+        throw std::invalid_argument("Error: Parameter 'coverage_threshold' must be in (0, 1]!");
+    }
+    auto lod = std::make_shared<Cube>(cube.size(), cube.position());
+    copy_with_lod(*lod, cube, depth, heuristic, coverage_threshold);
+    lod->simplify_recursive();
+    return lod;
+}
+
+} // namespace inexor::vulkan_renderer::octree
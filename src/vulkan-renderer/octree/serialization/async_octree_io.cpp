@@ -0,0 +1,116 @@
+#include "inexor/vulkan-renderer/octree/serialization/async_octree_io.hpp"
+
+#include "inexor/vulkan-renderer/octree/cube.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+
+#include <utility>
+
+namespace inexor::vulkan_renderer::serialization {
+
+AsyncOctreeIO::AsyncOctreeIO(tools::ThreadPool &thread_pool, NXOCParser parser, FileWriteOptions write_options)
+    : m_thread_pool(thread_pool), m_parser(std::move(parser)), m_write_options(write_options) {}
+
+AsyncOctreeIO::~AsyncOctreeIO() {
+    // The tasks use the parser and the completion queue
+    wait();
+}
+
+template <typename Task>
+auto AsyncOctreeIO::run(Task task) {
+    {
+        std::scoped_lock lock(m_mutex);
+        m_pending_tasks++;
+    }
+    return m_thread_pool.submit([this, task = std::move(task)]() mutable {
+        // The task is finished even if it throws
+        struct FinishTask {
+            AsyncOctreeIO &io;
+            explicit FinishTask(AsyncOctreeIO &io) : io(io) {}
+            FinishTask(const FinishTask &) = delete;
+            FinishTask(FinishTask &&) = delete;
+            ~FinishTask() {
+                // Notify with the lock held, because the destructor may destroy the condition variable right after
+                std::scoped_lock lock(io.m_mutex);
+                io.m_pending_tasks--;
+                io.m_finished.notify_all();
+            }
+            FinishTask &operator=(const FinishTask &) = delete;
+            FinishTask &operator=(FinishTask &&) = delete;
+        } finish_task(*this);
+        return task();
+    });
+}
+
+template <typename Task, typename Callback>
+void AsyncOctreeIO::run_with_callback(Task task, Callback callback) {
+    // The future is not needed because the result is passed to the callback
+    static_cast<void>(run([this, task = std::move(task), callback = std::move(callback)]() mutable {
+        decltype(task()) result{};
+        std::exception_ptr exception;
+        try {
+            result = task();
+        } catch (...) {
+            exception = std::current_exception();
+        }
+        std::scoped_lock lock(m_mutex);
+        m_completions.emplace_back([callback = std::move(callback), result = std::move(result), exception]() {
+            callback(result, exception);
+        });
+    }));
+}
+
+std::future<std::shared_ptr<octree::Cube>> AsyncOctreeIO::load(std::filesystem::path path,
+                                                               NXOCParser::SubtreeFilter filter) {
+    return run([this, path = std::move(path), filter = std::move(filter)]() {
+        return m_parser.deserialize(ByteStream(path), filter);
+    });
+}
+
+void AsyncOctreeIO::load(std::filesystem::path path, LoadCallback callback, NXOCParser::SubtreeFilter filter) {
+    run_with_callback(
+        [this, path = std::move(path), filter = std::move(filter)]() {
+            return m_parser.deserialize(ByteStream(path), filter);
+        },
+        std::move(callback));
+}
+
+std::future<std::size_t> AsyncOctreeIO::save(std::shared_ptr<const octree::Cube> cube, const std::uint32_t version,
+                                             std::filesystem::path path) {
+    return run([this, cube = std::move(cube), version, path = std::move(path)]() {
+        return m_parser.serialize(cube, version, path, m_write_options);
+    });
+}
+
+void AsyncOctreeIO::save(std::shared_ptr<const octree::Cube> cube, const std::uint32_t version,
+                         std::filesystem::path path, SaveCallback callback) {
+    run_with_callback(
+        [this, cube = std::move(cube), version, path = std::move(path)]() {
+            return m_parser.serialize(cube, version, path, m_write_options);
+        },
+        std::move(callback));
+}
+
+std::size_t AsyncOctreeIO::poll() {
+    std::vector<std::function<void()>> completions;
+    {
+        std::scoped_lock lock(m_mutex);
+        completions.swap(m_completions);
+    }
+    // The callbacks run without the lock, so they can submit new tasks
+    for (const auto &completion : completions) {
+        completion();
+    }
+    return completions.size();
+}
+
+std::size_t AsyncOctreeIO::pending_tasks() {
+    std::scoped_lock lock(m_mutex);
+    return m_pending_tasks;
+}
+
+void AsyncOctreeIO::wait() {
+    std::unique_lock lock(m_mutex);
+    m_finished.wait(lock, [&]() { return m_pending_tasks == 0; });
+}
+
+} // namespace inexor::vulkan_renderer::serialization
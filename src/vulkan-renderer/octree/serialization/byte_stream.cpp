@@ -1,60 +1,93 @@
 #include "inexor/vulkan-renderer/octree/serialization/byte_stream.hpp"
 
 #include "inexor/vulkan-renderer/octree/cube.hpp"
+#include "inexor/vulkan-renderer/tools/memory_mapped_file.hpp"
 
-#include <fstream>
+#include <algorithm>
+#include <cstdio>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
 
-namespace inexor::vulkan_renderer::serialization {
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#define INEXOR_BYTE_STREAM_POSIX
+#endif
 
-std::vector<std::uint8_t> ByteStream::read_file(const std::filesystem::path &path) {
-    std::ifstream stream(path, std::ios::in | std::ios::binary);
-    return {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
-}
+namespace inexor::vulkan_renderer::serialization {
 
 ByteStream::ByteStream(std::vector<std::uint8_t> buffer) : m_buffer(std::move(buffer)) {}
 
-ByteStream::ByteStream(const std::filesystem::path &path) : ByteStream(read_file(path)) {}
+ByteStream::ByteStream(const std::filesystem::path &path)
+    : m_file(std::make_shared<const tools::MemoryMappedFile>(path)) {}
 
-const std::vector<std::uint8_t> &ByteStream::buffer() const {
+std::span<const std::uint8_t> ByteStream::data() const {
+    if (m_file) {
+        return m_file->data();
+    }
     return m_buffer;
 }
 
 std::size_t ByteStream::size() const {
-    return m_buffer.size();
+    return data().size();
+}
+
+bool ByteStream::is_memory_mapped() const {
+    return m_file && m_file->is_mapped();
+}
+
+bool ByteStream::operator==(const ByteStream &rhs) const {
+    return std::ranges::equal(data(), rhs.data());
 }
 
 void ByteStreamReader::check_end(const std::size_t size) const {
-    if (static_cast<std::size_t>(std::distance(m_iter, m_stream.buffer().end())) < size) {
+    if (m_data.size() - m_position < size) {
         throw std::runtime_error("Error: end of byte stream would be overrun");
     }
 }
 
-ByteStreamReader::ByteStreamReader(const ByteStream &stream) : m_stream(stream), m_iter(stream.buffer().begin()) {}
+ByteStreamReader::ByteStreamReader(const ByteStream &stream) : m_data(stream.data()) {}
+
+ByteStreamReader::ByteStreamReader(const std::span<const std::uint8_t> data) : m_data(data) {}
 
 void ByteStreamReader::skip(const std::size_t size) {
-    const std::size_t skip = std::min(
-        size, std::size_t(std::distance<std::vector<std::uint8_t>::const_iterator>(m_iter, m_stream.buffer().end())));
-    std::advance(m_iter, skip);
+    m_position += std::min(size, m_data.size() - m_position);
 }
 
 template <>
 std::uint8_t ByteStreamReader::read() {
     check_end(1);
-    return *m_iter++;
+    return m_data[m_position++];
 }
 
 template <>
 std::uint32_t ByteStreamReader::read() {
     check_end(4);
-    return (*m_iter++ << 0u) | (*m_iter++ << 8u) | (*m_iter++ << 16u) | (*m_iter++ << 24u);
+    const auto *bytes = m_data.data() + m_position;
+    m_position += 4;
+    // Little endian
+    return static_cast<std::uint32_t>(bytes[0]) | (static_cast<std::uint32_t>(bytes[1]) << 8u) |
+           (static_cast<std::uint32_t>(bytes[2]) << 16u) | (static_cast<std::uint32_t>(bytes[3]) << 24u);
 }
 
 template <>
 std::string ByteStreamReader::read(const std::size_t &size) {
     check_end(size);
-    auto start = m_iter;
-    std::advance(m_iter, size);
-    return {start, m_iter};
+    const auto *start = reinterpret_cast<const char *>(m_data.data() + m_position);
+    m_position += size;
+    return {start, size};
+}
+
+template <>
+std::span<const std::uint8_t> ByteStreamReader::read(const std::size_t &size) {
+    check_end(size);
+    const auto view = m_data.subspan(m_position, size);
+    m_position += size;
+    return view;
 }
 
 template <>
@@ -67,36 +100,280 @@ std::array<octree::Indentation, 12> ByteStreamReader::read() {
     check_end(9);
     std::array<octree::Indentation, 12> indentations;
     auto writer = indentations.begin(); // NOLINT
-    const auto end = m_iter + 9;
-    while (m_iter != end) {
-        *writer++ = octree::Indentation(*m_iter >> 2u);
-        *writer++ = octree::Indentation(((*m_iter & 0b00000011u) << 4u) | (*(++m_iter) >> 4u));
-        *writer++ = octree::Indentation(((*m_iter & 0b00001111u) << 2u) | (*(++m_iter) >> 6u));
-        *writer++ = octree::Indentation(*m_iter++ & 0b00111111u);
+    const auto *iter = m_data.data() + m_position;
+    const auto *end = iter + 9;
+    while (iter != end) {
+        *writer++ = octree::Indentation(*iter >> 2u);
+        *writer++ = octree::Indentation(((*iter & 0b00000011u) << 4u) | (*(++iter) >> 4u));
+        *writer++ = octree::Indentation(((*iter & 0b00001111u) << 2u) | (*(++iter) >> 6u));
+        *writer++ = octree::Indentation(*iter++ & 0b00111111u);
     }
+    m_position += 9;
     return indentations;
 }
 
 std::size_t ByteStreamReader::remaining() const {
-    return std::distance<std::vector<std::uint8_t>::const_iterator>(m_iter, m_stream.buffer().end());
+    return m_data.size() - m_position;
+}
+
+std::size_t ByteStreamReader::position() const {
+    return m_position;
+}
+
+/// Writes the buffer of a ByteStreamWriter into a file. The bytes are written into a temporary file next to it, which
+/// replaces the file in finish(), so a failed write keeps the old file, and streams which map the old file stay valid.
+class ByteStreamWriter::FileSink {
+private:
+    std::filesystem::path m_path;
+    std::filesystem::path m_temporary_path;
+    bool m_sync{false};
+    /// Whether the temporary file has replaced the file
+    bool m_renamed{false};
+    /// The number of bytes which have been passed to write
+    std::size_t m_size{0};
+#ifdef INEXOR_BYTE_STREAM_POSIX
+    int m_file{-1};
+    bool m_direct_io{false};
+    /// O_DIRECT needs block aligned memory, offsets, and sizes, so the bytes are collected in an aligned buffer
+    std::uint8_t *m_aligned_buffer{nullptr};
+    std::size_t m_aligned_capacity{0};
+    std::size_t m_aligned_size{0};
+
+    void write_all(const std::uint8_t *data, std::size_t size) {
+        while (size > 0) {
+            const auto written = ::write(m_file, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("Error: Could not write file " + m_path.string() + "!");
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+#else
+    std::FILE *m_file{nullptr};
+#endif
+
+public:
+    FileSink(const std::filesystem::path &path, const FileWriteOptions &options)
+        : m_path(path), m_temporary_path(path.string() + ".tmp"), m_sync(options.sync) {
+#ifdef INEXOR_BYTE_STREAM_POSIX
+        constexpr int FLAGS = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+#ifdef O_DIRECT
+        if (options.direct_io) {
+            m_file = ::open(m_temporary_path.c_str(), FLAGS | O_DIRECT, 0644);
+            m_direct_io = m_file != -1;
+        }
+#endif
+        if (m_file == -1) {
+            m_file = ::open(m_temporary_path.c_str(), FLAGS, 0644);
+        }
+        if (m_file == -1) {
+            throw std::runtime_error("Error: Could not open file " + path.string() + "!");
+        }
+        if (m_direct_io) {
+            m_aligned_capacity = (std::max(options.buffer_size, DIRECT_IO_ALIGNMENT) + DIRECT_IO_ALIGNMENT - 1) /
+                                 DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+            m_aligned_buffer = static_cast<std::uint8_t *>(
+                ::operator new(m_aligned_capacity, std::align_val_t{DIRECT_IO_ALIGNMENT}));
+        }
+#else
+        m_file = std::fopen(m_temporary_path.string().c_str(), "wb");
+        if (m_file == nullptr) {
+            throw std::runtime_error("Error: Could not open file " + path.string() + "!");
+        }
+        // The writer buffers already
+        std::setvbuf(m_file, nullptr, _IONBF, 0);
+#endif
+    }
+
+    FileSink(const FileSink &) = delete;
+    FileSink(FileSink &&) = delete;
+
+    ~FileSink() {
+#ifdef INEXOR_BYTE_STREAM_POSIX
+        if (m_file != -1) {
+            ::close(m_file);
+        }
+        if (m_aligned_buffer != nullptr) {
+            ::operator delete(m_aligned_buffer, std::align_val_t{DIRECT_IO_ALIGNMENT});
+        }
+#else
+        if (m_file != nullptr) {
+            std::fclose(m_file);
+        }
+#endif
+        if (!m_renamed) {
+            std::error_code error;
+            std::filesystem::remove(m_temporary_path, error);
+        }
+    }
+
+    FileSink &operator=(const FileSink &) = delete;
+    FileSink &operator=(FileSink &&) = delete;
+
+    /// The block size which O_DIRECT requires for memory, offsets, and sizes.
+    static constexpr std::size_t DIRECT_IO_ALIGNMENT{4096};
+
+    void write(std::span<const std::uint8_t> data) {
+        m_size += data.size();
+#ifdef INEXOR_BYTE_STREAM_POSIX
+        if (!m_direct_io) {
+            write_all(data.data(), data.size());
+            return;
+        }
+        while (!data.empty()) {
+            const auto size = std::min(data.size(), m_aligned_capacity - m_aligned_size);
+            std::copy_n(data.begin(), size, m_aligned_buffer + m_aligned_size);
+            m_aligned_size += size;
+            data = data.subspan(size);
+            if (m_aligned_size == m_aligned_capacity) {
+                write_all(m_aligned_buffer, m_aligned_size);
+                m_aligned_size = 0;
+            }
+        }
+#else
+        if (std::fwrite(data.data(), 1, data.size(), m_file) != data.size()) {
+            throw std::runtime_error("Error: Could not write file " + m_path.string() + "!");
+        }
+#endif
+    }
+
+    void finish() {
+#ifdef INEXOR_BYTE_STREAM_POSIX
+        if (m_direct_io && m_aligned_size > 0) {
+            // The last block is padded, and the padding is cut off afterwards
+            const auto padded_size =
+                (m_aligned_size + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+            std::fill(m_aligned_buffer + m_aligned_size, m_aligned_buffer + padded_size, std::uint8_t{0});
+            write_all(m_aligned_buffer, padded_size);
+            m_aligned_size = 0;
+            if (::ftruncate(m_file, static_cast<off_t>(m_size)) != 0) {
+                throw std::runtime_error("Error: Could not write file " + m_path.string() + "!");
+            }
+        }
+        if (m_sync && ::fsync(m_file) != 0) {
+            throw std::runtime_error("Error: Could not flush file " + m_path.string() + "!");
+        }
+        const int file = std::exchange(m_file, -1);
+        if (::close(file) != 0) {
+            throw std::runtime_error("Error: Could not close file " + m_path.string() + "!");
+        }
+#else
+        // There is no portable way to flush the file to the disk, so sync only flushes the C library
+        if (m_sync && std::fflush(m_file) != 0) {
+            throw std::runtime_error("Error: Could not flush file " + m_path.string() + "!");
+        }
+        if (std::fclose(std::exchange(m_file, nullptr)) != 0) {
+            throw std::runtime_error("Error: Could not close file " + m_path.string() + "!");
+        }
+#endif
+        std::error_code error;
+        std::filesystem::rename(m_temporary_path, m_path, error);
+        if (error) {
+            throw std::runtime_error("Error: Could not replace file " + m_path.string() + ": " + error.message());
+        }
+        m_renamed = true;
+    }
+};
+
+ByteStreamWriter::ByteStreamWriter() = default;
+
+ByteStreamWriter::ByteStreamWriter(std::vector<std::uint8_t> buffer) : ByteStream(std::move(buffer)) {}
+
+ByteStreamWriter::ByteStreamWriter(const std::filesystem::path &path, const FileWriteOptions &options)
+    : m_sink(std::make_unique<FileSink>(path, options)), m_buffer_size(std::max<std::size_t>(options.buffer_size, 1)) {
+    m_buffer.reserve(m_buffer_size);
+}
+
+ByteStreamWriter::ByteStreamWriter(const std::size_t buffer_size, FlushCallback on_flush)
+    : m_on_flush(std::move(on_flush)), m_buffer_size(std::max<std::size_t>(buffer_size, 1)) {
+    m_buffer.reserve(m_buffer_size);
+}
+
+ByteStreamWriter::ByteStreamWriter(ByteStreamWriter &&) noexcept = default;
+
+ByteStreamWriter::~ByteStreamWriter() = default;
+
+ByteStreamWriter &ByteStreamWriter::operator=(ByteStreamWriter &&) noexcept = default;
+
+void ByteStreamWriter::append(const std::uint8_t value) {
+    m_buffer.push_back(value);
+    if (m_buffer_size > 0 && m_buffer.size() >= m_buffer_size) {
+        flush();
+    }
+}
+
+void ByteStreamWriter::append(std::span<const std::uint8_t> values) {
+    if (m_buffer_size == 0) {
+        m_buffer.insert(m_buffer.end(), values.begin(), values.end());
+        return;
+    }
+    // Fill the buffer without growing it
+    while (!values.empty()) {
+        const auto size = std::min(values.size(), m_buffer_size - m_buffer.size());
+        m_buffer.insert(m_buffer.end(), values.begin(), values.begin() + static_cast<std::ptrdiff_t>(size));
+        values = values.subspan(size);
+        if (m_buffer.size() >= m_buffer_size) {
+            flush();
+        }
+    }
+}
+
+void ByteStreamWriter::flush() {
+    if (m_buffer.empty()) {
+        return;
+    }
+    if (m_sink) {
+        m_sink->write(m_buffer);
+    } else {
+        m_on_flush(m_buffer);
+    }
+    m_flushed_size += m_buffer.size();
+    m_buffer.clear();
+}
+
+std::size_t ByteStreamWriter::bytes_written() const {
+    return m_flushed_size + m_buffer.size();
+}
+
+void ByteStreamWriter::finish() {
+    if (m_buffer_size == 0) {
+        return;
+    }
+    flush();
+    m_buffer_size = 0;
+    m_on_flush = nullptr;
+    if (m_sink) {
+        m_sink->finish();
+        m_sink.reset();
+    }
 }
 
 template <>
 void ByteStreamWriter::write(const std::uint8_t &value) {
-    m_buffer.emplace_back(value);
+    append(value);
 }
 
 template <>
 void ByteStreamWriter::write(const std::uint32_t &value) {
-    m_buffer.emplace_back(value >> 24u);
-    m_buffer.emplace_back(value >> 16u);
-    m_buffer.emplace_back(value >> 8u);
-    m_buffer.emplace_back(value);
+    // Little endian like ByteStreamReader::read<std::uint32_t>
+    const std::array<std::uint8_t, 4> bytes{static_cast<std::uint8_t>(value), static_cast<std::uint8_t>(value >> 8u),
+                                            static_cast<std::uint8_t>(value >> 16u),
+                                            static_cast<std::uint8_t>(value >> 24u)};
+    append(bytes);
 }
 
 template <>
 void ByteStreamWriter::write(const std::string &value) {
-    std::copy(value.begin(), value.end(), std::back_inserter(m_buffer));
+    append({reinterpret_cast<const std::uint8_t *>(value.data()), value.size()});
+}
+
+template <>
+void ByteStreamWriter::write(const std::span<const std::uint8_t> &value) {
+    append(value);
 }
 
 template <>
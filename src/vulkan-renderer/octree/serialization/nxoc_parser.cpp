@@ -2,88 +2,511 @@
 
 #include "inexor/vulkan-renderer/octree/cube.hpp"
 #include "inexor/vulkan-renderer/octree/serialization/byte_stream.hpp"
+#include "inexor/vulkan-renderer/tools/lz_codec.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
 
 namespace inexor::vulkan_renderer::serialization {
 
+namespace {
+
+constexpr std::size_t IDENTIFIER_SIZE{13};
+const std::string IDENTIFIER{"Inexor Octree"};
+/// The size of the packed indentations of a normal cube
+constexpr std::size_t INDENTATIONS_SIZE{9};
+
+/// Collect the roots of the subtrees of version 1 in pre-order, which are the cubes at the subtree depth.
+void collect_subtrees(const std::shared_ptr<octree::Cube> &cube, const std::uint32_t depth,
+                      const std::uint32_t subtree_depth, std::vector<std::shared_ptr<octree::Cube>> &subtrees) {
+    if (depth == subtree_depth) {
+        subtrees.push_back(cube);
+        return;
+    }
+    if (cube->type() == octree::Cube::Type::OCTANT) {
+        for (const auto &child : cube->children()) {
+            collect_subtrees(child, depth + 1, subtree_depth, subtrees);
+        }
+    }
+}
+
+} // namespace
+
+NXOCParser::NXOCParser(const std::uint32_t subtree_depth, const Compression compression)
+    : m_subtree_depth(subtree_depth), m_compression(compression) {
+    if (m_subtree_depth > std::numeric_limits<std::uint8_t>::max()) {
+        throw std::invalid_argument("Error: Parameter 'subtree_depth' must not be greater than 255!");
+    }
+}
+
+void NXOCParser::decode_cube(ByteStreamReader &reader, const std::shared_ptr<octree::Cube> &cube) {
+    // The parent is not simplified while decoding, so that different subtrees can be decoded in parallel
+    cube->set_type_without_simplify(reader.read<octree::Cube::Type>());
+    if (cube->type() == octree::Cube::Type::OCTANT) {
+        for (const auto &child : cube->children()) {
+            decode_cube(reader, child);
+        }
+        return;
+    }
+    if (cube->type() == octree::Cube::Type::NORMAL) {
+        cube->m_indentations = reader.read<std::array<octree::Indentation, octree::Cube::EDGES>>();
+    }
+}
+
+std::size_t NXOCParser::encoded_size(const std::shared_ptr<const octree::Cube> &cube) {
+    if (cube->type() == octree::Cube::Type::OCTANT) {
+        std::size_t size{1};
+        for (const auto &child : cube->children()) {
+            size += encoded_size(child);
+        }
+        return size;
+    }
+    return cube->type() == octree::Cube::Type::NORMAL ? 1 + INDENTATIONS_SIZE : 1;
+}
+
+void NXOCParser::encode_cube(ByteStreamWriter &writer, const std::shared_ptr<const octree::Cube> &cube) {
+    writer.write(cube->type());
+    if (cube->type() == octree::Cube::Type::OCTANT) {
+        for (const auto &child : cube->children()) {
+            encode_cube(writer, child);
+        }
+        return;
+    }
+    if (cube->type() == octree::Cube::Type::NORMAL) {
+        writer.write(cube->indentations());
+    }
+}
+
+void NXOCParser::decode_top_cubes(ByteStreamReader &reader, const std::shared_ptr<octree::Cube> &cube,
+                                  const std::uint32_t depth, const std::uint32_t subtree_depth,
+                                  std::vector<std::shared_ptr<octree::Cube>> &subtrees) {
+    if (depth == subtree_depth) {
+        subtrees.push_back(cube);
+        return;
+    }
+    cube->set_type_without_simplify(reader.read<octree::Cube::Type>());
+    if (cube->type() == octree::Cube::Type::OCTANT) {
+        for (const auto &child : cube->children()) {
+            decode_top_cubes(reader, child, depth + 1, subtree_depth, subtrees);
+        }
+        return;
+    }
+    if (cube->type() == octree::Cube::Type::NORMAL) {
+        cube->m_indentations = reader.read<std::array<octree::Indentation, octree::Cube::EDGES>>();
+    }
+}
+
+void NXOCParser::encode_top_cubes(ByteStreamWriter &writer, const std::shared_ptr<const octree::Cube> &cube,
+                                  const std::uint32_t depth, const std::uint32_t subtree_depth,
+                                  std::vector<std::shared_ptr<const octree::Cube>> &subtrees) {
+    if (depth == subtree_depth) {
+        subtrees.push_back(cube);
+        return;
+    }
+    writer.write(cube->type());
+    if (cube->type() == octree::Cube::Type::OCTANT) {
+        for (const auto &child : cube->children()) {
+            encode_top_cubes(writer, child, depth + 1, subtree_depth, subtrees);
+        }
+        return;
+    }
+    if (cube->type() == octree::Cube::Type::NORMAL) {
+        writer.write(cube->indentations());
+    }
+}
+
+NXOCParser::SubtreeTable NXOCParser::read_subtree_table(const ByteStream &stream, const std::uint32_t version) {
+    ByteStreamReader reader(stream);
+    // Skip identifier and version, which are already checked.
+    reader.skip(IDENTIFIER_SIZE + 4);
+
+    SubtreeTable table;
+    table.subtree_depth = reader.read<std::uint8_t>();
+    const auto check_entry = [&](const SubtreeEntry &entry) {
+        if (entry.offset > stream.size() || entry.size > stream.size() - entry.offset ||
+            (table.compression == Compression::NONE && entry.size != entry.decoded_size)) {
+            throw std::runtime_error("Error: Corrupt octree subtree table");
+        }
+    };
+
+    if (version == 1) {
+        const auto subtree_count = reader.read<std::uint32_t>();
+        // Every entry needs 8 bytes, which protects against huge allocations for corrupt counts
+        if (subtree_count > reader.remaining() / 8) {
+            throw std::runtime_error("Error: Corrupt octree subtree table");
+        }
+        table.subtrees.resize(subtree_count);
+        for (auto &subtree : table.subtrees) {
+            subtree.offset = reader.read<std::uint32_t>();
+            subtree.size = reader.read<std::uint32_t>();
+            subtree.decoded_size = subtree.size;
+            check_entry(subtree);
+        }
+        // The cubes above the subtree depth end where the first subtree starts
+        table.top.offset = static_cast<std::uint32_t>(reader.position());
+        const auto top_end = table.subtrees.empty() ? stream.size() : table.subtrees.front().offset;
+        if (top_end < table.top.offset) {
+            throw std::runtime_error("Error: Corrupt octree subtree table");
+        }
+        table.top.size = static_cast<std::uint32_t>(top_end - table.top.offset);
+        table.top.decoded_size = table.top.size;
+        return table;
+    }
+
+    const auto compression = reader.read<std::uint8_t>();
+    if (compression > static_cast<std::uint8_t>(Compression::LZ)) {
+        throw std::runtime_error("Error: Unsupported octree compression");
+    }
+    table.compression = static_cast<Compression>(compression);
+    const auto blocks_offset = reader.position();
+
+    // The table is at the end of the stream
+    if (stream.size() < blocks_offset + 4) {
+        throw std::runtime_error("Error: Corrupt octree subtree table");
+    }
+    reader.skip(stream.size() - 4 - blocks_offset);
+    const auto table_offset = reader.read<std::uint32_t>();
+    if (table_offset < blocks_offset || table_offset > stream.size() - 4) {
+        throw std::runtime_error("Error: Corrupt octree subtree table");
+    }
+    ByteStreamReader table_reader(stream.data().subspan(0, stream.size() - 4));
+    table_reader.skip(table_offset);
+    const auto subtree_count = table_reader.read<std::uint32_t>();
+    // Every entry needs 12 bytes, which protects against huge allocations for corrupt counts
+    if (subtree_count >= table_reader.remaining() / 12) {
+        throw std::runtime_error("Error: Corrupt octree subtree table");
+    }
+    const auto read_entry = [&](SubtreeEntry &entry) {
+        entry.offset = table_reader.read<std::uint32_t>();
+        entry.size = table_reader.read<std::uint32_t>();
+        entry.decoded_size = table_reader.read<std::uint32_t>();
+        check_entry(entry);
+    };
+    read_entry(table.top);
+    table.subtrees.resize(subtree_count);
+    for (auto &subtree : table.subtrees) {
+        read_entry(subtree);
+    }
+    return table;
+}
+
+std::span<const std::uint8_t> NXOCParser::read_block(const ByteStream &stream, const Compression compression,
+                                                     const SubtreeEntry &entry, std::vector<std::uint8_t> &buffer) {
+    const auto block = stream.data().subspan(entry.offset, entry.size);
+    if (compression == Compression::NONE) {
+        return block;
+    }
+    // Every chunk but the last one decodes to LZ_CHUNK_SIZE bytes
+    buffer.clear();
+    ByteStreamReader reader(block);
+    while (buffer.size() < entry.decoded_size) {
+        const auto chunk_size = reader.read<std::uint32_t>();
+        if (chunk_size > reader.remaining()) {
+            throw std::runtime_error("Error: Corrupt octree block");
+        }
+        const auto chunk = tools::lz_decompress(block.subspan(reader.position(), chunk_size),
+                                                std::min(LZ_CHUNK_SIZE, entry.decoded_size - buffer.size()));
+        buffer.insert(buffer.end(), chunk.begin(), chunk.end());
+        reader.skip(chunk_size);
+    }
+    if (reader.remaining() != 0) {
+        throw std::runtime_error("Error: Corrupt octree block");
+    }
+    return buffer;
+}
+
+std::shared_ptr<octree::Cube> NXOCParser::decode_blocks(const ByteStream &stream, const SubtreeTable &table,
+                                                        const SubtreeFilter &filter) {
+    std::vector<std::uint8_t> buffer;
+    const auto block = read_block(stream, table.compression, table.top, buffer);
+    ByteStreamReader reader(block);
+    std::shared_ptr<octree::Cube> root = std::make_shared<octree::Cube>();
+    std::vector<std::shared_ptr<octree::Cube>> subtrees;
+    decode_top_cubes(reader, root, 0, table.subtree_depth, subtrees);
+    if (reader.position() != block.size() || subtrees.size() != table.subtrees.size()) {
+        throw std::runtime_error("Error: Octree subtree table does not match the octree");
+    }
+    decode_subtrees(stream, table, subtrees, filter);
+    return root;
+}
+
+void NXOCParser::decode_subtrees(const ByteStream &stream, const SubtreeTable &table,
+                                 const std::span<const std::shared_ptr<octree::Cube>> subtrees,
+                                 const SubtreeFilter &filter) {
+    // Subtrees which were decoded before are cleared, and subtrees which are filtered out are left as they are
+    std::vector<std::size_t> selected;
+    for (std::size_t idx = 0; idx < subtrees.size(); idx++) {
+        if (!filter || filter(*subtrees[idx])) {
+            subtrees[idx]->set_type_without_simplify(octree::Cube::Type::EMPTY);
+            selected.push_back(idx);
+        }
+    }
+
+    // Every task takes the next subtree which has not been decoded yet, so large and small subtrees even out
+    std::atomic<std::size_t> next_subtree{0};
+    const auto decode_next_subtrees = [&]() {
+        std::vector<std::uint8_t> buffer;
+        for (auto idx = next_subtree++; idx < selected.size(); idx = next_subtree++) {
+            const auto block = read_block(stream, table.compression, table.subtrees[selected[idx]], buffer);
+            ByteStreamReader reader(block);
+            decode_cube(reader, subtrees[selected[idx]]);
+            if (reader.position() != block.size()) {
+                throw std::runtime_error("Error: Corrupt octree subtree " + std::to_string(selected[idx]));
+            }
+        }
+    };
+    const auto task_count =
+        std::min<std::size_t>(selected.size(), std::max(1u, std::thread::hardware_concurrency()));
+    if (task_count <= 1) {
+        decode_next_subtrees();
+        return;
+    }
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(task_count - 1);
+    for (std::size_t task = 1; task < task_count; task++) {
+        tasks.push_back(std::async(std::launch::async, decode_next_subtrees));
+    }
+    // The calling thread helps as well. All tasks are waited for before rethrowing, so no task outlives the captured
+    // references.
+    std::exception_ptr exception;
+    try {
+        decode_next_subtrees();
+    } catch (...) {
+        exception = std::current_exception();
+        next_subtree = selected.size();
+    }
+    for (auto &task : tasks) {
+        task.wait();
+    }
+    for (auto &task : tasks) {
+        task.get();
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
 template <>
-std::shared_ptr<octree::Cube> NXOCParser::deserialize_impl<0>(const ByteStream &stream) {
+std::shared_ptr<octree::Cube> NXOCParser::deserialize_impl<0>(const ByteStream &stream, const SubtreeFilter &) {
     ByteStreamReader reader(stream);
     std::shared_ptr<octree::Cube> root = std::make_shared<octree::Cube>();
 
     // Skip identifier, which is already checked.
-    reader.skip(13);
+    reader.skip(IDENTIFIER_SIZE);
     // Skip version.
     reader.skip(4);
 
-    std::function<void(std::shared_ptr<octree::Cube> &)> iter_func;
-    // pre-order traversal
-    iter_func = [&iter_func, &reader](std::shared_ptr<octree::Cube> &cube) {
-        cube->set_type(reader.read<octree::Cube::Type>());
-        if (cube->type() == octree::Cube::Type::OCTANT) {
-            for (auto child : cube->children()) {
-                iter_func(child);
-            }
-            return;
-        }
-        if (cube->type() == octree::Cube::Type::NORMAL) {
-            cube->m_indentations = reader.read<std::array<octree::Indentation, octree::Cube::EDGES>>();
-        }
-    };
-    iter_func(root);
+    decode_cube(reader, root);
     return root;
 }
 
 template <>
-ByteStream NXOCParser::serialize_impl<0>(const std::shared_ptr<const octree::Cube> cube) { // NOLINT
-    ByteStreamWriter writer;
-    writer.write<std::string>("Inexor Octree");
+std::shared_ptr<octree::Cube> NXOCParser::deserialize_impl<1>(const ByteStream &stream, const SubtreeFilter &filter) {
+    return decode_blocks(stream, read_subtree_table(stream, 1), filter);
+}
+
+template <>
+std::shared_ptr<octree::Cube> NXOCParser::deserialize_impl<2>(const ByteStream &stream, const SubtreeFilter &filter) {
+    return decode_blocks(stream, read_subtree_table(stream, 2), filter);
+}
+
+template <>
+void NXOCParser::serialize_impl<0>(ByteStreamWriter &writer, const std::shared_ptr<const octree::Cube> cube) { // NOLINT
+    writer.write<std::string>(IDENTIFIER);
     writer.write<std::uint32_t>(0);
+    encode_cube(writer, cube);
+}
 
-    std::function<void(const std::shared_ptr<const octree::Cube> &)> iter_func;
-    // pre-order traversal
-    iter_func = [&iter_func, &writer](const std::shared_ptr<const octree::Cube> &cube) {
-        writer.write(cube->type());
+template <>
+void NXOCParser::serialize_impl<1>(ByteStreamWriter &writer, const std::shared_ptr<const octree::Cube> cube) { // NOLINT
+    // The sizes of the subtrees are counted first, so the table can be written before the subtrees without buffering
+    // them. This keeps the memory of streaming into a file constant.
+    std::vector<std::size_t> subtree_sizes;
+    std::size_t top_size{0};
+    std::function<void(const std::shared_ptr<const octree::Cube> &, std::uint32_t)> count_func;
+    count_func = [&](const std::shared_ptr<const octree::Cube> &cube, const std::uint32_t depth) {
+        if (depth == m_subtree_depth) {
+            subtree_sizes.push_back(encoded_size(cube));
+            return;
+        }
+        top_size += 1;
         if (cube->type() == octree::Cube::Type::OCTANT) {
             for (const auto &child : cube->children()) {
-                iter_func(child);
+                count_func(child, depth + 1);
             }
             return;
         }
         if (cube->type() == octree::Cube::Type::NORMAL) {
-            writer.write(cube->indentations());
+            top_size += INDENTATIONS_SIZE;
         }
     };
+    count_func(cube, 0);
 
-    iter_func(cube);
-    return writer;
+    constexpr std::size_t HEADER_SIZE{IDENTIFIER_SIZE + 4 + 1 + 4};
+    std::size_t offset = HEADER_SIZE + 8 * subtree_sizes.size() + top_size;
+    std::size_t total_size = offset;
+    for (const auto size : subtree_sizes) {
+        total_size += size;
+    }
+    if (total_size > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::overflow_error("Error: Octree too big for version 1");
+    }
+
+    writer.write<std::string>(IDENTIFIER);
+    writer.write<std::uint32_t>(1);
+    writer.write(static_cast<std::uint8_t>(m_subtree_depth));
+    writer.write(static_cast<std::uint32_t>(subtree_sizes.size()));
+    for (const auto size : subtree_sizes) {
+        writer.write(static_cast<std::uint32_t>(offset));
+        writer.write(static_cast<std::uint32_t>(size));
+        offset += size;
+    }
+    // The cubes above the subtree depth, and the subtrees in pre-order
+    std::vector<std::shared_ptr<const octree::Cube>> subtrees;
+    encode_top_cubes(writer, cube, 0, m_subtree_depth, subtrees);
+    for (const auto &subtree : subtrees) {
+        encode_cube(writer, subtree);
+    }
+}
+
+template <>
+void NXOCParser::serialize_impl<2>(ByteStreamWriter &writer, const std::shared_ptr<const octree::Cube> cube) { // NOLINT
+    writer.write<std::string>(IDENTIFIER);
+    writer.write<std::uint32_t>(2);
+    writer.write(static_cast<std::uint8_t>(m_subtree_depth));
+    writer.write(static_cast<std::uint8_t>(m_compression));
+
+    // The blocks are encoded straight into the writer, and compressed blocks are compressed chunk by chunk, so only one
+    // chunk is held in memory at a time
+    std::vector<SubtreeEntry> entries;
+    const auto write_block = [&](const std::function<void(ByteStreamWriter &)> &encode) {
+        const auto offset = writer.bytes_written();
+        std::size_t decoded_size = 0;
+        if (m_compression == Compression::LZ) {
+            ByteStreamWriter chunks(LZ_CHUNK_SIZE, [&](const std::span<const std::uint8_t> chunk) {
+                const auto compressed = tools::lz_compress(chunk);
+                writer.write(static_cast<std::uint32_t>(compressed.size()));
+                writer.write(std::span<const std::uint8_t>(compressed));
+            });
+            encode(chunks);
+            chunks.finish();
+            decoded_size = chunks.bytes_written();
+        } else {
+            encode(writer);
+            decoded_size = writer.bytes_written() - offset;
+        }
+        // The table and its offset must fit as well
+        if (writer.bytes_written() + 12 * (entries.size() + 2) + 8 > std::numeric_limits<std::uint32_t>::max() ||
+            decoded_size > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::overflow_error("Error: Octree too big for version 2");
+        }
+        entries.push_back({.offset = static_cast<std::uint32_t>(offset),
+                           .size = static_cast<std::uint32_t>(writer.bytes_written() - offset),
+                           .decoded_size = static_cast<std::uint32_t>(decoded_size)});
+    };
+
+    std::vector<std::shared_ptr<const octree::Cube>> subtrees;
+    write_block([&](ByteStreamWriter &block) { encode_top_cubes(block, cube, 0, m_subtree_depth, subtrees); });
+    for (const auto &subtree : subtrees) {
+        write_block([&](ByteStreamWriter &block) { encode_cube(block, subtree); });
+    }
+
+    const auto table_offset = static_cast<std::uint32_t>(writer.bytes_written());
+    writer.write(static_cast<std::uint32_t>(subtrees.size()));
+    for (const auto &entry : entries) {
+        writer.write(entry.offset);
+        writer.write(entry.size);
+        writer.write(entry.decoded_size);
+    }
+    writer.write(table_offset);
 }
 
 std::shared_ptr<octree::Cube> NXOCParser::deserialize(const ByteStream &stream) {
+    return deserialize(stream, {});
+}
+
+std::shared_ptr<octree::Cube> NXOCParser::deserialize(const ByteStream &stream, const SubtreeFilter &filter) {
     ByteStreamReader reader(stream);
-    if (reader.read<std::string>(13ull) != "Inexor Octree") {
+    if (reader.read<std::string>(IDENTIFIER_SIZE) != IDENTIFIER) {
         throw std::runtime_error("Error: Wrong identifier");
     }
     const auto version = reader.read<std::uint32_t>();
-    switch (version) { // NOLINT
+    switch (version) {
     case 0:
-        return deserialize_impl<0>(stream);
+        return deserialize_impl<0>(stream, filter);
+    case 1:
+        return deserialize_impl<1>(stream, filter);
+    case 2:
+        return deserialize_impl<2>(stream, filter);
     default:
         throw std::runtime_error("Error: Unsupported octree version");
     }
 }
 
-ByteStream NXOCParser::serialize(const std::shared_ptr<const octree::Cube> cube, const std::uint32_t version) {
+void NXOCParser::load_subtrees(const ByteStream &stream, const std::shared_ptr<octree::Cube> &root,
+                               const SubtreeFilter &filter) {
+    if (root == nullptr) {
+        throw std::invalid_argument("Error: Cube cannot be a nullptr");
+    }
+    ByteStreamReader reader(stream);
+    if (reader.read<std::string>(IDENTIFIER_SIZE) != IDENTIFIER) {
+        throw std::runtime_error("Error: Wrong identifier");
+    }
+    const auto version = reader.read<std::uint32_t>();
+    if (version == 0) {
+        return;
+    }
+    if (version > LATEST_VERSION) {
+        throw std::runtime_error("Error: Unsupported octree version");
+    }
+    const auto table = read_subtree_table(stream, version);
+    std::vector<std::shared_ptr<octree::Cube>> subtrees;
+    collect_subtrees(root, 0, table.subtree_depth, subtrees);
+    if (subtrees.size() != table.subtrees.size()) {
+        throw std::invalid_argument("Error: Octree does not match the subtree table of the stream");
+    }
+    decode_subtrees(stream, table, subtrees, filter);
+}
+
+void NXOCParser::serialize(ByteStreamWriter &writer, const std::shared_ptr<const octree::Cube> &cube,
+                           const std::uint32_t version) {
     if (cube == nullptr) {
         throw std::invalid_argument("Error: Cube cannot be a nullptr");
     }
-    switch (version) { // NOLINT
+    switch (version) {
     case 0:
-        return serialize_impl<0>(cube);
+        return serialize_impl<0>(writer, cube);
+    case 1:
+        return serialize_impl<1>(writer, cube);
+    case 2:
+        return serialize_impl<2>(writer, cube);
     default:
         throw std::runtime_error("Error: Unsupported octree version");
     }
 }
 
+ByteStream NXOCParser::serialize(const std::shared_ptr<const octree::Cube> cube, const std::uint32_t version) {
+    ByteStreamWriter writer;
+    serialize(writer, cube, version);
+    return writer;
+}
+
+std::size_t NXOCParser::serialize(const std::shared_ptr<const octree::Cube> &cube, const std::uint32_t version,
+                                  const std::filesystem::path &path, const FileWriteOptions &options) {
+    ByteStreamWriter writer(path, options);
+    serialize(writer, cube, version);
+    writer.finish();
+    return writer.bytes_written();
+}
+
+ByteStream NXOCParser::convert(const ByteStream &stream, const std::uint32_t version) {
+    return serialize(deserialize(stream), version);
+}
+
 } // namespace inexor::vulkan_renderer::serialization
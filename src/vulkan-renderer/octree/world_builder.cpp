@@ -0,0 +1,279 @@
+#include "inexor/vulkan-renderer/octree/world_builder.hpp"
+
+#include "inexor/vulkan-renderer/octree/cube.hpp"
+#include "inexor/vulkan-renderer/octree/indentation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <future>
+#include <stdexcept>
+
+namespace {
+
+using inexor::vulkan_renderer::octree::Cube;
+using inexor::vulkan_renderer::octree::Indentation;
+
+/// How a cell relates to the surface before deciding whether to descend into it.
+enum class CellState { OUTSIDE, INSIDE, CROSSING };
+
+/// An edge of a cube as edge id and its lower and upper corner in the order of Cube::vertices().
+struct Edge {
+    std::uint8_t id;
+    std::uint8_t lower;
+    std::uint8_t upper;
+};
+
+/// The four edges which are parallel to the x, y, and z axis.
+constexpr std::array<std::array<Edge, 4>, 3> AXIS_EDGES{{
+    {{{0, 0, 4}, {9, 1, 5}, {3, 2, 6}, {6, 3, 7}}},
+    {{{1, 0, 2}, {4, 1, 3}, {10, 4, 6}, {7, 5, 7}}},
+    {{{2, 0, 1}, {11, 2, 3}, {5, 4, 5}, {8, 6, 7}}},
+}};
+
+/// The corner of a cube, with bit 2 selecting x, bit 1 selecting y, and bit 0 selecting z.
+glm::vec3 corner(const Cube &cube, const std::size_t index) {
+    return cube.position() + cube.size() * glm::vec3(static_cast<float>((index >> 2u) & 1u),
+                                                     static_cast<float>((index >> 1u) & 1u),
+                                                     static_cast<float>(index & 1u));
+}
+
+/// Convert a fraction of the cube's edge length into indentation steps.
+std::uint8_t to_steps(const float fraction) {
+    return static_cast<std::uint8_t>(std::lround(std::clamp(fraction, 0.0f, 1.0f) * Indentation::MAX));
+}
+
+template <typename Classify, typename BuildLeaf>
+void build_cell(Cube &cube, const std::uint32_t depth, const std::uint32_t max_depth, const Classify &classify,
+                const BuildLeaf &build_leaf) {
+    switch (classify(cube)) {
+    case CellState::OUTSIDE:
+        // Cubes are empty by default
+        return;
+    case CellState::INSIDE:
+        cube.set_type_without_simplify(Cube::Type::SOLID);
+        return;
+    case CellState::CROSSING:
+        break;
+    }
+    if (depth >= max_depth) {
+        build_leaf(cube);
+        return;
+    }
+    cube.set_type_without_simplify(Cube::Type::OCTANT);
+    for (const auto &child : cube.children()) {
+        build_cell(*child, depth + 1, max_depth, classify, build_leaf);
+    }
+}
+
+template <typename Classify, typename BuildLeaf>
+std::shared_ptr<Cube> build_world(const float size, const glm::vec3 &position, const std::uint32_t max_depth,
+                                  const Classify &classify, const BuildLeaf &build_leaf) {
+    auto root = std::make_shared<Cube>(size, position);
+    if (max_depth == 0 || classify(*root) != CellState::CROSSING) {
+        build_cell(*root, 0, max_depth, classify, build_leaf);
+        return root;
+    }
+    root->set_type_without_simplify(Cube::Type::OCTANT);
+
+    // The top-level octants are independent subtrees, so they can be built in parallel. This works because
+    // set_type_without_simplify never touches the parent of a cube.
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(Cube::SUB_CUBES);
+    for (const auto &child : root->children()) {
+        tasks.push_back(std::async(std::launch::async, [&classify, &build_leaf, child, max_depth]() {
+            build_cell(*child, 1, max_depth, classify, build_leaf);
+        }));
+    }
+    // Wait for all tasks first, so no task outlives the captured references if one of them throws
+    for (auto &task : tasks) {
+        task.wait();
+    }
+    for (auto &task : tasks) {
+        task.get();
+    }
+    root->simplify_recursive();
+    return root;
+}
+
+} // namespace
+
+namespace inexor::vulkan_renderer::octree {
+
+Heightmap::Heightmap(const std::uint32_t width, const std::uint32_t height, std::vector<float> heights)
+    : m_width(width), m_height(height), m_heights(std::move(heights)) {
+    if (m_width < 2 || m_height < 2) {
+        throw std::invalid_argument("Error: A heightmap requires at least 2 x 2 samples!");
+    }
+    if (m_heights.size() != static_cast<std::size_t>(m_width) * m_height) {
+        throw std::invalid_argument("Error: Heightmap size does not match width * height!");
+    }
+}
+
+std::pair<float, float> Heightmap::range(const float u0, const float v0, const float u1, const float v1) const {
+    const auto to_index = [](const float coordinate, const std::uint32_t samples, const bool round_up) {
+        const float texel = std::clamp(coordinate, 0.0f, 1.0f) * static_cast<float>(samples - 1);
+        return static_cast<std::uint32_t>(round_up ? std::ceil(texel) : std::floor(texel));
+    };
+    // Bilinear filtering never leaves the range of the surrounding samples, so the samples which cover the rectangle
+    // give a conservative bound.
+    const std::uint32_t x0 = to_index(u0, m_width, false);
+    const std::uint32_t x1 = to_index(u1, m_width, true);
+    const std::uint32_t y0 = to_index(v0, m_height, false);
+    const std::uint32_t y1 = to_index(v1, m_height, true);
+
+    float min_height = at(x0, y0);
+    float max_height = min_height;
+    for (std::uint32_t y = y0; y <= y1; y++) {
+        for (std::uint32_t x = x0; x <= x1; x++) {
+            min_height = std::min(min_height, at(x, y));
+            max_height = std::max(max_height, at(x, y));
+        }
+    }
+    return {min_height, max_height};
+}
+
+float Heightmap::sample(const float u, const float v) const {
+    const float fx = std::clamp(u, 0.0f, 1.0f) * static_cast<float>(m_width - 1);
+    const float fy = std::clamp(v, 0.0f, 1.0f) * static_cast<float>(m_height - 1);
+    const auto x0 = std::min(static_cast<std::uint32_t>(fx), m_width - 2);
+    const auto y0 = std::min(static_cast<std::uint32_t>(fy), m_height - 2);
+    const float tx = fx - static_cast<float>(x0);
+    const float ty = fy - static_cast<float>(y0);
+    const float bottom = at(x0, y0) + (at(x0 + 1, y0) - at(x0, y0)) * tx;
+    const float top = at(x0, y0 + 1) + (at(x0 + 1, y0 + 1) - at(x0, y0 + 1)) * tx;
+    return bottom + (top - bottom) * ty;
+}
+
+std::shared_ptr<Cube> create_world_from_heightmap(const Heightmap &heightmap, const std::uint32_t max_depth,
+                                                  const float size, const glm::vec3 &position) {
+    if (size <= 0.0f) {
+        throw std::invalid_argument("Error: Parameter 'size' must be greater than zero!");
+    }
+    // Normalized heightmap coordinates of the cube's footprint and its vertical extent relative to the root cube.
+    const auto footprint = [&](const Cube &cube) {
+        const glm::vec3 min = (cube.position() - position) / size;
+        const glm::vec3 max = min + cube.size() / size;
+        return std::make_pair(min, max);
+    };
+
+    auto classify = [&](const Cube &cube) {
+        const auto [min, max] = footprint(cube);
+        const auto [min_height, max_height] = heightmap.range(min.x, min.y, max.x, max.y);
+        const float bottom = min.z * size;
+        const float top = max.z * size;
+        if (bottom >= max_height) {
+            return CellState::OUTSIDE;
+        }
+        if (top <= min_height) {
+            return CellState::INSIDE;
+        }
+        return CellState::CROSSING;
+    };
+
+    auto build_leaf = [&](Cube &cube) {
+        const auto [min, max] = footprint(cube);
+        const float bottom = min.z * size;
+        std::array<Indentation, Cube::EDGES> indentations{};
+        bool all_solid = true;
+        bool all_empty = true;
+        // Pull the upper corner of every vertical edge down to the terrain height at that corner.
+        for (const auto &edge : AXIS_EDGES[2]) {
+            const float u = (edge.lower & 0b100u) != 0 ? max.x : min.x;
+            const float v = (edge.lower & 0b010u) != 0 ? max.y : min.y;
+            const std::uint8_t end = to_steps((heightmap.sample(u, v) - bottom) / cube.size());
+            indentations[edge.id] = Indentation(0, end);
+            all_solid = all_solid && end == Indentation::MAX;
+            all_empty = all_empty && end == 0;
+        }
+        if (all_empty) {
+            return;
+        }
+        if (all_solid) {
+            cube.set_type_without_simplify(Cube::Type::SOLID);
+            return;
+        }
+        cube.set_type_without_simplify(Cube::Type::NORMAL);
+        cube.set_indentations(indentations);
+    };
+
+    return build_world(size, position, max_depth, classify, build_leaf);
+}
+
+std::shared_ptr<Cube> create_world_from_sdf(const SignedDistanceFunction &sdf, const std::uint32_t max_depth,
+                                            const float size, const glm::vec3 &position) {
+    if (!sdf) {
+        throw std::invalid_argument("Error: Parameter 'sdf' is invalid!");
+    }
+    if (size <= 0.0f) {
+        throw std::invalid_argument("Error: Parameter 'size' must be greater than zero!");
+    }
+
+    auto classify = [&](const Cube &cube) {
+        // Half of the cube's space diagonal
+        const float radius = 0.5f * std::sqrt(3.0f) * cube.size();
+        const float distance = sdf(cube.center());
+        if (distance > radius) {
+            return CellState::OUTSIDE;
+        }
+        if (distance < -radius) {
+            return CellState::INSIDE;
+        }
+        return CellState::CROSSING;
+    };
+
+    auto build_leaf = [&](Cube &cube) {
+        std::array<float, 8> distances{};
+        std::size_t inside = 0;
+        glm::vec3 gradient{0.0f};
+        for (std::size_t idx = 0; idx < distances.size(); idx++) {
+            distances[idx] = sdf(corner(cube, idx));
+            inside += distances[idx] <= 0.0f ? 1 : 0;
+            gradient.x += (idx & 0b100u) != 0 ? distances[idx] : -distances[idx];
+            gradient.y += (idx & 0b010u) != 0 ? distances[idx] : -distances[idx];
+            gradient.z += (idx & 0b001u) != 0 ? distances[idx] : -distances[idx];
+        }
+        if (inside == 0) {
+            return;
+        }
+        if (inside == distances.size()) {
+            cube.set_type_without_simplify(Cube::Type::SOLID);
+            return;
+        }
+
+        // Indent the edges along the dominant axis of the surface normal, moving the outer corner of each edge onto
+        // the zero crossing of the signed distance.
+        std::size_t axis = 0;
+        for (std::size_t idx = 1; idx < 3; idx++) {
+            if (std::abs(gradient[static_cast<int>(idx)]) > std::abs(gradient[static_cast<int>(axis)])) {
+                axis = idx;
+            }
+        }
+        const bool outside_is_upper = gradient[static_cast<int>(axis)] > 0.0f;
+
+        std::array<Indentation, Cube::EDGES> indentations{};
+        for (const auto &edge : AXIS_EDGES[axis]) {
+            const float lower = distances[edge.lower];
+            const float upper = distances[edge.upper];
+            if (outside_is_upper) {
+                if (lower > 0.0f && upper > 0.0f) {
+                    indentations[edge.id] = Indentation(0, 0);
+                } else if (lower <= 0.0f && upper > 0.0f) {
+                    indentations[edge.id] = Indentation(0, to_steps(lower / (lower - upper)));
+                }
+            } else {
+                if (lower > 0.0f && upper > 0.0f) {
+                    indentations[edge.id] = Indentation(Indentation::MAX, Indentation::MAX);
+                } else if (lower > 0.0f && upper <= 0.0f) {
+                    indentations[edge.id] = Indentation(to_steps(lower / (lower - upper)), Indentation::MAX);
+                }
+            }
+        }
+        cube.set_type_without_simplify(Cube::Type::NORMAL);
+        cube.set_indentations(indentations);
+    };
+
+    return build_world(size, position, max_depth, classify, build_leaf);
+}
+
+} // namespace inexor::vulkan_renderer::octree
@@ -1,5 +1,6 @@
 #include "inexor/vulkan-renderer/render-graph/buffer.hpp"
 
+#include "inexor/vulkan-renderer/render-graph/frame_sync_manager.hpp"
 #include "inexor/vulkan-renderer/render-graph/staging_buffer.hpp"
 #include "inexor/vulkan-renderer/tools/exception.hpp"
 #include "inexor/vulkan-renderer/tools/make_info.hpp"
@@ -74,7 +75,7 @@ void Buffer::update_without_command_buffer() {
 }
 
 void Buffer::create(std::vector<PendingBufferCopy> &pending_buffer_copies, StagingBuffer &staging_buffer,
-                    std::size_t &upload_offset, std::vector<std::function<void()>> &pending_releases) {
+                    std::size_t &upload_offset, DeferredReleases &pending_releases) {
     if (can_update_without_command_buffer()) {
         update_without_command_buffer();
         return;
@@ -95,8 +96,7 @@ void Buffer::create(std::vector<PendingBufferCopy> &pending_buffer_copies, Stagi
 void Buffer::create_per_frame_buffer_resources(PerFrameBufferResources &slot,
                                                std::vector<PendingBufferCopy> &pending_buffer_copies,
                                                StagingBuffer &staging_buffer, std::size_t &upload_offset,
-                                               std::vector<std::function<void()>> &pending_releases,
-                                               const std::size_t slot_index) {
+                                               DeferredReleases &pending_releases, const std::size_t slot_index) {
 
     auto grow_capacity = [](const std::size_t current_capacity, const std::size_t required_capacity) {
         if (current_capacity >= required_capacity) {
@@ -111,8 +111,14 @@ void Buffer::create_per_frame_buffer_resources(PerFrameBufferResources &slot,
 
     const std::unordered_map<BufferType, VkBufferUsageFlags> buffer_usage{
         {BufferType::UNIFORM_BUFFER, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT},
-        {BufferType::VERTEX_BUFFER, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT},
-        {BufferType::INDEX_BUFFER, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT},
+        // Vertex and index buffers can be written to by compute passes (for example when meshing on the GPU)
+        {BufferType::VERTEX_BUFFER, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                                        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT},
+        {BufferType::INDEX_BUFFER, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                                       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT},
+        {BufferType::STORAGE_BUFFER, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT},
+        {BufferType::INDIRECT_BUFFER, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT},
     };
 
     const auto slot_name = m_slots.size() > 1 ? m_name + "[slot " + std::to_string(slot_index) + "]" : m_name;
@@ -156,11 +162,7 @@ void Buffer::create_per_frame_buffer_resources(PerFrameBufferResources &slot,
         slot.m_buffer_capacity = required_buffer_capacity;
         m_descriptor_resource_changed = true;
 
-        if (old_buffer != VK_NULL_HANDLE) {
-            const auto allocator = m_device.allocator();
-            pending_releases.push_back(
-                [allocator, old_buffer, old_alloc] { vmaDestroyBuffer(allocator, old_buffer, old_alloc); });
-        }
+        pending_releases.destroy_buffer(old_buffer, old_alloc);
     }
 
     VkMemoryPropertyFlags mem_prop_flags{};
@@ -185,6 +187,12 @@ void Buffer::create_per_frame_buffer_resources(PerFrameBufferResources &slot,
                 return {VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT, VK_ACCESS_2_INDEX_READ_BIT};
             case BufferType::VERTEX_BUFFER:
                 return {VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT};
+            case BufferType::INDIRECT_BUFFER:
+                return {VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT};
+            case BufferType::STORAGE_BUFFER:
+                return {VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT |
+                            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                        VK_ACCESS_2_SHADER_STORAGE_READ_BIT};
             case BufferType::UNIFORM_BUFFER:
             default:
                 return {VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
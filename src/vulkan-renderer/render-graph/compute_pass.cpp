@@ -0,0 +1,42 @@
+#include "inexor/vulkan-renderer/render-graph/compute_pass.hpp"
+
+#include "inexor/vulkan-renderer/render-graph/buffer.hpp"
+#include "inexor/vulkan-renderer/render-graph/texture.hpp"
+#include "inexor/vulkan-renderer/tools/exception.hpp"
+
+#include <utility>
+
+namespace inexor::vulkan_renderer::render_graph {
+
+// Using declaration
+using tools::InexorException;
+
+ComputePass::ComputePass(std::string name, std::function<void(CommandBufferBuilder &)> on_record_cmd_buffer,
+                         std::vector<std::weak_ptr<Buffer>> buffer_reads,
+                         std::vector<std::weak_ptr<Buffer>> buffer_writes,
+                         std::vector<std::weak_ptr<Texture>> texture_reads,
+                         std::vector<std::weak_ptr<Texture>> texture_writes,
+                         const DebugLabelColor pass_debug_label_color) {
+    if (name.empty()) {
+        throw InexorException("Error: Parameter 'name' is an empty string!");
+    }
+    m_name = std::move(name);
+    m_on_record_cmd_buffer = std::move(on_record_cmd_buffer);
+    m_buffer_reads = std::move(buffer_reads);
+    m_buffer_writes = std::move(buffer_writes);
+    m_texture_reads = std::move(texture_reads);
+    m_texture_writes = std::move(texture_writes);
+    m_debug_label_color = wrapper::core::get_debug_label_color(pass_debug_label_color);
+}
+
+ComputePass::ComputePass(ComputePass &&other) noexcept {
+    m_name = std::move(other.m_name);
+    m_on_record_cmd_buffer = std::move(other.m_on_record_cmd_buffer);
+    m_debug_label_color = other.m_debug_label_color;
+    m_buffer_reads = std::move(other.m_buffer_reads);
+    m_buffer_writes = std::move(other.m_buffer_writes);
+    m_texture_reads = std::move(other.m_texture_reads);
+    m_texture_writes = std::move(other.m_texture_writes);
+}
+
+} // namespace inexor::vulkan_renderer::render_graph
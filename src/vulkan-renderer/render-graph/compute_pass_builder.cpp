@@ -0,0 +1,87 @@
+#include "inexor/vulkan-renderer/render-graph/compute_pass_builder.hpp"
+
+#include "inexor/vulkan-renderer/render-graph/buffer.hpp"
+#include "inexor/vulkan-renderer/render-graph/compute_pass.hpp"
+#include "inexor/vulkan-renderer/render-graph/texture.hpp"
+#include "inexor/vulkan-renderer/tools/exception.hpp"
+
+#include <utility>
+
+namespace inexor::vulkan_renderer::render_graph {
+
+// Using declaration
+using tools::InexorException;
+
+ComputePassBuilder::ComputePassBuilder() {
+    reset();
+}
+
+ComputePassBuilder::ComputePassBuilder(ComputePassBuilder &&other) noexcept {
+    m_on_record_cmd_buffer = std::move(other.m_on_record_cmd_buffer);
+    m_buffer_reads = std::move(other.m_buffer_reads);
+    m_buffer_writes = std::move(other.m_buffer_writes);
+    m_texture_reads = std::move(other.m_texture_reads);
+    m_texture_writes = std::move(other.m_texture_writes);
+}
+
+std::shared_ptr<ComputePass> ComputePassBuilder::build(std::string name, const DebugLabelColor pass_debug_color) {
+    auto compute_pass = std::make_shared<ComputePass>(std::move(name), std::move(m_on_record_cmd_buffer),
+                                                      std::move(m_buffer_reads), std::move(m_buffer_writes),
+                                                      std::move(m_texture_reads), std::move(m_texture_writes),
+                                                      pass_debug_color);
+    reset();
+    return compute_pass;
+}
+
+ComputePassBuilder &ComputePassBuilder::reads_from(std::weak_ptr<Buffer> buffer) {
+    if (buffer.expired()) {
+        throw InexorException("Error: Parameter 'buffer' is an invalid pointer!");
+    }
+    m_buffer_reads.push_back(std::move(buffer));
+    return *this;
+}
+
+ComputePassBuilder &ComputePassBuilder::reads_from(std::weak_ptr<Texture> texture) {
+    if (texture.expired()) {
+        throw InexorException("Error: Parameter 'texture' is an invalid pointer!");
+    }
+    m_texture_reads.push_back(std::move(texture));
+    return *this;
+}
+
+void ComputePassBuilder::reset() {
+    m_on_record_cmd_buffer = {};
+    m_buffer_reads.clear();
+    m_buffer_writes.clear();
+    m_texture_reads.clear();
+    m_texture_writes.clear();
+}
+
+ComputePassBuilder &
+ComputePassBuilder::set_on_record(std::function<void(CommandBufferBuilder &)> on_record_cmd_buffer) {
+    m_on_record_cmd_buffer = std::move(on_record_cmd_buffer);
+    return *this;
+}
+
+ComputePassBuilder &ComputePassBuilder::writes_to(std::weak_ptr<Buffer> buffer) {
+    if (buffer.expired()) {
+        throw InexorException("Error: Parameter 'buffer' is an invalid pointer!");
+    }
+    m_buffer_writes.push_back(std::move(buffer));
+    return *this;
+}
+
+ComputePassBuilder &ComputePassBuilder::writes_to(std::weak_ptr<Texture> texture) {
+    const auto texture_ref = texture.lock();
+    if (!texture_ref) {
+        throw InexorException("Error: Parameter 'texture' is an invalid pointer!");
+    }
+    if (texture_ref->usage() != TextureUsage::STORAGE_IMAGE) {
+        throw InexorException("Error: Compute passes can only write to storage images, but texture " +
+                              texture_ref->name() + " is not a storage image!");
+    }
+    m_texture_writes.push_back(std::move(texture));
+    return *this;
+}
+
+} // namespace inexor::vulkan_renderer::render_graph
@@ -1,140 +1,133 @@
 #include "inexor/vulkan-renderer/render-graph/frame_sync_manager.hpp"
 
-#include "inexor/vulkan-renderer/tools/exception.hpp"
 #include "inexor/vulkan-renderer/wrapper/core/device.hpp"
+#include "inexor/vulkan-renderer/wrapper/images/image.hpp"
+#include "inexor/vulkan-renderer/wrapper/synchronization/timeline_semaphore.hpp"
 
 #include <algorithm>
-#include <limits>
-#include <unordered_map>
-#include <unordered_set>
 #include <utility>
 
 namespace inexor::vulkan_renderer::render_graph {
 
-using tools::VulkanException;
+// Using declaration
+using wrapper::synchronization::TimelineSemaphore;
 
-FrameSyncManager::FrameSyncManager(const wrapper::core::Device &device) : m_device(device) {}
-
-void FrameSyncManager::set_frame_context(const std::size_t frame_slot_count, const std::size_t current_frame_slot) {
-    m_frame_slot_count = std::max<std::size_t>(1, frame_slot_count);
-    m_current_frame_slot = std::min(current_frame_slot, m_frame_slot_count - 1);
-
-    if (m_frame_slot_submission_fences.size() != m_frame_slot_count) {
-        m_frame_slot_submission_fences.resize(m_frame_slot_count, VK_NULL_HANDLE);
+void DeferredReleases::destroy_buffer(const VkBuffer buffer, const VmaAllocation allocation) {
+    if (buffer != VK_NULL_HANDLE) {
+        m_buffers.push_back({
+            .buffer = buffer,
+            .allocation = allocation,
+        });
     }
 }
 
-void FrameSyncManager::mark_frame_slot_submission_fence(const VkFence fence) {
-    if (m_frame_slot_submission_fences.size() != m_frame_slot_count) {
-        m_frame_slot_submission_fences.resize(m_frame_slot_count, VK_NULL_HANDLE);
+void DeferredReleases::free_memory(const VmaAllocation allocation) {
+    if (allocation != VK_NULL_HANDLE) {
+        m_allocations.push_back(allocation);
     }
-    m_frame_slot_submission_fences.at(m_current_frame_slot) = fence;
 }
 
-void FrameSyncManager::defer_release(const std::span<const VkFence> fences, std::function<void()> release) {
-    if (!release) {
-        return;
+void DeferredReleases::destroy_image(std::shared_ptr<Image> image) {
+    if (image) {
+        m_images.push_back(std::move(image));
     }
+}
 
-    std::vector<VkFence> filtered_fences;
-    filtered_fences.reserve(fences.size());
-    for (const auto fence : fences) {
-        if (fence != VK_NULL_HANDLE) {
-            filtered_fences.push_back(fence);
-        }
+void DeferredReleases::release(const VmaAllocator allocator) {
+    // The images are destroyed first, because they may alias the memory blocks
+    m_images.clear();
+    for (const auto &buffer : m_buffers) {
+        vmaDestroyBuffer(allocator, buffer.buffer, buffer.allocation);
+    }
+    m_buffers.clear();
+    for (const auto allocation : m_allocations) {
+        vmaFreeMemory(allocator, allocation);
     }
+    m_allocations.clear();
+}
+
+FrameSyncManager::FrameSyncManager(const wrapper::core::Device &device)
+    : m_device(device),
+      m_frame_timeline(std::make_unique<TimelineSemaphore>(m_device, "render_graph_frame_timeline")) {}
 
-    m_deferred_releases.push_back({
-        .fences = std::move(filtered_fences),
-        .release = std::move(release),
-    });
+FrameSyncManager::~FrameSyncManager() = default;
+
+void FrameSyncManager::set_frame_context(const std::size_t frame_slot_count, const std::size_t current_frame_slot) {
+    m_frame_slot_count = std::max<std::size_t>(1, frame_slot_count);
+    m_current_frame_slot = std::min(current_frame_slot, m_frame_slot_count - 1);
 }
 
-void FrameSyncManager::defer_release(const VkFence fence, std::function<void()> release) {
-    defer_release(std::span<const VkFence>{&fence, fence == VK_NULL_HANDLE ? 0u : 1u}, std::move(release));
+VkSemaphore FrameSyncManager::frame_timeline_semaphore() const {
+    return m_frame_timeline->semaphore();
 }
 
-void FrameSyncManager::process_deferred_releases(const bool wait_all) {
-    if (m_deferred_releases.empty()) {
-        return;
-    }
+void FrameSyncManager::mark_frame_submitted() {
+    m_submitted_frame_value++;
+}
 
-    std::vector<VkFence> unique_fences;
-    unique_fences.reserve(m_deferred_releases.size());
-    std::unordered_set<VkFence> seen_fences;
-    seen_fences.reserve(m_deferred_releases.size());
-
-    for (const auto &entry : m_deferred_releases) {
-        for (const auto fence : entry.fences) {
-            if (fence == VK_NULL_HANDLE) {
-                continue;
-            }
-            if (seen_fences.insert(fence).second) {
-                unique_fences.push_back(fence);
-            }
+DeferredReleases &FrameSyncManager::current_frame_releases() {
+    const auto frame_value = current_frame_value();
+    if (m_frame_releases_count > 0) {
+        const auto newest_index = (m_oldest_frame_releases + m_frame_releases_count - 1) % m_frame_releases.size();
+        auto &newest = m_frame_releases[newest_index];
+        if (newest.m_frame_value == frame_value) {
+            return newest;
         }
     }
+    // The ring only grows if more frames are in flight than ever before
+    if (m_frame_releases_count == m_frame_releases.size()) {
+        std::rotate(m_frame_releases.begin(),
+                    m_frame_releases.begin() + static_cast<std::ptrdiff_t>(m_oldest_frame_releases),
+                    m_frame_releases.end());
+        m_oldest_frame_releases = 0;
+        m_frame_releases.emplace_back();
+    }
+    auto &releases = m_frame_releases[(m_oldest_frame_releases + m_frame_releases_count) % m_frame_releases.size()];
+    releases.m_frame_value = frame_value;
+    m_frame_releases_count++;
+    return releases;
+}
 
-    if (wait_all) {
-        if (!unique_fences.empty()) {
-            if (const auto result =
-                    vkWaitForFences(m_device.device(), static_cast<std::uint32_t>(unique_fences.size()),
-                                    unique_fences.data(), VK_TRUE, std::numeric_limits<std::uint64_t>::max());
-                result != VK_SUCCESS) {
-                throw VulkanException("Error: vkWaitForFences failed!", result,
-                                      "FrameSyncManager::process_deferred_releases");
-            }
-        }
+void FrameSyncManager::release_oldest_frame() {
+    m_frame_releases[m_oldest_frame_releases].release(m_device.allocator());
+    m_oldest_frame_releases = (m_oldest_frame_releases + 1) % m_frame_releases.size();
+    m_frame_releases_count--;
+}
 
-        for (auto &entry : m_deferred_releases) {
-            entry.release();
-        }
-        m_deferred_releases.clear();
+void FrameSyncManager::process_deferred_releases(const bool wait_all) {
+    // Frames without any releases don't need to be finished, so they are removed without querying the timeline
+    while (m_frame_releases_count > 0 && m_frame_releases[m_oldest_frame_releases].empty()) {
+        release_oldest_frame();
+    }
+    if (m_frame_releases_count == 0) {
         return;
     }
 
-    std::unordered_map<VkFence, bool> fence_ready;
-    fence_ready.reserve(unique_fences.size());
-    for (const auto fence : unique_fences) {
-        const auto result = vkWaitForFences(m_device.device(), 1, &fence, VK_TRUE, 0);
-        if (result == VK_SUCCESS) {
-            fence_ready.emplace(fence, true);
-        } else if (result == VK_TIMEOUT) {
-            fence_ready.emplace(fence, false);
-        } else {
-            throw VulkanException("Error: vkWaitForFences failed!", result,
-                                  "FrameSyncManager::process_deferred_releases");
+    std::uint64_t finished_frame_value = 0;
+    if (wait_all) {
+        // Resources of the current frame are released as well, because it has not been submitted yet
+        if (m_submitted_frame_value > 0) {
+            m_frame_timeline->wait(m_submitted_frame_value);
         }
+        finished_frame_value = current_frame_value();
+    } else {
+        finished_frame_value = m_frame_timeline->value();
     }
 
-    std::size_t write_index = 0;
-    for (std::size_t read_index = 0; read_index < m_deferred_releases.size(); ++read_index) {
-        auto &entry = m_deferred_releases[read_index];
-
-        bool ready = true;
-        for (const auto fence : entry.fences) {
-            const auto it = fence_ready.find(fence);
-            if (it == fence_ready.end() || !it->second) {
-                ready = false;
-                break;
-            }
-        }
-
-        if (ready) {
-            entry.release();
-            continue;
-        }
-
-        m_deferred_releases[write_index++] = std::move(entry);
+    while (m_frame_releases_count > 0 &&
+           m_frame_releases[m_oldest_frame_releases].m_frame_value <= finished_frame_value) {
+        release_oldest_frame();
     }
-    m_deferred_releases.resize(write_index);
 }
 
 void FrameSyncManager::clear() {
-    m_deferred_releases.clear();
-    m_frame_slot_submission_fences.clear();
+    // The frame timeline keeps its value, because it never decreases
+    while (m_frame_releases_count > 0) {
+        release_oldest_frame();
+    }
+    m_oldest_frame_releases = 0;
     m_frame_slot_count = 1;
     m_current_frame_slot = 0;
 }
 
-} // namespace inexor::vulkan_renderer::render_graph
\ No newline at end of file
+} // namespace inexor::vulkan_renderer::render_graph
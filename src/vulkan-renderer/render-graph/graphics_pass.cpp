@@ -16,7 +16,8 @@ using tools::make_info;
 
 GraphicsPass::GraphicsPass(
     std::string name, std::function<void(CommandBufferBuilder &)> on_record_cmd_buffer,
-    std::vector<std::weak_ptr<Buffer>> buffer_reads,
+    std::vector<std::weak_ptr<Buffer>> buffer_reads, std::vector<std::weak_ptr<Buffer>> buffer_writes,
+    std::vector<std::pair<std::weak_ptr<Texture>, VkShaderStageFlags>> texture_reads,
     std::vector<std::pair<std::weak_ptr<Texture>, std::optional<VkClearValue>>> texture_writes,
     std::vector<std::pair<std::weak_ptr<Swapchain>, std::optional<VkClearValue>>> swapchain_writes,
     const DebugLabelColor pass_debug_label_color) {
@@ -41,12 +42,16 @@ GraphicsPass::GraphicsPass(
     }
 
     buffer_reads.reserve(buffer_reads.size());
+    buffer_writes.reserve(buffer_writes.size());
+    texture_reads.reserve(texture_reads.size());
     texture_writes.reserve(texture_writes.size());
     swapchain_writes.reserve(swapchain_writes.size());
 
     m_name = std::move(name);
     m_on_record_cmd_buffer = std::move(on_record_cmd_buffer);
     m_buffer_reads = std::move(buffer_reads);
+    m_buffer_writes = std::move(buffer_writes);
+    m_texture_reads = std::move(texture_reads);
     m_texture_writes = std::move(texture_writes);
     m_swapchain_writes = std::move(swapchain_writes);
     m_debug_label_color = wrapper::core::get_debug_label_color(pass_debug_label_color);
@@ -70,8 +75,11 @@ GraphicsPass::GraphicsPass(GraphicsPass &&other) noexcept {
     m_debug_label_color = other.m_debug_label_color;
     m_extent = std::move(other.m_extent);
     m_buffer_reads = std::move(other.m_buffer_reads);
+    m_buffer_writes = std::move(other.m_buffer_writes);
+    m_texture_reads = std::move(other.m_texture_reads);
     m_texture_writes = std::move(other.m_texture_writes);
     m_swapchain_writes = std::move(other.m_swapchain_writes);
+    m_secondary_cmd_buffers_dirty = other.m_secondary_cmd_buffers_dirty;
     m_rendering_info = std::move(other.m_rendering_info);
     m_color_attachments = std::move(other.m_color_attachments);
     m_depth_attachment = std::move(other.m_depth_attachment);
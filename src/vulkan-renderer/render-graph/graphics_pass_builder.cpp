@@ -23,12 +23,14 @@ GraphicsPassBuilder::GraphicsPassBuilder(GraphicsPassBuilder &&other) noexcept {
     m_texture_writes = std::move(other.m_texture_writes);
     m_buffer_reads = std::move(other.m_buffer_reads);
     m_buffer_writes = std::move(other.m_buffer_writes);
+    m_texture_reads = std::move(other.m_texture_reads);
 }
 
 std::shared_ptr<GraphicsPass> GraphicsPassBuilder::build(std::string name, const DebugLabelColor pass_debug_color) {
-    auto graphics_pass =
-        std::make_shared<GraphicsPass>(std::move(name), std::move(m_on_record_cmd_buffer), std::move(m_buffer_reads),
-                                       std::move(m_texture_writes), std::move(m_swapchain_writes), pass_debug_color);
+    auto graphics_pass = std::make_shared<GraphicsPass>(std::move(name), std::move(m_on_record_cmd_buffer),
+                                                        std::move(m_buffer_reads), std::move(m_buffer_writes),
+                                                        std::move(m_texture_reads), std::move(m_texture_writes),
+                                                        std::move(m_swapchain_writes), pass_debug_color);
     // NOTE: We could use RAII here to bind the call of reset() to some destructor call like a scope guard pattern does.
     reset();
     return graphics_pass;
@@ -42,12 +44,24 @@ GraphicsPassBuilder &GraphicsPassBuilder::reads_from(std::weak_ptr<Buffer> buffe
     return *this;
 }
 
+GraphicsPassBuilder &GraphicsPassBuilder::reads_from(std::weak_ptr<Texture> texture, const VkShaderStageFlags stage) {
+    if (texture.expired()) {
+        throw InexorException("Error: Parameter 'texture' is an invalid pointer!");
+    }
+    if (stage == 0) {
+        throw InexorException("Error: Parameter 'stage' must specify at least one shader stage!");
+    }
+    m_texture_reads.emplace_back(std::move(texture), stage);
+    return *this;
+}
+
 void GraphicsPassBuilder::reset() {
     m_on_record_cmd_buffer = {};
     m_swapchain_writes.clear();
     m_texture_writes.clear();
     m_buffer_reads.clear();
     m_buffer_writes.clear();
+    m_texture_reads.clear();
 }
 
 GraphicsPassBuilder &
@@ -75,6 +89,11 @@ GraphicsPassBuilder::writes_to(std::variant<std::weak_ptr<Texture>, std::weak_pt
         if (texture.expired()) {
             throw InexorException("Error: Parameter 'write_attachment' is an invalid pointer!");
         }
+        // Storage images can't be used as attachments
+        if (texture.lock()->usage() == TextureUsage::STORAGE_IMAGE) {
+            throw InexorException("Error: Storage image " + texture.lock()->name() +
+                                  " can only be written to by compute passes!");
+        }
         // It's a std::weak_ptr<Texture> and the memory is valid
         m_texture_writes.emplace_back(std::move(texture), std::move(clear_value));
     } else {
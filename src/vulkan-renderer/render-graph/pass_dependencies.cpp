@@ -0,0 +1,173 @@
+#include "inexor/vulkan-renderer/render-graph/pass_dependencies.hpp"
+
+#include "inexor/vulkan-renderer/tools/exception.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace inexor::vulkan_renderer::render_graph {
+
+// Using declaration
+using tools::InexorException;
+
+std::vector<std::vector<std::size_t>> get_pass_dependencies(const std::size_t pass_count,
+                                                            const std::span<const ResourceAccesses> resources) {
+    std::vector<std::vector<std::size_t>> dependencies(pass_count);
+    for (const auto &accesses : resources) {
+        const auto &writers = accesses.writers;
+        const auto &readers = accesses.readers;
+        // The readers up to and including a writer are the readers before it, because a pass reads before it writes
+        std::size_t reader = 0;
+        for (std::size_t writer = 0; writer <= writers.size(); writer++) {
+            const bool has_writer = writer < writers.size();
+            for (; reader < readers.size() && (!has_writer || readers[reader] <= writers[writer]); reader++) {
+                // Read after write
+                if (writer > 0) {
+                    dependencies[readers[reader]].push_back(writers[writer - 1]);
+                }
+                // Write after read
+                if (has_writer && readers[reader] != writers[writer]) {
+                    dependencies[writers[writer]].push_back(readers[reader]);
+                }
+            }
+            // Write after write
+            if (has_writer && writer > 0) {
+                dependencies[writers[writer]].push_back(writers[writer - 1]);
+            }
+        }
+    }
+    for (auto &pass_dependencies : dependencies) {
+        std::sort(pass_dependencies.begin(), pass_dependencies.end());
+        pass_dependencies.erase(std::unique(pass_dependencies.begin(), pass_dependencies.end()),
+                                pass_dependencies.end());
+    }
+    return dependencies;
+}
+
+std::vector<std::size_t> sort_topologically(const std::vector<std::vector<std::size_t>> &dependencies) {
+    const auto pass_count = dependencies.size();
+    std::vector<std::vector<std::size_t>> dependents(pass_count);
+    std::vector<std::size_t> unsorted_dependency_count(pass_count);
+    std::vector<std::size_t> ready_passes;
+    for (std::size_t pass = 0; pass < pass_count; pass++) {
+        for (const auto dependency : dependencies[pass]) {
+            dependents[dependency].push_back(pass);
+        }
+        unsorted_dependency_count[pass] = dependencies[pass].size();
+        if (unsorted_dependency_count[pass] == 0) {
+            ready_passes.push_back(pass);
+        }
+    }
+
+    std::vector<std::size_t> order;
+    order.reserve(pass_count);
+    std::vector<std::size_t> position(pass_count);
+    // The position in the order at which the last barrier is needed
+    std::size_t barrier_position = 0;
+
+    while (!ready_passes.empty()) {
+        std::size_t best = 0;
+        std::size_t best_producers_end = 0;
+        bool best_shares_barrier = false;
+        for (std::size_t idx = 0; idx < ready_passes.size(); idx++) {
+            const auto pass = ready_passes[idx];
+            // The position after the last producer of the pass
+            std::size_t producers_end = 0;
+            for (const auto dependency : dependencies[pass]) {
+                producers_end = std::max(producers_end, position[dependency] + 1);
+            }
+            const bool shares_barrier = producers_end <= barrier_position;
+            bool is_better = true;
+            if (idx > 0 && shares_barrier != best_shares_barrier) {
+                is_better = shares_barrier;
+            } else if (idx > 0 && producers_end != best_producers_end) {
+                is_better = producers_end > best_producers_end;
+            } else if (idx > 0) {
+                is_better = pass < ready_passes[best];
+            }
+            if (is_better) {
+                best = idx;
+                best_producers_end = producers_end;
+                best_shares_barrier = shares_barrier;
+            }
+        }
+
+        const auto pass = ready_passes[best];
+        ready_passes[best] = ready_passes.back();
+        ready_passes.pop_back();
+        if (!best_shares_barrier) {
+            barrier_position = order.size();
+        }
+        position[pass] = order.size();
+        order.push_back(pass);
+        for (const auto dependent : dependents[pass]) {
+            if (--unsorted_dependency_count[dependent] == 0) {
+                ready_passes.push_back(dependent);
+            }
+        }
+    }
+    return order;
+}
+
+std::vector<std::size_t> find_cycle(const std::vector<std::vector<std::size_t>> &dependencies,
+                                    const std::vector<bool> &sorted) {
+    constexpr auto NOT_VISITED = std::numeric_limits<std::size_t>::max();
+    // Every pass which has not been sorted depends on another pass which has not been sorted, so following these
+    // dependencies must eventually visit a pass a second time
+    std::vector<std::size_t> visit_index(dependencies.size(), NOT_VISITED);
+    std::vector<std::size_t> path;
+    auto pass = static_cast<std::size_t>(std::distance(sorted.begin(), std::find(sorted.begin(), sorted.end(), false)));
+    while (visit_index[pass] == NOT_VISITED) {
+        visit_index[pass] = path.size();
+        path.push_back(pass);
+        pass = *std::find_if(dependencies[pass].begin(), dependencies[pass].end(),
+                             [&](const std::size_t dependency) { return !sorted[dependency]; });
+    }
+    std::vector<std::size_t> cycle(path.begin() + static_cast<std::ptrdiff_t>(visit_index[pass]), path.end());
+    std::reverse(cycle.begin(), cycle.end());
+    return cycle;
+}
+
+void check_for_cycles(const std::vector<std::vector<std::size_t>> &dependencies,
+                      const std::span<const std::string> pass_names) {
+    const auto order = sort_topologically(dependencies);
+    if (order.size() == dependencies.size()) {
+        return;
+    }
+    std::vector<bool> sorted(dependencies.size(), false);
+    for (const auto pass_index : order) {
+        sorted[pass_index] = true;
+    }
+    const auto cycle = find_cycle(dependencies, sorted);
+    std::string cycle_description;
+    for (const auto pass_index : cycle) {
+        cycle_description += pass_names[pass_index] + " -> ";
+    }
+    cycle_description += pass_names[cycle.front()];
+    throw InexorException("Error: The passes depend on each other in a cycle (" + cycle_description + ")!");
+}
+
+std::vector<bool> find_used_passes(const std::vector<std::vector<std::size_t>> &dependencies,
+                                   const std::vector<bool> &roots) {
+    std::vector<bool> used = roots;
+    std::vector<std::size_t> stack;
+    for (std::size_t pass_index = 0; pass_index < roots.size(); pass_index++) {
+        if (roots[pass_index]) {
+            stack.push_back(pass_index);
+        }
+    }
+    while (!stack.empty()) {
+        const auto pass_index = stack.back();
+        stack.pop_back();
+        for (const auto dependency : dependencies[pass_index]) {
+            if (!used[dependency]) {
+                used[dependency] = true;
+                stack.push_back(dependency);
+            }
+        }
+    }
+    return used;
+}
+
+} // namespace inexor::vulkan_renderer::render_graph
@@ -1,24 +1,174 @@
 ﻿#include "inexor/vulkan-renderer/render-graph/render_graph.hpp"
 
 #include "inexor/vulkan-renderer/render-graph/buffer.hpp"
+#include "inexor/vulkan-renderer/render-graph/compute_pass.hpp"
 #include "inexor/vulkan-renderer/render-graph/graphics_pass.hpp"
+#include "inexor/vulkan-renderer/render-graph/pass_dependencies.hpp"
 #include "inexor/vulkan-renderer/render-graph/texture.hpp"
 #include "inexor/vulkan-renderer/tools/exception.hpp"
 #include "inexor/vulkan-renderer/tools/make_info.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
 #include "inexor/vulkan-renderer/wrapper/core/device.hpp"
 #include "inexor/vulkan-renderer/wrapper/descriptors/per_frame_descriptor_sets.hpp"
 #include "inexor/vulkan-renderer/wrapper/synchronization/pipeline_barrier_batch_builder.hpp"
 #include "inexor/vulkan-renderer/wrapper/synchronization/semaphore.hpp"
+#include "inexor/vulkan-renderer/wrapper/synchronization/timeline_semaphore.hpp"
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstring>
+#include <exception>
 #include <functional>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <variant>
+
+namespace {
+
+// Using declarations
+using inexor::vulkan_renderer::render_graph::BufferType;
+using inexor::vulkan_renderer::render_graph::GraphicsPass;
+using inexor::vulkan_renderer::render_graph::ResourceAccess;
+using inexor::vulkan_renderer::render_graph::TextureUsage;
+
+/// Whether a pass which is visited in the passes of rendergraph is a graphics pass (otherwise it is a compute pass)
+template <typename PassPtr>
+constexpr bool IS_GRAPHICS_PASS = std::is_same_v<std::decay_t<PassPtr>, std::shared_ptr<GraphicsPass>>;
+
+/// Attachments and swapchain images have one mip level and one array layer
+constexpr VkImageSubresourceRange COLOR_IMAGE_RANGE{
+    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+    .baseMipLevel = 0,
+    .levelCount = 1,
+    .baseArrayLayer = 0,
+    .layerCount = 1,
+};
+
+/// The pipeline stages which execute shader stages
+VkPipelineStageFlags2 get_pipeline_stages(const VkShaderStageFlags shader_stages) {
+    VkPipelineStageFlags2 pipeline_stages = VK_PIPELINE_STAGE_2_NONE;
+    if ((shader_stages & VK_SHADER_STAGE_VERTEX_BIT) != 0) {
+        pipeline_stages |= VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT;
+    }
+    if ((shader_stages & VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT) != 0) {
+        pipeline_stages |= VK_PIPELINE_STAGE_2_TESSELLATION_CONTROL_SHADER_BIT;
+    }
+    if ((shader_stages & VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT) != 0) {
+        pipeline_stages |= VK_PIPELINE_STAGE_2_TESSELLATION_EVALUATION_SHADER_BIT;
+    }
+    if ((shader_stages & VK_SHADER_STAGE_GEOMETRY_BIT) != 0) {
+        pipeline_stages |= VK_PIPELINE_STAGE_2_GEOMETRY_SHADER_BIT;
+    }
+    if ((shader_stages & VK_SHADER_STAGE_FRAGMENT_BIT) != 0) {
+        pipeline_stages |= VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+    }
+    if ((shader_stages & VK_SHADER_STAGE_COMPUTE_BIT) != 0) {
+        pipeline_stages |= VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    }
+    return pipeline_stages;
+}
+
+/// The way a graphics pass writes to an attachment
+/// @param usage The usage of the attachment
+/// @param cleared Whether the attachment is cleared when rendering begins (otherwise its contents are loaded)
+ResourceAccess get_attachment_access(const TextureUsage usage, const bool cleared) {
+    switch (usage) {
+    case TextureUsage::DEPTH_ATTACHMENT:
+    case TextureUsage::STENCIL_ATTACHMENT:
+        // Depth and stencil tests read the attachment even if it was cleared
+        return {
+            .stage_mask = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+            .access_mask =
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        };
+    default:
+        return {
+            .stage_mask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+            .access_mask = cleared ? VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT
+                                   : VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+            .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        };
+    }
+}
 
-namespace {} // namespace
+/// The way a graphics pass reads from a buffer, depending on the buffer type
+ResourceAccess get_buffer_read_access(const BufferType type) {
+    switch (type) {
+    case BufferType::VERTEX_BUFFER:
+        return {
+            .stage_mask = VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT,
+            .access_mask = VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT,
+        };
+    case BufferType::INDEX_BUFFER:
+        return {
+            .stage_mask = VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT,
+            .access_mask = VK_ACCESS_2_INDEX_READ_BIT,
+        };
+    case BufferType::UNIFORM_BUFFER:
+        return {
+            .stage_mask = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+            .access_mask = VK_ACCESS_2_UNIFORM_READ_BIT,
+        };
+    case BufferType::INDIRECT_BUFFER:
+        return {
+            .stage_mask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+            .access_mask = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+        };
+    default:
+        return {
+            .stage_mask = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+            .access_mask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+        };
+    }
+}
+
+/// The way a compute pass reads from a buffer, depending on the buffer type
+ResourceAccess get_compute_buffer_read_access(const BufferType type) {
+    switch (type) {
+    case BufferType::UNIFORM_BUFFER:
+        return {
+            .stage_mask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            .access_mask = VK_ACCESS_2_UNIFORM_READ_BIT,
+        };
+    case BufferType::INDIRECT_BUFFER:
+        // Indirect buffers may hold the arguments of indirect dispatches
+        return {
+            .stage_mask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            .access_mask = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+        };
+    default:
+        return {
+            .stage_mask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            .access_mask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+        };
+    }
+}
+
+/// The way a pass reads from a texture in shaders
+/// @param usage The usage of the texture (storage images are loaded from, all other textures are sampled)
+/// @param layout The layout in which shaders access the texture
+/// @param stage_mask The pipeline stages which read from the texture
+ResourceAccess get_texture_read_access(const TextureUsage usage, const VkImageLayout layout,
+                                       const VkPipelineStageFlags2 stage_mask) {
+    return {
+        .stage_mask = stage_mask,
+        .access_mask = usage == TextureUsage::STORAGE_IMAGE ? VK_ACCESS_2_SHADER_STORAGE_READ_BIT
+                                                            : VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+        .layout = layout,
+    };
+}
+
+} // namespace
 
 namespace inexor::vulkan_renderer::render_graph {
 
@@ -26,35 +176,55 @@ using wrapper::commands::CommandBufferBuilder;
 
 // Using declaration
 using tools::make_info;
+using wrapper::core::QueueSemaphoreWait;
 using wrapper::descriptors::DescriptorSetLayoutBuilder;
 using wrapper::descriptors::DescriptorType;
 using wrapper::descriptors::PerFrameDescriptorSets;
 using wrapper::descriptors::WriteDescriptorSetBuilder;
 using wrapper::synchronization::Semaphore;
+using wrapper::synchronization::TimelineSemaphore;
 
 RenderGraph::RenderGraph(Device &device, const bool use_secondary_command_buffers)
-    : m_device(device), m_resource_descriptors(device), m_graphics_pipeline_builder(device),
-      m_swapchain_manager(device), m_command_buffer_cache(device, use_secondary_command_buffers),
-      m_upload_finished(std::make_unique<Semaphore>(device, "render_graph_upload_finished")),
-      m_frame_sync_manager(device), m_staging_buffer(device, "render_graph_upload_arena") {}
+    : m_device(device), m_resource_descriptors(device), m_transient_attachment_allocator(device),
+      m_graphics_pipeline_builder(device), m_compute_pipeline_builder(device), m_swapchain_manager(device),
+      m_command_buffer_cache(device, use_secondary_command_buffers),
+      m_upload_finished(std::make_unique<TimelineSemaphore>(device, "render_graph_upload_finished")),
+      m_frame_sync_manager(device), m_staging_buffer(device, "render_graph_upload_arena") {
+    if (m_device.has_async_compute_queue()) {
+        m_async_compute_resources_released =
+            std::make_unique<Semaphore>(device, "render_graph_async_compute_resources_released");
+        m_async_compute_finished = std::make_unique<Semaphore>(device, "render_graph_async_compute_finished");
+    }
+    // The render thread records secondary command buffers as well, so it is not counted
+    if (use_secondary_command_buffers && tools::ThreadPool::default_thread_count() > 1) {
+        m_recording_thread_pool = std::make_unique<tools::ThreadPool>(tools::ThreadPool::default_thread_count() - 1);
+    }
+}
 
 RenderGraph::~RenderGraph() {
     try {
         m_device.wait_idle();
         m_frame_sync_manager.process_deferred_releases(true);
-        for (auto &release : m_inline_update_pending_releases) {
-            release();
-        }
-        m_inline_update_pending_releases.clear();
         m_inline_update_commands = {};
         m_device.log_vma_statistics("RenderGraph shutdown");
+        m_passes.clear();
         m_graphics_passes.clear();
+        m_culled_passes.clear();
+        m_async_compute_passes.clear();
+        m_async_compute_buffers.clear();
+        m_async_compute_textures.clear();
         m_buffers.clear();
         m_textures.clear();
+        m_transient_attachments.clear();
+        m_memory_handovers.clear();
+        m_transient_attachment_allocator.reset();
         m_resource_descriptors.clear();
         m_graphics_pipeline_create_functions.clear();
+        m_compute_pipeline_create_functions.clear();
         m_swapchain_manager.clear();
         m_pending_queue_ownership_acquire_barriers.reset();
+        m_pending_async_compute_acquire_barriers.reset();
+        m_pending_graphics_acquire_barriers.reset();
         m_staging_buffer.reset();
     } catch (...) {}
 }
@@ -64,8 +234,7 @@ void RenderGraph::synchronize_frame_context() {
     m_current_frame_slot = m_swapchain_manager.current_frame_slot();
 
     m_frame_sync_manager.set_frame_context(m_frame_slot_count, m_current_frame_slot);
-    m_command_buffer_cache.set_frame_context(m_frame_slot_count, m_current_frame_slot,
-                                             m_frame_sync_manager.frame_slot_submission_fences());
+    m_command_buffer_cache.set_frame_context(m_frame_slot_count, m_current_frame_slot);
 
     m_resource_descriptors.set_frame_context(m_frame_slot_count, m_current_frame_slot);
     mark_graphics_pass_secondary_cmd_buffers_dirty();
@@ -89,11 +258,25 @@ std::weak_ptr<Buffer> RenderGraph::add_buffer(std::string name, const BufferType
         std::make_shared<Buffer>(m_device, std::move(name), type, std::move(on_update), update_mode));
 }
 
+std::weak_ptr<ComputePass> RenderGraph::add_compute_pass(OnBuildComputePass on_build_compute_pass) {
+    // This memory ownership models dictates that compute passes are owned by rendergraph and not by external code!
+    auto compute_pass = on_build_compute_pass(m_compute_pass_builder);
+    m_passes.emplace_back(compute_pass);
+    return compute_pass;
+}
+
+void RenderGraph::add_compute_pipeline(OnBuildComputePipeline on_build_compute_pipeline) {
+    // Just like graphics pipelines, compute pipelines are created when the descriptor set layouts are known
+    m_compute_pipeline_create_functions.emplace_back(std::move(on_build_compute_pipeline));
+}
+
 std::weak_ptr<GraphicsPass> RenderGraph::add_graphics_pass(OnBuildGraphicsPass on_build_graphics_pass) {
     // Invoke the graphics pipeline create lambda, insert the shared pointer into vector, and return weak pointer
     // This memory ownership models dictates that graphics passes are owned by rendergraph and not by external code!
     m_swapchain_manager.mark_swapchain_cache_dirty();
-    return m_graphics_passes.emplace_back(std::move(on_build_graphics_pass(m_graphics_pass_builder)));
+    auto graphics_pass = on_build_graphics_pass(m_graphics_pass_builder);
+    m_passes.emplace_back(graphics_pass);
+    return m_graphics_passes.emplace_back(std::move(graphics_pass));
 }
 
 void RenderGraph::add_graphics_pipeline(OnBuildGraphicsPipeline on_build_graphics_pipeline) {
@@ -117,13 +300,18 @@ std::weak_ptr<PerFrameDescriptorSets> RenderGraph::add_resource_descriptor(std::
     if (!resource_ref) {
         throw InexorException("Error: Parameter 'resource' is invalid!");
     }
-    if (resource_ref->type() != BufferType::UNIFORM_BUFFER) {
-        throw InexorException("Error: Automatic buffer descriptors currently only support uniform buffers!");
+    const auto buffer_type = resource_ref->type();
+    if (buffer_type != BufferType::UNIFORM_BUFFER && buffer_type != BufferType::STORAGE_BUFFER &&
+        buffer_type != BufferType::INDIRECT_BUFFER) {
+        throw InexorException("Error: Automatic buffer descriptors do not support vertex and index buffers!");
     }
 
+    m_descriptor_resources.insert(resource_ref.get());
     const auto descriptor_name = resource_ref->name();
-    auto build_descriptor_set_layout = [stage, descriptor_name](DescriptorSetLayoutBuilder &builder) {
-        return builder.add(DescriptorType::UNIFORM_BUFFER, stage).build(descriptor_name);
+    const auto descriptor_type =
+        (buffer_type == BufferType::UNIFORM_BUFFER) ? DescriptorType::UNIFORM_BUFFER : DescriptorType::STORAGE_BUFFER;
+    auto build_descriptor_set_layout = [stage, descriptor_type, descriptor_name](DescriptorSetLayoutBuilder &builder) {
+        return builder.add(descriptor_type, stage).build(descriptor_name);
     };
     auto build_write_descriptor_set = [resource](WriteDescriptorSetBuilder &builder,
                                                  const VkDescriptorSet descriptor_set) {
@@ -141,9 +329,13 @@ std::weak_ptr<PerFrameDescriptorSets> RenderGraph::add_resource_descriptor(std::
         throw InexorException("Error: Parameter 'resource' is invalid!");
     }
 
+    m_descriptor_resources.insert(resource_ref.get());
     const auto descriptor_name = resource_ref->name();
-    auto build_descriptor_set_layout = [stage, descriptor_name](DescriptorSetLayoutBuilder &builder) {
-        return builder.add(DescriptorType::COMBINED_IMAGE_SAMPLER, stage).build(descriptor_name);
+    const auto descriptor_type = (resource_ref->usage() == TextureUsage::STORAGE_IMAGE)
+                                     ? DescriptorType::STORAGE_IMAGE
+                                     : DescriptorType::COMBINED_IMAGE_SAMPLER;
+    auto build_descriptor_set_layout = [stage, descriptor_type, descriptor_name](DescriptorSetLayoutBuilder &builder) {
+        return builder.add(descriptor_type, stage).build(descriptor_name);
     };
     auto build_write_descriptor_set = [resource](WriteDescriptorSetBuilder &builder,
                                                  const VkDescriptorSet descriptor_set) {
@@ -185,27 +377,413 @@ void RenderGraph::mark_graphics_passes_using_texture_dirty(const Texture &textur
     }
 }
 
-void RenderGraph::create_graphics_pipelines() {
+void RenderGraph::create_pipelines() {
     m_resource_descriptors.create_descriptor_set_layouts();
     spdlog::trace("Creating {} graphics pipelines", m_graphics_pipeline_create_functions.size());
     for (const auto &create_func : m_graphics_pipeline_create_functions) {
         std::invoke(create_func, m_graphics_pipeline_builder);
     }
+    spdlog::trace("Creating {} compute pipelines", m_compute_pipeline_create_functions.size());
+    for (const auto &create_func : m_compute_pipeline_create_functions) {
+        std::invoke(create_func, m_compute_pipeline_builder);
+    }
     m_resource_descriptors.mark_descriptor_sets_dirty();
 }
 
+void RenderGraph::create_transient_attachments(DeferredReleases &pending_releases) {
+    // The images of a transient attachment, and the attachment they belong to
+    struct TransientImage {
+        std::size_t attachment_index{0};
+        bool msaa_image{false};
+    };
+    std::vector<TransientImage> images;
+    std::vector<TransientImageRequest> requests;
+
+    for (std::size_t attachment_index = 0; attachment_index < m_transient_attachments.size(); attachment_index++) {
+        const auto &attachment = m_transient_attachments[attachment_index];
+        auto *texture = attachment.texture;
+        // The old images may still be used by frames in flight
+        for (auto &resources : texture->m_per_frame_texture_resources) {
+            for (auto *image : {&resources.m_image, &resources.m_msaa_image}) {
+                if (*image) {
+                    m_resource_state_tracker.forget_image((*image)->image());
+                    pending_releases.destroy_image(std::move(*image));
+                }
+            }
+        }
+        texture->m_image_alias_memory = VK_NULL_HANDLE;
+        texture->m_msaa_image_alias_memory = VK_NULL_HANDLE;
+
+        const bool multisampled = texture->samples() > VK_SAMPLE_COUNT_1_BIT;
+        for (const bool msaa_image : {false, true}) {
+            // The image which is rendered into lazily allocated memory is not stored, so it doesn't alias anything
+            if ((msaa_image && !multisampled) || (texture->m_lazily_allocated && msaa_image == multisampled)) {
+                continue;
+            }
+            const auto img_ci = texture->image_create_info(msaa_image);
+            const auto requirements_info = make_info<VkDeviceImageMemoryRequirements>({
+                .pCreateInfo = &img_ci,
+            });
+            auto requirements = make_info<VkMemoryRequirements2>();
+            vkGetDeviceImageMemoryRequirements(m_device.device(), &requirements_info, &requirements);
+            images.push_back({
+                .attachment_index = attachment_index,
+                .msaa_image = msaa_image,
+            });
+            requests.push_back({
+                .first_pass = attachment.first_pass,
+                .last_pass = attachment.last_pass,
+                .requirements = requirements.memoryRequirements,
+            });
+        }
+    }
+
+    m_transient_attachment_allocator.allocate(requests, pending_releases);
+    for (std::size_t image_index = 0; image_index < images.size(); image_index++) {
+        auto *texture = m_transient_attachments[images[image_index].attachment_index].texture;
+        auto &alias_memory =
+            images[image_index].msaa_image ? texture->m_msaa_image_alias_memory : texture->m_image_alias_memory;
+        alias_memory = m_transient_attachment_allocator.memory(image_index);
+    }
+
+    for (const auto &attachment : m_transient_attachments) {
+        auto *texture = attachment.texture;
+        texture->create_all();
+        for (const auto &resources : texture->m_per_frame_texture_resources) {
+            m_resource_state_tracker.discard_image(resources.m_image->image(), texture->subresource_range());
+            if (resources.m_msaa_image) {
+                m_resource_state_tracker.discard_image(resources.m_msaa_image->image(), texture->subresource_range());
+            }
+        }
+        mark_graphics_passes_using_texture_dirty(*texture);
+    }
+    mark_graphics_pass_secondary_cmd_buffers_dirty();
+
+    // Every image of a memory block takes over the memory from the image which used it before, and the first image of
+    // a frame takes it over from the last image of the previous frame
+    std::unordered_map<std::size_t, std::vector<std::size_t>> block_images;
+    for (std::size_t image_index = 0; image_index < images.size(); image_index++) {
+        if (m_transient_attachment_allocator.memory(image_index) != VK_NULL_HANDLE) {
+            block_images[m_transient_attachment_allocator.block_index(image_index)].push_back(image_index);
+        }
+    }
+    auto get_image = [&](const std::size_t image_index) {
+        const auto *texture = m_transient_attachments[images[image_index].attachment_index].texture;
+        const auto &resources = texture->current_frame_resources();
+        return images[image_index].msaa_image ? resources.m_msaa_image->image() : resources.m_image->image();
+    };
+    m_memory_handovers.clear();
+    for (auto &[block_index, image_indices] : block_images) {
+        std::sort(image_indices.begin(), image_indices.end(), [&](const std::size_t lhs, const std::size_t rhs) {
+            return requests[lhs].first_pass < requests[rhs].first_pass;
+        });
+        for (std::size_t idx = 0; idx < image_indices.size(); idx++) {
+            const auto image_index = image_indices[idx];
+            const auto previous_image_index = image_indices[(idx + image_indices.size() - 1) % image_indices.size()];
+            m_memory_handovers.push_back({
+                .pass_index = requests[image_index].first_pass,
+                .image = get_image(image_index),
+                .range = m_transient_attachments[images[image_index].attachment_index].texture->subresource_range(),
+                .previous_image = get_image(previous_image_index),
+            });
+        }
+    }
+    std::sort(m_memory_handovers.begin(), m_memory_handovers.end(),
+              [](const auto &lhs, const auto &rhs) { return lhs.pass_index < rhs.pass_index; });
+}
+
 void RenderGraph::check_for_cycles() {
-    // @TODO Implement!
+    std::vector<ResourceAccesses> resource_accesses;
+    std::unordered_map<const void *, std::size_t> resource_indices;
+
+    for (std::size_t pass_index = 0; pass_index < m_passes.size(); pass_index++) {
+        std::visit(
+            [&](const auto &pass) {
+                auto get_accesses = [&](const auto &weak_resource) -> ResourceAccesses & {
+                    const auto resource = weak_resource.lock();
+                    if (!resource) {
+                        throw InexorException("Error: A resource of pass " + pass->m_name + " expired!");
+                    }
+                    const auto [entry, inserted] =
+                        resource_indices.try_emplace(resource.get(), resource_accesses.size());
+                    if (inserted) {
+                        resource_accesses.emplace_back();
+                    }
+                    return resource_accesses[entry->second];
+                };
+                auto add_writer = [&](ResourceAccesses &accesses) {
+                    if (accesses.writers.empty() || accesses.writers.back() != pass_index) {
+                        accesses.writers.push_back(pass_index);
+                    }
+                };
+                for (const auto &buffer : pass->m_buffer_reads) {
+                    get_accesses(buffer).readers.push_back(pass_index);
+                }
+                for (const auto &buffer : pass->m_buffer_writes) {
+                    add_writer(get_accesses(buffer));
+                }
+                if constexpr (IS_GRAPHICS_PASS<decltype(pass)>) {
+                    for (const auto &texture_read : pass->m_texture_reads) {
+                        get_accesses(texture_read.first).readers.push_back(pass_index);
+                    }
+                    for (const auto &texture_write : pass->m_texture_writes) {
+                        add_writer(get_accesses(texture_write.first));
+                    }
+                    for (const auto &swapchain_write : pass->m_swapchain_writes) {
+                        add_writer(get_accesses(swapchain_write.first));
+                    }
+                } else {
+                    for (const auto &texture : pass->m_texture_reads) {
+                        get_accesses(texture).readers.push_back(pass_index);
+                    }
+                    for (const auto &texture : pass->m_texture_writes) {
+                        add_writer(get_accesses(texture));
+                    }
+                }
+            },
+            m_passes[pass_index]);
+    }
+
+    m_pass_dependencies = get_pass_dependencies(m_passes.size(), resource_accesses);
+
+    std::vector<std::string> pass_names;
+    pass_names.reserve(m_passes.size());
+    for (const auto &pass_variant : m_passes) {
+        pass_names.push_back(std::visit([](const auto &pass) { return pass->m_name; }, pass_variant));
+    }
+    render_graph::check_for_cycles(m_pass_dependencies, pass_names);
+}
+
+void RenderGraph::cull_unused_passes() {
+    const auto pass_count = m_passes.size();
+    auto is_exported = [&](const auto &weak_resource) {
+        const auto resource = weak_resource.lock();
+        return resource && m_exported_resources.contains(resource.get());
+    };
+
+    // Passes which write to a swapchain or an exported resource are kept, and so are all passes they depend on
+    std::vector<bool> roots(pass_count, false);
+    for (std::size_t pass_index = 0; pass_index < pass_count; pass_index++) {
+        roots[pass_index] = std::visit(
+            [&](const auto &pass) {
+                if (std::any_of(pass->m_buffer_writes.begin(), pass->m_buffer_writes.end(), is_exported)) {
+                    return true;
+                }
+                if constexpr (IS_GRAPHICS_PASS<decltype(pass)>) {
+                    return !pass->m_swapchain_writes.empty() ||
+                           std::any_of(pass->m_texture_writes.begin(), pass->m_texture_writes.end(),
+                                       [&](const auto &texture_write) { return is_exported(texture_write.first); });
+                } else {
+                    return std::any_of(pass->m_texture_writes.begin(), pass->m_texture_writes.end(), is_exported);
+                }
+            },
+            m_passes[pass_index]);
+    }
+    const auto keep = find_used_passes(m_pass_dependencies, roots);
+
+    // Collect the resources of the kept passes and of the culled passes
+    std::unordered_set<const void *> kept_resources;
+    std::unordered_set<const void *> culled_resources;
+    for (std::size_t pass_index = 0; pass_index < pass_count; pass_index++) {
+        auto &resources = keep[pass_index] ? kept_resources : culled_resources;
+        auto add_resource = [&](const auto &weak_resource) {
+            if (const auto resource = weak_resource.lock()) {
+                resources.insert(resource.get());
+            }
+        };
+        std::visit(
+            [&](const auto &pass) {
+                std::for_each(pass->m_buffer_reads.begin(), pass->m_buffer_reads.end(), add_resource);
+                std::for_each(pass->m_buffer_writes.begin(), pass->m_buffer_writes.end(), add_resource);
+                if constexpr (IS_GRAPHICS_PASS<decltype(pass)>) {
+                    for (const auto &texture_read : pass->m_texture_reads) {
+                        add_resource(texture_read.first);
+                    }
+                    for (const auto &texture_write : pass->m_texture_writes) {
+                        add_resource(texture_write.first);
+                    }
+                } else {
+                    std::for_each(pass->m_texture_reads.begin(), pass->m_texture_reads.end(), add_resource);
+                    std::for_each(pass->m_texture_writes.begin(), pass->m_texture_writes.end(), add_resource);
+                }
+            },
+            m_passes[pass_index]);
+    }
+    // Resources which are bound by resource descriptors are kept, because the descriptor sets are always written
+    m_culled_resources.clear();
+    for (const auto *resource : culled_resources) {
+        if (!kept_resources.contains(resource) && !m_descriptor_resources.contains(resource)) {
+            m_culled_resources.insert(resource);
+        }
+    }
+
+    // Remove the culled passes, and remap the dependencies of the kept passes
+    std::vector<std::size_t> new_index(pass_count);
+    std::vector<Pass> kept_passes;
+    std::vector<std::vector<std::size_t>> kept_dependencies;
+    for (std::size_t pass_index = 0; pass_index < pass_count; pass_index++) {
+        if (!keep[pass_index]) {
+            spdlog::trace("Culling pass {} because its results are never used",
+                          std::visit([](const auto &pass) { return pass->m_name; }, m_passes[pass_index]));
+            m_culled_passes.push_back(std::move(m_passes[pass_index]));
+            continue;
+        }
+        new_index[pass_index] = kept_passes.size();
+        kept_passes.push_back(std::move(m_passes[pass_index]));
+        kept_dependencies.push_back(std::move(m_pass_dependencies[pass_index]));
+    }
+    for (auto &dependencies : kept_dependencies) {
+        for (auto &dependency : dependencies) {
+            dependency = new_index[dependency];
+        }
+    }
+    m_passes = std::move(kept_passes);
+    m_pass_dependencies = std::move(kept_dependencies);
+    if (!m_culled_passes.empty()) {
+        m_swapchain_manager.mark_swapchain_cache_dirty();
+    }
+
+    // The graphics passes are recorded in the order of the sorted passes
+    m_graphics_passes.clear();
+    for (const auto &pass : m_passes) {
+        if (const auto *graphics_pass = std::get_if<std::shared_ptr<GraphicsPass>>(&pass)) {
+            m_graphics_passes.push_back(*graphics_pass);
+        }
+    }
 }
 
 void RenderGraph::compile() {
+    // Passes which were culled before are considered again, after the passes which were kept (which preserves the
+    // order of the passes accessing the same resource, because kept passes never depend on culled passes)
+    for (auto &pass : m_culled_passes) {
+        if (const auto *graphics_pass = std::get_if<std::shared_ptr<GraphicsPass>>(&pass)) {
+            (*graphics_pass)->m_rendering_info_dirty = true;
+        }
+        m_passes.push_back(std::move(pass));
+    }
+    m_culled_passes.clear();
+
     check_for_cycles();
-    sort_graphics_passes_by_order();
+    sort_passes_by_order();
+    cull_unused_passes();
+    schedule_async_compute_passes();
+    find_transient_attachments();
     synchronize_frame_context();
-    create_graphics_pipelines();
+    create_pipelines();
     mark_graphics_pass_secondary_cmd_buffers_dirty();
 }
 
+void RenderGraph::export_resource(std::weak_ptr<Buffer> buffer) {
+    const auto buffer_ref = buffer.lock();
+    if (!buffer_ref) {
+        throw InexorException("Error: Parameter 'buffer' is invalid!");
+    }
+    m_exported_resources.insert(buffer_ref.get());
+}
+
+void RenderGraph::export_resource(std::weak_ptr<Texture> texture) {
+    const auto texture_ref = texture.lock();
+    if (!texture_ref) {
+        throw InexorException("Error: Parameter 'texture' is invalid!");
+    }
+    m_exported_resources.insert(texture_ref.get());
+}
+
+void RenderGraph::find_transient_attachments() {
+    // The images of the previous transient attachments alias memory blocks which are freed, and the images of the new
+    // transient attachments must be created in memory blocks, so they are all created again
+    bool device_idle = false;
+    auto destroy_images = [&](Texture &texture) {
+        const auto &resources = texture.current_frame_resources();
+        if (!resources.m_image && !resources.m_msaa_image) {
+            return;
+        }
+        if (!device_idle) {
+            m_device.wait_idle();
+            device_idle = true;
+        }
+        texture.destroy_all();
+        texture.m_update_requested = true;
+    };
+    for (const auto &attachment : m_transient_attachments) {
+        destroy_images(*attachment.texture);
+        attachment.texture->m_image_alias_memory = VK_NULL_HANDLE;
+        attachment.texture->m_msaa_image_alias_memory = VK_NULL_HANDLE;
+        attachment.texture->m_lazily_allocated = false;
+    }
+    m_transient_attachments.clear();
+    m_memory_handovers.clear();
+    m_transient_attachment_allocator.reset();
+
+    // The range of sorted passes which use a texture
+    struct TextureLifetime {
+        std::size_t first_pass{0};
+        std::size_t last_pass{0};
+        bool cleared_by_first_pass{false};
+        bool sampled{false};
+    };
+    std::unordered_map<const Texture *, TextureLifetime> lifetimes;
+    for (std::size_t pass_index = 0; pass_index < m_passes.size(); pass_index++) {
+        auto use_texture = [&](const std::weak_ptr<Texture> &weak_texture, const bool cleared, const bool sampled) {
+            const auto texture = weak_texture.lock();
+            if (!texture) {
+                return;
+            }
+            const auto [entry, first_use] = lifetimes.try_emplace(texture.get());
+            auto &lifetime = entry->second;
+            if (first_use) {
+                lifetime.first_pass = pass_index;
+                lifetime.cleared_by_first_pass = cleared;
+            }
+            lifetime.last_pass = pass_index;
+            lifetime.sampled = lifetime.sampled || sampled;
+        };
+        std::visit(
+            [&](const auto &pass) {
+                if constexpr (IS_GRAPHICS_PASS<decltype(pass)>) {
+                    for (const auto &[texture, clear_value] : pass->m_texture_writes) {
+                        use_texture(texture, clear_value.has_value(), false);
+                    }
+                    for (const auto &[texture, shader_stages] : pass->m_texture_reads) {
+                        use_texture(texture, false, true);
+                    }
+                } else {
+                    // The contents of storage images are loaded by compute shaders, so they are never transient
+                    for (const auto &texture : pass->m_texture_writes) {
+                        use_texture(texture, false, true);
+                    }
+                    for (const auto &texture : pass->m_texture_reads) {
+                        use_texture(texture, false, true);
+                    }
+                }
+            },
+            m_passes[pass_index]);
+    }
+
+    for (const auto &texture : m_textures) {
+        const auto lifetime = lifetimes.find(texture.get());
+        if (lifetime == lifetimes.end() || texture->usage() == TextureUsage::DEFAULT ||
+            !lifetime->second.cleared_by_first_pass || m_exported_resources.contains(texture.get()) ||
+            m_descriptor_resources.contains(texture.get())) {
+            continue;
+        }
+        const auto &[first_pass, last_pass, cleared_by_first_pass, sampled] = lifetime->second;
+        // The contents of an attachment which is neither sampled nor used by another pass are never stored
+        texture->m_lazily_allocated = m_device.is_lazily_allocated_memory_supported() && first_pass == last_pass &&
+                                      !sampled &&
+                                      (texture->samples() > VK_SAMPLE_COUNT_1_BIT ||
+                                       texture->usage() != TextureUsage::COLOR_ATTACHMENT);
+        destroy_images(*texture);
+        spdlog::trace("Texture {} is a transient attachment of passes {} to {}{}", texture->name(),
+                      first_pass, last_pass, texture->m_lazily_allocated ? " (lazily allocated)" : "");
+        m_transient_attachments.push_back({
+            .texture = texture.get(),
+            .first_pass = first_pass,
+            .last_pass = last_pass,
+        });
+    }
+}
+
 void RenderGraph::rebuild_graphics_pass_texture_rendering_info(GraphicsPass &pass) {
     if (!pass.m_rendering_info_dirty) {
         return;
@@ -241,7 +819,8 @@ void RenderGraph::rebuild_graphics_pass_texture_rendering_info(GraphicsPass &pas
     auto make_rendering_attachment_info = [&](const VkImageView image_view, const VkImageLayout image_layout,
                                               const std::optional<VkClearValue> &clear_value,
                                               const VkImageView resolve_image_view = VK_NULL_HANDLE,
-                                              const bool enable_resolve = false) {
+                                              const bool enable_resolve = false,
+                                              const VkAttachmentStoreOp store_op = VK_ATTACHMENT_STORE_OP_STORE) {
         const bool has_resolve = enable_resolve && resolve_image_view != VK_NULL_HANDLE;
         return make_info<VkRenderingAttachmentInfo>({
             .imageView = image_view,
@@ -250,7 +829,7 @@ void RenderGraph::rebuild_graphics_pass_texture_rendering_info(GraphicsPass &pas
             .resolveImageView = resolve_image_view,
             .resolveImageLayout = has_resolve ? image_layout : VK_IMAGE_LAYOUT_UNDEFINED,
             .loadOp = clear_value ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD,
-            .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+            .storeOp = store_op,
             .clearValue = clear_value.value_or(VkClearValue{}),
         });
     };
@@ -325,6 +904,8 @@ void RenderGraph::rebuild_graphics_pass_texture_rendering_info(GraphicsPass &pas
             .clear_value = write_attachment.second,
             .usage = attachment->usage(),
             .samples = sample_count,
+            .store_op =
+                attachment->m_lazily_allocated ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE,
         });
         track_attachment_usage(attachment->usage(), color_texture_attachment_count, has_depth_attachment,
                                has_stencil_attachment);
@@ -372,7 +953,8 @@ void RenderGraph::rebuild_graphics_pass_texture_rendering_info(GraphicsPass &pas
         return make_rendering_attachment_info(attachment_state.image_view, attachment_state.image_layout,
                                               attachment_state.clear_value, attachment_state.resolve_image_view,
                                               attachment_state.usage == TextureUsage::COLOR_ATTACHMENT &&
-                                                  attachment_state.resolve_image_view != VK_NULL_HANDLE);
+                                                  attachment_state.resolve_image_view != VK_NULL_HANDLE,
+                                              attachment_state.store_op);
     };
 
     for (const auto &attachment_state : texture_states) {
@@ -417,7 +999,8 @@ void RenderGraph::refresh_graphics_pass_swapchain_rendering_info(GraphicsPass &p
     auto make_rendering_attachment_info = [](const VkImageView image_view, const VkImageLayout image_layout,
                                              const std::optional<VkClearValue> &clear_value,
                                              const VkImageView resolve_image_view = VK_NULL_HANDLE,
-                                             const bool enable_resolve = false) {
+                                             const bool enable_resolve = false,
+                                             const VkAttachmentStoreOp store_op = VK_ATTACHMENT_STORE_OP_STORE) {
         const bool has_resolve = enable_resolve && resolve_image_view != VK_NULL_HANDLE;
         return make_info<VkRenderingAttachmentInfo>({
             .imageView = image_view,
@@ -426,7 +1009,7 @@ void RenderGraph::refresh_graphics_pass_swapchain_rendering_info(GraphicsPass &p
             .resolveImageView = resolve_image_view,
             .resolveImageLayout = has_resolve ? image_layout : VK_IMAGE_LAYOUT_UNDEFINED,
             .loadOp = clear_value ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD,
-            .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+            .storeOp = store_op,
             .clearValue = clear_value.value_or(VkClearValue{}),
         });
     };
@@ -513,7 +1096,8 @@ void RenderGraph::refresh_graphics_pass_swapchain_rendering_info(GraphicsPass &p
             make_rendering_attachment_info(attachment_state.image_view, attachment_state.image_layout,
                                            attachment_state.clear_value, attachment_state.resolve_image_view,
                                            attachment_state.usage == TextureUsage::COLOR_ATTACHMENT &&
-                                               attachment_state.resolve_image_view != VK_NULL_HANDLE));
+                                               attachment_state.resolve_image_view != VK_NULL_HANDLE,
+                                           attachment_state.store_op));
     }
 
     if (!resolve_to_swapchain) {
@@ -548,15 +1132,115 @@ void RenderGraph::refresh_graphics_pass_swapchain_rendering_info(GraphicsPass &p
     });
 }
 
-void RenderGraph::record_command_buffer_for_pass(const CommandBuffer &cmd_buf, GraphicsPass &pass) {
-    if (pass.m_rendering_info_dirty) {
-        rebuild_graphics_pass_texture_rendering_info(pass);
+void RenderGraph::require_graphics_pass_resources(const GraphicsPass &pass) {
+    for (const auto &[weak_texture, clear_value] : pass.m_texture_writes) {
+        const auto texture = weak_texture.lock();
+        if (!texture) {
+            throw InexorException("Error: Graphics pass texture attachment expired!");
+        }
+        // Multisampled attachments are rendered into the MSAA image
+        const auto &resources = texture->current_frame_resources();
+        const auto &image = resources.m_msaa_image ? resources.m_msaa_image : resources.m_image;
+        m_resource_state_tracker.require_image(image->image(), texture->subresource_range(),
+                                               get_attachment_access(texture->usage(), clear_value.has_value()));
+    }
+    for (const auto &[weak_swapchain, clear_value] : pass.m_swapchain_writes) {
+        const auto swapchain = weak_swapchain.lock();
+        if (!swapchain) {
+            throw InexorException("Error: Graphics pass swapchain attachment expired!");
+        }
+        m_resource_state_tracker.require_image(
+            swapchain->current_swapchain_image(), COLOR_IMAGE_RANGE,
+            get_attachment_access(TextureUsage::COLOR_ATTACHMENT, clear_value.has_value()));
     }
-    if (!pass.m_swapchain_writes.empty()) {
-        refresh_graphics_pass_swapchain_rendering_info(pass);
+    for (const auto &[weak_texture, shader_stages] : pass.m_texture_reads) {
+        const auto texture = weak_texture.lock();
+        if (!texture) {
+            throw InexorException("Error: Graphics pass texture read expired!");
+        }
+        const auto access = get_texture_read_access(texture->usage(), texture->shader_access_layout(),
+                                                    get_pipeline_stages(shader_stages));
+        m_resource_state_tracker.require_image(texture->current_frame_resources().m_image->image(),
+                                               texture->subresource_range(), access);
+    }
+    // Buffers which have not been created yet can't be accessed by the pass
+    for (const auto &weak_buffer : pass.m_buffer_reads) {
+        const auto buffer = weak_buffer.lock();
+        if (buffer && buffer->buffer() != VK_NULL_HANDLE) {
+            m_resource_state_tracker.require_buffer(buffer->buffer(), get_buffer_read_access(buffer->type()));
+        }
     }
+    for (const auto &weak_buffer : pass.m_buffer_writes) {
+        const auto buffer = weak_buffer.lock();
+        if (buffer && buffer->buffer() != VK_NULL_HANDLE) {
+            m_resource_state_tracker.require_buffer(
+                buffer->buffer(), {
+                                      .stage_mask = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT |
+                                                    VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                                      .access_mask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                                  });
+        }
+    }
+}
 
-    const auto inheritance_rendering_info = make_info<VkCommandBufferInheritanceRenderingInfo>({
+void RenderGraph::require_compute_pass_resources(const ComputePass &pass) {
+    for (const auto &weak_texture : pass.m_texture_writes) {
+        const auto texture = weak_texture.lock();
+        if (!texture) {
+            throw InexorException("Error: Compute pass storage image expired!");
+        }
+        // Storage images are often read and written by the same dispatch
+        m_resource_state_tracker.require_image(
+            texture->current_frame_resources().m_image->image(), texture->subresource_range(),
+            {
+                .stage_mask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                .access_mask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                .layout = VK_IMAGE_LAYOUT_GENERAL,
+            });
+    }
+    for (const auto &weak_texture : pass.m_texture_reads) {
+        const auto texture = weak_texture.lock();
+        if (!texture) {
+            throw InexorException("Error: Compute pass texture read expired!");
+        }
+        const auto access = get_texture_read_access(texture->usage(), texture->shader_access_layout(),
+                                                    VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+        m_resource_state_tracker.require_image(texture->current_frame_resources().m_image->image(),
+                                               texture->subresource_range(), access);
+    }
+    // Buffers which have not been created yet can't be accessed by the pass
+    for (const auto &weak_buffer : pass.m_buffer_reads) {
+        const auto buffer = weak_buffer.lock();
+        if (buffer && buffer->buffer() != VK_NULL_HANDLE) {
+            m_resource_state_tracker.require_buffer(buffer->buffer(), get_compute_buffer_read_access(buffer->type()));
+        }
+    }
+    for (const auto &weak_buffer : pass.m_buffer_writes) {
+        const auto buffer = weak_buffer.lock();
+        if (buffer && buffer->buffer() != VK_NULL_HANDLE) {
+            m_resource_state_tracker.require_buffer(
+                buffer->buffer(), {
+                                      .stage_mask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                      .access_mask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT |
+                                                     VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                                  });
+        }
+    }
+}
+
+void RenderGraph::record_command_buffer_for_pass(const CommandBuffer &cmd_buf, const GraphicsPass &pass) {
+    const auto inheritance_rendering_info = make_inheritance_rendering_info(pass);
+    const auto inheritance_info = make_info<VkCommandBufferInheritanceInfo>({
+        .pNext = &inheritance_rendering_info,
+    });
+
+    m_command_buffer_cache.execute_secondary_command_buffer(cmd_buf, pass.m_name, pass.m_debug_label_color,
+                                                            pass.m_cached_render_extent, inheritance_info,
+                                                            pass.m_rendering_info, pass.m_on_record_cmd_buffer);
+}
+
+VkCommandBufferInheritanceRenderingInfo RenderGraph::make_inheritance_rendering_info(const GraphicsPass &pass) {
+    return make_info<VkCommandBufferInheritanceRenderingInfo>({
         .colorAttachmentCount = static_cast<std::uint32_t>(pass.m_cached_color_attachment_formats.size()),
         .pColorAttachmentFormats =
             pass.m_cached_color_attachment_formats.empty() ? nullptr : pass.m_cached_color_attachment_formats.data(),
@@ -564,14 +1248,108 @@ void RenderGraph::record_command_buffer_for_pass(const CommandBuffer &cmd_buf, G
         .stencilAttachmentFormat = pass.m_cached_stencil_attachment_format,
         .rasterizationSamples = pass.m_cached_sample_count,
     });
+}
 
+void RenderGraph::record_secondary_command_buffer_for_pass(const GraphicsPass &pass) {
+    const auto inheritance_rendering_info = make_inheritance_rendering_info(pass);
     const auto inheritance_info = make_info<VkCommandBufferInheritanceInfo>({
         .pNext = &inheritance_rendering_info,
     });
+    m_command_buffer_cache.record_secondary_command_buffer(pass.m_name, inheritance_info, pass.m_on_record_cmd_buffer);
+}
+
+void RenderGraph::record_dirty_secondary_command_buffers() {
+    auto &dirty_passes = m_scratch_dirty_graphics_passes;
+    dirty_passes.clear();
+    for (const auto &pass : m_graphics_passes) {
+        if (pass->m_rendering_info_dirty) {
+            rebuild_graphics_pass_texture_rendering_info(*pass);
+        }
+        if (!pass->m_swapchain_writes.empty()) {
+            refresh_graphics_pass_swapchain_rendering_info(*pass);
+        }
+        if (pass->m_secondary_cmd_buffers_dirty) {
+            m_command_buffer_cache.invalidate_secondary_command_buffers(pass->m_name);
+            pass->m_secondary_cmd_buffers_dirty = false;
+        }
+        if (m_command_buffer_cache.prepare_secondary_command_buffer(pass->m_name, pass->m_cached_render_extent)) {
+            dirty_passes.push_back(pass.get());
+        }
+    }
+    if (dirty_passes.empty()) {
+        return;
+    }
+
+    // The render thread records the first pass while the thread pool records the other passes
+    auto &recordings = m_scratch_recording_futures;
+    recordings.clear();
+    const std::size_t render_thread_pass_count = m_recording_thread_pool ? 1 : dirty_passes.size();
+    for (std::size_t pass_index = render_thread_pass_count; pass_index < dirty_passes.size(); pass_index++) {
+        recordings.push_back(m_recording_thread_pool->submit(
+            [this, pass = dirty_passes[pass_index]] { record_secondary_command_buffer_for_pass(*pass); }));
+    }
 
-    m_command_buffer_cache.record_secondary_command_buffer(cmd_buf, pass.m_name, pass.m_debug_label_color,
-                                                           pass.m_cached_render_extent, inheritance_info,
-                                                           pass.m_rendering_info, pass.m_on_record_cmd_buffer);
+    std::exception_ptr exception;
+    try {
+        for (std::size_t pass_index = 0; pass_index < render_thread_pass_count; pass_index++) {
+            record_secondary_command_buffer_for_pass(*dirty_passes[pass_index]);
+        }
+    } catch (...) {
+        exception = std::current_exception();
+    }
+    // All recordings must have finished before an exception is rethrown, because they access the passes
+    for (auto &recording : recordings) {
+        try {
+            recording.get();
+        } catch (...) {
+            if (!exception) {
+                exception = std::current_exception();
+            }
+        }
+    }
+    recordings.clear();
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void RenderGraph::record_compute_pass(CommandBufferBuilder &cmd_buf, const ComputePass &pass) {
+    cmd_buf.begin_debug_label_region(pass.m_name, pass.m_debug_label_color);
+    std::invoke(pass.m_on_record_cmd_buffer, cmd_buf);
+    cmd_buf.end_debug_label_region();
+}
+
+void RenderGraph::record_passes(CommandBufferBuilder &cmd_buf, const std::size_t first_pass, const std::size_t end_pass,
+                                const bool skip_async_compute_passes) {
+    // Every pass is preceded by the barriers it needs, which are derived from the tracked resource states
+    auto handover = std::lower_bound(
+        m_memory_handovers.begin(), m_memory_handovers.end(), first_pass,
+        [](const MemoryHandover &memory_handover, const std::size_t pass_index) {
+            return memory_handover.pass_index < pass_index;
+        });
+    for (std::size_t pass_index = first_pass; pass_index < end_pass; pass_index++) {
+        // Transient attachments discard the contents of the memory they take over from other attachments
+        for (; handover != m_memory_handovers.end() && handover->pass_index == pass_index; ++handover) {
+            m_resource_state_tracker.alias_image(handover->image, handover->range, handover->previous_image);
+        }
+        if (skip_async_compute_passes && m_async_compute_passes[pass_index]) {
+            continue;
+        }
+        std::visit(
+            [&](const auto &pass) {
+                if constexpr (IS_GRAPHICS_PASS<decltype(pass)>) {
+                    require_graphics_pass_resources(*pass);
+                    m_resource_state_tracker.flush(cmd_buf);
+                    record_command_buffer_for_pass(cmd_buf.command_buffer(), *pass);
+                } else {
+                    // Compute passes are recorded into the primary command buffer, outside of rendering
+                    require_compute_pass_resources(*pass);
+                    m_resource_state_tracker.flush(cmd_buf);
+                    record_compute_pass(cmd_buf, *pass);
+                }
+            },
+            m_passes[pass_index]);
+    }
 }
 
 void RenderGraph::render() {
@@ -589,64 +1367,168 @@ void RenderGraph::render() {
 
     auto &render_wait_semaphores = m_scratch_render_wait_semaphores;
     render_wait_semaphores.clear();
-    render_wait_semaphores.reserve(m_swapchain_manager.image_available_semaphores().size() +
-                                   (m_upload_submission_pending ? 1u : 0u));
+    render_wait_semaphores.reserve(m_swapchain_manager.image_available_semaphores().size() + 2);
     for (const auto semaphore : m_swapchain_manager.image_available_semaphores()) {
         render_wait_semaphores.push_back({
             .semaphore = semaphore,
-            .stage_mask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .stage_mask = SwapchainManager::IMAGE_AVAILABLE_WAIT_STAGE,
         });
     }
-    if (m_upload_submission_pending) {
-        const auto upload_wait_stage_mask = m_upload_wait_stage_mask == VK_PIPELINE_STAGE_2_NONE
-                                                ? VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT
-                                                : m_upload_wait_stage_mask;
-        render_wait_semaphores.push_back({
-            .semaphore = m_upload_finished->semaphore(),
-            .stage_mask = upload_wait_stage_mask,
+
+    // The last submission of the frame signals the frame timeline, which the deferred releases of the frame wait for
+    auto &render_signal_semaphores = m_scratch_render_signal_semaphores;
+    render_signal_semaphores.clear();
+    for (const auto semaphore : m_swapchain_manager.rendering_finished_semaphores()) {
+        render_signal_semaphores.push_back(VkSemaphoreSubmitInfo{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = semaphore,
+            .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
         });
     }
+    render_signal_semaphores.push_back(VkSemaphoreSubmitInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = m_frame_sync_manager.frame_timeline_semaphore(),
+        .value = m_frame_sync_manager.current_frame_value(),
+        .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+    });
 
     if (m_resource_descriptors.descriptor_sets_dirty()) {
         if (m_resource_descriptors.update_write_descriptor_sets()) {
             mark_graphics_pass_secondary_cmd_buffers_dirty();
         }
     }
+    record_dirty_secondary_command_buffers();
+
+    VkFence render_submit_fence = VK_NULL_HANDLE;
+    if (!m_async_compute_passes.empty()) {
+        render_submit_fence = render_with_async_compute(render_wait_semaphores, render_signal_semaphores);
+    } else {
+        if (m_upload_submission_pending) {
+            render_wait_semaphores.push_back({
+                .semaphore = m_upload_finished->semaphore(),
+                .stage_mask = m_upload_wait_stage_mask,
+                .value = m_upload_timeline_value,
+            });
+        }
+        render_submit_fence = m_device.execute(
+            VK_QUEUE_GRAPHICS_BIT, DebugLabelColor::CYAN,
+            [&](CommandBufferBuilder &builder) {
+                if (m_inline_update_commands) {
+                    m_inline_update_commands(builder);
+                }
+
+                // Acquire ownership of any buffers/images that were uploaded on a transfer queue whose family differs
+                // from the graphics queue family, before they are read by any pass below.
+                m_pending_queue_ownership_acquire_barriers.flush_if_not_empty(builder);
+
+                m_swapchain_manager.prepare_swapchains_for_rendering(m_resource_state_tracker);
+                record_passes(builder, 0, m_passes.size(), false);
+                m_swapchain_manager.prepare_swapchains_for_presenting(m_resource_state_tracker, builder);
+            },
+            render_wait_semaphores, render_signal_semaphores);
+    }
+
+    m_upload_submission_pending = false;
+    m_inline_update_commands = {};
 
-    const auto render_submit_fence = m_device.execute(
+    m_frame_sync_manager.mark_frame_submitted();
+    m_swapchain_manager.mark_frame_swapchains_in_flight(render_submit_fence);
+    m_swapchain_manager.present(m_swapchain_manager.rendering_finished_semaphores());
+}
+
+VkFence RenderGraph::render_with_async_compute(const std::span<const QueueSemaphoreWait> render_wait_semaphores,
+                                               const std::span<const VkSemaphoreSubmitInfo> render_signal_semaphores) {
+    const auto graphics_queue_family_index = m_device.graphics_queue_family_index();
+    const auto compute_queue_family_index = m_device.compute_queue_family_index();
+    const std::array<VkSemaphore, 1> resources_released_semaphore{m_async_compute_resources_released->semaphore()};
+    const std::array<VkSemaphore, 1> compute_finished_semaphore{m_async_compute_finished->semaphore()};
+
+    // The uploads of the frame are submitted first, because they may write to the resources of the async compute
+    // passes, which are then handed over to the async compute queue. An upload on the transfer queue is waited for by
+    // all commands of this submission, whose acquire barriers precede every pass.
+    const std::array<QueueSemaphoreWait, 1> upload_wait{{{
+        .semaphore = m_upload_finished->semaphore(),
+        .stage_mask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        .value = m_upload_timeline_value,
+    }}};
+    std::ignore = m_device.execute(
         VK_QUEUE_GRAPHICS_BIT, DebugLabelColor::CYAN,
         [&](CommandBufferBuilder &builder) {
             if (m_inline_update_commands) {
                 m_inline_update_commands(builder);
             }
-
-            // Acquire ownership of any buffers/images that were uploaded on a transfer queue whose family differs
-            // from the graphics queue family, before they are read by any pass below.
             m_pending_queue_ownership_acquire_barriers.flush_if_not_empty(builder);
-
-            m_swapchain_manager.prepare_swapchains_for_rendering(builder);
-            for (const auto &pass : m_graphics_passes) {
-                record_command_buffer_for_pass(builder.command_buffer(), *pass);
+            transfer_async_compute_resources(graphics_queue_family_index, compute_queue_family_index,
+                                             m_pending_async_compute_acquire_barriers);
+            m_scratch_release_barriers.flush_if_not_empty(builder);
+        },
+        std::span<const QueueSemaphoreWait>(upload_wait.data(), m_upload_submission_pending ? 1 : 0),
+        std::span<const VkSemaphore>(resources_released_semaphore));
+
+    const std::array<QueueSemaphoreWait, 1> resources_released_wait{{{
+        .semaphore = m_async_compute_resources_released->semaphore(),
+        .stage_mask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+    }}};
+    std::ignore = m_device.execute(
+        VK_QUEUE_COMPUTE_BIT, DebugLabelColor::ORANGE,
+        [&](CommandBufferBuilder &builder) {
+            m_pending_async_compute_acquire_barriers.flush_if_not_empty(builder);
+            for (std::size_t pass_index = 0; pass_index < m_passes.size(); pass_index++) {
+                if (!m_async_compute_passes[pass_index]) {
+                    continue;
+                }
+                const auto &pass = *std::get<std::shared_ptr<ComputePass>>(m_passes[pass_index]);
+                require_compute_pass_resources(pass);
+                m_resource_state_tracker.flush(builder);
+                record_compute_pass(builder, pass);
             }
-            m_swapchain_manager.prepare_swapchains_for_presenting(builder);
+            transfer_async_compute_resources(compute_queue_family_index, graphics_queue_family_index,
+                                             m_pending_graphics_acquire_barriers);
+            m_scratch_release_barriers.flush_if_not_empty(builder);
         },
-        render_wait_semaphores, m_swapchain_manager.rendering_finished_semaphores());
-
-    m_upload_submission_pending = false;
-
-    if (!m_inline_update_pending_releases.empty()) {
-        std::vector<VkFence> release_wait_fences = m_frame_sync_manager.frame_slot_submission_fences();
-        release_wait_fences.push_back(render_submit_fence);
-        for (auto &release : m_inline_update_pending_releases) {
-            m_frame_sync_manager.defer_release(release_wait_fences, std::move(release));
+        std::span<const QueueSemaphoreWait>(resources_released_wait),
+        std::span<const VkSemaphore>(compute_finished_semaphore));
+
+    // The passes in front of the split don't access the resources of the async compute passes, so they overlap with
+    // them. The swapchain images must be available for the first submission which renders into them.
+    m_swapchain_manager.prepare_swapchains_for_rendering(m_resource_state_tracker);
+    bool has_passes_before_split = false;
+    bool renders_to_swapchain_before_split = false;
+    for (std::size_t pass_index = 0; pass_index < m_async_compute_split_index; pass_index++) {
+        if (m_async_compute_passes[pass_index]) {
+            continue;
+        }
+        has_passes_before_split = true;
+        if (const auto *graphics_pass = std::get_if<std::shared_ptr<GraphicsPass>>(&m_passes[pass_index])) {
+            renders_to_swapchain_before_split =
+                renders_to_swapchain_before_split || !(*graphics_pass)->m_swapchain_writes.empty();
         }
-        m_inline_update_pending_releases.clear();
     }
-    m_inline_update_commands = {};
+    if (has_passes_before_split) {
+        std::ignore = m_device.execute(
+            VK_QUEUE_GRAPHICS_BIT, DebugLabelColor::CYAN,
+            [&](CommandBufferBuilder &builder) { record_passes(builder, 0, m_async_compute_split_index, true); },
+            renders_to_swapchain_before_split ? render_wait_semaphores : std::span<const QueueSemaphoreWait>{},
+            std::span<const VkSemaphore>{});
+    }
 
-    m_frame_sync_manager.mark_frame_slot_submission_fence(render_submit_fence);
-    m_swapchain_manager.mark_frame_swapchains_in_flight(render_submit_fence);
-    m_swapchain_manager.present(m_swapchain_manager.rendering_finished_semaphores());
+    // The semaphores which the swapchain images wait for are stored in m_scratch_render_wait_semaphores
+    auto &wait_semaphores = m_scratch_render_wait_semaphores;
+    if (renders_to_swapchain_before_split) {
+        wait_semaphores.clear();
+    }
+    wait_semaphores.push_back({
+        .semaphore = m_async_compute_finished->semaphore(),
+        .stage_mask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+    });
+    return m_device.execute(
+        VK_QUEUE_GRAPHICS_BIT, DebugLabelColor::CYAN,
+        [&](CommandBufferBuilder &builder) {
+            m_pending_graphics_acquire_barriers.flush_if_not_empty(builder);
+            record_passes(builder, m_async_compute_split_index, m_passes.size(), true);
+            m_swapchain_manager.prepare_swapchains_for_presenting(m_resource_state_tracker, builder);
+        },
+        std::span<const QueueSemaphoreWait>(wait_semaphores), render_signal_semaphores);
 }
 
 void RenderGraph::reset_graph() {
@@ -654,16 +1536,31 @@ void RenderGraph::reset_graph() {
     m_staging_buffer.reset();
     m_buffers.clear();
     m_textures.clear();
+    m_transient_attachments.clear();
+    m_memory_handovers.clear();
+    m_transient_attachment_allocator.reset();
+    m_passes.clear();
     m_graphics_passes.clear();
+    m_pass_dependencies.clear();
+    m_culled_passes.clear();
+    m_async_compute_passes.clear();
+    m_async_compute_split_index = 0;
+    m_async_compute_buffers.clear();
+    m_async_compute_textures.clear();
+    m_exported_resources.clear();
+    m_descriptor_resources.clear();
+    m_culled_resources.clear();
     m_resource_descriptors.clear();
     m_graphics_pipeline_create_functions.clear();
-    m_graphics_passes.clear();
+    m_compute_pipeline_create_functions.clear();
     m_swapchain_manager.clear();
+    m_resource_state_tracker.reset();
     m_upload_submission_pending = false;
     m_upload_wait_stage_mask = VK_PIPELINE_STAGE_2_NONE;
     m_inline_update_commands = {};
-    m_inline_update_pending_releases.clear();
     m_pending_queue_ownership_acquire_barriers.reset();
+    m_pending_async_compute_acquire_barriers.reset();
+    m_pending_graphics_acquire_barriers.reset();
     m_frame_sync_manager.clear();
     m_frame_slot_count = 1;
     m_current_frame_slot = 0;
@@ -671,22 +1568,170 @@ void RenderGraph::reset_graph() {
     m_scratch_pending_texture_copies.clear();
     m_buffer_copy_batch_builder.reset();
     m_texture_copy_batch_builder.reset();
-    m_scratch_pending_releases.clear();
     m_scratch_color_attachment_formats.clear();
     m_resource_descriptors.mark_descriptor_sets_dirty();
     mark_graphics_pass_secondary_cmd_buffers_dirty();
 }
 
-void RenderGraph::sort_graphics_passes_by_order() {
-    // @TODO Implement this in rendergraph3
-    // @TODO Implement ordering mechanisms between passes instead of relying on swapchain write order
+void RenderGraph::schedule_async_compute_passes() {
+    m_async_compute_passes.clear();
+    m_async_compute_split_index = m_passes.size();
+    m_async_compute_buffers.clear();
+    m_async_compute_textures.clear();
+    if (!m_device.has_async_compute_queue()) {
+        return;
+    }
+
+    // The passes are sorted, so the passes which a pass depends on have been visited before it
+    std::vector<bool> depends_on_graphics_pass(m_passes.size(), false);
+    m_async_compute_passes.assign(m_passes.size(), false);
+    bool any_async_compute_pass = false;
+    for (std::size_t pass_index = 0; pass_index < m_passes.size(); pass_index++) {
+        for (const auto dependency : m_pass_dependencies[pass_index]) {
+            if (std::holds_alternative<std::shared_ptr<GraphicsPass>>(m_passes[dependency]) ||
+                depends_on_graphics_pass[dependency]) {
+                depends_on_graphics_pass[pass_index] = true;
+                break;
+            }
+        }
+        if (std::holds_alternative<std::shared_ptr<ComputePass>>(m_passes[pass_index]) &&
+            !depends_on_graphics_pass[pass_index]) {
+            m_async_compute_passes[pass_index] = true;
+            any_async_compute_pass = true;
+        }
+    }
+    if (!any_async_compute_pass) {
+        m_async_compute_passes.clear();
+        return;
+    }
+
+    // Collect the resources of the async compute passes
+    std::unordered_set<const void *> async_compute_resources;
+    for (std::size_t pass_index = 0; pass_index < m_passes.size(); pass_index++) {
+        if (!m_async_compute_passes[pass_index]) {
+            continue;
+        }
+        const auto &pass = *std::get<std::shared_ptr<ComputePass>>(m_passes[pass_index]);
+        auto add_resource = [&](const auto &weak_resource, auto &resources) {
+            const auto resource = weak_resource.lock();
+            if (resource && async_compute_resources.insert(resource.get()).second) {
+                resources.push_back(resource.get());
+            }
+        };
+        for (const auto &buffer : pass.m_buffer_reads) {
+            add_resource(buffer, m_async_compute_buffers);
+        }
+        for (const auto &buffer : pass.m_buffer_writes) {
+            add_resource(buffer, m_async_compute_buffers);
+        }
+        for (const auto &texture : pass.m_texture_reads) {
+            add_resource(texture, m_async_compute_textures);
+        }
+        for (const auto &texture : pass.m_texture_writes) {
+            add_resource(texture, m_async_compute_textures);
+        }
+    }
+
+    // The first pass on the graphics queue which accesses any of these resources must wait for the async compute passes
+    for (std::size_t pass_index = 0; pass_index < m_passes.size(); pass_index++) {
+        if (m_async_compute_passes[pass_index]) {
+            continue;
+        }
+        auto is_async_compute_resource = [&](const auto &weak_resource) {
+            const auto resource = weak_resource.lock();
+            return resource && async_compute_resources.contains(resource.get());
+        };
+        const bool accesses_async_compute_resource = std::visit(
+            [&](const auto &pass) {
+                if (std::any_of(pass->m_buffer_reads.begin(), pass->m_buffer_reads.end(), is_async_compute_resource) ||
+                    std::any_of(pass->m_buffer_writes.begin(), pass->m_buffer_writes.end(),
+                                is_async_compute_resource)) {
+                    return true;
+                }
+                if constexpr (IS_GRAPHICS_PASS<decltype(pass)>) {
+                    return std::any_of(pass->m_texture_reads.begin(), pass->m_texture_reads.end(),
+                                       [&](const auto &texture_read) {
+                                           return is_async_compute_resource(texture_read.first);
+                                       }) ||
+                           std::any_of(pass->m_texture_writes.begin(), pass->m_texture_writes.end(),
+                                       [&](const auto &texture_write) {
+                                           return is_async_compute_resource(texture_write.first);
+                                       });
+                } else {
+                    return std::any_of(pass->m_texture_reads.begin(), pass->m_texture_reads.end(),
+                                       is_async_compute_resource) ||
+                           std::any_of(pass->m_texture_writes.begin(), pass->m_texture_writes.end(),
+                                       is_async_compute_resource);
+                }
+            },
+            m_passes[pass_index]);
+        if (accesses_async_compute_resource) {
+            m_async_compute_split_index = pass_index;
+            break;
+        }
+    }
+
+    for (std::size_t pass_index = 0; pass_index < m_passes.size(); pass_index++) {
+        if (m_async_compute_passes[pass_index]) {
+            spdlog::trace("Pass {} is recorded on the async compute queue",
+                          std::get<std::shared_ptr<ComputePass>>(m_passes[pass_index])->m_name);
+        }
+    }
+    spdlog::trace("The passes from pass {} on wait for the async compute passes", m_async_compute_split_index);
+}
+
+void RenderGraph::sort_passes_by_order() {
+    const auto order = sort_topologically(m_pass_dependencies);
+
+    std::vector<std::size_t> new_index(order.size());
+    for (std::size_t idx = 0; idx < order.size(); idx++) {
+        new_index[order[idx]] = idx;
+    }
+    std::vector<Pass> sorted_passes;
+    std::vector<std::vector<std::size_t>> sorted_dependencies;
+    sorted_passes.reserve(order.size());
+    sorted_dependencies.reserve(order.size());
+    for (const auto pass_index : order) {
+        sorted_passes.push_back(std::move(m_passes[pass_index]));
+        auto &dependencies = sorted_dependencies.emplace_back(std::move(m_pass_dependencies[pass_index]));
+        for (auto &dependency : dependencies) {
+            dependency = new_index[dependency];
+        }
+        std::sort(dependencies.begin(), dependencies.end());
+    }
+    m_passes = std::move(sorted_passes);
+    m_pass_dependencies = std::move(sorted_dependencies);
+
+    for (std::size_t idx = 0; idx < m_passes.size(); idx++) {
+        spdlog::trace("Pass {}: {}", idx, std::visit([](const auto &pass) { return pass->m_name; }, m_passes[idx]));
+    }
+}
+
+void RenderGraph::transfer_async_compute_resources(const std::uint32_t src_queue_family_index,
+                                                   const std::uint32_t dst_queue_family_index,
+                                                   PipelineBarrierBatchBuilder &acquire_barriers) {
+    // Buffers and images which have not been created yet are not accessed by the passes either
+    for (const auto *buffer : m_async_compute_buffers) {
+        if (buffer->buffer() != VK_NULL_HANDLE) {
+            m_resource_state_tracker.transfer_buffer_ownership(buffer->buffer(), src_queue_family_index,
+                                                               dst_queue_family_index, m_scratch_release_barriers,
+                                                               acquire_barriers);
+        }
+    }
+    for (const auto *texture : m_async_compute_textures) {
+        const auto &image = texture->current_frame_resources().m_image;
+        if (image) {
+            m_resource_state_tracker.transfer_image_ownership(image->image(), texture->subresource_range(),
+                                                              src_queue_family_index, dst_queue_family_index,
+                                                              m_scratch_release_barriers, acquire_barriers);
+        }
+    }
 }
 
 void RenderGraph::update_resources() {
     m_upload_submission_pending = false;
     m_upload_wait_stage_mask = VK_PIPELINE_STAGE_2_NONE;
     m_inline_update_commands = {};
-    m_inline_update_pending_releases.clear();
 
     bool any_buffer_update_required = false;
     bool any_buffer_gpu_update_required = false;
@@ -697,6 +1742,9 @@ void RenderGraph::update_resources() {
     pending_gpu_buffer_updates.reserve(m_buffers.size());
 
     for (const auto &buffer : m_buffers) {
+        if (m_culled_resources.contains(buffer.get())) {
+            continue;
+        }
         std::invoke(buffer->m_on_check_for_update);
         if (buffer->m_update_requested) {
             any_buffer_update_required = true;
@@ -713,27 +1761,33 @@ void RenderGraph::update_resources() {
     }
 
     bool any_texture_update_required = false;
-    // Attachment-type textures (color/depth/stencil) that need their initial layout transition (or, in principle, a
-    // CPU-data re-upload) use graphics-pipeline-only pipeline stages (color attachment output, fragment tests) which
-    // are not valid on a transfer-only queue family. Whenever this is the case, we must not route this frame's
-    // updates through the transfer queue at all (falls back to the same-queue/inline path further below).
+    // Uploading CPU data into attachment-type textures (color/depth/stencil) needs a layout transition which waits for
+    // graphics-pipeline-only pipeline stages (color attachment output, fragment tests), which are not valid on a
+    // transfer-only queue family. Whenever this is the case, we must not route this frame's updates through the
+    // transfer queue at all (falls back to the same-queue/inline path further below). Newly created attachments don't
+    // need any preparation, because the passes which write to them transition them on first use.
     bool any_attachment_texture_layout_prep_required = false;
+    // Textures which already exist may still be sampled by the frames in flight on the graphics queue, which the
+    // transfer queue would have to wait for. Only the uploads into new images are made on the transfer queue.
+    bool any_texture_update_requires_graphics_queue = false;
     std::vector<Texture *> pending_texture_updates;
     pending_texture_updates.reserve(m_textures.size());
     for (const auto &texture : m_textures) {
+        if (m_culled_resources.contains(texture.get())) {
+            continue;
+        }
         if (texture->m_on_update) {
             std::invoke(texture->m_on_update.value());
         }
         if (texture->m_update_requested) {
             any_texture_update_required = true;
             pending_texture_updates.push_back(texture.get());
-            if (texture->usage() != TextureUsage::DEFAULT) {
-                const bool needs_initial_layout_prep =
-                    !texture->current_frame_resources().m_image ||
-                    texture->current_frame_resources().m_image->image() == VK_NULL_HANDLE;
-                if (needs_initial_layout_prep || texture->m_src_texture_data_size != 0) {
-                    any_attachment_texture_layout_prep_required = true;
-                }
+            if (texture->usage() != TextureUsage::DEFAULT && texture->m_src_texture_data_size != 0) {
+                any_attachment_texture_layout_prep_required = true;
+            }
+            const auto &image = texture->current_frame_resources().m_image;
+            if (texture->m_src_texture_data_size != 0 && image && image->image() != VK_NULL_HANDLE) {
+                any_texture_update_requires_graphics_queue = true;
             }
         }
     }
@@ -742,8 +1796,8 @@ void RenderGraph::update_resources() {
         return;
     }
 
-    auto &pending_releases = m_scratch_pending_releases;
-    pending_releases.clear();
+    // The frame waits for the upload, so the replaced resources are released once the frame is finished
+    auto &pending_releases = m_frame_sync_manager.current_frame_releases();
 
     for (auto *buffer : pending_direct_buffer_updates) {
         buffer->update_without_command_buffer();
@@ -783,10 +1837,13 @@ void RenderGraph::update_resources() {
 
     m_staging_buffer.ensure_capacity(required_upload_bytes, pending_releases);
 
-    // Keep uploads on the graphics queue so the frame uses one submit path end-to-end. This avoids the extra
-    // transfer-queue submit and the queue-family ownership transfer overhead, at the cost of giving up async upload
-    // overlap with rendering.
-    const bool use_transfer_queue = false && !any_attachment_texture_layout_prep_required;
+    // Uploads are made on the transfer queue if all of them write into new resources. These are not accessed by the
+    // frames in flight, so the copies overlap with rendering, and their barriers don't carry any graphics stages. All
+    // other uploads are recorded in front of the passes on the graphics queue.
+    const bool use_transfer_queue = m_device.has_dedicated_transfer_queue() &&
+                                    !any_buffer_gpu_update_requires_graphics_queue &&
+                                    !any_attachment_texture_layout_prep_required &&
+                                    !any_texture_update_requires_graphics_queue;
     const bool needs_queue_family_ownership_transfer =
         use_transfer_queue && !m_device.transfer_queue_shares_graphics_family();
     const std::uint32_t transfer_family_index =
@@ -808,6 +1865,10 @@ void RenderGraph::update_resources() {
 
     for (auto *buffer : pending_gpu_buffer_updates) {
         buffer->create(m_scratch_pending_buffer_copies, m_staging_buffer, upload_offset, pending_releases);
+        if (buffer->update_mode() == BufferUpdateMode::DEVICE_LOCAL) {
+            // Device local buffers are created again for every update, and may reuse the handle of a destroyed buffer
+            m_resource_state_tracker.forget_buffer(buffer->buffer());
+        }
         if (buffer->m_descriptor_resource_changed) {
             m_resource_descriptors.mark_descriptor_sets_dirty();
             mark_graphics_pass_secondary_cmd_buffers_dirty();
@@ -815,6 +1876,24 @@ void RenderGraph::update_resources() {
     }
 
     m_buffer_copy_batch_builder.add(m_scratch_pending_buffer_copies);
+    // The copies must wait for the passes which still access the buffers
+    for (const auto &copy_request : m_scratch_pending_buffer_copies) {
+        m_resource_state_tracker.require_buffer(copy_request.dst_buffer,
+                                                {
+                                                    .stage_mask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                                                    .access_mask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                                                });
+    }
+
+    // The images of transient attachments share memory blocks, so they are all created again if one of them is created
+    const bool transient_attachments_required =
+        std::any_of(m_transient_attachments.begin(), m_transient_attachments.end(), [](const auto &attachment) {
+            const auto &resources = attachment.texture->current_frame_resources();
+            return !resources.m_image || resources.m_image->image() == VK_NULL_HANDLE;
+        });
+    if (transient_attachments_required) {
+        create_transient_attachments(pending_releases);
+    }
 
     for (auto *texture : pending_texture_updates) {
         bool texture_was_created = false;
@@ -824,17 +1903,53 @@ void RenderGraph::update_resources() {
             texture_was_created = true;
         }
         if (texture_was_created) {
-            texture->prepare_initial_layout_barriers(pre_copy_barriers);
+            // The images may reuse the handles of destroyed images, whose states must not be carried over
+            for (const auto &resources : texture->m_per_frame_texture_resources) {
+                m_resource_state_tracker.discard_image(resources.m_image->image(), texture->subresource_range());
+                if (resources.m_msaa_image) {
+                    m_resource_state_tracker.discard_image(resources.m_msaa_image->image(),
+                                                           texture->subresource_range());
+                }
+            }
             mark_graphics_passes_using_texture_dirty(*texture);
             mark_graphics_pass_secondary_cmd_buffers_dirty();
         }
-        texture->prepare_update_barriers(pre_copy_barriers);
+        if (texture->m_src_texture_data_size != 0) {
+            for (const auto &resources : texture->m_per_frame_texture_resources) {
+                m_resource_state_tracker.require_image(resources.m_image->image(), texture->subresource_range(),
+                                                       {
+                                                           .stage_mask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                                                           .access_mask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                                                           .layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                       });
+            }
+        }
         texture->collect_update_copies(m_staging_buffer, upload_offset, pending_releases,
                                        m_scratch_pending_texture_copies);
     }
 
     m_texture_copy_batch_builder.add(m_scratch_pending_texture_copies);
 
+    // The pre-copy barriers are derived from the tracked states, while the post-copy barriers are recorded by the copy
+    // batch builders (which also handle queue family ownership transfers), so their results are reported back
+    m_resource_state_tracker.resolve(pre_copy_barriers);
+    for (const auto &copy_request : m_scratch_pending_buffer_copies) {
+        m_resource_state_tracker.assume_buffer_state(copy_request.dst_buffer,
+                                                     {
+                                                         .stage_mask = copy_request.dst_stage_mask,
+                                                         .access_mask = copy_request.dst_access_mask,
+                                                     });
+    }
+    for (const auto &copy_request : m_scratch_pending_texture_copies) {
+        const auto &barrier = copy_request.post_copy_barrier;
+        m_resource_state_tracker.assume_image_state(copy_request.dst_image, barrier.subresourceRange,
+                                                    {
+                                                        .stage_mask = barrier.dstStageMask,
+                                                        .access_mask = barrier.dstAccessMask,
+                                                        .layout = barrier.newLayout,
+                                                    });
+    }
+
     VkPipelineStageFlags2 upload_wait_stage_mask = VK_PIPELINE_STAGE_2_NONE;
     for (const auto &copy_request : m_scratch_pending_buffer_copies) {
         upload_wait_stage_mask |= copy_request.dst_stage_mask;
@@ -864,27 +1979,27 @@ void RenderGraph::update_resources() {
     };
 
     if (use_transfer_queue) {
-        const std::array<VkSemaphore, 1> upload_signal_semaphore = {m_upload_finished->semaphore()};
-        const auto update_fence =
-            m_device.execute(VK_QUEUE_TRANSFER_BIT, DebugLabelColor::MAGENTA, record_update_commands,
-                             std::span<const VkSemaphore>{}, std::span<const VkSemaphore>(upload_signal_semaphore));
-
-        std::vector<VkFence> release_wait_fences = m_frame_sync_manager.frame_slot_submission_fences();
-        release_wait_fences.push_back(update_fence);
+        // The upload doesn't wait for anything, so it is executed while the graphics queue still renders the previous
+        // frames, and only the stages which read the uploaded resources wait for it
+        m_upload_timeline_value++;
+        const std::array<VkSemaphoreSubmitInfo, 1> upload_signal_semaphore{{{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = m_upload_finished->semaphore(),
+            .value = m_upload_timeline_value,
+            .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        }}};
+        std::ignore = m_device.execute(VK_QUEUE_TRANSFER_BIT, DebugLabelColor::MAGENTA, record_update_commands,
+                                       std::span<const VkSemaphore>{},
+                                       std::span<const VkSemaphoreSubmitInfo>(upload_signal_semaphore));
 
         m_upload_submission_pending = true;
-        m_upload_wait_stage_mask = upload_wait_stage_mask;
-        if (!pending_releases.empty()) {
-            for (auto &release : pending_releases) {
-                m_frame_sync_manager.defer_release(release_wait_fences, std::move(release));
-            }
-        }
-        return;
+        m_upload_wait_stage_mask = upload_wait_stage_mask == VK_PIPELINE_STAGE_2_NONE
+                                       ? VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT
+                                       : upload_wait_stage_mask;
+    } else {
+        // Same-queue path: merge update recording into the main render submission to avoid an extra submit.
+        m_inline_update_commands = std::move(record_update_commands);
     }
-
-    // Same-queue path: merge update recording into the main render submission to avoid an extra submit.
-    m_inline_update_commands = std::move(record_update_commands);
-    m_inline_update_pending_releases = std::move(pending_releases);
 }
 
 } // namespace inexor::vulkan_renderer::render_graph
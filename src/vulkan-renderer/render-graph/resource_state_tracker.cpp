@@ -0,0 +1,445 @@
+#include "inexor/vulkan-renderer/render-graph/resource_state_tracker.hpp"
+
+#include "inexor/vulkan-renderer/tools/exception.hpp"
+#include "inexor/vulkan-renderer/tools/make_info.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <tuple>
+
+namespace {
+
+/// The memory accesses which write, all other accesses only read
+constexpr VkAccessFlags2 WRITE_ACCESS_MASK =
+    VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_HOST_WRITE_BIT |
+    VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+/// Expand the legacy shader access flags into the accesses they are equivalent to, so a write which has been made
+/// visible to VK_ACCESS_2_SHADER_READ_BIT is known to be visible to sampled reads as well
+VkAccessFlags2 expand_access_mask(VkAccessFlags2 access_mask) {
+    if ((access_mask & VK_ACCESS_2_MEMORY_READ_BIT) != 0) {
+        access_mask |= ~WRITE_ACCESS_MASK;
+    }
+    if ((access_mask & VK_ACCESS_2_SHADER_READ_BIT) != 0) {
+        access_mask |= VK_ACCESS_2_SHADER_SAMPLED_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+    }
+    if ((access_mask & VK_ACCESS_2_SHADER_WRITE_BIT) != 0) {
+        access_mask |= VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    }
+    return access_mask;
+}
+
+/// Expand VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT into all stages, so a write which has been made visible to all commands
+/// is known to be visible to every stage
+VkPipelineStageFlags2 expand_stage_mask(const VkPipelineStageFlags2 stage_mask) {
+    return (stage_mask & VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT) != 0 ? ~VkPipelineStageFlags2{0} : stage_mask;
+}
+
+/// The execution and memory dependency an access needs
+struct Dependency {
+    bool required{false};
+    VkPipelineStageFlags2 src_stage_mask{VK_PIPELINE_STAGE_2_NONE};
+    VkAccessFlags2 src_access_mask{VK_ACCESS_2_NONE};
+    VkPipelineStageFlags2 dst_stage_mask{VK_PIPELINE_STAGE_2_NONE};
+    VkAccessFlags2 dst_access_mask{VK_ACCESS_2_NONE};
+};
+
+/// Compute the dependency an access needs, and update the state of the resource.
+/// @param state The state of the resource
+/// @param access The access
+/// @param layout_transition Whether the access needs a layout transition, which counts as a write
+/// @return The dependency
+template <typename State>
+Dependency apply_access(State &state, const inexor::vulkan_renderer::render_graph::ResourceAccess &access,
+                        const bool layout_transition) {
+    Dependency dependency{
+        .dst_stage_mask = access.stage_mask,
+        .dst_access_mask = access.access_mask,
+    };
+
+    if (layout_transition || (access.access_mask & WRITE_ACCESS_MASK) != 0) {
+        // A write must wait for the last write and for all reads since then (write-after-write, write-after-read)
+        dependency.src_stage_mask = state.write_stages | state.read_stages;
+        dependency.src_access_mask = state.write_access;
+        dependency.required = layout_transition || dependency.src_stage_mask != VK_PIPELINE_STAGE_2_NONE;
+
+        state.write_stages = access.stage_mask;
+        state.write_access = access.access_mask & WRITE_ACCESS_MASK;
+        state.read_stages = VK_PIPELINE_STAGE_2_NONE;
+        // A layout transition without a write is visible to the access which needed it
+        const bool transition_only = dependency.required && state.write_access == VK_ACCESS_2_NONE;
+        state.visible_stages = transition_only ? access.stage_mask : VK_PIPELINE_STAGE_2_NONE;
+        state.visible_access = transition_only ? access.access_mask : VK_ACCESS_2_NONE;
+        return dependency;
+    }
+
+    // A read must wait for the last write, unless it has been made visible to the read already (read-after-write)
+    const bool visible = (access.stage_mask & ~expand_stage_mask(state.visible_stages)) == 0 &&
+                         (access.access_mask & ~expand_access_mask(state.visible_access)) == 0;
+    if (state.write_stages != VK_PIPELINE_STAGE_2_NONE && !visible) {
+        // The destination scope also covers the stages and accesses the write has been made visible to before, so the
+        // write is known to be visible to every combination of them
+        dependency.required = true;
+        dependency.src_stage_mask = state.write_stages;
+        dependency.src_access_mask = state.write_access;
+        dependency.dst_stage_mask |= state.visible_stages;
+        dependency.dst_access_mask |= state.visible_access;
+        state.visible_stages = dependency.dst_stage_mask;
+        state.visible_access = dependency.dst_access_mask;
+    }
+    state.read_stages |= access.stage_mask;
+    return dependency;
+}
+
+/// The state of a resource after it has been handed over to another queue. The semaphore the other queue waits for
+/// makes all accesses before the hand over available and visible to all stages (or the acquire barrier does, if the
+/// ownership is transferred), so only layout transitions and writes need to wait for it.
+/// @param layout The layout of the resource, which is kept
+template <typename State>
+State get_transferred_state(const VkImageLayout layout) {
+    return {
+        .layout = layout,
+        .write_stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        .visible_stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        .visible_access = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+    };
+}
+
+} // namespace
+
+namespace inexor::vulkan_renderer::render_graph {
+
+// Using declaration
+using tools::InexorException;
+
+ResourceStateTracker::State &ResourceStateTracker::image_state(const VkImage image, const std::uint32_t mip_level,
+                                                                const std::uint32_t array_layer) {
+    auto &image_state = m_images[image];
+    if (mip_level >= image_state.level_count || array_layer >= image_state.layer_count) {
+        // Grow the subresource states while keeping the states which are known already
+        const auto level_count = std::max(image_state.level_count, mip_level + 1);
+        const auto layer_count = std::max(image_state.layer_count, array_layer + 1);
+        std::vector<State> subresources(static_cast<std::size_t>(level_count) * layer_count);
+        for (std::uint32_t level = 0; level < image_state.level_count; level++) {
+            for (std::uint32_t layer = 0; layer < image_state.layer_count; layer++) {
+                subresources[level * layer_count + layer] =
+                    image_state.subresources[level * image_state.layer_count + layer];
+            }
+        }
+        image_state.level_count = level_count;
+        image_state.layer_count = layer_count;
+        image_state.subresources = std::move(subresources);
+    }
+    return image_state.subresources[mip_level * image_state.layer_count + array_layer];
+}
+
+void ResourceStateTracker::set_image_state(const VkImage image, const VkImageSubresourceRange &range,
+                                           const State &state) {
+    for (std::uint32_t level = 0; level < range.levelCount; level++) {
+        for (std::uint32_t layer = 0; layer < range.layerCount; layer++) {
+            image_state(image, range.baseMipLevel + level, range.baseArrayLayer + layer) = state;
+        }
+    }
+}
+
+void ResourceStateTracker::require_image(const VkImage image, const VkImageSubresourceRange &range,
+                                         const ResourceAccess &access) {
+    if (image == VK_NULL_HANDLE) {
+        throw InexorException("Error: Parameter 'image' is invalid!");
+    }
+    if (range.levelCount == VK_REMAINING_MIP_LEVELS || range.layerCount == VK_REMAINING_ARRAY_LAYERS) {
+        throw InexorException("Error: Parameter 'range' must specify the number of mip levels and array layers!");
+    }
+    for (std::uint32_t level = 0; level < range.levelCount; level++) {
+        for (std::uint32_t layer = 0; layer < range.layerCount; layer++) {
+            m_pending_image_accesses.push_back({
+                .image = image,
+                .aspect_mask = range.aspectMask,
+                .mip_level = range.baseMipLevel + level,
+                .array_layer = range.baseArrayLayer + layer,
+                .access = access,
+            });
+        }
+    }
+}
+
+void ResourceStateTracker::require_buffer(const VkBuffer buffer, const ResourceAccess &access) {
+    if (buffer == VK_NULL_HANDLE) {
+        throw InexorException("Error: Parameter 'buffer' is invalid!");
+    }
+    m_pending_buffer_accesses.push_back({
+        .buffer = buffer,
+        .access = access,
+    });
+}
+
+void ResourceStateTracker::discard_image(const VkImage image, const VkImageSubresourceRange &range,
+                                         const VkPipelineStageFlags2 stage_mask) {
+    set_image_state(image, range,
+                    {
+                        .layout = VK_IMAGE_LAYOUT_UNDEFINED,
+                        .write_stages = stage_mask,
+                    });
+}
+
+void ResourceStateTracker::alias_image(const VkImage image, const VkImageSubresourceRange &range,
+                                       const VkImage previous_image) {
+    // The memory is written by the next access, so it must wait for every access to any subresource of the other image
+    State state{};
+    if (const auto previous = m_images.find(previous_image); previous != m_images.end()) {
+        for (const auto &subresource : previous->second.subresources) {
+            state.write_stages |= subresource.write_stages | subresource.read_stages;
+            state.write_access |= subresource.write_access;
+        }
+    }
+    set_image_state(image, range, state);
+}
+
+void ResourceStateTracker::assume_image_state(const VkImage image, const VkImageSubresourceRange &range,
+                                              const ResourceAccess &access) {
+    set_image_state(image, range,
+                    {
+                        .layout = access.layout,
+                        .write_stages = access.stage_mask,
+                        .visible_stages = access.stage_mask,
+                        .visible_access = access.access_mask,
+                    });
+}
+
+void ResourceStateTracker::assume_buffer_state(const VkBuffer buffer, const ResourceAccess &access) {
+    m_buffers[buffer] = {
+        .write_stages = access.stage_mask,
+        .visible_stages = access.stage_mask,
+        .visible_access = access.access_mask,
+    };
+}
+
+void ResourceStateTracker::transfer_buffer_ownership(const VkBuffer buffer, const std::uint32_t src_queue_family_index,
+                                                     const std::uint32_t dst_queue_family_index,
+                                                     PipelineBarrierBatchBuilder &release_barriers,
+                                                     PipelineBarrierBatchBuilder &acquire_barriers) {
+    auto &state = m_buffers[buffer];
+    if (src_queue_family_index != dst_queue_family_index) {
+        release_barriers.add(tools::make_info<VkBufferMemoryBarrier2>({
+            .srcStageMask = state.write_stages | state.read_stages,
+            .srcAccessMask = state.write_access,
+            .dstStageMask = VK_PIPELINE_STAGE_2_NONE,
+            .dstAccessMask = VK_ACCESS_2_NONE,
+            .srcQueueFamilyIndex = src_queue_family_index,
+            .dstQueueFamilyIndex = dst_queue_family_index,
+            .buffer = buffer,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE,
+        }));
+        acquire_barriers.add(tools::make_info<VkBufferMemoryBarrier2>({
+            .srcStageMask = VK_PIPELINE_STAGE_2_NONE,
+            .srcAccessMask = VK_ACCESS_2_NONE,
+            .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+            .srcQueueFamilyIndex = src_queue_family_index,
+            .dstQueueFamilyIndex = dst_queue_family_index,
+            .buffer = buffer,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE,
+        }));
+    }
+    state = get_transferred_state<State>(VK_IMAGE_LAYOUT_UNDEFINED);
+}
+
+void ResourceStateTracker::transfer_image_ownership(const VkImage image, const VkImageSubresourceRange &range,
+                                                    const std::uint32_t src_queue_family_index,
+                                                    const std::uint32_t dst_queue_family_index,
+                                                    PipelineBarrierBatchBuilder &release_barriers,
+                                                    PipelineBarrierBatchBuilder &acquire_barriers) {
+    for (std::uint32_t level = 0; level < range.levelCount; level++) {
+        for (std::uint32_t layer = 0; layer < range.layerCount; layer++) {
+            auto &state = image_state(image, range.baseMipLevel + level, range.baseArrayLayer + layer);
+            // Subresources in the undefined layout have no contents which would have to be transferred
+            if (src_queue_family_index != dst_queue_family_index && state.layout != VK_IMAGE_LAYOUT_UNDEFINED) {
+                const VkImageSubresourceRange subresource_range{
+                    .aspectMask = range.aspectMask,
+                    .baseMipLevel = range.baseMipLevel + level,
+                    .levelCount = 1,
+                    .baseArrayLayer = range.baseArrayLayer + layer,
+                    .layerCount = 1,
+                };
+                release_barriers.add(tools::make_info<VkImageMemoryBarrier2>({
+                    .srcStageMask = state.write_stages | state.read_stages,
+                    .srcAccessMask = state.write_access,
+                    .dstStageMask = VK_PIPELINE_STAGE_2_NONE,
+                    .dstAccessMask = VK_ACCESS_2_NONE,
+                    .oldLayout = state.layout,
+                    .newLayout = state.layout,
+                    .srcQueueFamilyIndex = src_queue_family_index,
+                    .dstQueueFamilyIndex = dst_queue_family_index,
+                    .image = image,
+                    .subresourceRange = subresource_range,
+                }));
+                acquire_barriers.add(tools::make_info<VkImageMemoryBarrier2>({
+                    .srcStageMask = VK_PIPELINE_STAGE_2_NONE,
+                    .srcAccessMask = VK_ACCESS_2_NONE,
+                    .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                    .dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+                    .oldLayout = state.layout,
+                    .newLayout = state.layout,
+                    .srcQueueFamilyIndex = src_queue_family_index,
+                    .dstQueueFamilyIndex = dst_queue_family_index,
+                    .image = image,
+                    .subresourceRange = subresource_range,
+                }));
+            }
+            state = get_transferred_state<State>(state.layout);
+        }
+    }
+}
+
+void ResourceStateTracker::forget_image(const VkImage image) {
+    m_images.erase(image);
+}
+
+void ResourceStateTracker::forget_buffer(const VkBuffer buffer) {
+    m_buffers.erase(buffer);
+}
+
+void ResourceStateTracker::resolve(PipelineBarrierBatchBuilder &barriers) {
+    // All hazards which don't need a layout transition are merged into one global memory barrier
+    Dependency memory_dependency;
+    auto merge_into_memory_dependency = [&](const Dependency &dependency) {
+        memory_dependency.required = true;
+        memory_dependency.src_stage_mask |= dependency.src_stage_mask;
+        memory_dependency.src_access_mask |= dependency.src_access_mask;
+        memory_dependency.dst_stage_mask |= dependency.dst_stage_mask;
+        memory_dependency.dst_access_mask |= dependency.dst_access_mask;
+    };
+
+    // The accesses of a pass to the same resource happen at the same time, so they are combined into one access
+    std::sort(m_pending_buffer_accesses.begin(), m_pending_buffer_accesses.end(),
+              [](const auto &lhs, const auto &rhs) { return std::less<VkBuffer>{}(lhs.buffer, rhs.buffer); });
+    for (std::size_t idx = 0; idx < m_pending_buffer_accesses.size();) {
+        const auto buffer = m_pending_buffer_accesses[idx].buffer;
+        ResourceAccess access{};
+        for (; idx < m_pending_buffer_accesses.size() && m_pending_buffer_accesses[idx].buffer == buffer; idx++) {
+            access.stage_mask |= m_pending_buffer_accesses[idx].access.stage_mask;
+            access.access_mask |= m_pending_buffer_accesses[idx].access.access_mask;
+        }
+        if (const auto dependency = apply_access(m_buffers[buffer], access, false); dependency.required) {
+            merge_into_memory_dependency(dependency);
+        }
+    }
+    m_pending_buffer_accesses.clear();
+
+    std::sort(m_pending_image_accesses.begin(), m_pending_image_accesses.end(), [](const auto &lhs, const auto &rhs) {
+        if (lhs.image != rhs.image) {
+            return std::less<VkImage>{}(lhs.image, rhs.image);
+        }
+        return std::tie(lhs.mip_level, lhs.array_layer) < std::tie(rhs.mip_level, rhs.array_layer);
+    });
+
+    // The image memory barrier which is currently extended over consecutive array layers
+    std::optional<VkImageMemoryBarrier2> image_barrier;
+    auto add_image_barrier = [&](const VkImageMemoryBarrier2 &barrier) {
+        if (image_barrier && image_barrier->image == barrier.image &&
+            image_barrier->srcStageMask == barrier.srcStageMask &&
+            image_barrier->srcAccessMask == barrier.srcAccessMask &&
+            image_barrier->dstStageMask == barrier.dstStageMask &&
+            image_barrier->dstAccessMask == barrier.dstAccessMask && image_barrier->oldLayout == barrier.oldLayout &&
+            image_barrier->newLayout == barrier.newLayout &&
+            image_barrier->subresourceRange.aspectMask == barrier.subresourceRange.aspectMask &&
+            image_barrier->subresourceRange.baseMipLevel == barrier.subresourceRange.baseMipLevel &&
+            image_barrier->subresourceRange.baseArrayLayer + image_barrier->subresourceRange.layerCount ==
+                barrier.subresourceRange.baseArrayLayer) {
+            image_barrier->subresourceRange.layerCount++;
+            return;
+        }
+        if (image_barrier) {
+            barriers.add(*image_barrier);
+        }
+        image_barrier = barrier;
+    };
+
+    for (std::size_t idx = 0; idx < m_pending_image_accesses.size();) {
+        const auto &first = m_pending_image_accesses[idx];
+        const auto image = first.image;
+        const auto mip_level = first.mip_level;
+        const auto array_layer = first.array_layer;
+        VkImageAspectFlags aspect_mask = 0;
+        ResourceAccess access{
+            .layout = first.access.layout,
+        };
+        for (; idx < m_pending_image_accesses.size(); idx++) {
+            const auto &pending = m_pending_image_accesses[idx];
+            if (pending.image != image || pending.mip_level != mip_level || pending.array_layer != array_layer) {
+                break;
+            }
+            if (pending.access.layout != access.layout) {
+                throw InexorException("Error: An image subresource is required in two different layouts by the "
+                                      "same pass!");
+            }
+            aspect_mask |= pending.aspect_mask;
+            access.stage_mask |= pending.access.stage_mask;
+            access.access_mask |= pending.access.access_mask;
+        }
+
+        auto &state = image_state(image, mip_level, array_layer);
+        const auto old_layout = state.layout;
+        const bool layout_transition = old_layout != access.layout;
+        const auto dependency = apply_access(state, access, layout_transition);
+        state.layout = access.layout;
+        if (!dependency.required) {
+            continue;
+        }
+        if (!layout_transition) {
+            merge_into_memory_dependency(dependency);
+            continue;
+        }
+        add_image_barrier(tools::make_info<VkImageMemoryBarrier2>({
+            .srcStageMask = dependency.src_stage_mask,
+            .srcAccessMask = dependency.src_access_mask,
+            .dstStageMask = dependency.dst_stage_mask,
+            .dstAccessMask = dependency.dst_access_mask,
+            .oldLayout = old_layout,
+            .newLayout = access.layout,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = image,
+            .subresourceRange =
+                {
+                    .aspectMask = aspect_mask,
+                    .baseMipLevel = mip_level,
+                    .levelCount = 1,
+                    .baseArrayLayer = array_layer,
+                    .layerCount = 1,
+                },
+        }));
+    }
+    m_pending_image_accesses.clear();
+
+    if (image_barrier) {
+        barriers.add(*image_barrier);
+    }
+    if (memory_dependency.required) {
+        barriers.add(tools::make_info<VkMemoryBarrier2>({
+            .srcStageMask = memory_dependency.src_stage_mask,
+            .srcAccessMask = memory_dependency.src_access_mask,
+            .dstStageMask = memory_dependency.dst_stage_mask,
+            .dstAccessMask = memory_dependency.dst_access_mask,
+        }));
+    }
+}
+
+void ResourceStateTracker::flush(CommandBufferBuilder &cmd_buf) {
+    resolve(m_barriers);
+    m_barriers.flush_if_not_empty(cmd_buf);
+}
+
+void ResourceStateTracker::reset() {
+    m_images.clear();
+    m_buffers.clear();
+    m_pending_image_accesses.clear();
+    m_pending_buffer_accesses.clear();
+    m_barriers.reset();
+}
+
+} // namespace inexor::vulkan_renderer::render_graph
@@ -1,5 +1,6 @@
 #include "inexor/vulkan-renderer/render-graph/staging_buffer.hpp"
 
+#include "inexor/vulkan-renderer/render-graph/frame_sync_manager.hpp"
 #include "inexor/vulkan-renderer/tools/exception.hpp"
 #include "inexor/vulkan-renderer/tools/make_info.hpp"
 #include "inexor/vulkan-renderer/wrapper/core/device.hpp"
@@ -25,8 +26,7 @@ StagingBuffer::~StagingBuffer() {
     reset();
 }
 
-void StagingBuffer::ensure_capacity(const std::size_t required_bytes,
-                                    std::vector<std::function<void()>> &pending_releases) {
+void StagingBuffer::ensure_capacity(const std::size_t required_bytes, DeferredReleases &pending_releases) {
     if (required_bytes == 0) {
         return;
     }
@@ -65,11 +65,7 @@ void StagingBuffer::ensure_capacity(const std::size_t required_bytes,
     vmaSetAllocationName(m_device.allocator(), resources.m_alloc, slot_name.c_str());
     m_device.set_debug_name(resources.m_buffer, slot_name);
 
-    if (old_buffer != VK_NULL_HANDLE) {
-        const auto allocator = m_device.allocator();
-        pending_releases.push_back(
-            [allocator, old_buffer, old_alloc] { vmaDestroyBuffer(allocator, old_buffer, old_alloc); });
-    }
+    pending_releases.destroy_buffer(old_buffer, old_alloc);
 }
 
 void StagingBuffer::reset() {
@@ -1,6 +1,7 @@
 #include "inexor/vulkan-renderer/render-graph/swapchain_manager.hpp"
 
 #include "inexor/vulkan-renderer/render-graph/graphics_pass.hpp"
+#include "inexor/vulkan-renderer/render-graph/resource_state_tracker.hpp"
 #include "inexor/vulkan-renderer/tools/exception.hpp"
 #include "inexor/vulkan-renderer/wrapper/commands/command_buffer_builder.hpp"
 
@@ -12,6 +13,19 @@ namespace inexor::vulkan_renderer::render_graph {
 
 using wrapper::commands::CommandBufferBuilder;
 
+namespace {
+
+/// Swapchain images have one mip level and one array layer
+constexpr VkImageSubresourceRange SWAPCHAIN_IMAGE_RANGE{
+    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+    .baseMipLevel = 0,
+    .levelCount = 1,
+    .baseArrayLayer = 0,
+    .layerCount = 1,
+};
+
+} // namespace
+
 SwapchainManager::SwapchainManager(Device &device) : m_device(device) {}
 
 void SwapchainManager::mark_swapchain_cache_dirty() {
@@ -119,15 +133,24 @@ void SwapchainManager::synchronize_frame_context() {
     m_current_frame_slot = std::min(current_frame_slot, m_frame_slot_count - 1);
 }
 
-void SwapchainManager::prepare_swapchains_for_rendering(CommandBufferBuilder &cmd_buf) const {
+void SwapchainManager::prepare_swapchains_for_rendering(ResourceStateTracker &state_tracker) const {
     for (const auto &swapchain : m_frame_swapchains) {
-        swapchain->change_image_layout_to_prepare_for_rendering(cmd_buf);
+        state_tracker.discard_image(swapchain->current_swapchain_image(), SWAPCHAIN_IMAGE_RANGE,
+                                    IMAGE_AVAILABLE_WAIT_STAGE);
     }
 }
 
-void SwapchainManager::prepare_swapchains_for_presenting(CommandBufferBuilder &cmd_buf) const {
+void SwapchainManager::prepare_swapchains_for_presenting(ResourceStateTracker &state_tracker,
+                                                         CommandBufferBuilder &cmd_buf) const {
+    // Presentation is synchronized by the rendering finished semaphores, so no access needs to wait for the barrier
+    for (const auto &swapchain : m_frame_swapchains) {
+        state_tracker.require_image(swapchain->current_swapchain_image(), SWAPCHAIN_IMAGE_RANGE,
+                                    {.layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR});
+    }
+    state_tracker.flush(cmd_buf);
+    // The images are discarded when they are acquired again, and old images must not be kept after a resize
     for (const auto &swapchain : m_frame_swapchains) {
-        swapchain->change_image_layout_to_prepare_for_presenting(cmd_buf);
+        state_tracker.forget_image(swapchain->current_swapchain_image());
     }
 }
 
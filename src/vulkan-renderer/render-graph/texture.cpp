@@ -7,7 +7,6 @@
 #include "inexor/vulkan-renderer/wrapper/core/device.hpp"
 #include "inexor/vulkan-renderer/wrapper/images/image.hpp"
 #include "inexor/vulkan-renderer/wrapper/images/sampler.hpp"
-#include "inexor/vulkan-renderer/wrapper/synchronization/pipeline_barrier_batch_builder.hpp"
 
 #include <cstring>
 #include <utility>
@@ -34,6 +33,9 @@ Texture::Texture(Texture &&other) noexcept : m_device(other.m_device), m_usage(o
     m_channels = other.m_channels;
     m_samples = other.m_samples;
     m_default_sampler = std::exchange(other.m_default_sampler, nullptr);
+    m_image_alias_memory = std::exchange(other.m_image_alias_memory, VK_NULL_HANDLE);
+    m_msaa_image_alias_memory = std::exchange(other.m_msaa_image_alias_memory, VK_NULL_HANDLE);
+    m_lazily_allocated = other.m_lazily_allocated;
     m_update_requested = other.m_update_requested;
     m_src_texture_data = std::exchange(other.m_src_texture_data, nullptr);
     m_src_texture_data_size = other.m_src_texture_data_size;
@@ -46,8 +48,28 @@ Texture::~Texture() {
     destroy_all();
 }
 
+VkImageAspectFlags Texture::aspect_mask() const {
+    switch (m_usage) {
+    case TextureUsage::DEPTH_ATTACHMENT:
+        switch (m_format) {
+        case VK_FORMAT_S8_UINT:
+            return VK_IMAGE_ASPECT_STENCIL_BIT;
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+        default:
+            return VK_IMAGE_ASPECT_DEPTH_BIT;
+        }
+    case TextureUsage::STENCIL_ATTACHMENT:
+        return VK_IMAGE_ASPECT_STENCIL_BIT;
+    default:
+        return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+}
+
 void Texture::collect_update_copies(StagingBuffer &staging_buffer, std::size_t &upload_offset,
-                                    std::vector<std::function<void()>> &pending_releases,
+                                    DeferredReleases &pending_releases,
                                     std::vector<PendingTextureCopy> &pending_texture_copies) {
     if (m_src_texture_data_size == 0) {
         m_update_requested = false;
@@ -64,28 +86,7 @@ void Texture::collect_update_copies(StagingBuffer &staging_buffer, std::size_t &
                     m_src_texture_data_size);
         upload_offset += m_src_texture_data_size;
 
-        const auto aspect_mask = [&]() -> VkImageAspectFlags {
-            switch (m_usage) {
-            case TextureUsage::DEPTH_ATTACHMENT:
-                switch (m_format) {
-                case VK_FORMAT_D16_UNORM:
-                case VK_FORMAT_D32_SFLOAT:
-                    return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_DEPTH_BIT);
-                case VK_FORMAT_S8_UINT:
-                    return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_STENCIL_BIT);
-                case VK_FORMAT_D16_UNORM_S8_UINT:
-                case VK_FORMAT_D24_UNORM_S8_UINT:
-                case VK_FORMAT_D32_SFLOAT_S8_UINT:
-                    return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
-                default:
-                    return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_DEPTH_BIT);
-                }
-            case TextureUsage::STENCIL_ATTACHMENT:
-                return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_STENCIL_BIT);
-            default:
-                return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_COLOR_BIT);
-            }
-        }();
+        const auto aspect_mask = this->aspect_mask();
 
         pending_texture_copies.push_back({
             .src_buffer = staging_buffer.buffer(),
@@ -113,7 +114,7 @@ void Texture::collect_update_copies(StagingBuffer &staging_buffer, std::size_t &
                     .dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
                     .dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT,
                     .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                    .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    .newLayout = shader_access_layout(),
                     .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                     .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                     .image = slot.m_image->m_img,
@@ -131,7 +132,7 @@ void Texture::collect_update_copies(StagingBuffer &staging_buffer, std::size_t &
         slot.m_descriptor_img_info = {
             .sampler = m_default_sampler->sampler(),
             .imageView = slot.m_image->m_img_view,
-            .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .imageLayout = shader_access_layout(),
         };
     }
 
@@ -156,58 +157,12 @@ void Texture::create_per_frame_resources(PerFrameTextureResources &frame_resourc
         frame_resource.m_msaa_image = std::make_shared<Image>(m_device, slot_name + "|msaa");
     }
 
-    auto img_ci = tools::make_info<VkImageCreateInfo>({
-        .imageType = VK_IMAGE_TYPE_2D,
-        .format = m_format,
-        .extent =
-            {
-                .width = m_width,
-                .height = m_height,
-                .depth = 1,
-            },
-        .mipLevels = 1,
-        .arrayLayers = 1,
-        .samples = VK_SAMPLE_COUNT_1_BIT,
-        .tiling = VK_IMAGE_TILING_OPTIMAL,
-        .usage = [&]() -> VkImageUsageFlags {
-            switch (m_usage) {
-            case TextureUsage::DEFAULT:
-                return VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-            case TextureUsage::COLOR_ATTACHMENT:
-                return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-            default:
-                return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-            }
-        }(),
-        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-    });
-
     const auto img_view_ci = tools::make_info<VkImageViewCreateInfo>({
         .viewType = VK_IMAGE_VIEW_TYPE_2D,
         .format = m_format,
         .subresourceRange =
             {
-                .aspectMask = [&]() -> VkImageAspectFlags {
-                    switch (m_usage) {
-                    case TextureUsage::DEPTH_ATTACHMENT:
-                        switch (m_format) {
-                        case VK_FORMAT_D16_UNORM:
-                        case VK_FORMAT_D32_SFLOAT:
-                            return VK_IMAGE_ASPECT_DEPTH_BIT;
-                        case VK_FORMAT_S8_UINT:
-                            return VK_IMAGE_ASPECT_STENCIL_BIT;
-                        case VK_FORMAT_D16_UNORM_S8_UINT:
-                        case VK_FORMAT_D24_UNORM_S8_UINT:
-                        case VK_FORMAT_D32_SFLOAT_S8_UINT:
-                            return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
-                        default:
-                            return VK_IMAGE_ASPECT_DEPTH_BIT;
-                        }
-                    default:
-                        return VK_IMAGE_ASPECT_COLOR_BIT;
-                    }
-                }(),
+                .aspectMask = aspect_mask(),
                 .baseMipLevel = 0,
                 .levelCount = 1,
                 .baseArrayLayer = 0,
@@ -215,16 +170,23 @@ void Texture::create_per_frame_resources(PerFrameTextureResources &frame_resourc
             },
     });
 
-    frame_resource.m_image->create(img_ci, img_view_ci);
+    auto create_image = [&](Image &image, const bool msaa_image, const VmaAllocation alias_memory) {
+        if (alias_memory != VK_NULL_HANDLE) {
+            image.create(image_create_info(msaa_image), img_view_ci, alias_memory);
+        } else {
+            image.create(image_create_info(msaa_image), img_view_ci);
+        }
+    };
+
+    create_image(*frame_resource.m_image, false, m_image_alias_memory);
     frame_resource.m_descriptor_img_info = {
         .sampler = m_default_sampler->sampler(),
         .imageView = frame_resource.m_image->m_img_view,
-        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        .imageLayout = shader_access_layout(),
     };
 
     if (m_samples > VK_SAMPLE_COUNT_1_BIT && frame_resource.m_msaa_image) {
-        img_ci.samples = m_samples;
-        frame_resource.m_msaa_image->create(img_ci, img_view_ci);
+        create_image(*frame_resource.m_msaa_image, true, m_msaa_image_alias_memory);
     }
 }
 
@@ -254,6 +216,43 @@ void Texture::destroy_per_frame_resources(PerFrameTextureResources &resources) {
     resources.m_descriptor_img_info = {};
 }
 
+VkImageCreateInfo Texture::image_create_info(const bool msaa_image) const {
+    // The image which is rendered into can't be sampled if it is a transient attachment
+    const bool lazily_allocated = m_lazily_allocated && msaa_image == (m_samples > VK_SAMPLE_COUNT_1_BIT);
+    return tools::make_info<VkImageCreateInfo>({
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = m_format,
+        .extent =
+            {
+                .width = m_width,
+                .height = m_height,
+                .depth = 1,
+            },
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = msaa_image ? m_samples : VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = [&]() -> VkImageUsageFlags {
+            switch (m_usage) {
+            case TextureUsage::DEFAULT:
+                return VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+            case TextureUsage::COLOR_ATTACHMENT:
+                return lazily_allocated
+                           ? VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT
+                           : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+            case TextureUsage::STORAGE_IMAGE:
+                return VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+            default:
+                return lazily_allocated
+                           ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT
+                           : VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+            }
+        }(),
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    });
+}
+
 VkImageView Texture::image_view() const {
     return current_frame_resources().m_image->image_view();
 }
@@ -267,204 +266,6 @@ VkImageView Texture::msaa_image_view() const {
     return resources.m_image->image_view();
 }
 
-void Texture::prepare_initial_layout_barriers(PipelineBarrierBatchBuilder &barrier_builder) {
-    if (m_src_texture_data_size != 0) {
-        return;
-    }
-
-    const auto target_layout = [&]() -> VkImageLayout {
-        switch (m_usage) {
-        case TextureUsage::COLOR_ATTACHMENT:
-            return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        case TextureUsage::DEPTH_ATTACHMENT:
-        case TextureUsage::STENCIL_ATTACHMENT:
-            return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-        default:
-            return VK_IMAGE_LAYOUT_UNDEFINED;
-        }
-    }();
-
-    if (target_layout == VK_IMAGE_LAYOUT_UNDEFINED) {
-        return;
-    }
-
-    const auto target_stage_mask = [&]() -> VkPipelineStageFlags2 {
-        switch (target_layout) {
-        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-            return VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
-        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
-            return VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
-        default:
-            return VK_PIPELINE_STAGE_2_NONE;
-        }
-    }();
-
-    const auto target_access_mask = [&]() -> VkAccessFlags2 {
-        switch (target_layout) {
-        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-            return VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
-        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
-            return VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-        default:
-            return VK_ACCESS_2_NONE;
-        }
-    }();
-
-    const auto aspect_mask = [&]() -> VkImageAspectFlags {
-        switch (m_usage) {
-        case TextureUsage::DEPTH_ATTACHMENT:
-            switch (m_format) {
-            case VK_FORMAT_D16_UNORM:
-            case VK_FORMAT_D32_SFLOAT:
-                return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_DEPTH_BIT);
-            case VK_FORMAT_S8_UINT:
-                return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_STENCIL_BIT);
-            case VK_FORMAT_D16_UNORM_S8_UINT:
-            case VK_FORMAT_D24_UNORM_S8_UINT:
-            case VK_FORMAT_D32_SFLOAT_S8_UINT:
-                return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
-            default:
-                return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_DEPTH_BIT);
-            }
-        case TextureUsage::STENCIL_ATTACHMENT:
-            return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_STENCIL_BIT);
-        default:
-            return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_COLOR_BIT);
-        }
-    }();
-
-    for (const auto &slot : m_per_frame_texture_resources) {
-        barrier_builder.add(tools::make_info<VkImageMemoryBarrier2>({
-            .srcStageMask = VK_PIPELINE_STAGE_2_NONE,
-            .srcAccessMask = VK_ACCESS_2_NONE,
-            .dstStageMask = target_stage_mask,
-            .dstAccessMask = target_access_mask,
-            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-            .newLayout = target_layout,
-            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .image = slot.m_image->m_img,
-            .subresourceRange =
-                {
-                    .aspectMask = aspect_mask,
-                    .baseMipLevel = 0,
-                    .levelCount = 1,
-                    .baseArrayLayer = 0,
-                    .layerCount = 1,
-                },
-        }));
-
-        // Also transition MSAA image if it exists
-        if (slot.m_msaa_image) {
-            barrier_builder.add(tools::make_info<VkImageMemoryBarrier2>({
-                .srcStageMask = VK_PIPELINE_STAGE_2_NONE,
-                .srcAccessMask = VK_ACCESS_2_NONE,
-                .dstStageMask = target_stage_mask,
-                .dstAccessMask = target_access_mask,
-                .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-                .newLayout = target_layout,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = slot.m_msaa_image->m_img,
-                .subresourceRange =
-                    {
-                        .aspectMask = aspect_mask,
-                        .baseMipLevel = 0,
-                        .levelCount = 1,
-                        .baseArrayLayer = 0,
-                        .layerCount = 1,
-                    },
-            }));
-        }
-    }
-}
-
-void Texture::prepare_update_barriers(PipelineBarrierBatchBuilder &barrier_builder) {
-    if (m_src_texture_data_size == 0) {
-        return;
-    }
-
-    const auto old_layout = [&]() {
-        switch (m_usage) {
-        case TextureUsage::COLOR_ATTACHMENT:
-            return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        case TextureUsage::DEPTH_ATTACHMENT:
-        case TextureUsage::STENCIL_ATTACHMENT:
-            return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-        default:
-            return VK_IMAGE_LAYOUT_UNDEFINED;
-        }
-    }();
-
-    const auto src_stage_mask = [&]() -> VkPipelineStageFlags2 {
-        switch (old_layout) {
-        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-            return VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
-        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
-            return VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
-        default:
-            return VK_PIPELINE_STAGE_2_NONE;
-        }
-    }();
-
-    const auto src_access_mask = [&]() -> VkAccessFlags2 {
-        switch (old_layout) {
-        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-            return VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
-        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
-            return VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-        default:
-            return VK_ACCESS_2_NONE;
-        }
-    }();
-
-    for (std::size_t slot_index = 0; slot_index < m_per_frame_texture_resources.size(); ++slot_index) {
-        auto &slot = m_per_frame_texture_resources[slot_index];
-
-        barrier_builder.add(tools::make_info<VkImageMemoryBarrier2>({
-            .srcStageMask = src_stage_mask,
-            .srcAccessMask = src_access_mask,
-            .dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
-            .dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
-            .oldLayout = old_layout,
-            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .image = slot.m_image->m_img,
-            .subresourceRange =
-                {
-                    .aspectMask = [&]() -> VkImageAspectFlags {
-                        switch (m_usage) {
-                        case TextureUsage::DEPTH_ATTACHMENT:
-                            switch (m_format) {
-                            case VK_FORMAT_D16_UNORM:
-                            case VK_FORMAT_D32_SFLOAT:
-                                return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_DEPTH_BIT);
-                            case VK_FORMAT_S8_UINT:
-                                return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_STENCIL_BIT);
-                            case VK_FORMAT_D16_UNORM_S8_UINT:
-                            case VK_FORMAT_D24_UNORM_S8_UINT:
-                            case VK_FORMAT_D32_SFLOAT_S8_UINT:
-                                return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_DEPTH_BIT |
-                                                                       VK_IMAGE_ASPECT_STENCIL_BIT);
-                            default:
-                                return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_DEPTH_BIT);
-                            }
-                        case TextureUsage::STENCIL_ATTACHMENT:
-                            return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_STENCIL_BIT);
-                        default:
-                            return static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_COLOR_BIT);
-                        }
-                    }(),
-                    .baseMipLevel = 0,
-                    .levelCount = 1,
-                    .baseArrayLayer = 0,
-                    .layerCount = 1,
-                },
-        }));
-    }
-}
-
 void Texture::request_resize(const std::uint32_t width, const std::uint32_t height) {
     if (width == 0 || height == 0 || (width == m_width && height == m_height)) {
         return;
@@ -505,4 +306,18 @@ void Texture::set_frame_context(const std::size_t frame_slot_count, const std::s
     m_current_frame_slot = std::min(current_frame_slot, m_per_frame_texture_resources.size() - 1);
 }
 
+VkImageLayout Texture::shader_access_layout() const {
+    return m_usage == TextureUsage::STORAGE_IMAGE ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+}
+
+VkImageSubresourceRange Texture::subresource_range() const {
+    return {
+        .aspectMask = aspect_mask(),
+        .baseMipLevel = 0,
+        .levelCount = 1,
+        .baseArrayLayer = 0,
+        .layerCount = 1,
+    };
+}
+
 } // namespace inexor::vulkan_renderer::render_graph
@@ -0,0 +1,120 @@
+#include "inexor/vulkan-renderer/render-graph/transient_attachment_allocator.hpp"
+
+#include "inexor/vulkan-renderer/render-graph/frame_sync_manager.hpp"
+#include "inexor/vulkan-renderer/tools/exception.hpp"
+#include "inexor/vulkan-renderer/wrapper/core/device.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <utility>
+
+namespace inexor::vulkan_renderer::render_graph {
+
+// Using declaration
+using tools::VulkanException;
+
+std::vector<std::size_t> assign_memory_blocks(const std::span<const TransientImageRequest> requests) {
+    struct MemoryBlock {
+        /// The memory types which are suitable for all images of the block
+        std::uint32_t memory_type_bits{0};
+        /// The lifetimes of the images which share the block
+        std::vector<std::pair<std::size_t, std::size_t>> lifetimes;
+    };
+    std::vector<MemoryBlock> blocks;
+    std::vector<std::size_t> block_indices(requests.size());
+
+    std::vector<std::size_t> order(requests.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](const std::size_t lhs, const std::size_t rhs) {
+        return requests[lhs].requirements.size > requests[rhs].requirements.size;
+    });
+
+    for (const auto request_index : order) {
+        const auto &request = requests[request_index];
+        auto fits_into = [&](const MemoryBlock &block) {
+            if ((block.memory_type_bits & request.requirements.memoryTypeBits) == 0) {
+                return false;
+            }
+            return std::none_of(block.lifetimes.begin(), block.lifetimes.end(), [&](const auto &lifetime) {
+                return request.first_pass <= lifetime.second && lifetime.first <= request.last_pass;
+            });
+        };
+        const auto block = std::find_if(blocks.begin(), blocks.end(), fits_into);
+        const auto block_index = static_cast<std::size_t>(std::distance(blocks.begin(), block));
+        if (block == blocks.end()) {
+            blocks.push_back({.memory_type_bits = request.requirements.memoryTypeBits, .lifetimes = {}});
+        }
+        blocks[block_index].memory_type_bits &= request.requirements.memoryTypeBits;
+        blocks[block_index].lifetimes.emplace_back(request.first_pass, request.last_pass);
+        block_indices[request_index] = block_index;
+    }
+    return block_indices;
+}
+
+TransientAttachmentAllocator::TransientAttachmentAllocator(const Device &device) : m_device(device) {}
+
+TransientAttachmentAllocator::~TransientAttachmentAllocator() {
+    reset();
+}
+
+void TransientAttachmentAllocator::allocate(const std::span<const TransientImageRequest> requests,
+                                            DeferredReleases &pending_releases) {
+    // The images which alias the old blocks may still be used by frames in flight
+    for (const auto block : m_blocks) {
+        pending_releases.free_memory(block);
+    }
+    m_blocks.clear();
+
+    m_block_indices = assign_memory_blocks(requests);
+    const auto block_count =
+        m_block_indices.empty() ? 0 : *std::max_element(m_block_indices.begin(), m_block_indices.end()) + 1;
+
+    // The size, the alignment, and the memory types which are suitable for all images of a block
+    std::vector<VkMemoryRequirements> block_requirements(block_count);
+    std::vector<std::size_t> block_image_counts(block_count, 0);
+    for (std::size_t request_index = 0; request_index < requests.size(); request_index++) {
+        const auto &requirements = requests[request_index].requirements;
+        auto &block = block_requirements[m_block_indices[request_index]];
+        if (block_image_counts[m_block_indices[request_index]]++ == 0) {
+            block = requirements;
+            continue;
+        }
+        block.size = std::max(block.size, requirements.size);
+        block.alignment = std::max(block.alignment, requirements.alignment);
+        block.memoryTypeBits &= requirements.memoryTypeBits;
+    }
+
+    const VmaAllocationCreateInfo alloc_ci{
+        .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        .priority = 1.0f,
+    };
+
+    m_blocks.assign(block_count, VK_NULL_HANDLE);
+    for (std::size_t block_index = 0; block_index < block_count; block_index++) {
+        // An image which does not share its block with other images is created with a dedicated allocation
+        if (block_image_counts[block_index] < 2) {
+            continue;
+        }
+        const auto name = "Transient attachment memory block " + std::to_string(block_index);
+        if (const auto result = vmaAllocateMemory(m_device.allocator(), &block_requirements[block_index], &alloc_ci,
+                                                  &m_blocks[block_index], nullptr);
+            result != VK_SUCCESS) {
+            throw VulkanException("Error: vmaAllocateMemory failed!", result, name);
+        }
+        vmaSetAllocationName(m_device.allocator(), m_blocks[block_index], name.c_str());
+    }
+}
+
+void TransientAttachmentAllocator::reset() {
+    for (const auto block : m_blocks) {
+        if (block != VK_NULL_HANDLE) {
+            vmaFreeMemory(m_device.allocator(), block);
+        }
+    }
+    m_blocks.clear();
+    m_block_indices.clear();
+}
+
+} // namespace inexor::vulkan_renderer::render_graph
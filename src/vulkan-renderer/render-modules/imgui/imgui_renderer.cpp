@@ -175,6 +175,7 @@ ImGuiRenderer::ImGuiRenderer(std::shared_ptr<RenderGraph> render_graph, std::wea
     // Add the ImGui graphics pass to rendergraph
     m_imgui_pass = render_graph->add_graphics_pass([&](GraphicsPassBuilder &builder) {
         return builder.writes_to(swapchain)
+            .reads_from(m_imgui_texture, VK_SHADER_STAGE_FRAGMENT_BIT)
             .reads_from(m_vertex_buffer)
             .reads_from(m_index_buffer)
             .set_on_record([&](wrapper::commands::CommandBufferBuilder &cmd_buf) {
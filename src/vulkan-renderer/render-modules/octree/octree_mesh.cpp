@@ -0,0 +1,708 @@
+#include "inexor/vulkan-renderer/render-modules/octree/octree_mesh.hpp"
+
+#include "inexor/vulkan-renderer/octree/cube.hpp"
+#include "inexor/vulkan-renderer/render-modules/octree/octree_mesh_cache.hpp"
+#include "inexor/vulkan-renderer/tools/mesh_optimizer.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace inexor::vulkan_renderer::render_modules::octree {
+
+namespace {
+
+using vulkan_renderer::octree::Cube;
+
+void collect_chunks(const std::shared_ptr<Cube> &cube, const std::uint32_t depth, const std::uint32_t chunk_depth,
+                    std::vector<std::shared_ptr<Cube>> &chunks, std::vector<OctreeCullNode> &cull_nodes) {
+    if (cube->count_geometry_cubes() == 0) {
+        return;
+    }
+    const auto node_index = cull_nodes.size();
+    cull_nodes.push_back({
+        .bounding_box = cube->bounding_box(),
+        .first_chunk = static_cast<std::uint32_t>(chunks.size()),
+    });
+    if (cube->type() == Cube::Type::OCTANT && depth < chunk_depth) {
+        for (const auto &child : cube->children()) {
+            collect_chunks(child, depth + 1, chunk_depth, chunks, cull_nodes);
+        }
+    } else {
+        chunks.push_back(cube);
+    }
+    auto &node = cull_nodes[node_index];
+    node.chunk_count = static_cast<std::uint32_t>(chunks.size()) - node.first_chunk;
+    node.skip = static_cast<std::uint32_t>(cull_nodes.size());
+}
+
+void collect_occluders(const std::shared_ptr<Cube> &cube, std::vector<std::array<glm::vec3, 2>> &occluders) {
+    if (cube->type() == Cube::Type::SOLID) {
+        occluders.push_back(cube->bounding_box());
+    } else if (cube->type() == Cube::Type::OCTANT) {
+        for (const auto &child : cube->children()) {
+            collect_occluders(child, occluders);
+        }
+    }
+}
+
+/// Merge boxes which share a complete face, one axis after the other. The corners of cubes are exact in floating
+/// point, because cube sizes are powers of two of the world size, so the comparisons can be exact as well.
+void merge_occluders(std::vector<std::array<glm::vec3, 2>> &occluders) {
+    for (int axis = 0; axis < 3; axis++) {
+        const int u = (axis + 1) % 3;
+        const int v = (axis + 2) % 3;
+        std::sort(occluders.begin(), occluders.end(), [&](const auto &lhs, const auto &rhs) {
+            return std::make_tuple(lhs[0][u], lhs[1][u], lhs[0][v], lhs[1][v], lhs[0][axis]) <
+                   std::make_tuple(rhs[0][u], rhs[1][u], rhs[0][v], rhs[1][v], rhs[0][axis]);
+        });
+        std::size_t merged = 0;
+        for (std::size_t idx = 1; idx < occluders.size(); idx++) {
+            auto &last = occluders[merged];
+            const auto &next = occluders[idx];
+            if (last[0][u] == next[0][u] && last[1][u] == next[1][u] && last[0][v] == next[0][v] &&
+                last[1][v] == next[1][v] && last[1][axis] == next[0][axis]) {
+                last[1][axis] = next[1][axis];
+            } else {
+                occluders[++merged] = next;
+            }
+        }
+        if (!occluders.empty()) {
+            occluders.resize(merged + 1);
+        }
+    }
+}
+
+/// The distance from a point to the closest point of a box
+float distance_to_box(const glm::vec3 &point, const std::array<glm::vec3, 2> &bounding_box) {
+    const auto &[min, max] = bounding_box;
+    const glm::vec3 offset = point - glm::vec3{
+                                         std::clamp(point.x, min.x, max.x),
+                                         std::clamp(point.y, min.y, max.y),
+                                         std::clamp(point.z, min.z, max.z),
+                                     };
+    return std::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+}
+
+/// The brightness of a vertex by the number of occupied cells around it (3 = not occluded)
+constexpr std::array<float, 4> AMBIENT_OCCLUSION_CURVE{0.4f, 0.6f, 0.8f, 1.0f};
+
+/// Check if a point is inside of the geometry of a world. Type::NORMAL cubes count as occupied if they are at least
+/// half filled.
+bool is_occupied(const Cube &world, const glm::vec3 &point) {
+    const auto &[min, max] = world.bounding_box();
+    if (point.x < min.x || point.y < min.y || point.z < min.z || point.x >= max.x || point.y >= max.y ||
+        point.z >= max.z) {
+        return false;
+    }
+    const Cube *cube = &world;
+    while (cube->type() == Cube::Type::OCTANT) {
+        const auto center = cube->center();
+        const auto child = (point.x >= center.x ? 4u : 0u) | (point.y >= center.y ? 2u : 0u) |
+                           (point.z >= center.z ? 1u : 0u);
+        cube = cube->children()[child].get();
+    }
+    switch (cube->type()) {
+    case Cube::Type::SOLID:
+        return true;
+    case Cube::Type::NORMAL:
+        return cube->fill_ratio() >= 0.5f;
+    default:
+        return false;
+    }
+}
+
+/// @brief Calculate the ambient occlusion of a vertex of a face.
+/// The cells are as large as the cube of the face and lie in front of it. The two side cells are next to the face
+/// along the two tangent axes, and the corner cell is diagonal to it. Two occupied sides fully occlude the vertex.
+/// @param world The world which contains the face
+/// @param vertex The vertex
+/// @param centroid The centroid of the triangle, which tells in which directions the vertex lies on the face
+/// @param axis The axis which is closest to the face normal
+/// @param direction The sign of the face normal along the axis
+/// @param cell_size The size of the cube of the face
+float vertex_occlusion(const Cube &world, const glm::vec3 &vertex, const glm::vec3 &centroid, const int axis,
+                       const float direction, const float cell_size) {
+    const float half_cell = 0.5f * cell_size;
+    glm::vec3 front = vertex;
+    front[axis] += direction * half_cell;
+
+    glm::vec3 tangent1{0.0f};
+    glm::vec3 tangent2{0.0f};
+    const int axis1 = (axis + 1) % 3;
+    const int axis2 = (axis + 2) % 3;
+    if (vertex[axis1] != centroid[axis1]) {
+        tangent1[axis1] = vertex[axis1] > centroid[axis1] ? half_cell : -half_cell;
+    }
+    if (vertex[axis2] != centroid[axis2]) {
+        tangent2[axis2] = vertex[axis2] > centroid[axis2] ? half_cell : -half_cell;
+    }
+
+    // A vertex in the middle of an edge of the face has only one side, and neither side nor corner in the other
+    // direction
+    const bool has_side1 = tangent1[axis1] != 0.0f;
+    const bool has_side2 = tangent2[axis2] != 0.0f;
+    const bool side1 = has_side1 && is_occupied(world, front + tangent1 - tangent2);
+    const bool side2 = has_side2 && is_occupied(world, front + tangent2 - tangent1);
+    if (side1 && side2) {
+        return AMBIENT_OCCLUSION_CURVE[0];
+    }
+    const bool corner = has_side1 && has_side2 && is_occupied(world, front + tangent1 + tangent2);
+    return AMBIENT_OCCLUSION_CURVE[3 - static_cast<int>(side1) - static_cast<int>(side2) - static_cast<int>(corner)];
+}
+
+/// Append the polygons of all leaf cubes of a cube to a chunk mesh, with the ambient occlusion of every vertex.
+void append_polygons(const Cube &cube, const Cube &world, const OctreeVertexColorFunction &vertex_color,
+                     OctreeChunkMesh &mesh, std::unordered_map<OctreeVertex, std::uint32_t> &vertex_map) {
+    if (cube.type() == Cube::Type::OCTANT) {
+        for (const auto &child : cube.children()) {
+            append_polygons(*child, world, vertex_color, mesh, vertex_map);
+        }
+        return;
+    }
+    if (cube.type() == Cube::Type::EMPTY) {
+        return;
+    }
+    const auto cube_center = cube.center();
+    for (const auto &polygons : cube.polygons(true)) {
+        for (const auto &triangle : *polygons) {
+            const glm::vec3 centroid = (triangle[0] + triangle[1] + triangle[2]) / 3.0f;
+            glm::vec3 normal = glm::cross(triangle[1] - triangle[0], triangle[2] - triangle[0]);
+            if (glm::dot(normal, centroid - cube_center) < 0.0f) {
+                normal = -normal;
+            }
+            // Ambient occlusion is sampled in the grid of the octree, so slanted faces use the closest axis
+            int axis = 0;
+            for (int idx = 1; idx < 3; idx++) {
+                if (std::abs(normal[idx]) > std::abs(normal[axis])) {
+                    axis = idx;
+                }
+            }
+            const float direction = normal[axis] >= 0.0f ? 1.0f : -1.0f;
+
+            for (const auto &position : triangle) {
+                const OctreeVertex vertex(position, vertex_color(position),
+                                          vertex_occlusion(world, position, centroid, axis, direction, cube.size()));
+                auto [it, inserted] = vertex_map.try_emplace(vertex, static_cast<std::uint32_t>(mesh.vertices.size()));
+                if (inserted) {
+                    mesh.vertices.push_back(vertex);
+                }
+                mesh.indices.push_back(it->second);
+            }
+        }
+    }
+}
+
+std::vector<glm::vec3> vertex_positions(const OctreeChunkMesh &mesh) {
+    std::vector<glm::vec3> positions;
+    positions.reserve(mesh.vertices.size());
+    for (const auto &vertex : mesh.vertices) {
+        positions.push_back(vertex.position);
+    }
+    return positions;
+}
+
+/// @brief Sort the triangles of a chunk mesh into groups which face the same axis direction.
+/// Meshlets do not cross the groups, which keeps their normal cones narrow.
+/// @return The offsets into the indices at which the groups start
+std::vector<std::size_t> group_by_direction(OctreeChunkMesh &mesh) {
+    constexpr std::size_t DIRECTION_COUNT{6};
+    std::array<std::vector<std::uint32_t>, DIRECTION_COUNT> groups;
+    for (std::size_t idx = 0; idx < mesh.indices.size(); idx += 3) {
+        const auto &p0 = mesh.vertices[mesh.indices[idx]].position;
+        const auto &p1 = mesh.vertices[mesh.indices[idx + 1]].position;
+        const auto &p2 = mesh.vertices[mesh.indices[idx + 2]].position;
+        // Front faces are wound clockwise (see tools::build_meshlets)
+        const glm::vec3 normal = glm::cross(p2 - p0, p1 - p0);
+        int axis = 0;
+        for (int other_axis = 1; other_axis < 3; other_axis++) {
+            if (std::abs(normal[other_axis]) > std::abs(normal[axis])) {
+                axis = other_axis;
+            }
+        }
+        auto &group = groups[2 * axis + (normal[axis] < 0.0f ? 1 : 0)];
+        group.insert(group.end(), mesh.indices.begin() + idx, mesh.indices.begin() + idx + 3);
+    }
+    std::vector<std::size_t> offsets;
+    mesh.indices.clear();
+    for (const auto &group : groups) {
+        if (!group.empty()) {
+            offsets.push_back(mesh.indices.size());
+            mesh.indices.insert(mesh.indices.end(), group.begin(), group.end());
+        }
+    }
+    return offsets;
+}
+
+/// Optimize the triangle and vertex order of a chunk mesh inside of the groups of group_by_direction.
+void optimize_chunk_mesh(OctreeChunkMesh &mesh, const std::span<const std::size_t> groups,
+                         const OctreeMeshOptimizations &optimizations) {
+    const auto vertex_count = mesh.vertices.size();
+    mesh.acmr_before_optimization = tools::average_cache_miss_ratio(mesh.indices, vertex_count);
+    if (optimizations.vertex_cache) {
+        const auto positions = vertex_positions(mesh);
+        for (std::size_t group = 0; group < groups.size(); group++) {
+            const auto end = group + 1 < groups.size() ? groups[group + 1] : mesh.indices.size();
+            const auto indices = std::span(mesh.indices).subspan(groups[group], end - groups[group]);
+            const auto clusters = tools::optimize_vertex_cache(indices, vertex_count);
+            if (optimizations.overdraw) {
+                tools::optimize_overdraw(indices, positions, clusters);
+            }
+        }
+    }
+    if (optimizations.vertex_fetch) {
+        const auto remap = tools::optimize_vertex_fetch(mesh.indices, vertex_count);
+        tools::remap_vertices(mesh.vertices, remap);
+    }
+    mesh.acmr_after_optimization = tools::average_cache_miss_ratio(mesh.indices, mesh.vertices.size());
+}
+
+/// A 64 bit FNV-1a hash of the bytes of values.
+class ContentHash {
+private:
+    std::uint64_t m_hash{14695981039346656037ull};
+
+public:
+    template <typename T>
+    void add(const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        std::array<std::uint8_t, sizeof(T)> bytes;
+        std::memcpy(bytes.data(), &value, sizeof(T));
+        for (const auto byte : bytes) {
+            m_hash = (m_hash ^ byte) * 1099511628211ull;
+        }
+    }
+
+    [[nodiscard]] std::uint64_t value() const noexcept {
+        return m_hash;
+    }
+};
+
+/// Hash the cubes which intersect a region in pre-order. Cubes outside of the region are hashed as a marker only.
+void hash_region(ContentHash &hash, const Cube &cube, const std::array<glm::vec3, 2> &region) {
+    const auto &[min, max] = cube.bounding_box();
+    if (min.x > region[1].x || min.y > region[1].y || min.z > region[1].z || max.x < region[0].x ||
+        max.y < region[0].y || max.z < region[0].z) {
+        hash.add(std::numeric_limits<std::uint8_t>::max());
+        return;
+    }
+    hash.add(static_cast<std::uint8_t>(cube.type()));
+    if (cube.type() == Cube::Type::OCTANT) {
+        for (const auto &child : cube.children()) {
+            hash_region(hash, *child, region);
+        }
+        return;
+    }
+    if (cube.type() == Cube::Type::NORMAL) {
+        for (const auto &indentation : cube.indentations()) {
+            hash.add(indentation.start());
+            hash.add(indentation.end());
+        }
+    }
+}
+
+/// @brief The key of a chunk in the mesh cache.
+/// The mesh of a chunk depends on its cubes, and the ambient occlusion also on the cubes next to it. The lowest level
+/// of detail samples the ambient occlusion up to half a chunk size away, so the cubes within one chunk size around
+/// the chunk are hashed.
+std::uint64_t chunk_cache_key(const Cube &world, const Cube &chunk, const std::uint32_t max_lod_count,
+                              const vulkan_renderer::octree::LodHeuristic heuristic,
+                              const OctreeMeshOptimizations &optimizations, const std::uint64_t vertex_color_key) {
+    ContentHash hash;
+    hash.add(max_lod_count);
+    hash.add(heuristic);
+    hash.add(optimizations.vertex_cache);
+    hash.add(optimizations.overdraw);
+    hash.add(optimizations.vertex_fetch);
+    hash.add(vertex_color_key);
+    hash.add(world.position());
+    hash.add(world.size());
+    hash.add(chunk.position());
+    hash.add(chunk.size());
+    const auto &[min, max] = chunk.bounding_box();
+    const glm::vec3 margin(chunk.size());
+    hash_region(hash, world, {min - margin, max + margin});
+    return hash.value();
+}
+
+/// Mesh, optimize, and split into meshlets all levels of detail of a chunk.
+std::vector<OctreeChunkMesh> mesh_chunk(const Cube &world, const Cube &chunk, const std::uint32_t max_lod_count,
+                                        const OctreeVertexColorFunction &vertex_color,
+                                        const vulkan_renderer::octree::LodHeuristic heuristic,
+                                        const OctreeMeshOptimizations &optimizations) {
+    const auto chunk_depth = vulkan_renderer::octree::octree_depth(chunk);
+    std::vector<OctreeChunkMesh> lods(std::min(max_lod_count, chunk_depth + 1));
+    std::unordered_map<OctreeVertex, std::uint32_t> vertex_map;
+    for (std::uint32_t lod = 0; lod < lods.size(); lod++) {
+        vertex_map.clear();
+        if (lod == 0) {
+            append_polygons(chunk, world, vertex_color, lods[lod], vertex_map);
+        } else {
+            // Lower levels of detail sample the ambient occlusion in the full resolution world as well
+            const auto lod_cube = vulkan_renderer::octree::create_lod(chunk, chunk_depth - lod, heuristic);
+            append_polygons(*lod_cube, world, vertex_color, lods[lod], vertex_map);
+        }
+        const auto groups = group_by_direction(lods[lod]);
+        optimize_chunk_mesh(lods[lod], groups, optimizations);
+        lods[lod].meshlets = tools::build_meshlets(lods[lod].indices, vertex_positions(lods[lod]),
+                                                   tools::MAX_MESHLET_VERTICES, tools::MAX_MESHLET_TRIANGLES, groups);
+    }
+    return lods;
+}
+
+} // namespace
+
+OctreeMesher::OctreeMesher(const std::uint32_t chunk_depth, const std::uint32_t max_lod_count,
+                           OctreeVertexColorFunction vertex_color,
+                           const vulkan_renderer::octree::LodHeuristic heuristic)
+    : m_chunk_depth(chunk_depth), m_max_lod_count(max_lod_count), m_vertex_color(std::move(vertex_color)),
+      m_heuristic(heuristic) {
+    if (m_max_lod_count == 0) {
+        throw std::invalid_argument("Error: Parameter 'max_lod_count' must be at least 1!");
+    }
+    if (!m_vertex_color) {
+        throw std::invalid_argument("Error: Parameter 'vertex_color' is invalid!");
+    }
+}
+
+OctreeMesh OctreeMesher::assemble() const {
+    OctreeMesh mesh;
+    std::size_t vertex_count = 0;
+    std::size_t index_count = 0;
+    for (const auto &lods : m_chunk_meshes) {
+        for (const auto &lod : lods) {
+            vertex_count += lod.vertices.size();
+            index_count += lod.indices.size();
+        }
+    }
+    if (vertex_count > std::numeric_limits<std::uint32_t>::max() ||
+        index_count > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::overflow_error("Octree too big!");
+    }
+    mesh.vertices.reserve(vertex_count);
+    mesh.indices.reserve(index_count);
+    mesh.meshlet_triangles.reserve(index_count / 3);
+
+    mesh.chunks.resize(m_chunk_cubes.size());
+    for (std::size_t idx = 0; idx < m_chunk_cubes.size(); idx++) {
+        mesh.chunks[idx].bounding_box = m_chunk_cubes[idx]->bounding_box();
+        mesh.chunks[idx].lods.reserve(m_chunk_meshes[idx].size());
+        mesh.chunks[idx].lod_meshlets.reserve(m_chunk_meshes[idx].size());
+    }
+    // The ranges are sorted by level of detail first, so the ranges of consecutive chunks are adjacent
+    for (std::uint32_t lod = 0; lod < m_max_lod_count; lod++) {
+        for (std::size_t idx = 0; idx < m_chunk_meshes.size(); idx++) {
+            if (lod >= m_chunk_meshes[idx].size()) {
+                continue;
+            }
+            const auto &chunk_mesh = m_chunk_meshes[idx][lod];
+            const auto first_vertex = static_cast<std::uint32_t>(mesh.vertices.size());
+            const auto first_index = static_cast<std::uint32_t>(mesh.indices.size());
+            mesh.vertices.insert(mesh.vertices.end(), chunk_mesh.vertices.begin(), chunk_mesh.vertices.end());
+            for (const auto index : chunk_mesh.indices) {
+                mesh.indices.push_back(first_vertex + index);
+            }
+            mesh.chunks[idx].lods.push_back({
+                .first_index = first_index,
+                .index_count = static_cast<std::uint32_t>(chunk_mesh.indices.size()),
+            });
+            // The meshlet triangles are appended in the same order as the indices, which keeps the meshlets aligned
+            // with their index ranges
+            mesh.chunks[idx].lod_meshlets.push_back({
+                .first_meshlet = static_cast<std::uint32_t>(mesh.meshlets.size()),
+                .meshlet_count = static_cast<std::uint32_t>(chunk_mesh.meshlets.meshlets.size()),
+            });
+            const auto first_meshlet_vertex = static_cast<std::uint32_t>(mesh.meshlet_vertices.size());
+            const auto first_meshlet_triangle = static_cast<std::uint32_t>(mesh.meshlet_triangles.size());
+            for (auto meshlet : chunk_mesh.meshlets.meshlets) {
+                meshlet.vertex_offset += first_meshlet_vertex;
+                meshlet.triangle_offset += first_meshlet_triangle;
+                mesh.meshlets.push_back(meshlet);
+            }
+            for (const auto vertex : chunk_mesh.meshlets.vertices) {
+                mesh.meshlet_vertices.push_back(first_vertex + vertex);
+            }
+            mesh.meshlet_triangles.insert(mesh.meshlet_triangles.end(), chunk_mesh.meshlets.triangles.begin(),
+                                          chunk_mesh.meshlets.triangles.end());
+
+            const auto triangle_count = static_cast<float>(chunk_mesh.indices.size() / 3);
+            mesh.acmr_before_optimization += chunk_mesh.acmr_before_optimization * triangle_count;
+            mesh.acmr_after_optimization += chunk_mesh.acmr_after_optimization * triangle_count;
+        }
+    }
+    if (!mesh.indices.empty()) {
+        const auto triangle_count = static_cast<float>(mesh.indices.size() / 3);
+        mesh.acmr_before_optimization /= triangle_count;
+        mesh.acmr_after_optimization /= triangle_count;
+    }
+
+    mesh.cull_nodes = m_cull_nodes;
+    for (const auto &world : m_worlds) {
+        collect_occluders(world, mesh.occluders);
+    }
+    merge_occluders(mesh.occluders);
+    return mesh;
+}
+
+std::vector<std::uint32_t> OctreeMesher::find_chunks(const std::array<glm::vec3, 2> &region) const {
+    std::vector<std::uint32_t> chunks;
+    for (std::uint32_t idx = 0; idx < m_chunk_cubes.size(); idx++) {
+        const auto [min, max] = m_chunk_cubes[idx]->bounding_box();
+        if (min.x <= region[1].x && min.y <= region[1].y && min.z <= region[1].z && max.x >= region[0].x &&
+            max.y >= region[0].y && max.z >= region[0].z) {
+            chunks.push_back(idx);
+        }
+    }
+    return chunks;
+}
+
+OctreeMesh OctreeMesher::mesh(const std::span<const std::shared_ptr<vulkan_renderer::octree::Cube>> worlds) {
+    m_worlds.clear();
+    m_chunk_cubes.clear();
+    m_chunk_worlds.clear();
+    m_cull_nodes.clear();
+    for (const auto &world : worlds) {
+        if (!world) {
+            continue;
+        }
+        collect_chunks(world, 0, m_chunk_depth, m_chunk_cubes, m_cull_nodes);
+        m_chunk_worlds.resize(m_chunk_cubes.size(), m_worlds.size());
+        m_worlds.push_back(world);
+    }
+    m_chunk_meshes.assign(m_chunk_cubes.size(), {});
+
+    std::vector<std::uint32_t> all_chunks(m_chunk_cubes.size());
+    std::iota(all_chunks.begin(), all_chunks.end(), 0u);
+    mesh_chunks(all_chunks);
+    return assemble();
+}
+
+void OctreeMesher::mesh_chunks(const std::span<const std::uint32_t> chunks) {
+    for (const auto chunk : chunks) {
+        if (chunk >= m_chunk_cubes.size()) {
+            throw std::out_of_range("Error: Chunk index " + std::to_string(chunk) + " is out of range!");
+        }
+    }
+    // Every task takes the next chunk which has not been meshed yet, so large and small chunks even out
+    std::atomic<std::size_t> next_chunk{0};
+    const auto mesh_next_chunks = [&]() {
+        for (auto idx = next_chunk++; idx < chunks.size(); idx = next_chunk++) {
+            const auto chunk = chunks[idx];
+            const auto &world = *m_worlds[m_chunk_worlds[chunk]];
+            const auto &chunk_cube = *m_chunk_cubes[chunk];
+            if (!m_cache) {
+                m_chunk_meshes[chunk] =
+                    mesh_chunk(world, chunk_cube, m_max_lod_count, m_vertex_color, m_heuristic, m_optimizations);
+                continue;
+            }
+            const auto key = chunk_cache_key(world, chunk_cube, m_max_lod_count, m_heuristic, m_optimizations,
+                                             m_vertex_color_key);
+            if (auto lods = m_cache->find(key)) {
+                m_chunk_meshes[chunk] = std::move(*lods);
+                continue;
+            }
+            m_chunk_meshes[chunk] =
+                mesh_chunk(world, chunk_cube, m_max_lod_count, m_vertex_color, m_heuristic, m_optimizations);
+            m_cache->insert(key, m_chunk_meshes[chunk]);
+        }
+    };
+    const auto task_count =
+        std::min<std::size_t>(chunks.size(), std::max(1u, std::thread::hardware_concurrency()));
+    if (task_count <= 1) {
+        mesh_next_chunks();
+        return;
+    }
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(task_count - 1);
+    for (std::size_t task = 1; task < task_count; task++) {
+        tasks.push_back(std::async(std::launch::async, mesh_next_chunks));
+    }
+    // The calling thread helps as well. All tasks are waited for before rethrowing, so no task outlives the captured
+    // references.
+    std::exception_ptr exception;
+    try {
+        mesh_next_chunks();
+    } catch (...) {
+        exception = std::current_exception();
+        next_chunk = chunks.size();
+    }
+    for (auto &task : tasks) {
+        task.wait();
+    }
+    for (auto &task : tasks) {
+        task.get();
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+OctreeMesh OctreeMesher::remesh(const std::span<const std::uint32_t> chunks) {
+    mesh_chunks(chunks);
+    return assemble();
+}
+
+OctreeMesh build_octree_mesh(const std::span<const std::shared_ptr<vulkan_renderer::octree::Cube>> worlds,
+                             const std::uint32_t chunk_depth, const std::uint32_t max_lod_count,
+                             const OctreeVertexColorFunction &vertex_color,
+                             const vulkan_renderer::octree::LodHeuristic heuristic) {
+    return OctreeMesher(chunk_depth, max_lod_count, vertex_color, heuristic).mesh(worlds);
+}
+
+void collect_draw_ranges(const OctreeMesh &mesh, const std::span<const std::uint32_t> visible_chunks,
+                         const glm::vec3 &camera_position, const std::span<const float> lod_distances,
+                         std::vector<OctreeMeshRange> &draw_ranges) {
+    draw_ranges.clear();
+    for (const auto chunk_index : visible_chunks) {
+        const auto &chunk = mesh.chunks.at(chunk_index);
+        if (chunk.lods.empty()) {
+            continue;
+        }
+        const auto &range = chunk.lods[select_lod(chunk, camera_position, lod_distances)];
+        if (range.index_count == 0) {
+            continue;
+        }
+        if (!draw_ranges.empty() &&
+            draw_ranges.back().first_index + draw_ranges.back().index_count == range.first_index) {
+            draw_ranges.back().index_count += range.index_count;
+            continue;
+        }
+        draw_ranges.push_back(range);
+    }
+}
+
+void cull_occluded_chunks(const OctreeMesh &mesh, const std::span<const std::uint32_t> occluders,
+                          const glm::mat4 &view_projection, tools::OcclusionBuffer &occlusion_buffer,
+                          std::vector<std::uint32_t> &visible_chunks) {
+    if (occluders.empty()) {
+        return;
+    }
+    occlusion_buffer.clear(view_projection);
+    for (const auto occluder : occluders) {
+        occlusion_buffer.rasterize_box(mesh.occluders.at(occluder));
+    }
+    occlusion_buffer.build_hierarchy();
+    std::erase_if(visible_chunks, [&](const std::uint32_t chunk) {
+        return !occlusion_buffer.is_visible(mesh.chunks.at(chunk).bounding_box);
+    });
+}
+
+void cull_chunks(const OctreeMesh &mesh, const tools::Frustum &frustum, std::vector<std::uint32_t> &visible_chunks) {
+    visible_chunks.clear();
+    std::size_t node_index = 0;
+    while (node_index < mesh.cull_nodes.size()) {
+        const auto &node = mesh.cull_nodes[node_index];
+        const auto intersection = frustum.intersect(node.bounding_box);
+        // Descend only into octants which are partially visible
+        if (intersection == tools::FrustumIntersection::INTERSECTING && node.skip != node_index + 1) {
+            node_index++;
+            continue;
+        }
+        if (intersection != tools::FrustumIntersection::OUTSIDE) {
+            for (std::uint32_t chunk = node.first_chunk; chunk < node.first_chunk + node.chunk_count; chunk++) {
+                visible_chunks.push_back(chunk);
+            }
+        }
+        node_index = node.skip;
+    }
+}
+
+void select_occluders(const OctreeMesh &mesh, const glm::vec3 &camera_position, const std::size_t max_occluder_count,
+                      std::vector<std::uint32_t> &occluders) {
+    occluders.clear();
+    for (std::uint32_t idx = 0; idx < mesh.occluders.size(); idx++) {
+        if (distance_to_box(camera_position, mesh.occluders[idx]) > 0.0f) {
+            occluders.push_back(idx);
+        }
+    }
+    if (occluders.size() <= max_occluder_count) {
+        return;
+    }
+    // The size of a box divided by its distance approximates the angle it covers in the view
+    const auto coverage = [&](const std::uint32_t occluder) {
+        const auto &[min, max] = mesh.occluders[occluder];
+        const glm::vec3 extent = max - min;
+        return (extent.x + extent.y + extent.z) / distance_to_box(camera_position, mesh.occluders[occluder]);
+    };
+    std::nth_element(occluders.begin(), occluders.begin() + static_cast<std::ptrdiff_t>(max_occluder_count),
+                     occluders.end(), [&](const auto lhs, const auto rhs) { return coverage(lhs) > coverage(rhs); });
+    occluders.resize(max_occluder_count);
+}
+
+void collect_meshlet_draw_ranges(const OctreeMesh &mesh, const std::span<const std::uint32_t> visible_chunks,
+                                 const tools::Frustum &frustum, const glm::vec3 &camera_position,
+                                 const std::span<const float> lod_distances,
+                                 std::vector<OctreeMeshRange> &draw_ranges) {
+    draw_ranges.clear();
+    for (const auto chunk_index : visible_chunks) {
+        const auto &chunk = mesh.chunks.at(chunk_index);
+        if (chunk.lods.empty()) {
+            continue;
+        }
+        const auto add_range = [&](const OctreeMeshRange &range) {
+            if (range.index_count == 0) {
+                return;
+            }
+            if (!draw_ranges.empty() &&
+                draw_ranges.back().first_index + draw_ranges.back().index_count == range.first_index) {
+                draw_ranges.back().index_count += range.index_count;
+                return;
+            }
+            draw_ranges.push_back(range);
+        };
+        const auto lod = select_lod(chunk, camera_position, lod_distances);
+        // Chunks without meshlets are drawn as a whole
+        if (lod >= chunk.lod_meshlets.size()) {
+            add_range(chunk.lods[lod]);
+            continue;
+        }
+        const auto &meshlets = chunk.lod_meshlets[lod];
+        for (auto idx = meshlets.first_meshlet; idx < meshlets.first_meshlet + meshlets.meshlet_count; idx++) {
+            const auto &meshlet = mesh.meshlets[idx];
+            if (tools::is_meshlet_backfacing(meshlet, camera_position) ||
+                frustum.intersect(meshlet.center, meshlet.radius) == tools::FrustumIntersection::OUTSIDE) {
+                continue;
+            }
+            add_range({
+                .first_index = 3 * meshlet.triangle_offset,
+                .index_count = 3 * meshlet.triangle_count,
+            });
+        }
+    }
+}
+
+std::size_t select_lod(const OctreeChunk &chunk, const glm::vec3 &camera_position,
+                       const std::span<const float> lod_distances) {
+    if (chunk.lods.empty()) {
+        return 0;
+    }
+    const auto &[min, max] = chunk.bounding_box;
+    const glm::vec3 closest{
+        std::clamp(camera_position.x, min.x, max.x),
+        std::clamp(camera_position.y, min.y, max.y),
+        std::clamp(camera_position.z, min.z, max.z),
+    };
+    const glm::vec3 offset = camera_position - closest;
+    const float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+
+    std::size_t lod = 0;
+    while (lod < lod_distances.size() && distance >= lod_distances[lod]) {
+        lod++;
+    }
+    return std::min(lod, chunk.lods.size() - 1);
+}
+
+} // namespace inexor::vulkan_renderer::render_modules::octree
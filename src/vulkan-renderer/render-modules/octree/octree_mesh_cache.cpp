@@ -0,0 +1,327 @@
+#include "inexor/vulkan-renderer/render-modules/octree/octree_mesh_cache.hpp"
+
+#include "inexor/vulkan-renderer/tools/memory_mapped_file.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+
+namespace inexor::vulkan_renderer::render_modules::octree {
+
+namespace {
+
+constexpr std::string_view IDENTIFIER{"Inexor MeshCache"};
+constexpr std::uint32_t BYTE_ORDER_MARK{0x01020304};
+constexpr std::size_t HEADER_SIZE{IDENTIFIER.size() + 3 * sizeof(std::uint32_t)};
+constexpr std::size_t TABLE_ENTRY_SIZE{3 * sizeof(std::uint64_t)};
+/// The number of floats of an encoded OctreeVertex
+constexpr std::size_t VERTEX_FLOATS{7};
+
+template <typename T>
+void append(std::vector<std::uint8_t> &buffer, const T &value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto *bytes = reinterpret_cast<const std::uint8_t *>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+void append(std::vector<std::uint8_t> &buffer, const std::vector<T> &values) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto *bytes = reinterpret_cast<const std::uint8_t *>(values.data());
+    buffer.insert(buffer.end(), bytes, bytes + values.size() * sizeof(T));
+}
+
+/// Reads the values of an entry with bounds checks, because the file may be corrupt.
+class EntryReader {
+private:
+    std::span<const std::uint8_t> m_data;
+    std::size_t m_position{0};
+
+    void check(const std::size_t size) const {
+        if (size > m_data.size() - m_position) {
+            throw std::runtime_error("Error: Corrupt octree mesh cache entry!");
+        }
+    }
+
+public:
+    explicit EntryReader(const std::span<const std::uint8_t> data) : m_data(data) {}
+
+    template <typename T>
+    [[nodiscard]] T read() {
+        check(sizeof(T));
+        T value;
+        std::memcpy(&value, m_data.data() + m_position, sizeof(T));
+        m_position += sizeof(T);
+        return value;
+    }
+
+    template <typename T>
+    void read(std::vector<T> &values, const std::size_t count) {
+        // The size is checked before allocating, so corrupt counts can't cause huge allocations
+        check(count * sizeof(T));
+        values.resize(count);
+        std::memcpy(values.data(), m_data.data() + m_position, count * sizeof(T));
+        m_position += count * sizeof(T);
+    }
+
+    [[nodiscard]] std::size_t remaining() const {
+        return m_data.size() - m_position;
+    }
+};
+
+std::vector<std::uint8_t> encode_lods(const std::span<const OctreeChunkMesh> lods) {
+    std::vector<std::uint8_t> buffer;
+    append(buffer, static_cast<std::uint32_t>(lods.size()));
+    for (const auto &lod : lods) {
+        append(buffer, static_cast<std::uint32_t>(lod.vertices.size()));
+        append(buffer, static_cast<std::uint32_t>(lod.indices.size()));
+        append(buffer, static_cast<std::uint32_t>(lod.meshlets.meshlets.size()));
+        append(buffer, static_cast<std::uint32_t>(lod.meshlets.vertices.size()));
+        append(buffer, static_cast<std::uint32_t>(lod.meshlets.triangles.size()));
+        append(buffer, lod.acmr_before_optimization);
+        append(buffer, lod.acmr_after_optimization);
+    }
+    for (const auto &lod : lods) {
+        for (const auto &vertex : lod.vertices) {
+            const std::array<float, VERTEX_FLOATS> floats{vertex.position.x, vertex.position.y, vertex.position.z,
+                                                          vertex.color.x,    vertex.color.y,    vertex.color.z,
+                                                          vertex.occlusion};
+            append(buffer, floats);
+        }
+        append(buffer, lod.indices);
+        append(buffer, lod.meshlets.meshlets);
+        append(buffer, lod.meshlets.vertices);
+        append(buffer, lod.meshlets.triangles);
+    }
+    return buffer;
+}
+
+std::vector<OctreeChunkMesh> decode_lods(const std::span<const std::uint8_t> data) {
+    EntryReader reader(data);
+    const auto lod_count = reader.read<std::uint32_t>();
+    // Every level of detail needs 7 values, which protects against huge allocations for corrupt counts
+    if (lod_count > reader.remaining() / (7 * sizeof(std::uint32_t))) {
+        throw std::runtime_error("Error: Corrupt octree mesh cache entry!");
+    }
+    std::vector<OctreeChunkMesh> lods(lod_count);
+    std::vector<std::array<std::uint32_t, 5>> counts(lod_count);
+    for (std::uint32_t lod = 0; lod < lod_count; lod++) {
+        for (auto &count : counts[lod]) {
+            count = reader.read<std::uint32_t>();
+        }
+        lods[lod].acmr_before_optimization = reader.read<float>();
+        lods[lod].acmr_after_optimization = reader.read<float>();
+    }
+    std::vector<std::array<float, VERTEX_FLOATS>> vertices;
+    for (std::uint32_t lod = 0; lod < lod_count; lod++) {
+        auto &mesh = lods[lod];
+        reader.read(vertices, counts[lod][0]);
+        mesh.vertices.reserve(vertices.size());
+        for (const auto &vertex : vertices) {
+            mesh.vertices.emplace_back(glm::vec3(vertex[0], vertex[1], vertex[2]),
+                                       glm::vec3(vertex[3], vertex[4], vertex[5]), vertex[6]);
+        }
+        reader.read(mesh.indices, counts[lod][1]);
+        reader.read(mesh.meshlets.meshlets, counts[lod][2]);
+        reader.read(mesh.meshlets.vertices, counts[lod][3]);
+        reader.read(mesh.meshlets.triangles, counts[lod][4]);
+        // The indices are not used without checking, because a corrupt mesh must not read outside of its vertices
+        for (const auto index : mesh.indices) {
+            if (index >= mesh.vertices.size()) {
+                throw std::runtime_error("Error: Corrupt octree mesh cache entry!");
+            }
+        }
+        for (const auto vertex : mesh.meshlets.vertices) {
+            if (vertex >= mesh.vertices.size()) {
+                throw std::runtime_error("Error: Corrupt octree mesh cache entry!");
+            }
+        }
+        // The meshlets are drawn as ranges of the meshlet triangles and of the index buffer
+        for (const auto &meshlet : mesh.meshlets.meshlets) {
+            const auto triangle_end = std::uint64_t{meshlet.triangle_offset} + meshlet.triangle_count;
+            if (std::uint64_t{meshlet.vertex_offset} + meshlet.vertex_count > mesh.meshlets.vertices.size() ||
+                triangle_end > mesh.meshlets.triangles.size() || triangle_end > mesh.indices.size() / 3) {
+                throw std::runtime_error("Error: Corrupt octree mesh cache entry!");
+            }
+        }
+    }
+    if (reader.remaining() != 0) {
+        throw std::runtime_error("Error: Corrupt octree mesh cache entry!");
+    }
+    return lods;
+}
+
+} // namespace
+
+OctreeMeshCache::OctreeMeshCache(std::filesystem::path path) : m_path(std::move(path)) {
+    load();
+}
+
+OctreeMeshCache::~OctreeMeshCache() = default;
+
+void OctreeMeshCache::load() {
+    if (!std::filesystem::exists(m_path)) {
+        // This is not an error at all, just likely the first time the application is started
+        spdlog::trace("Octree mesh cache file '{}' does not exist yet.", m_path.string());
+        return;
+    }
+    try {
+        m_file = std::make_shared<const tools::MemoryMappedFile>(m_path);
+    } catch (const std::runtime_error &exception) {
+        spdlog::error("Could not load octree mesh cache file '{}': {}", m_path.string(), exception.what());
+        return;
+    }
+    const auto data = m_file->data();
+    const auto discard = [&](const std::string_view reason) {
+        spdlog::trace("Discarding octree mesh cache file '{}' ({}).", m_path.string(), reason);
+        m_file.reset();
+        m_entries.clear();
+    };
+    if (data.size() < HEADER_SIZE ||
+        std::string_view(reinterpret_cast<const char *>(data.data()), IDENTIFIER.size()) != IDENTIFIER) {
+        return discard("wrong identifier");
+    }
+    EntryReader reader(data.subspan(IDENTIFIER.size()));
+    if (reader.read<std::uint32_t>() != VERSION) {
+        return discard("outdated version");
+    }
+    if (reader.read<std::uint32_t>() != BYTE_ORDER_MARK) {
+        return discard("different byte order");
+    }
+    const auto entry_count = reader.read<std::uint32_t>();
+    if (entry_count > reader.remaining() / TABLE_ENTRY_SIZE) {
+        return discard("corrupt table");
+    }
+    m_entries.resize(entry_count);
+    for (std::size_t idx = 0; idx < m_entries.size(); idx++) {
+        auto &entry = m_entries[idx];
+        entry.key = reader.read<std::uint64_t>();
+        entry.offset = reader.read<std::uint64_t>();
+        entry.size = reader.read<std::uint64_t>();
+        if (entry.offset > data.size() || entry.size > data.size() - entry.offset ||
+            (idx > 0 && entry.key <= m_entries[idx - 1].key)) {
+            return discard("corrupt table");
+        }
+    }
+    spdlog::trace("Loaded {} chunk meshes from octree mesh cache file '{}'.", m_entries.size(), m_path.string());
+}
+
+std::optional<std::vector<OctreeChunkMesh>> OctreeMeshCache::find(const std::uint64_t key) {
+    std::shared_ptr<const tools::MemoryMappedFile> file;
+    Entry entry;
+    {
+        std::scoped_lock lock(m_mutex);
+        if (const auto new_entry = m_new_entries.find(key); new_entry != m_new_entries.end()) {
+            m_hits++;
+            return decode_lods(new_entry->second);
+        }
+        const auto file_entry =
+            std::lower_bound(m_entries.begin(), m_entries.end(), key,
+                             [](const Entry &lhs, const std::uint64_t rhs) { return lhs.key < rhs; });
+        if (file_entry == m_entries.end() || file_entry->key != key) {
+            m_misses++;
+            return std::nullopt;
+        }
+        // The file is kept alive by this reference, even if save replaces it meanwhile
+        file = m_file;
+        entry = *file_entry;
+    }
+    try {
+        // The file is only read, so several threads can decode entries at once
+        auto lods = decode_lods(file->data().subspan(entry.offset, entry.size));
+        std::scoped_lock lock(m_mutex);
+        m_used_keys.insert(key);
+        m_hits++;
+        return lods;
+    } catch (const std::runtime_error &exception) {
+        spdlog::warn("Ignoring octree mesh cache entry {:016x}: {}", key, exception.what());
+        m_misses++;
+        return std::nullopt;
+    }
+}
+
+void OctreeMeshCache::insert(const std::uint64_t key, const std::span<const OctreeChunkMesh> lods) {
+    // Encode outside of the lock, so chunks which are meshed in parallel do not wait for each other
+    auto entry = encode_lods(lods);
+    std::scoped_lock lock(m_mutex);
+    m_new_entries.insert_or_assign(key, std::move(entry));
+}
+
+bool OctreeMeshCache::save() {
+    std::scoped_lock lock(m_mutex);
+    // Inserted meshes replace the meshes of the file with the same key
+    std::vector<std::pair<std::uint64_t, std::span<const std::uint8_t>>> entries;
+    entries.reserve(m_used_keys.size() + m_new_entries.size());
+    for (const auto &entry : m_entries) {
+        if (m_used_keys.contains(entry.key) && !m_new_entries.contains(entry.key)) {
+            entries.emplace_back(entry.key, m_file->data().subspan(entry.offset, entry.size));
+        }
+    }
+    for (const auto &[key, data] : m_new_entries) {
+        entries.emplace_back(key, data);
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+
+    auto temporary_path = m_path;
+    temporary_path += ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            spdlog::error("Could not create octree mesh cache file '{}'!", temporary_path.string());
+            return false;
+        }
+        std::vector<std::uint8_t> header;
+        header.insert(header.end(), IDENTIFIER.begin(), IDENTIFIER.end());
+        append(header, VERSION);
+        append(header, BYTE_ORDER_MARK);
+        append(header, static_cast<std::uint32_t>(entries.size()));
+        std::uint64_t offset = HEADER_SIZE + TABLE_ENTRY_SIZE * entries.size();
+        for (const auto &[key, data] : entries) {
+            append(header, key);
+            append(header, offset);
+            append(header, static_cast<std::uint64_t>(data.size()));
+            offset += data.size();
+        }
+        file.write(reinterpret_cast<const char *>(header.data()), static_cast<std::streamsize>(header.size()));
+        for (const auto &[key, data] : entries) {
+            file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        }
+        if (!file.flush()) {
+            spdlog::error("Could not write octree mesh cache file '{}'!", temporary_path.string());
+            return false;
+        }
+    }
+    std::unordered_set<std::uint64_t> saved_keys;
+    for (const auto &[key, data] : entries) {
+        saved_keys.insert(key);
+    }
+    entries.clear();
+
+    // The old file must not be mapped while it is replaced, which is not even possible on Windows
+    m_file.reset();
+    m_entries.clear();
+    std::error_code error;
+    std::filesystem::rename(temporary_path, m_path, error);
+    if (error) {
+        spdlog::error("Could not replace octree mesh cache file '{}': {}", m_path.string(), error.message());
+        std::filesystem::remove(temporary_path, error);
+        load();
+        return false;
+    }
+    spdlog::trace("Writing {} chunk meshes to octree mesh cache file '{}'.", saved_keys.size(), m_path.string());
+    // The inserted meshes are in the new file now, and all of its entries are kept by the next save
+    m_new_entries.clear();
+    m_used_keys = std::move(saved_keys);
+    load();
+    return true;
+}
+
+} // namespace inexor::vulkan_renderer::render_modules::octree
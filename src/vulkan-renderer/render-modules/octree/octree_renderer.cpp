@@ -5,14 +5,18 @@
 #include "inexor/vulkan-renderer/render-graph/texture.hpp"
 #include "inexor/vulkan-renderer/tools/camera.hpp"
 #include "inexor/vulkan-renderer/tools/exception.hpp"
+#include "inexor/vulkan-renderer/wrapper/core/device.hpp"
 #include "inexor/vulkan-renderer/wrapper/descriptors/per_frame_descriptor_sets.hpp"
 #include "inexor/vulkan-renderer/wrapper/descriptors/write_descriptor_set_builder.hpp"
 #include "inexor/vulkan-renderer/wrapper/shaders/shader.hpp"
 
 #include <fmt/color.h>
+#include <glm/common.hpp>
 #include <spdlog/fmt/bundled/color.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <utility>
 
@@ -68,6 +72,50 @@ OctreeRenderer::OctreeRenderer(std::shared_ptr<RenderGraph> render_graph, std::w
         },
         render_graph::BufferUpdateMode::PER_FRAME_HOST_VISIBLE);
 
+    // Frustum culling, occlusion culling, level of detail selection, and meshlet culling happen in the update of the
+    // indirect buffer, because buffers are updated before the passes are recorded. Every merged index range of the
+    // visible chunks or meshlets becomes one draw command.
+    m_multi_draw_indirect = render_graph->device().is_multi_draw_indirect_supported();
+    m_indirect_buffer = render_graph->add_buffer(
+        "indirect draw commands", BufferType::INDIRECT_BUFFER,
+        [&]() {
+            const auto camera = m_camera.lock();
+            cull_chunks(m_octree_mesh, camera->frustum(), m_visible_chunks);
+            if (m_occlusion_culling) {
+                select_occluders(m_octree_mesh, camera->position(), MAX_OCCLUDER_COUNT, m_occluders);
+                cull_occluded_chunks(m_octree_mesh, m_occluders, camera->perspective_matrix() * camera->view_matrix(),
+                                     m_occlusion_buffer, m_visible_chunks);
+            }
+            if (m_meshlet_culling) {
+                collect_meshlet_draw_ranges(m_octree_mesh, m_visible_chunks, camera->frustum(), camera->position(),
+                                            m_lod_distances, m_draw_ranges);
+            } else {
+                collect_draw_ranges(m_octree_mesh, m_visible_chunks, camera->position(), m_lod_distances,
+                                    m_draw_ranges);
+            }
+            m_draw_commands.clear();
+            for (const auto &range : m_draw_ranges) {
+                m_draw_commands.push_back({
+                    .indexCount = range.index_count,
+                    .instanceCount = 1,
+                    .firstIndex = range.first_index,
+                });
+            }
+            // The draw count is recorded into the secondary command buffers of the pass, which are only recorded again
+            // when they are marked dirty. The draw commands are padded with empty ones to the next power of two, so
+            // the pass is recorded again only when this count changes and not every time a chunk becomes visible.
+            // This also writes an empty draw command if nothing is visible, so no old draw commands are left over.
+            const auto draw_count = std::bit_ceil(std::max<std::size_t>(m_draw_commands.size(), 1));
+            m_draw_commands.resize(draw_count, VkDrawIndexedIndirectCommand{});
+            const auto octree_pass = m_octree_pass.lock();
+            if (octree_pass && draw_count != m_recorded_draw_count) {
+                m_recorded_draw_count = draw_count;
+                octree_pass->mark_secondary_cmd_buffers_dirty();
+            }
+            m_indirect_buffer.lock()->request_update(m_draw_commands);
+        },
+        render_graph::BufferUpdateMode::PER_FRAME_HOST_VISIBLE);
+
     // Descriptor management for the model/view/projection uniform buffer
     m_descriptor_set = render_graph->add_resource_descriptor(m_mvp_matrix, VK_SHADER_STAGE_VERTEX_BIT);
 
@@ -75,8 +123,8 @@ OctreeRenderer::OctreeRenderer(std::shared_ptr<RenderGraph> render_graph, std::w
         // Upload once after render-graph/swapchain recreation as well, because the new buffer starts null.
         const auto vertex_buffer = m_vertex_buffer.lock();
         const bool needs_initial_upload = vertex_buffer && vertex_buffer->buffer() == VK_NULL_HANDLE;
-        if ((m_geometry_updated || needs_initial_upload) && !m_octree_vertices.empty()) {
-            vertex_buffer->request_update(m_octree_vertices);
+        if ((m_geometry_updated || needs_initial_upload) && !m_octree_mesh.vertices.empty()) {
+            vertex_buffer->request_update(m_octree_mesh.vertices);
         }
     });
 
@@ -84,8 +132,8 @@ OctreeRenderer::OctreeRenderer(std::shared_ptr<RenderGraph> render_graph, std::w
         // Upload once after render-graph/swapchain recreation as well, because the new buffer starts null.
         const auto index_buffer = m_index_buffer.lock();
         const bool needs_initial_upload = index_buffer && index_buffer->buffer() == VK_NULL_HANDLE;
-        if ((m_geometry_updated || needs_initial_upload) && !m_octree_indices.empty()) {
-            index_buffer->request_update(m_octree_indices);
+        if ((m_geometry_updated || needs_initial_upload) && !m_octree_mesh.indices.empty()) {
+            index_buffer->request_update(m_octree_mesh.indices);
             // Reset after index update has been requested so vertex+index uploads stay in sync.
             m_geometry_updated = false;
         }
@@ -117,6 +165,11 @@ OctreeRenderer::OctreeRenderer(std::shared_ptr<RenderGraph> render_graph, std::w
                         .format = VK_FORMAT_R32G32B32_SFLOAT,
                         .offset = offsetof(OctreeVertex, color),
                     },
+                    {
+                        .location = 2,
+                        .format = VK_FORMAT_R32_SFLOAT,
+                        .offset = offsetof(OctreeVertex, occlusion),
+                    },
                 })
                 .add_standard_alpha_blend_attachment()
                 .set_depth_attachment_format(m_depth_buffer.lock()->format())
@@ -155,14 +208,16 @@ OctreeRenderer::OctreeRenderer(std::shared_ptr<RenderGraph> render_graph, std::w
 
         return builder.writes_to(m_depth_buffer, VkClearValue{.depthStencil = {.depth = 1.0f, .stencil = 0}})
             .reads_from(m_vertex_buffer)
-            .writes_to(m_index_buffer)
             .reads_from(m_index_buffer)
+            .reads_from(m_indirect_buffer)
             .set_on_record([&](wrapper::commands::CommandBufferBuilder &cmd_buf) {
                 const auto vertex_buffer = m_vertex_buffer.lock();
                 const auto index_buffer = m_index_buffer.lock();
+                const auto indirect_buffer = m_indirect_buffer.lock();
                 const auto swapchain = m_swapchain.lock();
-                if (!vertex_buffer || !index_buffer || vertex_buffer->buffer() == VK_NULL_HANDLE ||
-                    index_buffer->buffer() == VK_NULL_HANDLE || m_octree_indices.empty() || !swapchain) {
+                if (!vertex_buffer || !index_buffer || !indirect_buffer || vertex_buffer->buffer() == VK_NULL_HANDLE ||
+                    index_buffer->buffer() == VK_NULL_HANDLE || indirect_buffer->buffer() == VK_NULL_HANDLE ||
+                    !swapchain) {
                     return;
                 }
                 const auto render_extent = swapchain->extent();
@@ -178,21 +233,67 @@ OctreeRenderer::OctreeRenderer(std::shared_ptr<RenderGraph> render_graph, std::w
                     })
                     .set_scissor({
                         .extent = render_extent,
-                    })
-                    .draw_indexed(static_cast<std::uint32_t>(m_octree_indices.size()));
+                    });
+
+                const auto draw_count = static_cast<std::uint32_t>(m_draw_commands.size());
+                if (m_multi_draw_indirect) {
+                    cmd_buf.draw_indexed_indirect(m_indirect_buffer, draw_count);
+                    return;
+                }
+                for (std::uint32_t draw = 0; draw < draw_count; draw++) {
+                    cmd_buf.draw_indexed_indirect(m_indirect_buffer, 1, draw * sizeof(VkDrawIndexedIndirectCommand));
+                }
             })
             .build("Octree", DebugLabelColor::GREEN);
     });
 }
 
-void OctreeRenderer::set_vertices_and_indices(std::vector<OctreeVertex> vertices, std::vector<std::uint32_t> indices) {
-    if (m_octree_vertices == vertices && m_octree_indices == indices) {
+void OctreeRenderer::set_lod_distances(std::vector<float> lod_distances) {
+    if (!std::is_sorted(lod_distances.begin(), lod_distances.end())) {
+        throw tools::InexorException("Error: Level of detail distances must be in ascending order!");
+    }
+    m_lod_distances = std::move(lod_distances);
+}
+
+void OctreeRenderer::set_mesh(OctreeMesh mesh) {
+    if (m_octree_mesh.vertices == mesh.vertices && m_octree_mesh.indices == mesh.indices) {
+        m_octree_mesh.chunks = std::move(mesh.chunks);
+        m_octree_mesh.cull_nodes = std::move(mesh.cull_nodes);
+        m_octree_mesh.occluders = std::move(mesh.occluders);
+        m_octree_mesh.meshlets = std::move(mesh.meshlets);
+        m_octree_mesh.meshlet_vertices = std::move(mesh.meshlet_vertices);
+        m_octree_mesh.meshlet_triangles = std::move(mesh.meshlet_triangles);
         return;
     }
 
-    m_octree_vertices = std::move(vertices);
-    m_octree_indices = std::move(indices);
+    m_octree_mesh = std::move(mesh);
     m_geometry_updated = true;
 }
 
+void OctreeRenderer::set_vertices_and_indices(std::vector<OctreeVertex> vertices, std::vector<std::uint32_t> indices) {
+    OctreeMesh mesh{
+        .vertices = std::move(vertices),
+        .indices = std::move(indices),
+    };
+    if (!mesh.vertices.empty()) {
+        // A single chunk which covers all of the geometry
+        OctreeChunk chunk{
+            .bounding_box = {mesh.vertices.front().position, mesh.vertices.front().position},
+            .lods = {{.first_index = 0, .index_count = static_cast<std::uint32_t>(mesh.indices.size())}},
+        };
+        for (const auto &vertex : mesh.vertices) {
+            chunk.bounding_box[0] = glm::min(chunk.bounding_box[0], vertex.position);
+            chunk.bounding_box[1] = glm::max(chunk.bounding_box[1], vertex.position);
+        }
+        mesh.cull_nodes.push_back({
+            .bounding_box = chunk.bounding_box,
+            .first_chunk = 0,
+            .chunk_count = 1,
+            .skip = 1,
+        });
+        mesh.chunks.push_back(std::move(chunk));
+    }
+    set_mesh(std::move(mesh));
+}
+
 } // namespace inexor::vulkan_renderer::render_modules::octree
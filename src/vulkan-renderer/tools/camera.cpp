@@ -128,6 +128,7 @@ void Camera::update_matrices() {
             m_vertical_fov = 2.0f * glm::atan(glm::tan(glm::radians(m_fov) / 2.0f) / m_aspect_ratio);
             m_update_vertical_fov = false;
         }
+        const bool update_frustum = m_update_view_matrix || m_update_perspective_matrix;
         if (m_update_view_matrix) {
             m_view_matrix = glm::lookAt(m_position, m_position + m_front, m_up);
             m_update_view_matrix = false;
@@ -136,6 +137,9 @@ void Camera::update_matrices() {
             m_perspective_matrix = glm::perspective(m_vertical_fov, m_aspect_ratio, m_near_plane, m_far_plane);
             m_update_perspective_matrix = false;
         }
+        if (update_frustum) {
+            m_frustum = Frustum(m_perspective_matrix * m_view_matrix);
+        }
     }
 }
 
@@ -0,0 +1,57 @@
+#include "inexor/vulkan-renderer/tools/frustum.hpp"
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_access.hpp>
+
+namespace inexor::vulkan_renderer::tools {
+
+Frustum::Frustum(const glm::mat4 &view_projection) {
+    const glm::vec4 row0 = glm::row(view_projection, 0);
+    const glm::vec4 row1 = glm::row(view_projection, 1);
+    const glm::vec4 row2 = glm::row(view_projection, 2);
+    const glm::vec4 row3 = glm::row(view_projection, 3);
+
+    m_planes = {row3 + row0, row3 - row0, row3 + row1, row3 - row1, row2, row3 - row2};
+    for (auto &plane : m_planes) {
+        const float length = glm::length(glm::vec3(plane.x, plane.y, plane.z));
+        if (length > 0.0f) {
+            plane /= length;
+        }
+    }
+}
+
+FrustumIntersection Frustum::intersect(const std::array<glm::vec3, 2> &bounding_box) const noexcept {
+    const auto &[min, max] = bounding_box;
+    auto result = FrustumIntersection::INSIDE;
+    for (const auto &plane : m_planes) {
+        // The corner which is furthest along the plane normal (p-vertex), and the one opposite of it (n-vertex)
+        const glm::vec3 positive{plane.x >= 0.0f ? max.x : min.x, plane.y >= 0.0f ? max.y : min.y,
+                                 plane.z >= 0.0f ? max.z : min.z};
+        const glm::vec3 negative{plane.x >= 0.0f ? min.x : max.x, plane.y >= 0.0f ? min.y : max.y,
+                                 plane.z >= 0.0f ? min.z : max.z};
+        const glm::vec3 normal{plane.x, plane.y, plane.z};
+        if (glm::dot(normal, positive) + plane.w < 0.0f) {
+            return FrustumIntersection::OUTSIDE;
+        }
+        if (glm::dot(normal, negative) + plane.w < 0.0f) {
+            result = FrustumIntersection::INTERSECTING;
+        }
+    }
+    return result;
+}
+
+FrustumIntersection Frustum::intersect(const glm::vec3 &center, const float radius) const noexcept {
+    auto result = FrustumIntersection::INSIDE;
+    for (const auto &plane : m_planes) {
+        const float distance = glm::dot(glm::vec3(plane.x, plane.y, plane.z), center) + plane.w;
+        if (distance < -radius) {
+            return FrustumIntersection::OUTSIDE;
+        }
+        if (distance < radius) {
+            result = FrustumIntersection::INTERSECTING;
+        }
+    }
+    return result;
+}
+
+} // namespace inexor::vulkan_renderer::tools
@@ -0,0 +1,144 @@
+#include "inexor/vulkan-renderer/tools/lz_codec.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace inexor::vulkan_renderer::tools {
+
+namespace {
+
+constexpr std::size_t MIN_MATCH{4};
+constexpr std::size_t MAX_OFFSET{0xFFFF};
+constexpr std::uint32_t HASH_BITS{14};
+constexpr std::uint8_t NIBBLE_MAX{15};
+
+std::uint32_t load32(const std::span<const std::uint8_t> data, const std::size_t position) {
+    return static_cast<std::uint32_t>(data[position]) | static_cast<std::uint32_t>(data[position + 1]) << 8u |
+           static_cast<std::uint32_t>(data[position + 2]) << 16u |
+           static_cast<std::uint32_t>(data[position + 3]) << 24u;
+}
+
+std::uint32_t hash(const std::uint32_t sequence) {
+    // Fibonacci hashing
+    return (sequence * 2654435761u) >> (32u - HASH_BITS);
+}
+
+/// Write the part of a length which does not fit into the nibble of the token.
+void write_length(std::vector<std::uint8_t> &block, std::size_t length) {
+    for (; length >= 255; length -= 255) {
+        block.push_back(255);
+    }
+    block.push_back(static_cast<std::uint8_t>(length));
+}
+
+void write_sequence(std::vector<std::uint8_t> &block, const std::span<const std::uint8_t> literals,
+                    const std::size_t offset, const std::size_t match_length) {
+    const auto match_extra = match_length == 0 ? 0 : match_length - MIN_MATCH;
+    block.push_back(static_cast<std::uint8_t>(std::min<std::size_t>(literals.size(), NIBBLE_MAX) << 4u |
+                                              std::min<std::size_t>(match_extra, NIBBLE_MAX)));
+    if (literals.size() >= NIBBLE_MAX) {
+        write_length(block, literals.size() - NIBBLE_MAX);
+    }
+    block.insert(block.end(), literals.begin(), literals.end());
+    if (match_length == 0) {
+        return;
+    }
+    block.push_back(static_cast<std::uint8_t>(offset));
+    block.push_back(static_cast<std::uint8_t>(offset >> 8u));
+    if (match_extra >= NIBBLE_MAX) {
+        write_length(block, match_extra - NIBBLE_MAX);
+    }
+}
+
+} // namespace
+
+std::vector<std::uint8_t> lz_compress(const std::span<const std::uint8_t> data) {
+    std::vector<std::uint8_t> block;
+    block.reserve(data.size() / 2 + 16);
+    // The last position + 1 of every hashed sequence, where 0 means none
+    std::vector<std::uint32_t> positions(std::size_t{1} << HASH_BITS, 0);
+
+    std::size_t anchor{0};
+    std::size_t position{0};
+    while (position + MIN_MATCH <= data.size()) {
+        const auto sequence = load32(data, position);
+        auto &entry = positions[hash(sequence)];
+        const std::size_t candidate = entry;
+        entry = static_cast<std::uint32_t>(position + 1);
+        if (candidate == 0 || position - (candidate - 1) > MAX_OFFSET || load32(data, candidate - 1) != sequence) {
+            position++;
+            continue;
+        }
+        const auto match = candidate - 1;
+        auto length = MIN_MATCH;
+        while (position + length < data.size() && data[match + length] == data[position + length]) {
+            length++;
+        }
+        write_sequence(block, data.subspan(anchor, position - anchor), position - match, length);
+        position += length;
+        anchor = position;
+    }
+    write_sequence(block, data.subspan(anchor), 0, 0);
+    return block;
+}
+
+std::vector<std::uint8_t> lz_decompress(const std::span<const std::uint8_t> block, const std::size_t decoded_size) {
+    // Every byte of a block decodes to at most 255 bytes, which protects against huge allocations for corrupt sizes
+    if (decoded_size / 255 > block.size()) {
+        throw std::runtime_error("Error: Corrupt compressed block!");
+    }
+    std::vector<std::uint8_t> data;
+    data.reserve(decoded_size);
+    std::size_t position{0};
+
+    const auto corrupt = []() { return std::runtime_error("Error: Corrupt compressed block!"); };
+    const auto read_length = [&](std::size_t length) {
+        if (length < NIBBLE_MAX) {
+            return length;
+        }
+        std::uint8_t extra{255};
+        while (extra == 255) {
+            if (position == block.size()) {
+                throw corrupt();
+            }
+            extra = block[position++];
+            length += extra;
+        }
+        return length;
+    };
+
+    while (position < block.size()) {
+        const auto token = block[position++];
+        const auto literal_count = read_length(token >> 4u);
+        if (literal_count > block.size() - position || literal_count > decoded_size - data.size()) {
+            throw corrupt();
+        }
+        data.insert(data.end(), block.begin() + static_cast<std::ptrdiff_t>(position),
+                    block.begin() + static_cast<std::ptrdiff_t>(position + literal_count));
+        position += literal_count;
+        // The last sequence has no match
+        if (position == block.size()) {
+            break;
+        }
+        if (block.size() - position < 2) {
+            throw corrupt();
+        }
+        const std::size_t offset = block[position] | static_cast<std::size_t>(block[position + 1]) << 8u;
+        position += 2;
+        const auto match_length = read_length(token & NIBBLE_MAX) + MIN_MATCH;
+        if (offset == 0 || offset > data.size() || match_length > decoded_size - data.size()) {
+            throw corrupt();
+        }
+        // The match may overlap the bytes it writes, so it is copied byte by byte
+        auto match = data.size() - offset;
+        for (std::size_t idx = 0; idx < match_length; idx++) {
+            data.push_back(data[match++]);
+        }
+    }
+    if (data.size() != decoded_size) {
+        throw corrupt();
+    }
+    return data;
+}
+
+} // namespace inexor::vulkan_renderer::tools
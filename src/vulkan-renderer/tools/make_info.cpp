@@ -58,6 +58,12 @@ VkCommandPoolCreateInfo make_info(VkCommandPoolCreateInfo info) {
     return info;
 }
 
+template <>
+VkComputePipelineCreateInfo make_info(VkComputePipelineCreateInfo info) {
+    info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    return info;
+}
+
 template <>
 VkDebugMarkerMarkerInfoEXT make_info(VkDebugMarkerMarkerInfoEXT info) {
     info.sType = VK_STRUCTURE_TYPE_DEBUG_MARKER_MARKER_INFO_EXT;
@@ -130,6 +136,12 @@ VkDeviceCreateInfo make_info(VkDeviceCreateInfo info) {
     return info;
 }
 
+template <>
+VkDeviceImageMemoryRequirements make_info(VkDeviceImageMemoryRequirements info) {
+    info.sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS;
+    return info;
+}
+
 template <>
 VkDeviceQueueCreateInfo make_info(VkDeviceQueueCreateInfo info) {
     info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
@@ -190,12 +202,36 @@ VkMemoryBarrier make_info(VkMemoryBarrier info) {
     return info;
 }
 
+template <>
+VkMemoryBarrier2 make_info(VkMemoryBarrier2 info) {
+    info.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+    return info;
+}
+
+template <>
+VkMemoryRequirements2 make_info(VkMemoryRequirements2 info) {
+    info.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    return info;
+}
+
 template <>
 VkPhysicalDeviceDynamicRenderingFeaturesKHR make_info(VkPhysicalDeviceDynamicRenderingFeaturesKHR info) {
     info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
     return info;
 }
 
+template <>
+VkPhysicalDeviceFeatures2 make_info(VkPhysicalDeviceFeatures2 info) {
+    info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    return info;
+}
+
+template <>
+VkPhysicalDeviceVulkan12Features make_info(VkPhysicalDeviceVulkan12Features info) {
+    info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    return info;
+}
+
 template <>
 VkPipelineCacheCreateInfo make_info(VkPipelineCacheCreateInfo info) {
     info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
@@ -316,6 +352,18 @@ VkSemaphoreCreateInfo make_info(VkSemaphoreCreateInfo info) {
     return info;
 }
 
+template <>
+VkSemaphoreTypeCreateInfo make_info(VkSemaphoreTypeCreateInfo info) {
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    return info;
+}
+
+template <>
+VkSemaphoreWaitInfo make_info(VkSemaphoreWaitInfo info) {
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    return info;
+}
+
 template <>
 VkShaderModuleCreateInfo make_info(VkShaderModuleCreateInfo info) {
     info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -0,0 +1,143 @@
+#include "inexor/vulkan-renderer/tools/memory_mapped_file.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define INEXOR_MEMORY_MAPPED_FILE_POSIX
+#endif
+
+namespace inexor::vulkan_renderer::tools {
+
+MemoryMappedFile::MemoryMappedFile(const std::filesystem::path &path) {
+#ifdef _WIN32
+    m_file_handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file_handle == INVALID_HANDLE_VALUE) {
+        m_file_handle = nullptr;
+        throw std::runtime_error("Error: Could not open file " + path.string() + "!");
+    }
+    LARGE_INTEGER file_size{};
+    if (GetFileSizeEx(m_file_handle, &file_size) && file_size.QuadPart > 0) {
+        m_mapping_handle = CreateFileMappingW(m_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping_handle != nullptr) {
+            m_data = static_cast<const std::uint8_t *>(MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+        }
+        if (m_data != nullptr) {
+            m_size = static_cast<std::size_t>(file_size.QuadPart);
+            m_mapped = true;
+            return;
+        }
+    }
+    unmap();
+#elif defined(INEXOR_MEMORY_MAPPED_FILE_POSIX)
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file == -1) {
+        throw std::runtime_error("Error: Could not open file " + path.string() + "!");
+    }
+    struct stat file_stat {};
+    if (fstat(file, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0) {
+        void *mapping = mmap(nullptr, static_cast<std::size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping != MAP_FAILED) {
+            // The file is read front to back by the octree parsers
+            madvise(mapping, static_cast<std::size_t>(file_stat.st_size), MADV_SEQUENTIAL);
+            m_data = static_cast<const std::uint8_t *>(mapping);
+            m_size = static_cast<std::size_t>(file_stat.st_size);
+            m_mapped = true;
+        }
+    }
+    // The mapping stays valid after closing the file
+    close(file);
+    if (m_mapped) {
+        return;
+    }
+#endif
+    read(path);
+}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile &&other) noexcept {
+    *this = std::move(other);
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+    unmap();
+}
+
+MemoryMappedFile &MemoryMappedFile::operator=(MemoryMappedFile &&other) noexcept {
+    if (this != &other) {
+        unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_mapped = std::exchange(other.m_mapped, false);
+        // Moving the vector keeps its storage, so m_data stays valid for files which are not mapped
+        m_buffer = std::move(other.m_buffer);
+#ifdef _WIN32
+        m_file_handle = std::exchange(other.m_file_handle, nullptr);
+        m_mapping_handle = std::exchange(other.m_mapping_handle, nullptr);
+#endif
+    }
+    return *this;
+}
+
+void MemoryMappedFile::read(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::ate | std::ios::binary | std::ios::in);
+    if (!file) {
+        throw std::runtime_error("Error: Could not open file " + path.string() + "!");
+    }
+    const auto file_size = file.tellg();
+    if (file_size > 0) {
+        m_buffer.resize(static_cast<std::size_t>(file_size));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char *>(m_buffer.data()), file_size)) {
+            throw std::runtime_error("Error: Could not read file " + path.string() + "!");
+        }
+    } else {
+        // Files of unknown size like pipes are read until their end
+        file.clear();
+        file.seekg(0);
+        m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+}
+
+void MemoryMappedFile::unmap() noexcept {
+#ifdef _WIN32
+    if (m_mapped && m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping_handle != nullptr) {
+        CloseHandle(m_mapping_handle);
+        m_mapping_handle = nullptr;
+    }
+    if (m_file_handle != nullptr) {
+        CloseHandle(m_file_handle);
+        m_file_handle = nullptr;
+    }
+#elif defined(INEXOR_MEMORY_MAPPED_FILE_POSIX)
+    if (m_mapped && m_data != nullptr) {
+        munmap(const_cast<std::uint8_t *>(m_data), m_size);
+    }
+#endif
+    if (m_mapped) {
+        m_data = nullptr;
+        m_size = 0;
+        m_mapped = false;
+    }
+}
+
+} // namespace inexor::vulkan_renderer::tools
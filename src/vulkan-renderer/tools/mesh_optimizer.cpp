@@ -0,0 +1,232 @@
+#include "inexor/vulkan-renderer/tools/mesh_optimizer.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+
+namespace inexor::vulkan_renderer::tools {
+
+namespace {
+
+void validate_triangle_list(const std::span<const std::uint32_t> indices, const std::size_t vertex_count) {
+    if (indices.size() % 3 != 0) {
+        throw std::invalid_argument("Error: The number of indices must be a multiple of 3!");
+    }
+    for (const auto index : indices) {
+        if (index >= vertex_count) {
+            throw std::invalid_argument("Error: Index " + std::to_string(index) + " is out of range!");
+        }
+    }
+}
+
+} // namespace
+
+float average_cache_miss_ratio(const std::span<const std::uint32_t> indices, const std::size_t vertex_count,
+                               const std::size_t cache_size) {
+    validate_triangle_list(indices, vertex_count);
+    if (indices.empty()) {
+        return 0.0f;
+    }
+    // A vertex is in the FIFO cache if less than cache_size vertices have been inserted after it
+    std::vector<std::size_t> insertion_time(vertex_count, 0);
+    std::size_t time = cache_size + 1;
+    std::size_t misses = 0;
+    for (const auto index : indices) {
+        if (time - insertion_time[index] > cache_size) {
+            insertion_time[index] = time++;
+            misses++;
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
+
+std::vector<std::size_t> optimize_vertex_cache(const std::span<std::uint32_t> indices, const std::size_t vertex_count,
+                                               const std::size_t cache_size) {
+    validate_triangle_list(indices, vertex_count);
+    const auto triangle_count = indices.size() / 3;
+    if (triangle_count == 0) {
+        return {};
+    }
+
+    // The triangles of every vertex in a compressed adjacency table
+    std::vector<std::uint32_t> live_triangles(vertex_count, 0);
+    for (const auto index : indices) {
+        live_triangles[index]++;
+    }
+    std::vector<std::size_t> adjacency_offsets(vertex_count + 1, 0);
+    std::partial_sum(live_triangles.begin(), live_triangles.end(), adjacency_offsets.begin() + 1);
+    std::vector<std::size_t> adjacency(indices.size());
+    {
+        auto fill = adjacency_offsets;
+        for (std::size_t idx = 0; idx < indices.size(); idx++) {
+            adjacency[fill[indices[idx]]++] = idx / 3;
+        }
+    }
+
+    std::vector<std::size_t> cache_time(vertex_count, 0);
+    std::vector<bool> emitted(triangle_count, false);
+    std::vector<std::uint32_t> dead_ends;
+    std::vector<std::uint32_t> candidates;
+    std::vector<std::uint32_t> output;
+    output.reserve(indices.size());
+    std::vector<std::size_t> clusters{0};
+
+    std::size_t time = cache_size + 1;
+    std::size_t cursor = 0;
+
+    // Find a vertex with live triangles on the dead end stack, or the next one in input order
+    const auto skip_dead_end = [&]() -> std::int64_t {
+        while (!dead_ends.empty()) {
+            const auto vertex = dead_ends.back();
+            dead_ends.pop_back();
+            if (live_triangles[vertex] > 0) {
+                return vertex;
+            }
+        }
+        for (; cursor < vertex_count; cursor++) {
+            if (live_triangles[cursor] > 0) {
+                return static_cast<std::int64_t>(cursor);
+            }
+        }
+        return -1;
+    };
+
+    std::int64_t fanning_vertex = skip_dead_end();
+    while (fanning_vertex >= 0) {
+        const auto fan = static_cast<std::uint32_t>(fanning_vertex);
+        candidates.clear();
+        for (auto adj = adjacency_offsets[fan]; adj < adjacency_offsets[fan + 1]; adj++) {
+            const auto triangle = adjacency[adj];
+            if (emitted[triangle]) {
+                continue;
+            }
+            emitted[triangle] = true;
+            for (std::size_t corner = 0; corner < 3; corner++) {
+                const auto vertex = indices[3 * triangle + corner];
+                output.push_back(vertex);
+                dead_ends.push_back(vertex);
+                candidates.push_back(vertex);
+                live_triangles[vertex]--;
+                if (time - cache_time[vertex] > cache_size) {
+                    cache_time[vertex] = time++;
+                }
+            }
+        }
+
+        // Prefer the candidate which has been in the cache the longest, as long as its remaining triangles still fit
+        // into the cache
+        std::int64_t next_vertex = -1;
+        std::size_t best_priority = 0;
+        for (const auto vertex : candidates) {
+            if (live_triangles[vertex] == 0) {
+                continue;
+            }
+            std::size_t priority = 0;
+            if (time - cache_time[vertex] + 2 * live_triangles[vertex] <= cache_size) {
+                priority = time - cache_time[vertex];
+            }
+            if (next_vertex < 0 || priority > best_priority) {
+                best_priority = priority;
+                next_vertex = vertex;
+            }
+        }
+        if (next_vertex < 0) {
+            next_vertex = skip_dead_end();
+            if (next_vertex >= 0 && output.size() < indices.size()) {
+                clusters.push_back(output.size());
+            }
+        }
+        fanning_vertex = next_vertex;
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+    return clusters;
+}
+
+std::vector<std::uint32_t> optimize_vertex_fetch(const std::span<std::uint32_t> indices,
+                                                 const std::size_t vertex_count) {
+    validate_triangle_list(indices, vertex_count);
+    std::vector<std::uint32_t> remap(vertex_count, UNUSED_VERTEX);
+    std::uint32_t next_vertex = 0;
+    for (auto &index : indices) {
+        if (remap[index] == UNUSED_VERTEX) {
+            remap[index] = next_vertex++;
+        }
+        index = remap[index];
+    }
+    return remap;
+}
+
+void optimize_overdraw(const std::span<std::uint32_t> indices, const std::span<const glm::vec3> positions,
+                       const std::span<const std::size_t> clusters) {
+    validate_triangle_list(indices, positions.size());
+    if (clusters.size() < 2) {
+        return;
+    }
+
+    // The area weighted centroid of the whole mesh
+    const auto triangle_area = [&](const std::size_t first_index, glm::vec3 &centroid, glm::vec3 &normal) {
+        const auto &p0 = positions[indices[first_index]];
+        const auto &p1 = positions[indices[first_index + 1]];
+        const auto &p2 = positions[indices[first_index + 2]];
+        normal = glm::cross(p1 - p0, p2 - p0);
+        centroid = (p0 + p1 + p2) / 3.0f;
+        return glm::length(normal);
+    };
+    glm::vec3 mesh_centroid{0.0f};
+    float mesh_area = 0.0f;
+    for (std::size_t idx = 0; idx < indices.size(); idx += 3) {
+        glm::vec3 centroid;
+        glm::vec3 normal;
+        const float area = triangle_area(idx, centroid, normal);
+        mesh_centroid += centroid * area;
+        mesh_area += area;
+    }
+    if (mesh_area <= 0.0f) {
+        return;
+    }
+    mesh_centroid /= mesh_area;
+
+    // The occlusion potential of a cluster is how far it lies outside of the mesh centroid along its normal
+    struct Cluster {
+        std::size_t begin;
+        std::size_t end;
+        float potential;
+    };
+    std::vector<Cluster> sorted_clusters(clusters.size());
+    for (std::size_t cluster = 0; cluster < clusters.size(); cluster++) {
+        const auto begin = clusters[cluster];
+        const auto end = cluster + 1 < clusters.size() ? clusters[cluster + 1] : indices.size();
+        glm::vec3 cluster_centroid{0.0f};
+        glm::vec3 cluster_normal{0.0f};
+        float cluster_area = 0.0f;
+        for (auto idx = begin; idx < end; idx += 3) {
+            glm::vec3 centroid;
+            glm::vec3 normal;
+            const float area = triangle_area(idx, centroid, normal);
+            cluster_centroid += centroid * area;
+            cluster_normal += normal;
+            cluster_area += area;
+        }
+        float potential = 0.0f;
+        if (cluster_area > 0.0f) {
+            cluster_centroid /= cluster_area;
+            potential = glm::dot(cluster_centroid - mesh_centroid, cluster_normal / cluster_area);
+        }
+        sorted_clusters[cluster] = {begin, end, potential};
+    }
+    std::stable_sort(sorted_clusters.begin(), sorted_clusters.end(),
+                     [](const Cluster &lhs, const Cluster &rhs) { return lhs.potential > rhs.potential; });
+
+    std::vector<std::uint32_t> output;
+    output.reserve(indices.size());
+    for (const auto &cluster : sorted_clusters) {
+        output.insert(output.end(), indices.begin() + static_cast<std::ptrdiff_t>(cluster.begin),
+                      indices.begin() + static_cast<std::ptrdiff_t>(cluster.end));
+    }
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+} // namespace inexor::vulkan_renderer::tools
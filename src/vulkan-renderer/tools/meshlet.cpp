@@ -0,0 +1,198 @@
+#include "inexor/vulkan-renderer/tools/meshlet.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace inexor::vulkan_renderer::tools {
+
+namespace {
+
+constexpr std::uint32_t NO_LOCAL_VERTEX{std::numeric_limits<std::uint32_t>::max()};
+
+/// Calculate the bounding sphere of a meshlet with Ritter's algorithm, which is at most about 5% larger than the
+/// minimal sphere.
+void calculate_bounding_sphere(Meshlet &meshlet, const std::span<const std::uint32_t> vertices,
+                               const std::span<const glm::vec3> positions) {
+    // Start with the pair of extreme points along the axis on which they are furthest apart
+    std::array<std::uint32_t, 3> min_vertex{vertices[0], vertices[0], vertices[0]};
+    std::array<std::uint32_t, 3> max_vertex{vertices[0], vertices[0], vertices[0]};
+    for (const auto vertex : vertices) {
+        for (int axis = 0; axis < 3; axis++) {
+            if (positions[vertex][axis] < positions[min_vertex[axis]][axis]) {
+                min_vertex[axis] = vertex;
+            }
+            if (positions[vertex][axis] > positions[max_vertex[axis]][axis]) {
+                max_vertex[axis] = vertex;
+            }
+        }
+    }
+    int widest_axis = 0;
+    float widest_distance = -1.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        const auto offset = positions[max_vertex[axis]] - positions[min_vertex[axis]];
+        const float distance = glm::dot(offset, offset);
+        if (distance > widest_distance) {
+            widest_distance = distance;
+            widest_axis = axis;
+        }
+    }
+    glm::vec3 center = (positions[min_vertex[widest_axis]] + positions[max_vertex[widest_axis]]) * 0.5f;
+    float radius = std::sqrt(widest_distance) * 0.5f;
+
+    // Grow the sphere to contain the points outside of it
+    for (const auto vertex : vertices) {
+        const auto offset = positions[vertex] - center;
+        const float distance = glm::length(offset);
+        if (distance > radius) {
+            const float new_radius = (radius + distance) * 0.5f;
+            center += offset * ((new_radius - radius) / distance);
+            radius = new_radius;
+        }
+    }
+    meshlet.center = center;
+    meshlet.radius = radius;
+}
+
+/// Calculate the normal cone of a meshlet from the normals of its triangles.
+void calculate_normal_cone(Meshlet &meshlet, const std::span<const std::uint32_t> vertices,
+                           const std::span<const std::uint32_t> triangles,
+                           const std::span<const glm::vec3> positions) {
+    std::vector<std::array<glm::vec3, 2>> normals; // The normal and the first corner of every triangle
+    normals.reserve(triangles.size());
+    glm::vec3 axis{0.0f};
+    for (const auto triangle : triangles) {
+        const auto corners = unpack_meshlet_triangle(triangle);
+        const auto &p0 = positions[vertices[corners[0]]];
+        const auto &p1 = positions[vertices[corners[1]]];
+        const auto &p2 = positions[vertices[corners[2]]];
+        // Front faces are wound clockwise
+        const glm::vec3 normal = glm::cross(p2 - p0, p1 - p0);
+        const float length = glm::length(normal);
+        if (length <= 0.0f) {
+            continue;
+        }
+        normals.push_back({normal / length, p0});
+        axis += normal / length;
+    }
+    const float axis_length = glm::length(axis);
+    if (normals.empty() || axis_length <= 0.0f) {
+        return;
+    }
+    axis /= axis_length;
+
+    float min_dot = 1.0f;
+    for (const auto &[normal, corner] : normals) {
+        min_dot = std::min(min_dot, glm::dot(normal, axis));
+    }
+    // The normals spread over more than a hemisphere, so there is always a triangle facing the camera
+    if (min_dot <= 0.0f) {
+        return;
+    }
+    // Move the apex back along the axis until it is behind the planes of all triangles, so the cone test with the
+    // apex is conservative for all of them
+    float max_t = 0.0f;
+    for (const auto &[normal, corner] : normals) {
+        const float t = glm::dot(meshlet.center - corner, normal) / glm::dot(axis, normal);
+        max_t = std::max(max_t, t);
+    }
+    meshlet.cone_apex = meshlet.center - axis * max_t;
+    meshlet.cone_axis = axis;
+    meshlet.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+}
+
+} // namespace
+
+MeshletData build_meshlets(const std::span<const std::uint32_t> indices, const std::span<const glm::vec3> positions,
+                           const std::size_t max_vertices, const std::size_t max_triangles,
+                           const std::span<const std::size_t> splits) {
+    if (max_vertices < 3 || max_vertices > 256) {
+        throw std::invalid_argument("Error: Parameter 'max_vertices' must be in the range 3 to 256!");
+    }
+    if (max_triangles == 0) {
+        throw std::invalid_argument("Error: Parameter 'max_triangles' must be at least 1!");
+    }
+    if (indices.size() % 3 != 0) {
+        throw std::invalid_argument("Error: The number of indices must be a multiple of 3!");
+    }
+    for (const auto index : indices) {
+        if (index >= positions.size()) {
+            throw std::invalid_argument("Error: Index " + std::to_string(index) + " is out of range!");
+        }
+    }
+
+    MeshletData data;
+    data.triangles.reserve(indices.size() / 3);
+    // The local index of every vertex in the current meshlet
+    std::vector<std::uint32_t> local_vertices(positions.size(), NO_LOCAL_VERTEX);
+    Meshlet meshlet;
+
+    const auto finish_meshlet = [&]() {
+        if (meshlet.triangle_count == 0) {
+            return;
+        }
+        const auto vertices = std::span(data.vertices).subspan(meshlet.vertex_offset, meshlet.vertex_count);
+        for (const auto vertex : vertices) {
+            local_vertices[vertex] = NO_LOCAL_VERTEX;
+        }
+        calculate_bounding_sphere(meshlet, vertices, positions);
+        calculate_normal_cone(meshlet, vertices,
+                              std::span(data.triangles).subspan(meshlet.triangle_offset, meshlet.triangle_count),
+                              positions);
+        data.meshlets.push_back(meshlet);
+        meshlet = Meshlet{
+            .vertex_offset = static_cast<std::uint32_t>(data.vertices.size()),
+            .triangle_offset = static_cast<std::uint32_t>(data.triangles.size()),
+        };
+    };
+
+    auto next_split = splits.begin();
+    for (std::size_t idx = 0; idx < indices.size(); idx += 3) {
+        bool split = false;
+        while (next_split != splits.end() && *next_split <= idx) {
+            split = split || *next_split == idx;
+            next_split++;
+        }
+        std::size_t new_vertices = 0;
+        for (std::size_t corner = 0; corner < 3; corner++) {
+            const auto vertex = indices[idx + corner];
+            // Repeated vertices of a degenerate triangle are counted once
+            if (local_vertices[vertex] == NO_LOCAL_VERTEX &&
+                std::find(indices.begin() + idx, indices.begin() + idx + corner, vertex) ==
+                    indices.begin() + idx + corner) {
+                new_vertices++;
+            }
+        }
+        if (split || meshlet.vertex_count + new_vertices > max_vertices || meshlet.triangle_count == max_triangles) {
+            finish_meshlet();
+        }
+        std::array<std::uint32_t, 3> triangle{};
+        for (std::size_t corner = 0; corner < 3; corner++) {
+            const auto vertex = indices[idx + corner];
+            if (local_vertices[vertex] == NO_LOCAL_VERTEX) {
+                local_vertices[vertex] = meshlet.vertex_count++;
+                data.vertices.push_back(vertex);
+            }
+            triangle[corner] = local_vertices[vertex];
+        }
+        data.triangles.push_back(pack_meshlet_triangle(triangle));
+        meshlet.triangle_count++;
+    }
+    finish_meshlet();
+    return data;
+}
+
+bool is_meshlet_backfacing(const Meshlet &meshlet, const glm::vec3 &camera_position) noexcept {
+    const auto view = meshlet.cone_apex - camera_position;
+    const float distance = glm::length(view);
+    if (distance <= 0.0f) {
+        return false;
+    }
+    return glm::dot(view, meshlet.cone_axis) >= meshlet.cone_cutoff * distance;
+}
+
+} // namespace inexor::vulkan_renderer::tools
@@ -0,0 +1,297 @@
+#include "inexor/vulkan-renderer/tools/occlusion_buffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INEXOR_OCCLUSION_BUFFER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace inexor::vulkan_renderer::tools {
+
+namespace {
+
+/// The corners of a box (bit 0 = x, bit 1 = y, bit 2 = z) for every face in consecutive order.
+/// The faces are rasterized as quads, because the shared edge of two triangles would not be covered with conservative
+/// rasterization.
+constexpr std::array<std::array<std::uint8_t, 4>, 6> BOX_FACES{{
+    {0, 2, 6, 4}, // -x
+    {1, 3, 7, 5}, // +x
+    {0, 1, 5, 4}, // -y
+    {2, 3, 7, 6}, // +y
+    {0, 1, 3, 2}, // -z
+    {4, 5, 7, 6}, // +z
+}};
+
+std::array<glm::vec3, 8> box_corners(const std::array<glm::vec3, 2> &bounding_box) {
+    const auto &[min, max] = bounding_box;
+    std::array<glm::vec3, 8> corners;
+    for (std::size_t idx = 0; idx < corners.size(); idx++) {
+        corners[idx] = {(idx & 1u) ? max.x : min.x, (idx & 2u) ? max.y : min.y, (idx & 4u) ? max.z : min.z};
+    }
+    return corners;
+}
+
+/// Whether a projected point (see OcclusionBuffer::project) is behind the camera or in front of the near plane, where
+/// the depth is negative.
+bool is_clipped_by_near_plane(const glm::vec4 &projected) {
+    return projected.w < OcclusionBuffer::MIN_CLIP_W || projected.z < 0.0f;
+}
+
+} // namespace
+
+OcclusionBuffer::OcclusionBuffer(const std::uint32_t width, const std::uint32_t height) {
+    if (width == 0 || height == 0) {
+        throw std::invalid_argument("Error: The size of the occlusion buffer must not be 0!");
+    }
+    m_width = (width + 3u) & ~3u;
+    m_height = height;
+
+    std::size_t offset = 0;
+    std::uint32_t level_width = m_width;
+    std::uint32_t level_height = m_height;
+    while (true) {
+        m_levels.push_back({.offset = offset, .width = level_width, .height = level_height});
+        offset += static_cast<std::size_t>(level_width) * level_height;
+        if (level_width == 1 && level_height == 1) {
+            break;
+        }
+        level_width = (level_width + 1) / 2;
+        level_height = (level_height + 1) / 2;
+    }
+    m_depth.resize(offset, 1.0f);
+}
+
+void OcclusionBuffer::build_hierarchy() {
+    for (std::size_t level = 1; level < m_levels.size(); level++) {
+        const auto &src = m_levels[level - 1];
+        const auto &dst = m_levels[level];
+        for (std::uint32_t y = 0; y < dst.height; y++) {
+            const auto y0 = std::min(2 * y, src.height - 1);
+            const auto y1 = std::min(2 * y + 1, src.height - 1);
+            for (std::uint32_t x = 0; x < dst.width; x++) {
+                const auto x0 = std::min(2 * x, src.width - 1);
+                const auto x1 = std::min(2 * x + 1, src.width - 1);
+                const auto *row0 = &m_depth[src.offset + static_cast<std::size_t>(y0) * src.width];
+                const auto *row1 = &m_depth[src.offset + static_cast<std::size_t>(y1) * src.width];
+                m_depth[dst.offset + static_cast<std::size_t>(y) * dst.width + x] =
+                    std::max({row0[x0], row0[x1], row1[x0], row1[x1]});
+            }
+        }
+    }
+}
+
+void OcclusionBuffer::clear(const glm::mat4 &view_projection) {
+    m_view_projection = view_projection;
+    std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+}
+
+float OcclusionBuffer::depth(const std::uint32_t x, const std::uint32_t y, const std::size_t level) const {
+    const auto &lvl = m_levels.at(level);
+    if (x >= lvl.width || y >= lvl.height) {
+        throw std::out_of_range("Error: Texel is outside of the occlusion buffer level!");
+    }
+    return m_depth[lvl.offset + static_cast<std::size_t>(y) * lvl.width + x];
+}
+
+bool OcclusionBuffer::is_visible(const std::array<glm::vec3, 2> &bounding_box) const {
+    float min_x = std::numeric_limits<float>::max();
+    float min_y = std::numeric_limits<float>::max();
+    float max_x = std::numeric_limits<float>::lowest();
+    float max_y = std::numeric_limits<float>::lowest();
+    float min_depth = std::numeric_limits<float>::max();
+    for (const auto &corner : box_corners(bounding_box)) {
+        const auto projected = project(corner);
+        if (is_clipped_by_near_plane(projected)) {
+            return true;
+        }
+        min_x = std::min(min_x, projected.x);
+        min_y = std::min(min_y, projected.y);
+        max_x = std::max(max_x, projected.x);
+        max_y = std::max(max_y, projected.y);
+        min_depth = std::min(min_depth, projected.z);
+    }
+    if (min_depth <= 0.0f || max_x < 0.0f || max_y < 0.0f || min_x >= static_cast<float>(m_width) ||
+        min_y >= static_cast<float>(m_height)) {
+        return true;
+    }
+
+    auto x0 = static_cast<std::uint32_t>(std::max(min_x, 0.0f));
+    auto y0 = static_cast<std::uint32_t>(std::max(min_y, 0.0f));
+    auto x1 = static_cast<std::uint32_t>(std::min(max_x, static_cast<float>(m_width - 1)));
+    auto y1 = static_cast<std::uint32_t>(std::min(max_y, static_cast<float>(m_height - 1)));
+
+    // Go up the pyramid until the box covers at most 2x2 texels
+    std::size_t level = 0;
+    while (level + 1 < m_levels.size() && (x1 - x0 > 1 || y1 - y0 > 1)) {
+        x0 >>= 1;
+        y0 >>= 1;
+        x1 >>= 1;
+        y1 >>= 1;
+        level++;
+    }
+    const auto &lvl = m_levels[level];
+    for (auto y = y0; y <= y1; y++) {
+        for (auto x = x0; x <= x1; x++) {
+            if (m_depth[lvl.offset + static_cast<std::size_t>(y) * lvl.width + x] >= min_depth) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+glm::vec4 OcclusionBuffer::project(const glm::vec3 &point) const {
+    const glm::vec4 clip = m_view_projection * glm::vec4(point, 1.0f);
+    if (clip.w < MIN_CLIP_W) {
+        return clip;
+    }
+    return {
+        (clip.x / clip.w * 0.5f + 0.5f) * static_cast<float>(m_width),
+        (clip.y / clip.w * 0.5f + 0.5f) * static_cast<float>(m_height),
+        clip.z / clip.w,
+        clip.w,
+    };
+}
+
+void OcclusionBuffer::rasterize_box(const std::array<glm::vec3, 2> &bounding_box) {
+    std::array<glm::vec4, 8> projected;
+    const auto corners = box_corners(bounding_box);
+    for (std::size_t idx = 0; idx < corners.size(); idx++) {
+        projected[idx] = project(corners[idx]);
+        if (is_clipped_by_near_plane(projected[idx])) {
+            return;
+        }
+    }
+    // The faces on the far side of the box are covered by the near side, so the depth test takes care of them
+    for (const auto &face : BOX_FACES) {
+        rasterize_projected_polygon({projected[face[0]], projected[face[1]], projected[face[2]], projected[face[3]]});
+    }
+}
+
+void OcclusionBuffer::rasterize_projected_polygon(const std::array<glm::vec4, 4> &polygon) {
+    // Twice the signed area of the polygon (shoelace formula), whose sign tells the winding order
+    float area = 0.0f;
+    for (std::size_t idx = 0; idx < polygon.size(); idx++) {
+        const auto &from = polygon[idx];
+        const auto &to = polygon[(idx + 1) % polygon.size()];
+        area += (from.x - to.x) * (from.y + to.y);
+    }
+    if (std::abs(area) < 1e-6f) {
+        return;
+    }
+    const float winding = area > 0.0f ? 1.0f : -1.0f;
+
+    float min_x = std::numeric_limits<float>::max();
+    float min_y = std::numeric_limits<float>::max();
+    float max_x = std::numeric_limits<float>::lowest();
+    float max_y = std::numeric_limits<float>::lowest();
+    float max_z = 0.0f;
+    for (const auto &vertex : polygon) {
+        min_x = std::min(min_x, vertex.x);
+        min_y = std::min(min_y, vertex.y);
+        max_x = std::max(max_x, vertex.x);
+        max_y = std::max(max_y, vertex.y);
+        max_z = std::max(max_z, vertex.z);
+    }
+    if (max_x < 0.0f || max_y < 0.0f || min_x >= static_cast<float>(m_width) ||
+        min_y >= static_cast<float>(m_height)) {
+        return;
+    }
+    // The first pixel is aligned to 4 so every row is processed in blocks of 4 pixels
+    const auto x0 = static_cast<std::uint32_t>(std::max(min_x, 0.0f)) & ~3u;
+    const auto x1 = static_cast<std::uint32_t>(std::min(max_x, static_cast<float>(m_width - 1)));
+    const auto y0 = static_cast<std::uint32_t>(std::max(min_y, 0.0f));
+    const auto y1 = static_cast<std::uint32_t>(std::min(max_y, static_cast<float>(m_height - 1)));
+
+    // The edge functions a * x + b * y + c are positive inside of the polygon. They are moved inwards by half a pixel
+    // diagonal, so only pixels which are completely covered pass the test. Degenerate edges (e.g. the last edge of a
+    // triangle) are always passed.
+    std::array<float, 4> edge_a{};
+    std::array<float, 4> edge_b{};
+    std::array<float, 4> edge_c{};
+    for (std::size_t edge = 0; edge < polygon.size(); edge++) {
+        const auto &from = polygon[edge];
+        const auto &to = polygon[(edge + 1) % polygon.size()];
+        edge_a[edge] = winding * (from.y - to.y);
+        edge_b[edge] = winding * (to.x - from.x);
+        edge_c[edge] = -(edge_a[edge] * from.x + edge_b[edge] * from.y) -
+                       0.5f * (std::abs(edge_a[edge]) + std::abs(edge_b[edge]));
+    }
+
+    // The depth plane of the polygon from the larger of its two triangles, moved back to the farthest depth inside of
+    // a pixel and clamped to the farthest vertex
+    const auto &p0 = polygon[0];
+    const bool use_first_triangle =
+        std::abs((polygon[1].x - p0.x) * (polygon[2].y - p0.y) - (polygon[2].x - p0.x) * (polygon[1].y - p0.y)) >=
+        std::abs((polygon[2].x - p0.x) * (polygon[3].y - p0.y) - (polygon[3].x - p0.x) * (polygon[2].y - p0.y));
+    const auto &p1 = use_first_triangle ? polygon[1] : polygon[2];
+    const auto &p2 = use_first_triangle ? polygon[2] : polygon[3];
+    const float det = (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y);
+    if (std::abs(det) < 1e-6f) {
+        return;
+    }
+    const float dz_dx = ((p1.z - p0.z) * (p2.y - p0.y) - (p2.z - p0.z) * (p1.y - p0.y)) / det;
+    const float dz_dy = ((p2.z - p0.z) * (p1.x - p0.x) - (p1.z - p0.z) * (p2.x - p0.x)) / det;
+    const float dz_c = p0.z - dz_dx * p0.x - dz_dy * p0.y + 0.5f * (std::abs(dz_dx) + std::abs(dz_dy));
+    max_z = std::min(max_z, 1.0f);
+
+    for (auto y = y0; y <= y1; y++) {
+        const float py = static_cast<float>(y) + 0.5f;
+        float *row = &m_depth[static_cast<std::size_t>(y) * m_width];
+#ifdef INEXOR_OCCLUSION_BUFFER_SSE2
+        const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 row_z = _mm_set1_ps(dz_dy * py + dz_c);
+        const __m128 max_z4 = _mm_set1_ps(max_z);
+        const __m128 row_e0 = _mm_set1_ps(edge_b[0] * py + edge_c[0]);
+        const __m128 row_e1 = _mm_set1_ps(edge_b[1] * py + edge_c[1]);
+        const __m128 row_e2 = _mm_set1_ps(edge_b[2] * py + edge_c[2]);
+        const __m128 row_e3 = _mm_set1_ps(edge_b[3] * py + edge_c[3]);
+        for (auto x = x0; x <= x1; x += 4) {
+            const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+            const __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edge_a[0]), px), row_e0);
+            const __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edge_a[1]), px), row_e1);
+            const __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edge_a[2]), px), row_e2);
+            const __m128 e3 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edge_a[3]), px), row_e3);
+            const __m128 inside = _mm_cmpge_ps(_mm_min_ps(_mm_min_ps(e0, e1), _mm_min_ps(e2, e3)), zero);
+            if (_mm_movemask_ps(inside) == 0) {
+                continue;
+            }
+            const __m128 z = _mm_min_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(dz_dx), px), row_z), max_z4);
+            const __m128 old_depth = _mm_loadu_ps(row + x);
+            const __m128 new_depth = _mm_min_ps(old_depth, z);
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, new_depth), _mm_andnot_ps(inside, old_depth)));
+        }
+#else
+        for (auto x = x0; x <= x1; x += 4) {
+            for (std::uint32_t lane = 0; lane < 4; lane++) {
+                const float px = static_cast<float>(x + lane) + 0.5f;
+                bool inside = true;
+                for (std::size_t edge = 0; edge < edge_a.size(); edge++) {
+                    inside = inside && edge_a[edge] * px + edge_b[edge] * py + edge_c[edge] >= 0.0f;
+                }
+                if (inside) {
+                    row[x + lane] = std::min(row[x + lane], std::min(dz_dx * px + dz_dy * py + dz_c, max_z));
+                }
+            }
+        }
+#endif
+    }
+}
+
+void OcclusionBuffer::rasterize_triangle(const std::array<glm::vec3, 3> &triangle) {
+    const auto v0 = project(triangle[0]);
+    const auto v1 = project(triangle[1]);
+    const auto v2 = project(triangle[2]);
+    if (is_clipped_by_near_plane(v0) || is_clipped_by_near_plane(v1) || is_clipped_by_near_plane(v2)) {
+        return;
+    }
+    // The last edge of the quad is degenerate and therefore always passed
+    rasterize_projected_polygon({v0, v1, v2, v2});
+}
+
+} // namespace inexor::vulkan_renderer::tools
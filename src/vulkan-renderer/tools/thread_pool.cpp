@@ -0,0 +1,68 @@
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace inexor::vulkan_renderer::tools {
+
+std::size_t ThreadPool::default_thread_count() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+ThreadPool::ThreadPool(const std::size_t thread_count) {
+    if (thread_count == 0) {
+        throw std::invalid_argument("Error: Parameter 'thread_count' must not be 0!");
+    }
+    m_threads.reserve(thread_count);
+    for (std::size_t idx = 0; idx < thread_count; idx++) {
+        m_threads.emplace_back([this]() { run_worker(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_task_available.notify_all();
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::push(std::function<void()> task) {
+    {
+        std::scoped_lock lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_task_available.notify_one();
+}
+
+void ThreadPool::run_worker() {
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        m_task_available.wait(lock, [&]() { return m_stop || !m_tasks.empty(); });
+        // The remaining tasks are run before stopping, so no future is left without a result
+        if (m_tasks.empty()) {
+            return;
+        }
+        auto task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+        m_running_tasks++;
+        lock.unlock();
+        // Exceptions are stored in the future by the packaged task
+        task();
+        lock.lock();
+        m_running_tasks--;
+        if (m_tasks.empty() && m_running_tasks == 0) {
+            m_idle.notify_all();
+        }
+    }
+}
+
+void ThreadPool::wait_idle() {
+    std::unique_lock lock(m_mutex);
+    m_idle.wait(lock, [&]() { return m_tasks.empty() && m_running_tasks == 0; });
+}
+
+} // namespace inexor::vulkan_renderer::tools
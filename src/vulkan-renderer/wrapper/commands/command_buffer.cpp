@@ -694,6 +694,7 @@ void CommandBuffer::submit(const VkQueueFlagBits queue_type,
         m_wait_submit_infos_scratch[index] = VkSemaphoreSubmitInfo{
             .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
             .semaphore = wait_semaphore.semaphore,
+            .value = wait_semaphore.value,
             .stageMask = wait_semaphore.stage_mask,
         };
     }
@@ -710,6 +711,7 @@ void CommandBuffer::submit(const VkQueueFlagBits queue_type,
         m_wait_submit_infos_scratch[index] = VkSemaphoreSubmitInfo{
             .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
             .semaphore = wait_semaphore.semaphore,
+            .value = wait_semaphore.value,
             .stageMask = wait_semaphore.stage_mask,
         };
     }
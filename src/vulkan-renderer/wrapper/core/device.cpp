@@ -150,6 +150,14 @@ Device::Device(const Instance &inst, const VkSurfaceKHR surface, const VkPhysica
         }
     }
 
+    // Multi draw indirect is optional, because the renderers fall back to one indirect draw per command if it is not
+    // available.
+    auto supported_features2 = tools::make_info<VkPhysicalDeviceFeatures2>();
+    vkGetPhysicalDeviceFeatures2(m_physical_device, &supported_features2);
+    if (supported_features2.features.multiDrawIndirect == VK_TRUE) {
+        m_enabled_features.multiDrawIndirect = VK_TRUE;
+    }
+
     // We want to use synchronization2 for vkCmdPipelineBarrier2.
     VkPhysicalDeviceSynchronization2Features sync2_feature{};
     sync2_feature.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
@@ -171,9 +179,15 @@ Device::Device(const Instance &inst, const VkSurfaceKHR surface, const VkPhysica
         .dynamicRendering = VK_TRUE,
     });
 
+    // Timeline semaphores are part of Vulkan 1.2 core, and rendergraph uses them to wait for uploads
+    auto vulkan12_features = make_info<VkPhysicalDeviceVulkan12Features>({
+        .pNext = &dyn_rendering_feature,
+        .timelineSemaphore = VK_TRUE,
+    });
+
     const auto device_ci = make_info<VkDeviceCreateInfo>({
         // This is one of those rare cases where pNext is actually not nullptr!
-        .pNext = &dyn_rendering_feature, // We use dynamic rendering
+        .pNext = &vulkan12_features, // We use dynamic rendering
         .queueCreateInfoCount = static_cast<std::uint32_t>(optimal_queues.queues_to_create.size()),
         .pQueueCreateInfos = optimal_queues.queues_to_create.data(),
         .enabledExtensionCount = static_cast<std::uint32_t>(enabled_extensions.size()),
@@ -267,6 +281,14 @@ Device::Device(const Instance &inst, const VkSurfaceKHR surface, const VkPhysica
         throw VulkanException("Error: vmaCreateAllocator failed!", result);
     }
 
+    const VkPhysicalDeviceMemoryProperties *memory_properties = nullptr;
+    vmaGetMemoryProperties(m_allocator, &memory_properties);
+    for (std::uint32_t type_index = 0; type_index < memory_properties->memoryTypeCount; type_index++) {
+        if ((memory_properties->memoryTypes[type_index].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0) {
+            m_lazily_allocated_memory_supported = true;
+        }
+    }
+
     // Create a Vuklan pipeline cache to speed up pipeline creation
     m_pipeline_cache = std::make_unique<PipelineCache>(*this);
 
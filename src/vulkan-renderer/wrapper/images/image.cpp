@@ -31,8 +31,11 @@ void Image::create(VkImageCreateInfo img_ci, VkImageViewCreateInfo img_view_ci)
         priority = 1.0f;
     }
 
+    // The contents of transient attachments are never stored, so their memory only needs to be committed on demand
+    const bool lazily_allocated = (m_img_ci.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) != 0;
+
     const VmaAllocationCreateInfo alloc_ci{
-        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+        .usage = lazily_allocated ? VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED : VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
         .priority = priority,
     };
 
@@ -48,6 +51,29 @@ void Image::create(VkImageCreateInfo img_ci, VkImageViewCreateInfo img_view_ci)
     // Set the internal debug name of the image in Vulkan Memory Allocator (VMA)
     vmaSetAllocationName(m_device.allocator(), m_alloc, m_name.c_str());
 
+    create_image_view();
+}
+
+void Image::create(VkImageCreateInfo img_ci, VkImageViewCreateInfo img_view_ci, const VmaAllocation alias_alloc) {
+    m_img_ci = std::move(img_ci);
+    m_img_view_ci = std::move(img_view_ci);
+
+    using tools::VulkanException;
+
+    // Create the image at the beginning of the allocation, which is owned by the caller (so m_alloc stays empty)
+    if (const auto result = vmaCreateAliasingImage(m_device.allocator(), alias_alloc, &m_img_ci, &m_img);
+        result != VK_SUCCESS) {
+        throw VulkanException("Error: vmaCreateAliasingImage failed!", result, m_name);
+    }
+    m_device.set_debug_name(m_img, m_name);
+    vmaGetAllocationInfo(m_device.allocator(), alias_alloc, &m_alloc_info);
+
+    create_image_view();
+}
+
+void Image::create_image_view() {
+    using tools::VulkanException;
+
     // Set the image in the VkImageViewCreateInfo
     m_img_view_ci.image = m_img;
 
@@ -66,6 +92,7 @@ void Image::destroy() {
 
     vkDestroyImageView(m_device.device(), m_img_view, nullptr);
     m_img_view = VK_NULL_HANDLE;
+    // Images which alias the memory of other images don't own an allocation, in which case only the image is destroyed
     vmaDestroyImage(m_device.allocator(), m_img, m_alloc);
     m_img = VK_NULL_HANDLE;
     m_alloc = VK_NULL_HANDLE;
@@ -0,0 +1,55 @@
+#include "inexor/vulkan-renderer/wrapper/pipelines/compute_pipeline.hpp"
+
+#include "inexor/vulkan-renderer/tools/exception.hpp"
+#include "inexor/vulkan-renderer/wrapper/core/device.hpp"
+#include "inexor/vulkan-renderer/wrapper/descriptors/per_frame_descriptor_sets.hpp"
+#include "inexor/vulkan-renderer/wrapper/pipelines/pipeline_layout.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <utility>
+
+namespace inexor::vulkan_renderer::wrapper::pipelines {
+
+using tools::InexorException;
+using tools::VulkanException;
+
+ComputePipeline::ComputePipeline(const core::Device &device, ComputePipelineSetupData setup_data, std::string name)
+    : m_device(device), m_name(std::move(name)) {
+
+    spdlog::trace("   - Building compute pipeline [{}]", m_name);
+
+    m_pipeline_layout = std::make_unique<PipelineLayout>(m_device, m_name, setup_data.descriptor_set_layouts,
+                                                         setup_data.push_constant_ranges);
+
+    for (const auto &descriptor_set : setup_data.associated_descriptor_sets) {
+        const auto descriptor_set_ref = descriptor_set.lock();
+        if (!descriptor_set_ref) {
+            throw InexorException("Error: Associated descriptor set is invalid!");
+        }
+        descriptor_set_ref->set_pipeline_layout(m_pipeline_layout->pipeline_layout());
+    }
+
+    const auto pipeline_ci = make_info<VkComputePipelineCreateInfo>({
+        .stage = setup_data.shader_stage,
+        .layout = m_pipeline_layout->pipeline_layout(),
+    });
+
+    // Create the compute pipeline
+    if (const auto result = vkCreateComputePipelines(m_device.device(), m_device.pipeline_cache(), 1, &pipeline_ci,
+                                                     nullptr, &m_pipeline);
+        result != VK_SUCCESS) {
+        throw VulkanException("Error: vkCreateComputePipelines failed!", result, m_name);
+    }
+    m_device.set_debug_name(m_pipeline, m_name);
+}
+
+ComputePipeline::~ComputePipeline() {
+    vkDestroyPipeline(m_device.device(), m_pipeline, nullptr);
+}
+
+VkPipelineLayout ComputePipeline::pipeline_layout() const {
+    return m_pipeline_layout->pipeline_layout();
+}
+
+} // namespace inexor::vulkan_renderer::wrapper::pipelines
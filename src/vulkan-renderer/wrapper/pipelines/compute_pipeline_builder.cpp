@@ -0,0 +1,29 @@
+#include "inexor/vulkan-renderer/wrapper/pipelines/compute_pipeline_builder.hpp"
+
+namespace inexor::vulkan_renderer::wrapper::pipelines {
+
+ComputePipelineBuilder::ComputePipelineBuilder(const core::Device &device) : m_device(device) {
+    reset();
+}
+
+std::shared_ptr<ComputePipeline> ComputePipelineBuilder::build(std::string name) {
+    if (name.empty()) {
+        throw InexorException("Error: Parameter 'name' is an empty string!");
+    }
+    if (m_data.shader_stage.module == VK_NULL_HANDLE) {
+        throw InexorException("Error: No compute shader was set for compute pipeline " + name + "!");
+    }
+
+    auto compute_pipeline = std::make_shared<ComputePipeline>(m_device, std::move(m_data), std::move(name));
+
+    // NOTE: We reset the data of the builder here so it can be re-used
+    reset();
+
+    return compute_pipeline;
+}
+
+void ComputePipelineBuilder::reset() {
+    m_data = {};
+}
+
+} // namespace inexor::vulkan_renderer::wrapper::pipelines
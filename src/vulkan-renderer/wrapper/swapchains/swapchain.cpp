@@ -4,8 +4,6 @@
 #include "inexor/vulkan-renderer/tools/exception.hpp"
 #include "inexor/vulkan-renderer/tools/make_info.hpp"
 #include "inexor/vulkan-renderer/tools/representation.hpp"
-#include "inexor/vulkan-renderer/wrapper/commands/command_buffer.hpp"
-#include "inexor/vulkan-renderer/wrapper/commands/command_buffer_builder.hpp"
 #include "inexor/vulkan-renderer/wrapper/core/device.hpp"
 #include "inexor/vulkan-renderer/wrapper/swapchains/swapchain_utils.hpp"
 
@@ -21,7 +19,6 @@ namespace inexor::vulkan_renderer::wrapper::swapchains {
 using tools::InexorException;
 using tools::make_info;
 using tools::VulkanException;
-using wrapper::commands::CommandBufferBuilder;
 
 Swapchain::Swapchain(const core::Device &device, std::string name, const VkSurfaceKHR surface)
     : m_device(device), m_name(std::move(name)), m_surface(surface) {
@@ -139,18 +136,6 @@ void Swapchain::mark_current_frame_slot_in_flight(const VkFence fence) {
     m_frame_slot_submission_fences[m_current_frame_slot] = fence;
 }
 
-// @TODO Move to inside of rendergraph
-void Swapchain::change_image_layout_to_prepare_for_rendering(CommandBufferBuilder &cmd_buf) {
-    cmd_buf.change_image_layout(m_current_swapchain_img, m_format, VK_IMAGE_LAYOUT_UNDEFINED,
-                                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-}
-
-// @TODO Move to inside of rendergraph
-void Swapchain::change_image_layout_to_prepare_for_presenting(CommandBufferBuilder &cmd_buf) {
-    cmd_buf.change_image_layout(m_current_swapchain_img, m_format, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                                VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
-}
-
 std::vector<VkImage> Swapchain::get_swapchain_images() {
     std::uint32_t img_count = 0;
     if (const auto result = vkGetSwapchainImagesKHR(m_device.device(), m_swapchain, &img_count, nullptr);
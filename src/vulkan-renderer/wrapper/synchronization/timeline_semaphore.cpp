@@ -0,0 +1,65 @@
+#include "inexor/vulkan-renderer/wrapper/synchronization/timeline_semaphore.hpp"
+
+#include "inexor/vulkan-renderer/tools/exception.hpp"
+#include "inexor/vulkan-renderer/tools/make_info.hpp"
+#include "inexor/vulkan-renderer/wrapper/core/device.hpp"
+
+#include <limits>
+#include <utility>
+
+namespace inexor::vulkan_renderer::wrapper::synchronization {
+
+// Using declaration
+using tools::VulkanException;
+
+TimelineSemaphore::TimelineSemaphore(const core::Device &device, const std::string &name,
+                                     const std::uint64_t initial_value)
+    : m_device(device), m_name(name) {
+    if (name.empty()) {
+        throw std::invalid_argument("Error: Parameter 'name' is empty!");
+    }
+    const auto semaphore_type_ci = tools::make_info<VkSemaphoreTypeCreateInfo>({
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = initial_value,
+    });
+    const auto semaphore_ci = tools::make_info<VkSemaphoreCreateInfo>({
+        .pNext = &semaphore_type_ci,
+    });
+    if (const auto result = vkCreateSemaphore(m_device.device(), &semaphore_ci, nullptr, &m_semaphore);
+        result != VK_SUCCESS) {
+        throw VulkanException("Error: vkCreateSemaphore failed!", result, m_name);
+    }
+    m_device.set_debug_name(m_semaphore, m_name);
+}
+
+TimelineSemaphore::TimelineSemaphore(TimelineSemaphore &&other) noexcept : m_device(other.m_device) {
+    m_semaphore = std::exchange(other.m_semaphore, nullptr);
+    m_name = std::move(other.m_name);
+}
+
+TimelineSemaphore::~TimelineSemaphore() {
+    vkDestroySemaphore(m_device.device(), m_semaphore, nullptr);
+}
+
+std::uint64_t TimelineSemaphore::value() const {
+    std::uint64_t value = 0;
+    if (const auto result = vkGetSemaphoreCounterValue(m_device.device(), m_semaphore, &value);
+        result != VK_SUCCESS) {
+        throw VulkanException("Error: vkGetSemaphoreCounterValue failed!", result, m_name);
+    }
+    return value;
+}
+
+void TimelineSemaphore::wait(const std::uint64_t value) const {
+    const auto wait_info = tools::make_info<VkSemaphoreWaitInfo>({
+        .semaphoreCount = 1,
+        .pSemaphores = &m_semaphore,
+        .pValues = &value,
+    });
+    if (const auto result = vkWaitSemaphores(m_device.device(), &wait_info, std::numeric_limits<std::uint64_t>::max());
+        result != VK_SUCCESS) {
+        throw VulkanException("Error: vkWaitSemaphores failed!", result, m_name);
+    }
+}
+
+} // namespace inexor::vulkan_renderer::wrapper::synchronization
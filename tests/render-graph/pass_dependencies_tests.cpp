@@ -0,0 +1,82 @@
+#include "inexor/vulkan-renderer/render-graph/pass_dependencies.hpp"
+#include "inexor/vulkan-renderer/tools/exception.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace inexor::vulkan_renderer::render_graph {
+
+TEST(PassDependencies, writers_before_readers) {
+    // Pass 1 reads what pass 0 writes, and passes 2 and 3 write to the same resource in the order they were added
+    const std::vector<ResourceAccesses> resources{
+        {.writers = {0}, .readers = {1}},
+        {.writers = {2, 3}, .readers = {}},
+    };
+    const auto dependencies = get_pass_dependencies(4, resources);
+    ASSERT_EQ(dependencies.size(), 4);
+    EXPECT_TRUE(dependencies[0].empty());
+    EXPECT_EQ(dependencies[1], std::vector<std::size_t>{0});
+    EXPECT_TRUE(dependencies[2].empty());
+    EXPECT_EQ(dependencies[3], std::vector<std::size_t>{2});
+    // Pass 2 does not need a barrier after pass 0, so it is sorted before pass 1
+    EXPECT_EQ(sort_topologically(dependencies), (std::vector<std::size_t>{0, 2, 3, 1}));
+
+    // Readers depend on the last writer before them, and a pass which reads what it writes does not depend on itself
+    const std::vector<ResourceAccesses> read_after_writes{{.writers = {0, 1}, .readers = {1, 2}}};
+    const auto read_dependencies = get_pass_dependencies(3, read_after_writes);
+    EXPECT_EQ(read_dependencies[1], std::vector<std::size_t>{0});
+    EXPECT_EQ(read_dependencies[2], std::vector<std::size_t>{1});
+}
+
+TEST(PassDependencies, readers_before_writers) {
+    // Pass 0 reads the resource before pass 1 overwrites it, and pass 2 reads what pass 1 wrote. Pass 3 reads and
+    // writes the resource, so it reads what pass 1 wrote and must not overwrite it before pass 2 has read it.
+    const std::vector<ResourceAccesses> resources{{.writers = {1, 3}, .readers = {0, 2, 3}}};
+    const auto dependencies = get_pass_dependencies(4, resources);
+    EXPECT_TRUE(dependencies[0].empty());
+    EXPECT_EQ(dependencies[1], std::vector<std::size_t>{0});
+    EXPECT_EQ(dependencies[2], std::vector<std::size_t>{1});
+    EXPECT_EQ(dependencies[3], (std::vector<std::size_t>{1, 2}));
+    EXPECT_EQ(sort_topologically(dependencies), (std::vector<std::size_t>{0, 1, 2, 3}));
+
+    // A resource which is only read does not order the passes
+    const std::vector<ResourceAccesses> read_only{{.writers = {}, .readers = {0, 1}}};
+    EXPECT_EQ(get_pass_dependencies(2, read_only), std::vector<std::vector<std::size_t>>(2));
+}
+
+TEST(PassDependencies, independent_passes_keep_their_order) {
+    const std::vector<std::vector<std::size_t>> dependencies(4);
+    EXPECT_EQ(sort_topologically(dependencies), (std::vector<std::size_t>{0, 1, 2, 3}));
+    EXPECT_NO_THROW(check_for_cycles(dependencies, std::vector<std::string>{"a", "b", "c", "d"}));
+}
+
+TEST(PassDependencies, cycles) {
+    // Passes 1, 2, and 3 depend on each other in a cycle, and pass 0 can still be sorted
+    const std::vector<std::vector<std::size_t>> dependencies{{}, {0, 3}, {1}, {2}};
+    EXPECT_EQ(sort_topologically(dependencies), std::vector<std::size_t>{0});
+    EXPECT_EQ(find_cycle(dependencies, {true, false, false, false}), (std::vector<std::size_t>{2, 3, 1}));
+
+    const std::vector<std::string> pass_names{"upload", "shadow", "lighting", "post"};
+    try {
+        check_for_cycles(dependencies, pass_names);
+        FAIL() << "The cycle has not been detected";
+    } catch (const tools::InexorException &exception) {
+        EXPECT_NE(std::string(exception.what()).find("lighting -> post -> shadow -> lighting"), std::string::npos);
+    }
+}
+
+TEST(PassDependencies, unused_passes) {
+    // Pass 3 writes to the swapchain and depends on pass 1, which depends on pass 0. Pass 2 reads what pass 0 writes,
+    // but nothing uses its results, and pass 4 depends on pass 3 but writes to nothing which is used.
+    const std::vector<std::vector<std::size_t>> dependencies{{}, {0}, {0}, {1}, {3}};
+    EXPECT_EQ(find_used_passes(dependencies, {false, false, false, true, false}),
+              (std::vector<bool>{true, true, false, true, false}));
+    // Every pass a root depends on is used, even if another root depends on it as well
+    EXPECT_EQ(find_used_passes(dependencies, {false, false, true, true, false}),
+              (std::vector<bool>{true, true, true, true, false}));
+    EXPECT_EQ(find_used_passes(dependencies, std::vector<bool>(5, false)), std::vector<bool>(5, false));
+}
+
+} // namespace inexor::vulkan_renderer::render_graph
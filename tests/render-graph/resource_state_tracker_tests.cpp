@@ -0,0 +1,363 @@
+#include "inexor/vulkan-renderer/render-graph/resource_state_tracker.hpp"
+#include "inexor/vulkan-renderer/tools/exception.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace inexor::vulkan_renderer::render_graph {
+
+namespace {
+
+/// Non-dispatchable handles are pointers on 64 bit platforms and integers on 32 bit platforms
+template <typename Handle>
+Handle fake_handle(const std::uintptr_t value) {
+    if constexpr (std::is_pointer_v<Handle>) {
+        return reinterpret_cast<Handle>(value);
+    } else {
+        return static_cast<Handle>(value);
+    }
+}
+
+constexpr VkImageSubresourceRange COLOR_RANGE{
+    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+    .baseMipLevel = 0,
+    .levelCount = 1,
+    .baseArrayLayer = 0,
+    .layerCount = 1,
+};
+
+constexpr ResourceAccess COLOR_ATTACHMENT_WRITE{
+    .stage_mask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+    .access_mask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+    .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+};
+
+constexpr ResourceAccess FRAGMENT_SHADER_SAMPLE{
+    .stage_mask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+    .access_mask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+    .layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+};
+
+} // namespace
+
+TEST(ResourceStateTracker, layout_transitions) {
+    ResourceStateTracker tracker;
+    PipelineBarrierBatchBuilder barriers;
+    const auto image = fake_handle<VkImage>(1);
+
+    // The first use transitions the image from the undefined layout without waiting for anything
+    tracker.require_image(image, COLOR_RANGE, COLOR_ATTACHMENT_WRITE);
+    tracker.resolve(barriers);
+    ASSERT_EQ(barriers.image_barriers().size(), 1);
+    EXPECT_TRUE(barriers.memory_barriers().empty());
+    EXPECT_EQ(barriers.image_barriers()[0].oldLayout, VK_IMAGE_LAYOUT_UNDEFINED);
+    EXPECT_EQ(barriers.image_barriers()[0].newLayout, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    EXPECT_EQ(barriers.image_barriers()[0].srcStageMask, VK_PIPELINE_STAGE_2_NONE);
+    barriers.reset();
+
+    // Sampling the image waits for the attachment write
+    tracker.require_image(image, COLOR_RANGE, FRAGMENT_SHADER_SAMPLE);
+    tracker.resolve(barriers);
+    ASSERT_EQ(barriers.image_barriers().size(), 1);
+    EXPECT_EQ(barriers.image_barriers()[0].srcStageMask, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+    EXPECT_EQ(barriers.image_barriers()[0].srcAccessMask, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+    EXPECT_EQ(barriers.image_barriers()[0].dstStageMask, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+    EXPECT_EQ(barriers.image_barriers()[0].newLayout, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    barriers.reset();
+
+    // Sampling it again in another pass is synchronized already
+    tracker.require_image(image, COLOR_RANGE, FRAGMENT_SHADER_SAMPLE);
+    tracker.resolve(barriers);
+    EXPECT_TRUE(barriers.empty());
+
+    // Writing it again must wait for the reads, but there is nothing to make available
+    tracker.require_image(image, COLOR_RANGE, COLOR_ATTACHMENT_WRITE);
+    tracker.resolve(barriers);
+    ASSERT_EQ(barriers.image_barriers().size(), 1);
+    EXPECT_EQ(barriers.image_barriers()[0].srcStageMask, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+    EXPECT_EQ(barriers.image_barriers()[0].srcAccessMask, VK_ACCESS_2_NONE);
+}
+
+TEST(ResourceStateTracker, uploads) {
+    ResourceStateTracker tracker;
+    PipelineBarrierBatchBuilder barriers;
+    const auto image = fake_handle<VkImage>(1);
+
+    // A barrier which was recorded by the upload code made the copy visible to all shader reads already
+    tracker.assume_image_state(image, COLOR_RANGE,
+                               {
+                                   .stage_mask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                                   .access_mask = VK_ACCESS_2_SHADER_READ_BIT,
+                                   .layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                               });
+    tracker.require_image(image, COLOR_RANGE, FRAGMENT_SHADER_SAMPLE);
+    tracker.resolve(barriers);
+    EXPECT_TRUE(barriers.empty());
+
+    // Uploading new data must wait for the pass which samples the image
+    tracker.require_image(image, COLOR_RANGE,
+                          {
+                              .stage_mask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                              .access_mask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                              .layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          });
+    tracker.resolve(barriers);
+    ASSERT_EQ(barriers.image_barriers().size(), 1);
+    EXPECT_EQ(barriers.image_barriers()[0].srcStageMask, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+    EXPECT_EQ(barriers.image_barriers()[0].oldLayout, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    EXPECT_EQ(barriers.image_barriers()[0].newLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+}
+
+TEST(ResourceStateTracker, memory_barriers) {
+    ResourceStateTracker tracker;
+    PipelineBarrierBatchBuilder barriers;
+    const auto image = fake_handle<VkImage>(1);
+    const auto buffer_a = fake_handle<VkBuffer>(2);
+    const auto buffer_b = fake_handle<VkBuffer>(3);
+    constexpr ResourceAccess STORAGE_WRITE{
+        .stage_mask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        .access_mask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+    };
+
+    // Reading a buffer which has not been written by any pass needs no barrier
+    tracker.require_buffer(buffer_a, {
+                                         .stage_mask = VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT,
+                                         .access_mask = VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT,
+                                     });
+    tracker.require_image(image, COLOR_RANGE, COLOR_ATTACHMENT_WRITE);
+    tracker.resolve(barriers);
+    EXPECT_TRUE(barriers.memory_barriers().empty());
+    barriers.reset();
+
+    // Hazards which don't change the layout are merged into one memory barrier
+    tracker.require_buffer(buffer_a, STORAGE_WRITE);
+    tracker.require_buffer(buffer_b, STORAGE_WRITE);
+    tracker.require_image(image, COLOR_RANGE, COLOR_ATTACHMENT_WRITE);
+    tracker.resolve(barriers);
+    EXPECT_TRUE(barriers.image_barriers().empty());
+    ASSERT_EQ(barriers.memory_barriers().size(), 1);
+    EXPECT_EQ(barriers.memory_barriers()[0].srcStageMask,
+              VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT | VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+    EXPECT_EQ(barriers.memory_barriers()[0].srcAccessMask, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+    barriers.reset();
+
+    // Accesses to the same buffer in one pass are combined
+    tracker.require_buffer(buffer_a, {
+                                         .stage_mask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+                                         .access_mask = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+                                     });
+    tracker.require_buffer(buffer_a, {
+                                         .stage_mask = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
+                                         .access_mask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                                     });
+    tracker.resolve(barriers);
+    ASSERT_EQ(barriers.memory_barriers().size(), 1);
+    EXPECT_EQ(barriers.memory_barriers()[0].srcStageMask, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+    EXPECT_EQ(barriers.memory_barriers()[0].dstStageMask,
+              VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT);
+    barriers.reset();
+
+    // The write is visible to both stages now
+    tracker.require_buffer(buffer_a, {
+                                         .stage_mask = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
+                                         .access_mask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                                     });
+    tracker.resolve(barriers);
+    EXPECT_TRUE(barriers.empty());
+}
+
+TEST(ResourceStateTracker, subresources) {
+    ResourceStateTracker tracker;
+    PipelineBarrierBatchBuilder barriers;
+    const auto image = fake_handle<VkImage>(1);
+
+    // Subresources in the same state share one barrier
+    tracker.require_image(image,
+                          {
+                              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                              .baseMipLevel = 0,
+                              .levelCount = 1,
+                              .baseArrayLayer = 0,
+                              .layerCount = 4,
+                          },
+                          COLOR_ATTACHMENT_WRITE);
+    tracker.resolve(barriers);
+    ASSERT_EQ(barriers.image_barriers().size(), 1);
+    EXPECT_EQ(barriers.image_barriers()[0].subresourceRange.layerCount, 4);
+    barriers.reset();
+
+    // Only the subresources which are accessed are transitioned
+    tracker.require_image(image,
+                          {
+                              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                              .baseMipLevel = 0,
+                              .levelCount = 1,
+                              .baseArrayLayer = 2,
+                              .layerCount = 1,
+                          },
+                          FRAGMENT_SHADER_SAMPLE);
+    tracker.resolve(barriers);
+    ASSERT_EQ(barriers.image_barriers().size(), 1);
+    EXPECT_EQ(barriers.image_barriers()[0].subresourceRange.baseArrayLayer, 2);
+    barriers.reset();
+
+    tracker.require_image(image,
+                          {
+                              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                              .baseMipLevel = 0,
+                              .levelCount = 1,
+                              .baseArrayLayer = 0,
+                              .layerCount = 4,
+                          },
+                          FRAGMENT_SHADER_SAMPLE);
+    tracker.resolve(barriers);
+    ASSERT_EQ(barriers.image_barriers().size(), 2);
+    EXPECT_EQ(barriers.image_barriers()[0].subresourceRange.layerCount, 2);
+    EXPECT_EQ(barriers.image_barriers()[1].subresourceRange.baseArrayLayer, 3);
+
+    // A pass can't require the same subresource in two layouts
+    tracker.require_image(image, COLOR_RANGE, COLOR_ATTACHMENT_WRITE);
+    tracker.require_image(image, COLOR_RANGE, FRAGMENT_SHADER_SAMPLE);
+    EXPECT_THROW(tracker.resolve(barriers), tools::InexorException);
+}
+
+TEST(ResourceStateTracker, swapchain_images) {
+    ResourceStateTracker tracker;
+    PipelineBarrierBatchBuilder barriers;
+    const auto image = fake_handle<VkImage>(1);
+
+    for (int frame = 0; frame < 2; frame++) {
+        // The acquired image waits for the stage which waits for the image available semaphore
+        tracker.discard_image(image, COLOR_RANGE, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+        tracker.require_image(image, COLOR_RANGE, COLOR_ATTACHMENT_WRITE);
+        tracker.resolve(barriers);
+        ASSERT_EQ(barriers.image_barriers().size(), 1);
+        EXPECT_EQ(barriers.image_barriers()[0].oldLayout, VK_IMAGE_LAYOUT_UNDEFINED);
+        EXPECT_EQ(barriers.image_barriers()[0].srcStageMask, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+        barriers.reset();
+
+        tracker.require_image(image, COLOR_RANGE, {.layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR});
+        tracker.resolve(barriers);
+        ASSERT_EQ(barriers.image_barriers().size(), 1);
+        EXPECT_EQ(barriers.image_barriers()[0].srcAccessMask, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+        EXPECT_EQ(barriers.image_barriers()[0].newLayout, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        barriers.reset();
+    }
+}
+
+TEST(ResourceStateTracker, aliased_images) {
+    ResourceStateTracker tracker;
+    PipelineBarrierBatchBuilder barriers;
+    const auto first_image = fake_handle<VkImage>(1);
+    const auto second_image = fake_handle<VkImage>(2);
+
+    tracker.require_image(first_image, COLOR_RANGE, COLOR_ATTACHMENT_WRITE);
+    tracker.resolve(barriers);
+    barriers.reset();
+
+    // The image which takes over the memory waits for the write to the other image
+    tracker.alias_image(second_image, COLOR_RANGE, first_image);
+    tracker.require_image(second_image, COLOR_RANGE, COLOR_ATTACHMENT_WRITE);
+    tracker.resolve(barriers);
+    ASSERT_EQ(barriers.image_barriers().size(), 1);
+    EXPECT_EQ(barriers.image_barriers()[0].image, second_image);
+    EXPECT_EQ(barriers.image_barriers()[0].oldLayout, VK_IMAGE_LAYOUT_UNDEFINED);
+    EXPECT_EQ(barriers.image_barriers()[0].srcStageMask, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+    EXPECT_EQ(barriers.image_barriers()[0].srcAccessMask, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+    barriers.reset();
+
+    tracker.require_image(second_image, COLOR_RANGE, FRAGMENT_SHADER_SAMPLE);
+    tracker.resolve(barriers);
+    barriers.reset();
+
+    // When the first image takes the memory back, it waits for the read and its contents are discarded as well
+    tracker.alias_image(first_image, COLOR_RANGE, second_image);
+    tracker.require_image(first_image, COLOR_RANGE, COLOR_ATTACHMENT_WRITE);
+    tracker.resolve(barriers);
+    ASSERT_EQ(barriers.image_barriers().size(), 1);
+    EXPECT_EQ(barriers.image_barriers()[0].oldLayout, VK_IMAGE_LAYOUT_UNDEFINED);
+    EXPECT_EQ(barriers.image_barriers()[0].srcStageMask, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+    barriers.reset();
+
+    // An image which aliases an image that has not been used yet does not wait for anything
+    const auto third_image = fake_handle<VkImage>(3);
+    tracker.alias_image(third_image, COLOR_RANGE, fake_handle<VkImage>(4));
+    tracker.require_image(third_image, COLOR_RANGE, COLOR_ATTACHMENT_WRITE);
+    tracker.resolve(barriers);
+    ASSERT_EQ(barriers.image_barriers().size(), 1);
+    EXPECT_EQ(barriers.image_barriers()[0].srcStageMask, VK_PIPELINE_STAGE_2_NONE);
+}
+
+TEST(ResourceStateTracker, queue_ownership_transfers) {
+    ResourceStateTracker tracker;
+    PipelineBarrierBatchBuilder barriers;
+    PipelineBarrierBatchBuilder release_barriers;
+    PipelineBarrierBatchBuilder acquire_barriers;
+    const auto buffer = fake_handle<VkBuffer>(1);
+    const auto image = fake_handle<VkImage>(2);
+    const auto unused_image = fake_handle<VkImage>(3);
+    constexpr std::uint32_t GRAPHICS_FAMILY = 0;
+    constexpr std::uint32_t COMPUTE_FAMILY = 1;
+    constexpr ResourceAccess COMPUTE_STORAGE_WRITE{
+        .stage_mask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        .access_mask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+        .layout = VK_IMAGE_LAYOUT_GENERAL,
+    };
+
+    tracker.require_buffer(buffer, COMPUTE_STORAGE_WRITE);
+    tracker.require_image(image, COLOR_RANGE, COMPUTE_STORAGE_WRITE);
+    tracker.resolve(barriers);
+    barriers.reset();
+
+    // The release barriers wait for the writes, and the acquire barriers keep the layout
+    tracker.transfer_buffer_ownership(buffer, COMPUTE_FAMILY, GRAPHICS_FAMILY, release_barriers, acquire_barriers);
+    tracker.transfer_image_ownership(image, COLOR_RANGE, COMPUTE_FAMILY, GRAPHICS_FAMILY, release_barriers,
+                                     acquire_barriers);
+    tracker.transfer_image_ownership(unused_image, COLOR_RANGE, COMPUTE_FAMILY, GRAPHICS_FAMILY, release_barriers,
+                                     acquire_barriers);
+    ASSERT_EQ(release_barriers.buffer_barriers().size(), 1);
+    EXPECT_EQ(release_barriers.buffer_barriers()[0].srcStageMask, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+    EXPECT_EQ(release_barriers.buffer_barriers()[0].srcAccessMask, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    EXPECT_EQ(release_barriers.buffer_barriers()[0].srcQueueFamilyIndex, COMPUTE_FAMILY);
+    EXPECT_EQ(release_barriers.buffer_barriers()[0].dstQueueFamilyIndex, GRAPHICS_FAMILY);
+    ASSERT_EQ(acquire_barriers.buffer_barriers().size(), 1);
+    EXPECT_EQ(acquire_barriers.buffer_barriers()[0].srcStageMask, VK_PIPELINE_STAGE_2_NONE);
+    // The image which has not been used yet has no contents to transfer
+    ASSERT_EQ(release_barriers.image_barriers().size(), 1);
+    ASSERT_EQ(acquire_barriers.image_barriers().size(), 1);
+    EXPECT_EQ(release_barriers.image_barriers()[0].image, image);
+    EXPECT_EQ(acquire_barriers.image_barriers()[0].oldLayout, VK_IMAGE_LAYOUT_GENERAL);
+    EXPECT_EQ(acquire_barriers.image_barriers()[0].newLayout, VK_IMAGE_LAYOUT_GENERAL);
+
+    // Reads after the acquire barriers are synchronized already
+    tracker.require_buffer(buffer, {
+                                       .stage_mask = VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT,
+                                       .access_mask = VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT,
+                                   });
+    tracker.require_image(image, COLOR_RANGE,
+                          {
+                              .stage_mask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                              .access_mask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                              .layout = VK_IMAGE_LAYOUT_GENERAL,
+                          });
+    tracker.resolve(barriers);
+    EXPECT_TRUE(barriers.empty());
+
+    // Layout transitions wait for the acquire barriers
+    tracker.require_image(unused_image, COLOR_RANGE, FRAGMENT_SHADER_SAMPLE);
+    tracker.resolve(barriers);
+    ASSERT_EQ(barriers.image_barriers().size(), 1);
+    EXPECT_EQ(barriers.image_barriers()[0].srcStageMask, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    barriers.reset();
+    release_barriers.reset();
+    acquire_barriers.reset();
+
+    // Queues of the same family are synchronized by the semaphore alone
+    tracker.transfer_buffer_ownership(buffer, GRAPHICS_FAMILY, GRAPHICS_FAMILY, release_barriers, acquire_barriers);
+    EXPECT_TRUE(release_barriers.empty());
+    EXPECT_TRUE(acquire_barriers.empty());
+}
+
+} // namespace inexor::vulkan_renderer::render_graph
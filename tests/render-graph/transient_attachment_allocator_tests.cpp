@@ -0,0 +1,73 @@
+#include "inexor/vulkan-renderer/render-graph/transient_attachment_allocator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace inexor::vulkan_renderer::render_graph {
+
+namespace {
+
+TransientImageRequest make_request(const std::size_t first_pass, const std::size_t last_pass,
+                                   const VkDeviceSize size, const std::uint32_t memory_type_bits = 1) {
+    return {
+        .first_pass = first_pass,
+        .last_pass = last_pass,
+        .requirements =
+            {
+                .size = size,
+                .alignment = 256,
+                .memoryTypeBits = memory_type_bits,
+            },
+    };
+}
+
+} // namespace
+
+TEST(TransientAttachmentAllocator, lifetimes) {
+    // Images which are used by different passes share a block, images which are used by the same pass don't
+    const std::vector<TransientImageRequest> requests{
+        make_request(0, 1, 100),
+        make_request(2, 3, 100),
+        make_request(3, 4, 100),
+        make_request(5, 5, 100),
+    };
+    const auto blocks = assign_memory_blocks(requests);
+    ASSERT_EQ(blocks.size(), 4);
+    EXPECT_EQ(blocks[0], blocks[1]);
+    EXPECT_NE(blocks[1], blocks[2]);
+    EXPECT_EQ(blocks[3], blocks[0]);
+}
+
+TEST(TransientAttachmentAllocator, sizes) {
+    // The largest image opens the first block, and the smaller images fill the other blocks first
+    const std::vector<TransientImageRequest> requests{
+        make_request(0, 0, 10),
+        make_request(1, 1, 20),
+        make_request(0, 1, 30),
+    };
+    const auto blocks = assign_memory_blocks(requests);
+    ASSERT_EQ(blocks.size(), 3);
+    EXPECT_EQ(blocks[2], 0);
+    EXPECT_EQ(blocks[1], 1);
+    EXPECT_EQ(blocks[0], 1);
+}
+
+TEST(TransientAttachmentAllocator, memory_types) {
+    // Images can only share a block if there is a memory type which is suitable for all of them
+    const std::vector<TransientImageRequest> requests{
+        make_request(0, 0, 100, 0b011),
+        make_request(1, 1, 100, 0b001),
+        make_request(2, 2, 100, 0b010),
+        make_request(3, 3, 100, 0b110),
+    };
+    const auto blocks = assign_memory_blocks(requests);
+    ASSERT_EQ(blocks.size(), 4);
+    EXPECT_EQ(blocks[0], blocks[1]);
+    EXPECT_NE(blocks[2], blocks[0]);
+    EXPECT_EQ(blocks[3], blocks[2]);
+
+    EXPECT_TRUE(assign_memory_blocks({}).empty());
+}
+
+} // namespace inexor::vulkan_renderer::render_graph
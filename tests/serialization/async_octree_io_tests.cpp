@@ -0,0 +1,92 @@
+#include <inexor/vulkan-renderer/octree/cube.hpp>
+#include <inexor/vulkan-renderer/octree/serialization/async_octree_io.hpp>
+#include <inexor/vulkan-renderer/octree/serialization/nxoc_parser.hpp>
+#include <inexor/vulkan-renderer/tools/thread_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+using inexor::vulkan_renderer::octree::Cube;
+using inexor::vulkan_renderer::tools::ThreadPool;
+using namespace inexor::vulkan_renderer::serialization;
+
+TEST(ThreadPool, submit) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.thread_count(), 4u);
+
+    std::atomic<int> sum{0};
+    std::vector<std::future<int>> futures;
+    for (int idx = 0; idx < 100; idx++) {
+        futures.push_back(pool.submit([idx, &sum]() {
+            sum += idx;
+            return idx * 2;
+        }));
+    }
+    for (int idx = 0; idx < 100; idx++) {
+        EXPECT_EQ(futures[idx].get(), idx * 2);
+    }
+    pool.wait_idle();
+    EXPECT_EQ(sum, 4950);
+
+    // Exceptions are passed to the future
+    auto failing = pool.submit([]() { throw std::runtime_error("Error"); });
+    EXPECT_THROW(failing.get(), std::runtime_error);
+    EXPECT_THROW(ThreadPool(0), std::invalid_argument);
+}
+
+TEST(AsyncOctreeIO, load_and_save) {
+    auto world = std::make_shared<Cube>();
+    world->set_type(Cube::Type::OCTANT);
+    world->children()[3]->set_type(Cube::Type::NORMAL);
+    world->children()[3]->indent(5, true, 2);
+    world->children()[6]->set_type(Cube::Type::OCTANT);
+    world->children()[6]->children()[1]->set_type(Cube::Type::SOLID);
+    const auto expected = NXOCParser().serialize(world, 0);
+
+    ThreadPool pool(2);
+    AsyncOctreeIO io(pool);
+    const auto path = std::filesystem::temp_directory_path() / "inexor_async_octree_io_tests.nxoc";
+
+    // Futures
+    EXPECT_GT(io.save(world, NXOCParser::LATEST_VERSION, path).get(), 0u);
+    const auto loaded = io.load(path).get();
+    EXPECT_EQ(NXOCParser().serialize(loaded, 0), expected);
+
+    // Callbacks only run in poll() on the calling thread
+    const auto caller = std::this_thread::get_id();
+    std::shared_ptr<Cube> swapped_in;
+    io.load(path, [&](std::shared_ptr<Cube> cube, std::exception_ptr exception) {
+        EXPECT_EQ(std::this_thread::get_id(), caller);
+        EXPECT_FALSE(exception);
+        swapped_in = std::move(cube);
+    });
+    bool failed{false};
+    io.load(path.string() + ".missing", [&](std::shared_ptr<Cube> cube, std::exception_ptr exception) {
+        EXPECT_EQ(cube, nullptr);
+        failed = exception != nullptr;
+    });
+    io.wait();
+    EXPECT_EQ(io.pending_tasks(), 0u);
+    EXPECT_EQ(swapped_in, nullptr);
+    EXPECT_EQ(io.poll(), 2u);
+    ASSERT_NE(swapped_in, nullptr);
+    EXPECT_EQ(NXOCParser().serialize(swapped_in, 0), expected);
+    EXPECT_TRUE(failed);
+    EXPECT_EQ(io.poll(), 0u);
+
+    std::size_t saved_size{0};
+    io.save(world, 0, path, [&](std::size_t size, std::exception_ptr) { saved_size = size; });
+    io.wait();
+    io.poll();
+    EXPECT_EQ(saved_size, expected.size());
+    std::filesystem::remove(path);
+}
+
+} // namespace
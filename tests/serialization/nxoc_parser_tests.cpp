@@ -0,0 +1,286 @@
+#include <inexor/vulkan-renderer/octree/cube.hpp>
+#include <inexor/vulkan-renderer/octree/serialization/byte_stream.hpp>
+#include <inexor/vulkan-renderer/octree/serialization/nxoc_parser.hpp>
+#include <inexor/vulkan-renderer/tools/lz_codec.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+using inexor::vulkan_renderer::octree::Cube;
+using namespace inexor::vulkan_renderer::serialization;
+
+/// An octree of depth 3 with all cube types, and a normal cube at every depth.
+std::shared_ptr<Cube> create_test_world() {
+    auto world = std::make_shared<Cube>();
+    world->set_type(Cube::Type::OCTANT);
+    world->children()[1]->set_type(Cube::Type::SOLID);
+    world->children()[2]->set_type(Cube::Type::NORMAL);
+    world->children()[2]->indent(3, true, 2);
+    for (const auto idx : {0, 5, 7}) {
+        const auto &octant = world->children()[idx];
+        octant->set_type(Cube::Type::OCTANT);
+        octant->children()[idx]->set_type(Cube::Type::SOLID);
+        octant->children()[3]->set_type(Cube::Type::NORMAL);
+        octant->children()[3]->indent(idx, false, 1);
+        octant->children()[6]->set_type(Cube::Type::OCTANT);
+        octant->children()[6]->children()[2]->set_type(Cube::Type::NORMAL);
+        octant->children()[6]->children()[2]->indent(11, true, 4);
+        octant->children()[6]->children()[4]->set_type(Cube::Type::SOLID);
+    }
+    return world;
+}
+
+TEST(NXOCParser, byte_stream_round_trip) {
+    ByteStreamWriter writer;
+    writer.write<std::uint32_t>(0x12345678u);
+    writer.write<std::uint8_t>(0xABu);
+    // The writer and the reader agree on little endian
+    EXPECT_EQ(std::vector<std::uint8_t>(writer.data().begin(), writer.data().end()),
+              (std::vector<std::uint8_t>{0x78, 0x56, 0x34, 0x12, 0xAB}));
+    ByteStreamReader reader(writer);
+    EXPECT_EQ(reader.read<std::uint32_t>(), 0x12345678u);
+    EXPECT_EQ(reader.position(), 4u);
+    EXPECT_EQ(reader.read<std::uint8_t>(), 0xABu);
+    EXPECT_THROW(static_cast<void>(reader.read<std::uint8_t>()), std::runtime_error);
+}
+
+TEST(NXOCParser, versions) {
+    const auto world = create_test_world();
+    NXOCParser parser;
+    const auto v0 = parser.serialize(world, 0);
+    const auto v1 = parser.serialize(world, 1);
+    EXPECT_NE(v0, v1);
+
+    // Both versions decode to the same octree, which is encoded exactly like the original
+    EXPECT_EQ(parser.serialize(parser.deserialize(v0), 0), v0);
+    EXPECT_EQ(parser.serialize(parser.deserialize(v1), 0), v0);
+    EXPECT_EQ(parser.deserialize(v1)->count_geometry_cubes(), world->count_geometry_cubes());
+
+    // Conversion in both directions
+    EXPECT_EQ(parser.convert(v0, 1), v1);
+    EXPECT_EQ(parser.convert(v1, 0), v0);
+
+    // Every subtree depth, including subtrees which are deeper than the octree
+    for (std::uint32_t depth = 0; depth < 5; depth++) {
+        NXOCParser depth_parser(depth);
+        EXPECT_EQ(depth_parser.convert(depth_parser.serialize(world, 1), 0), v0);
+    }
+    EXPECT_THROW(NXOCParser(256), std::invalid_argument);
+    EXPECT_THROW(static_cast<void>(parser.serialize(world, NXOCParser::LATEST_VERSION + 1)), std::runtime_error);
+}
+
+TEST(NXOCParser, lazy_loading) {
+    const auto world = create_test_world();
+    NXOCParser parser(1);
+    const auto v1 = parser.serialize(world, 1);
+
+    // Only decode the subtrees in the lower half
+    const auto lower_half = [](const Cube &subtree) { return subtree.position().x < 16.0f; };
+    const auto root = parser.deserialize(v1, lower_half);
+    EXPECT_EQ(root->children()[0]->type(), Cube::Type::OCTANT);
+    EXPECT_EQ(root->children()[2]->type(), Cube::Type::NORMAL);
+    EXPECT_EQ(root->children()[5]->type(), Cube::Type::EMPTY);
+    EXPECT_EQ(root->children()[7]->type(), Cube::Type::EMPTY);
+
+    // Load the rest later
+    parser.load_subtrees(v1, root, [&](const Cube &subtree) { return !lower_half(subtree); });
+    EXPECT_EQ(parser.serialize(root, 1), v1);
+
+    // The octree must match the stream above the subtree depth
+    EXPECT_THROW(parser.load_subtrees(v1, std::make_shared<Cube>(), {}), std::invalid_argument);
+
+    // A corrupt subtree size is detected
+    std::vector<std::uint8_t> corrupt(v1.data().begin(), v1.data().end());
+    corrupt[13 + 4 + 1 + 4 + 4] += 1;
+    EXPECT_THROW(static_cast<void>(parser.deserialize(ByteStream(corrupt))), std::runtime_error);
+}
+
+TEST(NXOCParser, lz_codec) {
+    using inexor::vulkan_renderer::tools::lz_compress;
+    using inexor::vulkan_renderer::tools::lz_decompress;
+
+    // Runs, repeated patterns, noise, and lengths which need extension bytes
+    std::vector<std::uint8_t> data(1000, 3);
+    for (std::uint32_t idx = 0; idx < 2000; idx++) {
+        data.push_back(static_cast<std::uint8_t>(idx % 7));
+    }
+    std::uint32_t state{12345};
+    for (std::uint32_t idx = 0; idx < 500; idx++) {
+        state = state * 1103515245u + 12345u;
+        data.push_back(static_cast<std::uint8_t>(state >> 24u));
+    }
+    for (std::size_t size : {std::size_t{0}, std::size_t{3}, std::size_t{17}, std::size_t{1000}, data.size()}) {
+        const std::span<const std::uint8_t> input(data.data(), size);
+        const auto block = lz_compress(input);
+        EXPECT_EQ(lz_decompress(block, size), std::vector<std::uint8_t>(input.begin(), input.end()));
+    }
+    const auto block = lz_compress(data);
+    EXPECT_LT(block.size(), data.size() / 2);
+
+    // Corrupt blocks are detected
+    EXPECT_THROW(static_cast<void>(lz_decompress(block, data.size() - 1)), std::runtime_error);
+    EXPECT_THROW(static_cast<void>(lz_decompress(std::vector<std::uint8_t>{0x00, 0x01, 0x00}, 4)), std::runtime_error);
+    EXPECT_THROW(static_cast<void>(lz_decompress(block, std::size_t{1} << 40u)), std::runtime_error);
+}
+
+TEST(NXOCParser, compression) {
+    const auto world = create_test_world();
+    const auto v0 = NXOCParser().serialize(world, 0);
+    for (const auto compression : {NXOCParser::Compression::NONE, NXOCParser::Compression::LZ}) {
+        for (std::uint32_t depth = 0; depth < 5; depth++) {
+            NXOCParser parser(depth, compression);
+            const auto v2 = parser.serialize(world, 2);
+            EXPECT_EQ(parser.convert(v2, 0), v0);
+            // The compression is read from the stream
+            EXPECT_EQ(NXOCParser(depth, NXOCParser::Compression::NONE).convert(v2, 2),
+                      NXOCParser(depth, NXOCParser::Compression::NONE).serialize(world, 2));
+        }
+    }
+
+    // A big world of equal cubes compresses well
+    auto big_world = std::make_shared<Cube>();
+    big_world->set_type(Cube::Type::OCTANT);
+    for (const auto &octant : big_world->children()) {
+        octant->set_type(Cube::Type::OCTANT);
+        for (const auto &child : octant->children()) {
+            child->set_type(Cube::Type::OCTANT);
+            for (const auto &grandchild : child->children()) {
+                grandchild->set_type(Cube::Type::NORMAL);
+                grandchild->indent(1, true, 1);
+            }
+        }
+    }
+    const auto uncompressed = NXOCParser(1, NXOCParser::Compression::NONE).serialize(big_world, 2);
+    const auto compressed = NXOCParser(1, NXOCParser::Compression::LZ).serialize(big_world, 2);
+    EXPECT_LT(compressed.size() * 4, uncompressed.size());
+    EXPECT_EQ(NXOCParser().convert(compressed, 0), NXOCParser().serialize(big_world, 0));
+
+    // Blocks which are bigger than a chunk are compressed in several chunks
+    for (const auto &octant : big_world->children()) {
+        for (const auto &child : octant->children()) {
+            for (const auto &grandchild : child->children()) {
+                grandchild->set_type(Cube::Type::OCTANT);
+                for (const auto &leaf_octant : grandchild->children()) {
+                    leaf_octant->set_type(Cube::Type::OCTANT);
+                    for (std::uint8_t idx = 0; const auto &leaf : leaf_octant->children()) {
+                        leaf->set_type(Cube::Type::NORMAL);
+                        leaf->indent(idx++, true, 1);
+                    }
+                }
+            }
+        }
+    }
+    const auto big_v0 = NXOCParser().serialize(big_world, 0);
+    ASSERT_GT(big_v0.size(), 2 * NXOCParser::LZ_CHUNK_SIZE);
+    const auto chunked = NXOCParser(0, NXOCParser::Compression::LZ).serialize(big_world, 2);
+    EXPECT_EQ(NXOCParser().convert(chunked, 0), big_v0);
+
+    // Lazy loading works on compressed blocks
+    NXOCParser parser(1);
+    const auto v2 = parser.serialize(world, 2);
+    const auto lower_half = [](const Cube &subtree) { return subtree.position().x < 16.0f; };
+    const auto root = parser.deserialize(v2, lower_half);
+    EXPECT_EQ(root->children()[5]->type(), Cube::Type::EMPTY);
+    parser.load_subtrees(v2, root, [&](const Cube &subtree) { return !lower_half(subtree); });
+    EXPECT_EQ(parser.serialize(root, 2), v2);
+
+    // A corrupt table offset or block is detected
+    std::vector<std::uint8_t> corrupt(v2.data().begin(), v2.data().end());
+    corrupt.back() += 1;
+    EXPECT_THROW(static_cast<void>(parser.deserialize(ByteStream(corrupt))), std::runtime_error);
+    corrupt = std::vector<std::uint8_t>(v2.data().begin(), v2.data().end());
+    corrupt[13 + 4 + 1 + 1] ^= 0xFFu;
+    EXPECT_THROW(static_cast<void>(parser.deserialize(ByteStream(corrupt))), std::runtime_error);
+}
+
+TEST(NXOCParser, memory_mapped_file) {
+    const auto world = create_test_world();
+    NXOCParser parser;
+    const auto v1 = parser.serialize(world, 1);
+    const auto path = std::filesystem::temp_directory_path() / "inexor_nxoc_parser_tests.nxoc";
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(v1.data().data()), static_cast<std::streamsize>(v1.size()));
+    }
+    {
+        const ByteStream stream(path);
+#if defined(__unix__) || defined(__APPLE__) || defined(_WIN32)
+        EXPECT_TRUE(stream.is_memory_mapped());
+#endif
+        EXPECT_EQ(stream, v1);
+        // Copies share the mapping
+        const auto copy = stream;
+        EXPECT_EQ(copy.data().data(), stream.data().data());
+        EXPECT_EQ(parser.serialize(parser.deserialize(stream), 1), v1);
+    }
+    std::filesystem::remove(path);
+    EXPECT_THROW(ByteStream{path}, std::runtime_error);
+}
+
+TEST(NXOCParser, file_writer) {
+    const auto world = create_test_world();
+    NXOCParser parser;
+    const auto path = std::filesystem::temp_directory_path() / "inexor_nxoc_parser_file_writer_tests.nxoc";
+    for (const std::uint32_t version : {0u, 1u, 2u}) {
+        const auto expected = parser.serialize(world, version);
+        for (const bool direct_io : {false, true}) {
+            // A tiny buffer is flushed many times
+            const FileWriteOptions options{.buffer_size = 7, .direct_io = direct_io, .sync = direct_io};
+            EXPECT_EQ(parser.serialize(world, version, path, options), expected.size());
+            EXPECT_EQ(ByteStream(path), expected);
+        }
+    }
+
+    // The writer never holds more than the buffer size
+    ByteStreamWriter writer(path, {.buffer_size = 4});
+    writer.write<std::string>("Inexor Octree");
+    writer.write<std::uint32_t>(1);
+    EXPECT_LT(writer.size(), 4u);
+    EXPECT_EQ(writer.bytes_written(), 17u);
+    writer.finish();
+    EXPECT_EQ(ByteStream(path).size(), 17u);
+
+    // The file is only replaced in finish, and a stream which maps the old file stays valid
+    {
+        const ByteStream old_file(path);
+        ByteStreamWriter replacement(path, {.buffer_size = 4});
+        replacement.write<std::string>("Inexor Octree");
+        EXPECT_EQ(ByteStream(path), old_file);
+        replacement.finish();
+        EXPECT_EQ(old_file.size(), 17u);
+        EXPECT_EQ(old_file.data()[13], 1u);
+        EXPECT_EQ(ByteStream(path).size(), 13u);
+    }
+    // An unfinished writer keeps the old file and removes its temporary file
+    {
+        ByteStreamWriter unfinished(path, {.buffer_size = 4});
+        unfinished.write<std::string>("Inexor");
+    }
+    EXPECT_EQ(ByteStream(path).size(), 13u);
+    EXPECT_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+    std::filesystem::remove(path);
+
+    // A writer which streams into a function passes full buffers, and the rest in finish
+    std::vector<std::size_t> flushed;
+    ByteStreamWriter function_writer(4, [&](const std::span<const std::uint8_t> bytes) {
+        flushed.push_back(bytes.size());
+    });
+    function_writer.write<std::string>("Inexor Octree");
+    function_writer.write<std::uint32_t>(1);
+    function_writer.finish();
+    EXPECT_EQ(flushed, (std::vector<std::size_t>{4, 4, 4, 4, 1}));
+    EXPECT_EQ(function_writer.bytes_written(), 17u);
+
+    EXPECT_THROW(ByteStreamWriter(std::filesystem::temp_directory_path() / "missing" / "file.nxoc", {}),
+                 std::runtime_error);
+}
+
+} // namespace
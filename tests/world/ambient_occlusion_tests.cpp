@@ -0,0 +1,76 @@
+#include <inexor/vulkan-renderer/octree/cube.hpp>
+#include <inexor/vulkan-renderer/render-modules/octree/octree_mesh.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+
+namespace {
+using inexor::vulkan_renderer::octree::Cube;
+using inexor::vulkan_renderer::render_modules::octree::build_octree_mesh;
+using inexor::vulkan_renderer::render_modules::octree::OctreeMesh;
+using inexor::vulkan_renderer::render_modules::octree::OctreeMesher;
+
+glm::vec3 white(const glm::vec3 &) {
+    return glm::vec3{1.0f};
+}
+
+/// The lowest ambient occlusion of all vertices at a position
+float min_occlusion(const OctreeMesh &mesh, const glm::vec3 &position) {
+    float occlusion = 1.0f;
+    for (const auto &vertex : mesh.vertices) {
+        if (vertex.position == position) {
+            occlusion = std::min(occlusion, vertex.occlusion);
+        }
+    }
+    return occlusion;
+}
+
+/// A floor cube with two walls on top of it, which meet at the corner (1, 1, 1) of the floor.
+std::shared_ptr<Cube> create_test_world() {
+    auto world = std::make_shared<Cube>(2.0f, glm::vec3{0.0f});
+    world->set_type(Cube::Type::OCTANT);
+    world->children()[0]->set_type(Cube::Type::SOLID);
+    world->children()[3]->set_type(Cube::Type::SOLID);
+    world->children()[5]->set_type(Cube::Type::SOLID);
+    return world;
+}
+
+TEST(AmbientOcclusion, corners_between_walls) {
+    const std::array worlds{create_test_world()};
+    const auto mesh = build_octree_mesh(worlds, 1, 1, white);
+
+    // Both sides of the inner corner on top of the floor are occupied
+    EXPECT_FLOAT_EQ(min_occlusion(mesh, {1.0f, 1.0f, 1.0f}), 0.4f);
+    // One wall next to the vertex
+    EXPECT_FLOAT_EQ(min_occlusion(mesh, {1.0f, 0.0f, 1.0f}), 0.8f);
+    // Nothing around the outer corner of the floor
+    EXPECT_FLOAT_EQ(min_occlusion(mesh, {0.0f, 0.0f, 0.0f}), 1.0f);
+}
+
+TEST(AmbientOcclusion, incremental_remeshing) {
+    const std::array worlds{create_test_world()};
+    OctreeMesher mesher(1, 1, white);
+    const auto mesh = mesher.mesh(worlds);
+    ASSERT_EQ(mesh.chunks.size(), 3u);
+
+    // Remove one wall and re-mesh the chunks which touch it, which are all three chunks in this small world
+    const auto wall = worlds[0]->children()[3];
+    wall->set_type(Cube::Type::EMPTY);
+    const auto chunks = mesher.find_chunks(wall->bounding_box());
+    EXPECT_EQ(chunks, (std::vector<std::uint32_t>{0, 1, 2}));
+    const auto remeshed = mesher.remesh(chunks);
+
+    EXPECT_FLOAT_EQ(min_occlusion(remeshed, {1.0f, 1.0f, 1.0f}), 0.8f);
+    // The chunk of the wall stays in the layout without geometry
+    ASSERT_EQ(remeshed.chunks.size(), 3u);
+    EXPECT_EQ(remeshed.chunks[1].lods[0].index_count, 0u);
+    // Otherwise, the result is the same as meshing everything again
+    const auto full = build_octree_mesh(worlds, 1, 1, white);
+    EXPECT_EQ(remeshed.vertices, full.vertices);
+    EXPECT_EQ(remeshed.indices, full.indices);
+    EXPECT_THROW(static_cast<void>(mesher.remesh(std::vector<std::uint32_t>{3})), std::out_of_range);
+}
+
+} // namespace
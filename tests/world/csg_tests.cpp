@@ -0,0 +1,55 @@
+#include <inexor/vulkan-renderer/octree/csg.hpp>
+#include <inexor/vulkan-renderer/octree/cube.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+using namespace inexor::vulkan_renderer::octree;
+
+TEST(Csg, subtract_carves_solid_cube) {
+    auto world = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    world->set_type(Cube::Type::SOLID);
+
+    auto brush = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    brush->set_type(Cube::Type::OCTANT);
+    brush->children()[0]->set_type(Cube::Type::SOLID);
+
+    apply_csg(*world, *brush, CsgOperation::SUBTRACT);
+
+    ASSERT_EQ(world->type(), Cube::Type::OCTANT);
+    EXPECT_EQ(world->children()[0]->type(), Cube::Type::EMPTY);
+    for (std::size_t idx = 1; idx < Cube::SUB_CUBES; idx++) {
+        EXPECT_EQ(world->children()[idx]->type(), Cube::Type::SOLID);
+    }
+}
+
+TEST(Csg, union_simplifies_once_at_the_end) {
+    auto world = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    world->set_type(Cube::Type::OCTANT);
+    for (std::size_t idx = 0; idx < 4; idx++) {
+        world->children()[idx]->set_type(Cube::Type::SOLID);
+    }
+
+    auto brush = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    brush->set_type(Cube::Type::OCTANT);
+    for (std::size_t idx = 4; idx < Cube::SUB_CUBES; idx++) {
+        brush->children()[idx]->set_type(Cube::Type::SOLID);
+    }
+
+    apply_csg(*world, *brush, CsgOperation::UNION);
+    EXPECT_EQ(world->type(), Cube::Type::SOLID);
+}
+
+TEST(Csg, intersect_with_empty_brush) {
+    auto world = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    world->set_type(Cube::Type::SOLID);
+    const auto brush = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+
+    apply_csg(*world, *brush, CsgOperation::INTERSECT);
+    EXPECT_EQ(world->type(), Cube::Type::EMPTY);
+
+    const auto misplaced_brush = std::make_shared<Cube>(2.0f, glm::vec3{1, 0, 0});
+    EXPECT_THROW(apply_csg(*world, *misplaced_brush, CsgOperation::UNION), std::invalid_argument);
+}
+
+} // namespace
@@ -0,0 +1,155 @@
+#include <inexor/vulkan-renderer/octree/cube.hpp>
+#include <inexor/vulkan-renderer/render-modules/octree/octree_mesh.hpp>
+#include <inexor/vulkan-renderer/tools/frustum.hpp>
+#include <inexor/vulkan-renderer/tools/occlusion_buffer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+namespace {
+using inexor::vulkan_renderer::octree::Cube;
+using inexor::vulkan_renderer::render_modules::octree::build_octree_mesh;
+using inexor::vulkan_renderer::render_modules::octree::collect_draw_ranges;
+using inexor::vulkan_renderer::render_modules::octree::cull_chunks;
+using inexor::vulkan_renderer::render_modules::octree::cull_occluded_chunks;
+using inexor::vulkan_renderer::render_modules::octree::OctreeMeshRange;
+using inexor::vulkan_renderer::render_modules::octree::select_occluders;
+using inexor::vulkan_renderer::tools::Frustum;
+using inexor::vulkan_renderer::tools::FrustumIntersection;
+using inexor::vulkan_renderer::tools::OcclusionBuffer;
+
+/// A world with three solid children, whose lower half in z direction is behind the near plane of the clip space.
+std::shared_ptr<Cube> create_test_world(const glm::vec3 &position) {
+    auto world = std::make_shared<Cube>(2.0f, position);
+    world->set_type(Cube::Type::OCTANT);
+    world->children()[0]->set_type(Cube::Type::SOLID);
+    world->children()[1]->set_type(Cube::Type::SOLID);
+    world->children()[7]->set_type(Cube::Type::SOLID);
+    return world;
+}
+
+TEST(Culling, frustum_from_identity_matrix) {
+    // The identity matrix gives the clip space box [-1, 1] x [-1, 1] x [0, 1]
+    const Frustum frustum(glm::mat4(1.0f));
+    EXPECT_EQ(frustum.intersect({glm::vec3{-0.5f, -0.5f, 0.25f}, glm::vec3{0.5f, 0.5f, 0.75f}}),
+              FrustumIntersection::INSIDE);
+    EXPECT_EQ(frustum.intersect({glm::vec3{0.5f, 0.5f, 0.5f}, glm::vec3{1.5f, 1.5f, 1.5f}}),
+              FrustumIntersection::INTERSECTING);
+    EXPECT_EQ(frustum.intersect({glm::vec3{-0.5f, -0.5f, -2.0f}, glm::vec3{0.5f, 0.5f, -1.0f}}),
+              FrustumIntersection::OUTSIDE);
+    // A default constructed frustum contains everything
+    EXPECT_EQ(Frustum().intersect({glm::vec3{100.0f}, glm::vec3{200.0f}}), FrustumIntersection::INSIDE);
+}
+
+TEST(Culling, hierarchical_chunk_culling) {
+    const std::array worlds{
+        create_test_world({-1.0f, -1.0f, -1.5f}),
+        // This world is far away, so it is rejected at its root node
+        create_test_world({10.0f, 10.0f, 10.0f}),
+    };
+    const auto mesh = build_octree_mesh(worlds, 1, 1, [](const glm::vec3 &) { return glm::vec3{1.0f}; });
+    ASSERT_EQ(mesh.chunks.size(), 6u);
+    ASSERT_EQ(mesh.cull_nodes.size(), 8u);
+
+    std::vector<std::uint32_t> visible_chunks;
+    cull_chunks(mesh, Frustum(glm::mat4(1.0f)), visible_chunks);
+    // Child 0 is behind the near plane, while child 1 and 7 intersect the frustum
+    EXPECT_EQ(visible_chunks, (std::vector<std::uint32_t>{1, 2}));
+
+    // The visible chunks are adjacent in the index buffer, so they can be drawn at once
+    EXPECT_EQ(mesh.chunks[1].lods[0].first_index + mesh.chunks[1].lods[0].index_count,
+              mesh.chunks[2].lods[0].first_index);
+    std::vector<OctreeMeshRange> draw_ranges;
+    collect_draw_ranges(mesh, visible_chunks, glm::vec3{0.0f}, {}, draw_ranges);
+    EXPECT_EQ(draw_ranges, (std::vector<OctreeMeshRange>{{
+                               .first_index = mesh.chunks[1].lods[0].first_index,
+                               .index_count = mesh.chunks[1].lods[0].index_count + mesh.chunks[2].lods[0].index_count,
+                           }}));
+}
+
+TEST(Culling, occlusion_buffer) {
+    // With the identity matrix, x and y are mapped to the screen and z is the depth
+    OcclusionBuffer buffer(64, 32);
+    buffer.clear(glm::mat4(1.0f));
+    buffer.rasterize_box({glm::vec3{-0.5f, -0.5f, 0.2f}, glm::vec3{0.5f, 0.5f, 0.3f}});
+    buffer.build_hierarchy();
+
+    EXPECT_FLOAT_EQ(buffer.depth(32, 16), 0.2f);
+    EXPECT_FLOAT_EQ(buffer.depth(0, 0), 1.0f);
+    // The top level of the pyramid stores the farthest depth of the whole screen
+    EXPECT_FLOAT_EQ(buffer.depth(0, 0, buffer.level_count() - 1), 1.0f);
+
+    // Behind the occluder
+    EXPECT_FALSE(buffer.is_visible({glm::vec3{-0.2f, -0.2f, 0.6f}, glm::vec3{0.2f, 0.2f, 0.7f}}));
+    // Partially next to the occluder
+    EXPECT_TRUE(buffer.is_visible({glm::vec3{0.3f, 0.3f, 0.6f}, glm::vec3{0.8f, 0.8f, 0.7f}}));
+    // In front of the occluder
+    EXPECT_TRUE(buffer.is_visible({glm::vec3{-0.1f, -0.1f, 0.05f}, glm::vec3{0.1f, 0.1f, 0.1f}}));
+    // The occluder itself is not occluded
+    EXPECT_TRUE(buffer.is_visible({glm::vec3{-0.5f, -0.5f, 0.2f}, glm::vec3{0.5f, 0.5f, 0.3f}}));
+}
+
+TEST(Culling, occluders_crossing_the_near_plane) {
+    // With the identity matrix, the near plane is at z = 0, so these occluders reach in front of it
+    OcclusionBuffer buffer(64, 32);
+    buffer.clear(glm::mat4(1.0f));
+    buffer.rasterize_box({glm::vec3{-0.5f, -0.5f, -0.5f}, glm::vec3{0.5f, 0.5f, 0.3f}});
+    buffer.rasterize_triangle(
+        {glm::vec3{-1.0f, -1.0f, -0.1f}, glm::vec3{1.0f, -1.0f, 0.2f}, glm::vec3{0.0f, 1.0f, 0.2f}});
+    buffer.build_hierarchy();
+
+    // They are skipped, so they neither write negative depths nor hide the boxes behind them
+    EXPECT_FLOAT_EQ(buffer.depth(32, 16), 1.0f);
+    EXPECT_TRUE(buffer.is_visible({glm::vec3{-0.2f, -0.2f, 0.6f}, glm::vec3{0.2f, 0.2f, 0.7f}}));
+    // Boxes which cross the near plane are always visible
+    EXPECT_TRUE(buffer.is_visible({glm::vec3{-0.2f, -0.2f, -0.1f}, glm::vec3{0.2f, 0.2f, 0.7f}}));
+}
+
+TEST(Culling, merged_occluders) {
+    auto world = std::make_shared<Cube>(2.0f, glm::vec3{0.0f});
+    world->set_type(Cube::Type::OCTANT);
+    world->children()[0]->set_type(Cube::Type::SOLID);
+    world->children()[1]->set_type(Cube::Type::SOLID);
+    const std::array worlds{world};
+    const auto mesh = build_octree_mesh(worlds, 1, 1, [](const glm::vec3 &) { return glm::vec3{1.0f}; });
+
+    // The two solid children are neighbours in z direction, so they are merged into one occluder
+    ASSERT_EQ(mesh.occluders.size(), 1u);
+    EXPECT_EQ(mesh.occluders[0][0], (glm::vec3{0.0f, 0.0f, 0.0f}));
+    EXPECT_EQ(mesh.occluders[0][1], (glm::vec3{1.0f, 1.0f, 2.0f}));
+}
+
+TEST(Culling, chunk_occlusion_culling) {
+    auto create_solid_world = [](const float size, const glm::vec3 &position) {
+        auto world = std::make_shared<Cube>(size, position);
+        world->set_type(Cube::Type::SOLID);
+        return world;
+    };
+    const std::array worlds{
+        // A wall in front of the second world, while the third world is next to it
+        create_solid_world(0.5f, {-0.25f, -0.25f, 0.1f}),
+        create_solid_world(0.125f, {-0.0625f, -0.0625f, 0.7f}),
+        create_solid_world(0.125f, {0.5f, 0.5f, 0.7f}),
+    };
+    const auto mesh = build_octree_mesh(worlds, 0, 1, [](const glm::vec3 &) { return glm::vec3{1.0f}; });
+    ASSERT_EQ(mesh.chunks.size(), 3u);
+    ASSERT_EQ(mesh.occluders.size(), 3u);
+
+    const glm::vec3 camera_position{0.0f, 0.0f, -1.0f};
+    std::vector<std::uint32_t> occluders;
+    select_occluders(mesh, camera_position, 1, occluders);
+    ASSERT_EQ(occluders.size(), 1u);
+    EXPECT_EQ(mesh.occluders[occluders[0]], worlds[0]->bounding_box());
+
+    std::vector<std::uint32_t> visible_chunks;
+    cull_chunks(mesh, Frustum(glm::mat4(1.0f)), visible_chunks);
+    ASSERT_EQ(visible_chunks, (std::vector<std::uint32_t>{0, 1, 2}));
+
+    OcclusionBuffer buffer(64, 64);
+    select_occluders(mesh, camera_position, 8, occluders);
+    cull_occluded_chunks(mesh, occluders, glm::mat4(1.0f), buffer, visible_chunks);
+    EXPECT_EQ(visible_chunks, (std::vector<std::uint32_t>{0, 2}));
+}
+
+} // namespace
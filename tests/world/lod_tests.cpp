@@ -0,0 +1,72 @@
+#include <inexor/vulkan-renderer/octree/cube.hpp>
+#include <inexor/vulkan-renderer/octree/lod.hpp>
+#include <inexor/vulkan-renderer/render-modules/octree/octree_mesh.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+namespace {
+using namespace inexor::vulkan_renderer::octree;
+using inexor::vulkan_renderer::render_modules::octree::build_octree_mesh;
+using inexor::vulkan_renderer::render_modules::octree::select_lod;
+
+/// A cube whose first octant is split again, with five of the eight grandchildren being solid.
+std::shared_ptr<Cube> create_test_world() {
+    auto world = std::make_shared<Cube>(4.0f, glm::vec3{0.0f, 0.0f, 0.0f});
+    world->set_type(Cube::Type::OCTANT);
+    const auto octant = world->children()[0];
+    octant->set_type(Cube::Type::OCTANT);
+    for (std::size_t idx = 0; idx < 5; idx++) {
+        octant->children()[idx]->set_type(Cube::Type::SOLID);
+    }
+    return world;
+}
+
+TEST(Lod, collapse_by_coverage) {
+    const auto world = create_test_world();
+    ASSERT_EQ(octree_depth(*world), 2u);
+
+    // At full depth the copy is identical
+    const auto full = create_lod(*world, 2);
+    EXPECT_EQ(full->count_geometry_cubes(), world->count_geometry_cubes());
+
+    // 5/8 of the octant are filled, which is above the default threshold
+    const auto collapsed = create_lod(*world, 1);
+    ASSERT_EQ(collapsed->type(), Cube::Type::OCTANT);
+    EXPECT_EQ(collapsed->children()[0]->type(), Cube::Type::SOLID);
+    // With a higher threshold the octant is dropped, and the whole copy simplifies to an empty cube
+    EXPECT_EQ(create_lod(*world, 1, LodHeuristic::COVERAGE, 0.75f)->type(), Cube::Type::EMPTY);
+
+    // The whole world is less than half filled, so it disappears at depth 0
+    EXPECT_EQ(create_lod(*world, 0)->type(), Cube::Type::EMPTY);
+}
+
+TEST(Lod, collapse_by_majority_type) {
+    const auto world = create_test_world();
+    const auto collapsed = create_lod(*world, 1, LodHeuristic::MAJORITY_TYPE);
+    ASSERT_EQ(collapsed->type(), Cube::Type::OCTANT);
+    EXPECT_EQ(collapsed->children()[0]->type(), Cube::Type::SOLID);
+    // The copy is independent of the original
+    EXPECT_EQ(world->children()[0]->type(), Cube::Type::OCTANT);
+}
+
+TEST(Lod, chunked_mesh_and_distance_selection) {
+    const std::array worlds{create_test_world()};
+    const auto mesh = build_octree_mesh(worlds, 1, 4, [](const glm::vec3 &) { return glm::vec3{1.0f}; });
+
+    // Only the first octant contains geometry. It has one level of octants, so it gets two levels of detail.
+    ASSERT_EQ(mesh.chunks.size(), 1u);
+    const auto &chunk = mesh.chunks.front();
+    ASSERT_EQ(chunk.lods.size(), 2u);
+    EXPECT_GT(chunk.lods[0].index_count, chunk.lods[1].index_count);
+    EXPECT_EQ(chunk.lods[1].first_index, chunk.lods[0].index_count);
+
+    const std::array distances{10.0f, 20.0f};
+    EXPECT_EQ(select_lod(chunk, {1.0f, 1.0f, 1.0f}, distances), 0u);
+    EXPECT_EQ(select_lod(chunk, {2.0f, 0.0f, 15.0f}, distances), 1u);
+    // The selection is clamped to the levels of detail of the chunk
+    EXPECT_EQ(select_lod(chunk, {2.0f, 0.0f, 100.0f}, distances), 1u);
+}
+
+} // namespace
@@ -0,0 +1,152 @@
+#include <inexor/vulkan-renderer/octree/cube.hpp>
+#include <inexor/vulkan-renderer/render-modules/octree/octree_mesh.hpp>
+#include <inexor/vulkan-renderer/render-modules/octree/octree_mesh_cache.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace {
+using inexor::vulkan_renderer::octree::create_random_world;
+using inexor::vulkan_renderer::octree::Cube;
+using inexor::vulkan_renderer::render_modules::octree::OctreeChunkMesh;
+using inexor::vulkan_renderer::render_modules::octree::OctreeMesh;
+using inexor::vulkan_renderer::render_modules::octree::OctreeMeshCache;
+using inexor::vulkan_renderer::render_modules::octree::OctreeMesher;
+using inexor::vulkan_renderer::render_modules::octree::OctreeVertex;
+using inexor::vulkan_renderer::tools::Meshlet;
+using inexor::vulkan_renderer::tools::pack_meshlet_triangle;
+
+glm::vec3 white(const glm::vec3 &) {
+    return glm::vec3{1.0f};
+}
+
+void expect_same_mesh(const OctreeMesh &lhs, const OctreeMesh &rhs) {
+    EXPECT_EQ(lhs.vertices, rhs.vertices);
+    EXPECT_EQ(lhs.indices, rhs.indices);
+    EXPECT_EQ(lhs.chunks, rhs.chunks);
+    EXPECT_EQ(lhs.meshlet_vertices, rhs.meshlet_vertices);
+    EXPECT_EQ(lhs.meshlet_triangles, rhs.meshlet_triangles);
+    EXPECT_EQ(lhs.meshlets.size(), rhs.meshlets.size());
+}
+
+TEST(OctreeMeshCache, skips_meshing_of_unchanged_chunks) {
+    const std::array worlds{create_random_world(3, {0.0f, 0.0f, 0.0f}, 42)};
+    const auto path = std::filesystem::temp_directory_path() / "inexor_octree_mesh_cache_tests.cache";
+    std::filesystem::remove(path);
+    const auto uncached = OctreeMesher(1, 2, white).mesh(worlds);
+    ASSERT_GT(uncached.chunks.size(), 1u);
+
+    // The first start meshes every chunk
+    {
+        auto cache = std::make_shared<OctreeMeshCache>(path);
+        OctreeMesher mesher(1, 2, white);
+        mesher.set_cache(cache);
+        expect_same_mesh(mesher.mesh(worlds), uncached);
+        EXPECT_EQ(cache->hits(), 0u);
+        EXPECT_EQ(cache->misses(), uncached.chunks.size());
+        EXPECT_TRUE(cache->save());
+    }
+
+    // The next start loads every chunk from the file
+    {
+        auto cache = std::make_shared<OctreeMeshCache>(path);
+        OctreeMesher mesher(1, 2, white);
+        mesher.set_cache(cache);
+        expect_same_mesh(mesher.mesh(worlds), uncached);
+        EXPECT_EQ(cache->hits(), uncached.chunks.size());
+        EXPECT_EQ(cache->misses(), 0u);
+
+        // Different settings and vertex colors are different keys
+        OctreeMesher other_mesher(1, 1, white);
+        other_mesher.set_cache(cache, 1);
+        static_cast<void>(other_mesher.mesh(worlds));
+        EXPECT_EQ(cache->hits(), uncached.chunks.size());
+        EXPECT_TRUE(cache->save());
+    }
+
+    // An edit changes the key of the edited chunk and of the chunks next to it, because of the ambient occlusion
+    const auto edited = worlds[0]->children()[0];
+    edited->set_type(edited->type() == Cube::Type::SOLID ? Cube::Type::EMPTY : Cube::Type::SOLID);
+    {
+        auto cache = std::make_shared<OctreeMeshCache>(path);
+        OctreeMesher mesher(1, 2, white);
+        mesher.set_cache(cache);
+        const auto mesh = mesher.mesh(worlds);
+        expect_same_mesh(mesh, OctreeMesher(1, 2, white).mesh(worlds));
+        EXPECT_GT(cache->misses(), 0u);
+        EXPECT_EQ(cache->hits() + cache->misses(), mesh.chunks.size());
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(OctreeMeshCache, invalid_files) {
+    const std::array worlds{create_random_world(2, {0.0f, 0.0f, 0.0f}, 7)};
+    const auto path = std::filesystem::temp_directory_path() / "inexor_octree_mesh_cache_invalid_tests.cache";
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "Inexor MeshCache but not really";
+    }
+    auto cache = std::make_shared<OctreeMeshCache>(path);
+    OctreeMesher mesher(1, 2, white);
+    mesher.set_cache(cache);
+    expect_same_mesh(mesher.mesh(worlds), OctreeMesher(1, 2, white).mesh(worlds));
+    EXPECT_EQ(cache->hits(), 0u);
+    EXPECT_TRUE(cache->save());
+
+    // Truncated entries are ignored
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+    auto truncated = std::make_shared<OctreeMeshCache>(path);
+    mesher.set_cache(truncated);
+    expect_same_mesh(mesher.mesh(worlds), OctreeMesher(1, 2, white).mesh(worlds));
+    std::filesystem::remove(path);
+}
+
+TEST(OctreeMeshCache, invalid_meshlet_ranges) {
+    const auto path = std::filesystem::temp_directory_path() / "inexor_octree_mesh_cache_meshlet_tests.cache";
+    std::filesystem::remove(path);
+    OctreeChunkMesh triangle;
+    triangle.vertices = {OctreeVertex({0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}),
+                         OctreeVertex({1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}),
+                         OctreeVertex({0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 1.0f})};
+    triangle.indices = {0, 1, 2};
+    triangle.meshlets.meshlets = {Meshlet{.vertex_count = 3, .triangle_count = 1}};
+    triangle.meshlets.vertices = {0, 1, 2};
+    triangle.meshlets.triangles = {pack_meshlet_triangle({0, 1, 2})};
+
+    // Meshlets which reach outside of the meshlet vertices, the meshlet triangles, the indices, or the vertices
+    std::vector<OctreeChunkMesh> meshes(5, triangle);
+    meshes[1].meshlets.meshlets[0].vertex_count = 4;
+    meshes[2].meshlets.meshlets[0].triangle_offset = 1;
+    meshes[3].meshlets.triangles.push_back(pack_meshlet_triangle({0, 1, 2}));
+    meshes[3].meshlets.meshlets[0].triangle_count = 2;
+    meshes[4].meshlets.vertices[2] = 3;
+    {
+        OctreeMeshCache cache(path);
+        for (std::uint64_t key = 0; key < meshes.size(); key++) {
+            cache.insert(key, {&meshes[key], 1});
+        }
+        // The file must not be replaced while it is mapped, and its entries must be found after saving
+        ASSERT_TRUE(cache.save());
+        EXPECT_TRUE(cache.find(0).has_value());
+        EXPECT_TRUE(cache.save());
+    }
+
+    OctreeMeshCache cache(path);
+    const auto lods = cache.find(0);
+    ASSERT_TRUE(lods.has_value());
+    EXPECT_EQ(lods->at(0).meshlets.vertices, triangle.meshlets.vertices);
+    for (std::uint64_t key = 1; key < meshes.size(); key++) {
+        EXPECT_FALSE(cache.find(key).has_value());
+    }
+    EXPECT_EQ(cache.hits(), 1u);
+    EXPECT_EQ(cache.misses(), meshes.size() - 1);
+    std::filesystem::remove(path);
+}
+
+} // namespace
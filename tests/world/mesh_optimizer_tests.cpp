@@ -0,0 +1,122 @@
+#include <inexor/vulkan-renderer/octree/cube.hpp>
+#include <inexor/vulkan-renderer/render-modules/octree/octree_mesh.hpp>
+#include <inexor/vulkan-renderer/tools/mesh_optimizer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace {
+using namespace inexor::vulkan_renderer::tools;
+using inexor::vulkan_renderer::octree::Cube;
+using inexor::vulkan_renderer::render_modules::octree::OctreeMesher;
+
+/// A regular grid of quads whose triangles are listed in a cache unfriendly order: all lower triangles first, then
+/// all upper triangles, column by column.
+std::vector<std::uint32_t> create_grid_indices(const std::uint32_t size) {
+    const auto vertex = [&](const std::uint32_t x, const std::uint32_t y) { return y * (size + 1) + x; };
+    std::vector<std::uint32_t> indices;
+    for (std::uint32_t half = 0; half < 2; half++) {
+        for (std::uint32_t x = 0; x < size; x++) {
+            for (std::uint32_t y = 0; y < size; y++) {
+                if (half == 0) {
+                    indices.insert(indices.end(), {vertex(x, y), vertex(x + 1, y), vertex(x, y + 1)});
+                } else {
+                    indices.insert(indices.end(), {vertex(x + 1, y), vertex(x + 1, y + 1), vertex(x, y + 1)});
+                }
+            }
+        }
+    }
+    return indices;
+}
+
+/// The triangles of a triangle list with their corners rotated so the smallest index is first, in sorted order.
+std::vector<std::array<std::uint32_t, 3>> sorted_triangles(const std::vector<std::uint32_t> &indices) {
+    std::vector<std::array<std::uint32_t, 3>> triangles;
+    for (std::size_t idx = 0; idx < indices.size(); idx += 3) {
+        std::array<std::uint32_t, 3> triangle{indices[idx], indices[idx + 1], indices[idx + 2]};
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        triangles.push_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+TEST(MeshOptimizer, vertex_cache) {
+    constexpr std::uint32_t GRID_SIZE{16};
+    constexpr std::size_t VERTEX_COUNT{(GRID_SIZE + 1) * (GRID_SIZE + 1)};
+    const auto original = create_grid_indices(GRID_SIZE);
+    auto indices = original;
+
+    const float acmr_before = average_cache_miss_ratio(indices, VERTEX_COUNT);
+    const auto clusters = optimize_vertex_cache(indices, VERTEX_COUNT);
+    const float acmr_after = average_cache_miss_ratio(indices, VERTEX_COUNT);
+    EXPECT_LT(acmr_after, acmr_before);
+    EXPECT_LT(acmr_after, 1.0f);
+    ASSERT_FALSE(clusters.empty());
+    EXPECT_EQ(clusters.front(), 0u);
+    EXPECT_TRUE(std::is_sorted(clusters.begin(), clusters.end()));
+    for (const auto cluster : clusters) {
+        EXPECT_EQ(cluster % 3, 0u);
+    }
+    // Only the order of the triangles changes
+    EXPECT_EQ(sorted_triangles(indices), sorted_triangles(original));
+
+    EXPECT_THROW(optimize_vertex_cache(std::span(indices).first(4), VERTEX_COUNT), std::invalid_argument);
+    EXPECT_THROW(optimize_vertex_cache(indices, VERTEX_COUNT - 1), std::invalid_argument);
+}
+
+TEST(MeshOptimizer, vertex_fetch) {
+    // Vertex 1 is not used
+    std::vector<std::uint32_t> indices{4, 2, 0, 0, 2, 3};
+    std::vector<int> vertices{10, 11, 12, 13, 14};
+
+    const auto remap = optimize_vertex_fetch(indices, vertices.size());
+    EXPECT_EQ(indices, (std::vector<std::uint32_t>{0, 1, 2, 2, 1, 3}));
+    EXPECT_EQ(remap[1], UNUSED_VERTEX);
+    remap_vertices(vertices, remap);
+    EXPECT_EQ(vertices, (std::vector<int>{14, 12, 10, 13}));
+}
+
+TEST(MeshOptimizer, octree_mesh) {
+    auto world = std::make_shared<Cube>(2.0f, glm::vec3{0.0f, 0.0f, 0.0f});
+    world->set_type(Cube::Type::OCTANT);
+    for (std::size_t idx = 0; idx < 8; idx += 2) {
+        world->children()[idx]->set_type(Cube::Type::SOLID);
+    }
+    const std::array worlds{world};
+    const auto color = [](const glm::vec3 &) { return glm::vec3{1.0f}; };
+
+    OctreeMesher unoptimized_mesher(1, 1, color);
+    unoptimized_mesher.set_optimizations({.vertex_cache = false, .overdraw = false, .vertex_fetch = false});
+    const auto unoptimized = unoptimized_mesher.mesh(worlds);
+    const auto optimized = OctreeMesher(1, 1, color).mesh(worlds);
+
+    ASSERT_EQ(optimized.indices.size(), unoptimized.indices.size());
+    ASSERT_EQ(optimized.vertices.size(), unoptimized.vertices.size());
+    EXPECT_EQ(unoptimized.acmr_before_optimization, unoptimized.acmr_after_optimization);
+    EXPECT_LE(optimized.acmr_after_optimization, optimized.acmr_before_optimization);
+    // The chunk ranges are unchanged, and every range references the same vertices
+    EXPECT_EQ(optimized.chunks, unoptimized.chunks);
+    for (const auto &chunk : optimized.chunks) {
+        const auto [first_index, index_count] = chunk.lods[0];
+        std::vector<glm::vec3> optimized_positions;
+        std::vector<glm::vec3> unoptimized_positions;
+        for (auto idx = first_index; idx < first_index + index_count; idx++) {
+            optimized_positions.push_back(optimized.vertices[optimized.indices[idx]].position);
+            unoptimized_positions.push_back(unoptimized.vertices[unoptimized.indices[idx]].position);
+        }
+        const auto less = [](const glm::vec3 &lhs, const glm::vec3 &rhs) {
+            return std::tie(lhs.x, lhs.y, lhs.z) < std::tie(rhs.x, rhs.y, rhs.z);
+        };
+        std::sort(optimized_positions.begin(), optimized_positions.end(), less);
+        std::sort(unoptimized_positions.begin(), unoptimized_positions.end(), less);
+        EXPECT_EQ(optimized_positions, unoptimized_positions);
+    }
+}
+
+} // namespace
@@ -0,0 +1,157 @@
+#include <inexor/vulkan-renderer/octree/cube.hpp>
+#include <inexor/vulkan-renderer/render-modules/octree/octree_mesh.hpp>
+#include <inexor/vulkan-renderer/tools/meshlet.hpp>
+
+#include <gtest/gtest.h>
+
+#include <glm/geometric.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace {
+using namespace inexor::vulkan_renderer::tools;
+using inexor::vulkan_renderer::octree::Cube;
+using inexor::vulkan_renderer::render_modules::octree::build_octree_mesh;
+using inexor::vulkan_renderer::render_modules::octree::collect_draw_ranges;
+using inexor::vulkan_renderer::render_modules::octree::collect_meshlet_draw_ranges;
+using inexor::vulkan_renderer::render_modules::octree::OctreeMeshRange;
+
+std::size_t count_indices(const std::vector<OctreeMeshRange> &ranges) {
+    std::size_t index_count = 0;
+    for (const auto &range : ranges) {
+        index_count += range.index_count;
+    }
+    return index_count;
+}
+
+TEST(Meshlet, build_meshlets) {
+    // A flat grid in the xz plane whose triangles face upwards
+    constexpr std::uint32_t GRID_SIZE{16};
+    std::vector<glm::vec3> positions;
+    for (std::uint32_t z = 0; z <= GRID_SIZE; z++) {
+        for (std::uint32_t x = 0; x <= GRID_SIZE; x++) {
+            positions.emplace_back(static_cast<float>(x), 0.0f, static_cast<float>(z));
+        }
+    }
+    const auto vertex = [&](const std::uint32_t x, const std::uint32_t z) { return z * (GRID_SIZE + 1) + x; };
+    std::vector<std::uint32_t> indices;
+    for (std::uint32_t z = 0; z < GRID_SIZE; z++) {
+        for (std::uint32_t x = 0; x < GRID_SIZE; x++) {
+            indices.insert(indices.end(), {vertex(x, z), vertex(x + 1, z), vertex(x, z + 1)});
+            indices.insert(indices.end(), {vertex(x + 1, z), vertex(x + 1, z + 1), vertex(x, z + 1)});
+        }
+    }
+
+    const auto data = build_meshlets(indices, positions);
+    ASSERT_GT(data.meshlets.size(), 1u);
+    EXPECT_EQ(data.triangles.size(), indices.size() / 3);
+    std::size_t next_triangle = 0;
+    for (const auto &meshlet : data.meshlets) {
+        EXPECT_LE(meshlet.vertex_count, MAX_MESHLET_VERTICES);
+        EXPECT_LE(meshlet.triangle_count, MAX_MESHLET_TRIANGLES);
+        // The meshlets cover the triangles in the order of the indices
+        EXPECT_EQ(meshlet.triangle_offset, next_triangle);
+        next_triangle += meshlet.triangle_count;
+        for (std::uint32_t triangle = 0; triangle < meshlet.triangle_count; triangle++) {
+            const auto corners = unpack_meshlet_triangle(data.triangles[meshlet.triangle_offset + triangle]);
+            for (std::size_t corner = 0; corner < 3; corner++) {
+                ASSERT_LT(corners[corner], meshlet.vertex_count);
+                const auto index = data.vertices[meshlet.vertex_offset + corners[corner]];
+                EXPECT_EQ(index, indices[3 * (meshlet.triangle_offset + triangle) + corner]);
+                EXPECT_LE(glm::length(positions[index] - meshlet.center), meshlet.radius * 1.0001f);
+            }
+        }
+        // All triangles of a plane face the same way, so the cone has no spread
+        EXPECT_LT(meshlet.cone_cutoff, 0.01f);
+        EXPECT_TRUE(is_meshlet_backfacing(meshlet, meshlet.center - glm::vec3{0.0f, 5.0f, 0.0f}));
+        EXPECT_FALSE(is_meshlet_backfacing(meshlet, meshlet.center + glm::vec3{0.0f, 5.0f, 0.0f}));
+    }
+    EXPECT_EQ(next_triangle, indices.size() / 3);
+
+    // Splits start new meshlets
+    const std::array<std::size_t, 1> splits{6};
+    const auto split_data = build_meshlets(std::span(indices).first(12), positions, MAX_MESHLET_VERTICES,
+                                           MAX_MESHLET_TRIANGLES, splits);
+    ASSERT_EQ(split_data.meshlets.size(), 2u);
+    EXPECT_EQ(split_data.meshlets[1].triangle_offset, 2u);
+
+    EXPECT_THROW(build_meshlets(indices, positions, 2), std::invalid_argument);
+    EXPECT_THROW(build_meshlets(indices, positions, MAX_MESHLET_VERTICES, 0), std::invalid_argument);
+    EXPECT_THROW(build_meshlets(std::span(indices).first(4), positions), std::invalid_argument);
+}
+
+TEST(Meshlet, normal_cone_of_stacked_faces) {
+    // A small quad at y = 0 below a large grid at y = 2, all facing upwards, so the bounding sphere of the meshlet is
+    // not centered between the two planes
+    std::vector<glm::vec3> positions{{1.0f, 0.0f, 1.0f}, {2.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 2.0f}, {2.0f, 0.0f, 2.0f}};
+    std::vector<std::uint32_t> indices{0, 1, 2, 1, 3, 2};
+    constexpr std::uint32_t GRID_SIZE{3};
+    for (std::uint32_t z = 0; z <= GRID_SIZE; z++) {
+        for (std::uint32_t x = 0; x <= GRID_SIZE; x++) {
+            positions.emplace_back(static_cast<float>(x), 2.0f, static_cast<float>(z));
+        }
+    }
+    const auto vertex = [&](const std::uint32_t x, const std::uint32_t z) { return 4 + z * (GRID_SIZE + 1) + x; };
+    for (std::uint32_t z = 0; z < GRID_SIZE; z++) {
+        for (std::uint32_t x = 0; x < GRID_SIZE; x++) {
+            indices.insert(indices.end(), {vertex(x, z), vertex(x + 1, z), vertex(x, z + 1)});
+            indices.insert(indices.end(), {vertex(x + 1, z), vertex(x + 1, z + 1), vertex(x, z + 1)});
+        }
+    }
+
+    const auto data = build_meshlets(indices, positions);
+    ASSERT_EQ(data.meshlets.size(), 1u);
+    const auto &meshlet = data.meshlets[0];
+    ASSERT_GT(meshlet.center.y, 1.0f);
+    // The apex is behind the planes of all triangles
+    EXPECT_LE(meshlet.cone_apex.y, 0.0f);
+    // A camera between the two planes sees the upper side of the small quad
+    EXPECT_FALSE(is_meshlet_backfacing(meshlet, glm::vec3{1.5f, 0.25f, 1.5f}));
+    EXPECT_TRUE(is_meshlet_backfacing(meshlet, glm::vec3{1.5f, -5.0f, 1.5f}));
+}
+
+TEST(Meshlet, octree_meshlet_culling) {
+    // A wall of 4 x 4 solid cubes in the xy plane
+    auto world = std::make_shared<Cube>(4.0f, glm::vec3{0.0f, 0.0f, 0.0f});
+    world->set_type(Cube::Type::OCTANT);
+    for (const auto &child : world->children()) {
+        child->set_type(Cube::Type::OCTANT);
+        for (std::size_t idx = 0; idx < 8; idx++) {
+            // Only the cubes with z = 0 are solid
+            if ((idx & 1) == 0 && (child->bounding_box()[0].z == 0.0f)) {
+                child->children()[idx]->set_type(Cube::Type::SOLID);
+            }
+        }
+    }
+    const std::array worlds{world};
+    const auto mesh = build_octree_mesh(worlds, 1, 1, [](const glm::vec3 &) { return glm::vec3{1.0f}; });
+    ASSERT_FALSE(mesh.meshlets.empty());
+    ASSERT_EQ(mesh.meshlet_triangles.size(), mesh.indices.size() / 3);
+    for (const auto &meshlet : mesh.meshlets) {
+        for (std::uint32_t triangle = 0; triangle < meshlet.triangle_count; triangle++) {
+            const auto corners = unpack_meshlet_triangle(mesh.meshlet_triangles[meshlet.triangle_offset + triangle]);
+            for (std::size_t corner = 0; corner < 3; corner++) {
+                EXPECT_EQ(mesh.meshlet_vertices[meshlet.vertex_offset + corners[corner]],
+                          mesh.indices[3 * (meshlet.triangle_offset + triangle) + corner]);
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> all_chunks(mesh.chunks.size());
+    for (std::uint32_t idx = 0; idx < all_chunks.size(); idx++) {
+        all_chunks[idx] = idx;
+    }
+    // Looking at the wall from the front, the back faces of the wall are culled
+    const glm::vec3 camera_position{2.0f, 2.0f, -10.0f};
+    std::vector<OctreeMeshRange> chunk_ranges;
+    std::vector<OctreeMeshRange> meshlet_ranges;
+    collect_draw_ranges(mesh, all_chunks, camera_position, {}, chunk_ranges);
+    collect_meshlet_draw_ranges(mesh, all_chunks, Frustum(), camera_position, {}, meshlet_ranges);
+    EXPECT_EQ(count_indices(chunk_ranges), mesh.indices.size());
+    EXPECT_GT(count_indices(meshlet_ranges), 0u);
+    EXPECT_LT(count_indices(meshlet_ranges), count_indices(chunk_ranges));
+}
+
+} // namespace
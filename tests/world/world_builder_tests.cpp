@@ -0,0 +1,55 @@
+#include <inexor/vulkan-renderer/octree/cube.hpp>
+#include <inexor/vulkan-renderer/octree/world_builder.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+namespace {
+using namespace inexor::vulkan_renderer::octree;
+
+TEST(WorldBuilder, flat_heightmap) {
+    // A flat terrain at half of the root's height fills exactly the lower four octants.
+    const Heightmap heightmap(2, 2, {2.0f, 2.0f, 2.0f, 2.0f});
+    const auto world = create_world_from_heightmap(heightmap, 3, 4.0f, {0.0f, 0.0f, 0.0f});
+
+    ASSERT_EQ(world->type(), Cube::Type::OCTANT);
+    for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+        const bool lower_half = (idx & 1u) == 0;
+        EXPECT_EQ(world->children()[idx]->type(), lower_half ? Cube::Type::SOLID : Cube::Type::EMPTY);
+    }
+}
+
+TEST(WorldBuilder, sloped_heightmap_indents_vertical_edges) {
+    // The terrain rises from 0 to 1 along x, so the root cube of size 1 is crossed by the surface.
+    const Heightmap heightmap(2, 2, {0.0f, 1.0f, 0.0f, 1.0f});
+    const auto world = create_world_from_heightmap(heightmap, 0, 1.0f, {0.0f, 0.0f, 0.0f});
+
+    ASSERT_EQ(world->type(), Cube::Type::NORMAL);
+    const auto indentations = world->indentations();
+    // Vertical edges at x = 0 are pulled down completely, the ones at x = 1 are not indented at all.
+    EXPECT_EQ(indentations[2].end_abs(), 0);
+    EXPECT_EQ(indentations[11].end_abs(), 0);
+    EXPECT_EQ(indentations[5].end_abs(), Indentation::MAX);
+    EXPECT_EQ(indentations[8].end_abs(), Indentation::MAX);
+}
+
+TEST(WorldBuilder, sdf_only_subdivides_at_surface) {
+    const auto sphere = [](const glm::vec3 &point) {
+        const glm::vec3 offset = point - glm::vec3{4.0f, 4.0f, 4.0f};
+        return std::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z) - 3.0f;
+    };
+    const auto world = create_world_from_sdf(sphere, 4, 8.0f, {0.0f, 0.0f, 0.0f});
+
+    ASSERT_EQ(world->type(), Cube::Type::OCTANT);
+    EXPECT_GT(world->count_geometry_cubes(), 0u);
+
+    // A sphere which does not touch the root cube is not subdivided at all.
+    const auto far_away = [](const glm::vec3 &point) {
+        const glm::vec3 offset = point - glm::vec3{100.0f, 100.0f, 100.0f};
+        return std::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z) - 1.0f;
+    };
+    EXPECT_EQ(create_world_from_sdf(far_away, 4, 8.0f, {0.0f, 0.0f, 0.0f})->type(), Cube::Type::EMPTY);
+}
+
+} // namespace